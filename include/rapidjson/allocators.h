@@ -287,6 +287,35 @@ public:
         shared_->chunkHead->size = 0;
     }
 
+    //! Takes over the memory chunks of another allocator.
+    /*! Blocks allocated from \c rhs stay valid and are freed with this
+        allocator, which keeps allocating from its current chunk. \c rhs is
+        left empty, as after Clear().
+
+        The chunks are freed by this allocator's base allocator, which must
+        be able to free the memory of the base allocator of \c rhs (as with
+        the stateless CrtAllocator).
+        \param rhs Allocator owning its first chunk, not shared.
+    */
+    void Adopt(MemoryPoolAllocator& rhs) {
+        RAPIDJSON_ASSERT(shared_->refcount > 0);
+        RAPIDJSON_ASSERT(rhs.shared_->refcount == 1 && rhs.shared_->ownBuffer);
+        RAPIDJSON_ASSERT(shared_ != rhs.shared_);
+        ChunkHeader* first = rhs.shared_->chunkHead;
+        ChunkHeader* last = GetChunkHead(rhs.shared_);  // The first chunk, which is never freed
+        if (first == last)
+            return;
+        if (!baseAllocator_)
+            shared_->ownBaseAllocator = baseAllocator_ = RAPIDJSON_NEW(BaseAllocator)();
+        ChunkHeader* c = first;
+        while (c->next != last)
+            c = c->next;
+        c->next = shared_->chunkHead->next;
+        shared_->chunkHead->next = first;
+        rhs.shared_->chunkHead = last;
+        last->size = 0;
+    }
+
     //! Computes the total capacity of allocated memory chunks.
     /*! \return total capacity in bytes.
     */
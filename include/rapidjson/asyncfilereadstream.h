@@ -0,0 +1,237 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_ASYNCFILEREADSTREAM_H_
+#define RAPIDJSON_ASYNCFILEREADSTREAM_H_
+
+/*! \file asyncfilereadstream.h */
+
+#include "stream.h"
+
+#if RAPIDJSON_HAS_CXX11
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+namespace internal {
+
+//! Background thread of AsyncFileReadStream, filling the blocks of a buffer in turn with fread().
+class BlockReader {
+public:
+    BlockReader(std::FILE* fp, char* blocks, size_t blockSize, size_t blockCount) :
+        fp_(fp), blocks_(blocks), blockSize_(blockSize), readCounts_(blockCount, static_cast<size_t>(kEmpty)),
+        mutex_(), filled_(), emptied_(), stop_(false), thread_()
+    {
+        thread_ = std::thread(&BlockReader::Run, this);
+    }
+
+    ~BlockReader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        emptied_.notify_one();
+        thread_.join();
+    }
+
+    //! Hands a consumed block back to the thread.
+    void Release(size_t block) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            readCounts_[block] = kEmpty;
+        }
+        emptied_.notify_one();
+    }
+
+    //! Waits for a block to be filled, and returns the number of bytes read in it.
+    size_t Acquire(size_t block) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (readCounts_[block] == kEmpty)
+            filled_.wait(lock);
+        return readCounts_[block];
+    }
+
+    size_t GetBlockCount() const { return readCounts_.size(); }
+
+private:
+    BlockReader(const BlockReader&);
+    BlockReader& operator=(const BlockReader&);
+
+    static const size_t kEmpty = ~static_cast<size_t>(0); //!< Read count of a block not filled yet.
+
+    //! Fills the blocks in turn until the end of the file.
+    void Run() {
+        for (size_t i = 0; ; i = (i + 1) % readCounts_.size()) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (!stop_ && readCounts_[i] != kEmpty)
+                    emptied_.wait(lock);
+                if (stop_)
+                    return;
+            }
+            const size_t readCount = std::fread(blocks_ + i * blockSize_, 1, blockSize_, fp_);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                readCounts_[i] = readCount;
+            }
+            filled_.notify_one();
+            if (readCount < blockSize_)
+                return;
+        }
+    }
+
+    std::FILE* fp_;
+    char* blocks_;
+    size_t blockSize_;
+    std::vector<size_t> readCounts_;    //!< Number of bytes read in each block, kEmpty if the block is free.
+    std::mutex mutex_;
+    std::condition_variable filled_;    //!< Signals a block read by the thread.
+    std::condition_variable emptied_;   //!< Signals a block consumed by the stream, or stop_.
+    bool stop_;
+    std::thread thread_;
+};
+
+} // namespace internal
+
+//! File byte stream for input, reading ahead with a background thread.
+/*! The user-supplied buffer is split into \c blockCount blocks. A background
+    thread fills them in turn with fread() while the parser consumes the
+    block before: the parser only waits for the file when it consumes
+    faster than the file can be read.
+
+    Apart from the buffer layout, it behaves as FileReadStream: the file must
+    not be used by anything else until the stream is destroyed, and Peek4()
+    only sees the first block.
+
+    \note implements Stream concept
+    \note The destructor waits for the fread() in progress, which on a pipe
+        or a terminal may block until more input is available.
+*/
+class AsyncFileReadStream {
+public:
+    typedef char Ch;    //!< Character type (byte).
+
+    //! Constructor.
+    /*!
+        \param fp File pointer opened for read.
+        \param buffer user-supplied buffer.
+        \param bufferSize size of buffer in bytes. Must >= 4 bytes per block.
+        \param blockCount Number of blocks the buffer is split into. Must >= 2.
+    */
+    AsyncFileReadStream(std::FILE* fp, char* buffer, size_t bufferSize, size_t blockCount = 2) :
+        reader_(), blocks_(buffer), blockSize_(bufferSize / blockCount), block_(0),
+        buffer_(buffer), bufferLast_(0), current_(buffer), readCount_(0), count_(0), eof_(false)
+    {
+        RAPIDJSON_ASSERT(fp != 0);
+        RAPIDJSON_ASSERT(blockCount >= 2);
+        RAPIDJSON_ASSERT(blockSize_ >= 4);
+        reader_ = RAPIDJSON_NEW(internal::BlockReader)(fp, buffer, blockSize_, blockCount);
+        Read();
+    }
+
+    ~AsyncFileReadStream() { RAPIDJSON_DELETE(reader_); }
+
+    Ch Peek() const { return *current_; }
+    Ch Take() { Ch c = *current_; Read(); return c; }
+    size_t Tell() const { return count_ + static_cast<size_t>(current_ - buffer_); }
+
+    // Not implemented
+    void Put(Ch) { RAPIDJSON_ASSERT(false); }
+    void Flush() { RAPIDJSON_ASSERT(false); }
+    Ch* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+    size_t PutEnd(Ch*) { RAPIDJSON_ASSERT(false); return 0; }
+
+    // For encoding detection only.
+    const Ch* Peek4() const {
+        return (current_ + 4 - !eof_ <= bufferLast_) ? current_ : 0;
+    }
+
+    // BufferedStream concept, the null character ending the file is not part of the window.
+    const Ch* Window() const { return current_; }
+    size_t WindowSize() const { return static_cast<size_t>(bufferLast_ - current_) + !eof_; }
+    void Consume(size_t n) {
+        RAPIDJSON_ASSERT(n <= WindowSize());
+        current_ += n;
+        if (current_ > bufferLast_) {
+            current_ = bufferLast_;
+            Read();
+        }
+    }
+
+private:
+    AsyncFileReadStream(const AsyncFileReadStream&);
+    AsyncFileReadStream& operator=(const AsyncFileReadStream&);
+
+    void Read() {
+        if (current_ < bufferLast_)
+            ++current_;
+        else if (!eof_)
+            NextBlock();
+    }
+
+    //! Hands the consumed block back to the reading thread, and waits for the next one.
+    void NextBlock() {
+        count_ += readCount_;
+        if (bufferLast_ != 0) { // Not the first block
+            reader_->Release(block_);
+            block_ = (block_ + 1) % reader_->GetBlockCount();
+        }
+        readCount_ = reader_->Acquire(block_);
+        buffer_ = blocks_ + block_ * blockSize_;
+        bufferLast_ = buffer_ + readCount_ - 1;
+        current_ = buffer_;
+
+        if (readCount_ < blockSize_) {
+            buffer_[readCount_] = '\0';
+            ++bufferLast_;
+            eof_ = true;
+        }
+    }
+
+    internal::BlockReader* reader_;
+    Ch* blocks_;
+    size_t blockSize_;
+    size_t block_;  //!< Index of the block being consumed.
+    Ch *buffer_;
+    Ch *bufferLast_;
+    Ch *current_;
+    size_t readCount_;
+    size_t count_;  //!< Number of characters read
+    bool eof_;
+};
+
+template<>
+struct BufferedStreamTraits<AsyncFileReadStream> {
+    enum { buffered = 1 };
+};
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_HAS_CXX11
+
+#endif // RAPIDJSON_ASYNCFILEREADSTREAM_H_
@@ -55,10 +55,6 @@ RAPIDJSON_DIAG_OFF(effc++)
 #include <iterator> // std::random_access_iterator_tag
 #endif
 
-#if RAPIDJSON_USE_MEMBERSMAP
-#include <map> // std::multimap
-#endif
-
 RAPIDJSON_NAMESPACE_BEGIN
 
 // Forward declaration.
@@ -372,7 +368,7 @@ struct GenericStringRef {
      */
 #endif
     template<SizeType N>
-    GenericStringRef(const CharType (&str)[N]) RAPIDJSON_NOEXCEPT
+    RAPIDJSON_CONSTEXPR GenericStringRef(const CharType (&str)[N]) RAPIDJSON_NOEXCEPT
         : s(str), length(N-1) {}
 
     //! Explicitly create string reference from \c const character pointer
@@ -411,7 +407,7 @@ struct GenericStringRef {
     GenericStringRef(const CharType* str, SizeType len)
         : s(RAPIDJSON_LIKELY(str) ? str : emptyString), length(len) { RAPIDJSON_ASSERT(str != 0 || len == 0u); }
 
-    GenericStringRef(const GenericStringRef& rhs) : s(rhs.s), length(rhs.length) {}
+    RAPIDJSON_CONSTEXPR GenericStringRef(const GenericStringRef& rhs) : s(rhs.s), length(rhs.length) {}
 
     //! implicit conversion to plain CharType pointer
     operator const Ch *() const { return s; }
@@ -494,6 +490,101 @@ inline GenericStringRef<CharType> StringRef(const std::basic_string<CharType>& s
 }
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+// GenericHashedStringRef
+
+//! Reference to a constant string, with its hash computed once
+/*!
+    \tparam CharType character type of the string
+
+    A \ref GenericStringRef which also carries the hash of the string, for
+    names looked up repeatedly with \ref GenericValue::FindMember. Construct
+    it once, e.g. as a \c static object, and reuse it:
+
+    \code
+    static const Value::HashedStringRefType kTimestamp = "timestamp";
+    for (...) {
+        Value::ConstMemberIterator itr = document.FindMember(kTimestamp);
+        ...
+    }
+    \endcode
+
+    With C++11, the hash of a string literal is a constant expression when
+    the object is copy-initialized from it, as above: a \c static object is
+    constant-initialized, and a \c constexpr one can be declared. Direct
+    initialization, e.g. \c kTimestamp("timestamp"), selects the constructor
+    from a pointer, which hashes at runtime like it does for other strings
+    and for string literals before C++11.
+
+    When \ref RAPIDJSON_USE_MEMBERSMAP is enabled, objects cache the hashes
+    of their member names as well, and a lookup rejects every other name by
+    comparing two integers. The price is that every member name added to an
+    object, e.g. every key of a parsed document, is hashed, whether or not
+    hashed lookups are used.
+
+    Otherwise, which is the default, the hash is not used: a lookup compares
+    names as \ref GenericValue::FindMember(const GenericValue&) does, and
+    costs the same.
+
+    \see HashedStringRef, GenericValue::FindMember(const HashedStringRefType&)
+*/
+template<typename CharType>
+struct GenericHashedStringRef : GenericStringRef<CharType> {
+    typedef CharType Ch; //!< character type of the string
+
+    //! Create hashed string reference from \c const character array
+    /*! The hash of a string literal is computed at compile time with C++11. */
+    template<SizeType N>
+    RAPIDJSON_CONSTEXPR GenericHashedStringRef(const CharType (&str)[N]) RAPIDJSON_NOEXCEPT
+        : GenericStringRef<CharType>(Literal(str)), hash(internal::StrHashLiteral(str, N - 1)) {}
+
+    //! Explicitly create hashed string reference from \c const character pointer
+    explicit GenericHashedStringRef(const CharType* str)
+        : GenericStringRef<CharType>(str), hash(internal::StrHash(this->s, this->length)) {}
+
+    //! Create hashed string reference from pointer and length
+    GenericHashedStringRef(const CharType* str, SizeType len)
+        : GenericStringRef<CharType>(str, len), hash(internal::StrHash(this->s, this->length)) {}
+
+    RAPIDJSON_CONSTEXPR GenericHashedStringRef(const GenericHashedStringRef& rhs) : GenericStringRef<CharType>(rhs), hash(rhs.hash) {}
+
+    const uint32_t hash; //!< hash of the string, see internal::StrHash()
+
+private:
+    //! Reference to a literal, without the strlen() of direct initialization
+    template<SizeType N>
+    static RAPIDJSON_CONSTEXPR GenericStringRef<CharType> Literal(const CharType (&str)[N]) { return str; }
+
+    //! Disallow construction from non-const array
+    template<SizeType N>
+    GenericHashedStringRef(CharType (&str)[N]) /* = delete */;
+    //! Copy assignment operator not permitted - immutable type
+    GenericHashedStringRef& operator=(const GenericHashedStringRef& rhs) /* = delete */;
+};
+
+//! Mark a character pointer as constant string and compute its hash
+/*! \tparam CharType Character type of the string
+    \param str Constant string, lifetime assumed to be longer than the use of the string in e.g. a GenericValue
+    \return GenericHashedStringRef string reference object
+    \relatesalso GenericHashedStringRef
+*/
+template<typename CharType>
+inline GenericHashedStringRef<CharType> HashedStringRef(const CharType* str) {
+    return GenericHashedStringRef<CharType>(str);
+}
+
+//! Mark a character pointer as constant string and compute its hash
+/*! \tparam CharType Character type of the string
+    \param str Constant string, lifetime assumed to be longer than the use of the string in e.g. a GenericValue
+    \param length The length of source string.
+    \return GenericHashedStringRef string reference object
+    \relatesalso GenericHashedStringRef
+*/
+template<typename CharType>
+inline GenericHashedStringRef<CharType> HashedStringRef(const CharType* str, size_t length) {
+    return GenericHashedStringRef<CharType>(str, SizeType(length));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // GenericValue type traits
 namespace internal {
@@ -647,6 +738,59 @@ struct TypeHelper<ValueType, typename ValueType::ConstObject> {
 
 } // namespace internal
 
+///////////////////////////////////////////////////////////////////////////////
+// Raw numbers
+
+namespace internal {
+
+//! Read-only stream of the text of a raw number, which may not be null-terminated.
+template <typename Encoding>
+class RawNumberStream {
+public:
+    typedef typename Encoding::Ch Ch;
+
+    RawNumberStream(const Ch* src, SizeType length) : src_(src), head_(src), end_(src + length) {}
+
+    Ch Peek() const { return src_ != end_ ? *src_ : Ch('\0'); }
+    Ch Take() { return src_ != end_ ? *src_++ : Ch('\0'); }
+    size_t Tell() const { return static_cast<size_t>(src_ - head_); }
+
+    Ch* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+    void Put(Ch) { RAPIDJSON_ASSERT(false); }
+    void Flush() { RAPIDJSON_ASSERT(false); }
+    size_t PutEnd(Ch*) { RAPIDJSON_ASSERT(false); return 0; }
+
+private:
+    RawNumberStream(const RawNumberStream&);
+    RawNumberStream& operator=(const RawNumberStream&);
+
+    const Ch* src_;
+    const Ch* head_;
+    const Ch* end_;
+};
+
+//! Handler setting a value to the number parsed from a raw number.
+template <typename ValueType>
+class RawNumberHandler : public BaseReaderHandler<typename ValueType::EncodingType, RawNumberHandler<ValueType> > {
+public:
+    explicit RawNumberHandler(ValueType& value) : value_(value) {}
+
+    bool Default() { return false; }
+    bool Int(int i) { value_.SetInt(i); return true; }
+    bool Uint(unsigned u) { value_.SetUint(u); return true; }
+    bool Int64(int64_t i) { value_.SetInt64(i); return true; }
+    bool Uint64(uint64_t u) { value_.SetUint64(u); return true; }
+    bool Double(double d) { value_.SetDouble(d); return true; }
+
+private:
+    RawNumberHandler(const RawNumberHandler&);
+    RawNumberHandler& operator=(const RawNumberHandler&);
+
+    ValueType& value_;
+};
+
+} // namespace internal
+
 // Forward declarations
 template <bool, typename> class GenericArray;
 template <bool, typename> class GenericObject;
@@ -673,6 +817,7 @@ public:
     typedef Allocator AllocatorType;                //!< Allocator type from template parameter.
     typedef typename Encoding::Ch Ch;               //!< Character type derived from Encoding.
     typedef GenericStringRef<Ch> StringRefType;     //!< Reference to a constant string
+    typedef GenericHashedStringRef<Ch> HashedStringRefType; //!< Reference to a constant string, with its hash
     typedef typename GenericMemberIterator<false,Encoding,Allocator>::Iterator MemberIterator;  //!< Member iterator for iterating in object.
     typedef typename GenericMemberIterator<true,Encoding,Allocator>::Iterator ConstMemberIterator;  //!< Constant member iterator for iterating in object.
     typedef GenericValue* ValueIterator;            //!< Value iterator for iterating in array.
@@ -740,6 +885,7 @@ public:
     */
     template <typename SourceAllocator>
     GenericValue(const GenericValue<Encoding,SourceAllocator>& rhs, Allocator& allocator, bool copyConstStrings = false) {
+        rhs.Materialize();
         switch (rhs.GetType()) {
         case kObjectType:
             DoCopyMembers(rhs, allocator, copyConstStrings);
@@ -764,8 +910,12 @@ public:
                 SetStringRaw(StringRef(rhs.GetString(), rhs.GetStringLength()), allocator);
             break;
         default:
-            data_.f.flags = rhs.data_.f.flags;
-            data_  = *reinterpret_cast<const Data*>(&rhs.data_);
+            if ((rhs.data_.f.flags & kRawNumberFlag) && (rhs.data_.f.flags != kConstRawNumberFlag || copyConstStrings))
+                SetRawNumberRaw(StringRef(DataString(*reinterpret_cast<const Data*>(&rhs.data_)), DataStringLength(*reinterpret_cast<const Data*>(&rhs.data_))), &allocator);
+            else {
+                data_.f.flags = rhs.data_.f.flags;
+                data_  = *reinterpret_cast<const Data*>(&rhs.data_);
+            }
             break;
         }
     }
@@ -878,10 +1028,7 @@ public:
     /*! Need to destruct elements of array, members of object, or copy-string.
     */
     ~GenericValue() {
-        // With RAPIDJSON_USE_MEMBERSMAP, the maps need to be destroyed to release
-        // their Allocator if it's refcounted (e.g. MemoryPoolAllocator).
-        if (Allocator::kNeedFree || (RAPIDJSON_USE_MEMBERSMAP+0 &&
-                                     internal::IsRefCounted<Allocator>::Value)) {
+        if (Allocator::kNeedFree) {  // Shortcut by Allocator's trait
             switch(data_.f.flags) {
             case kArrayFlag:
                 {
@@ -899,11 +1046,17 @@ public:
                 break;
 
             case kCopyStringFlag:
+            case kCopyRawNumberFlag:
                 if (Allocator::kNeedFree) { // Shortcut by Allocator's trait
                     Allocator::Free(const_cast<Ch*>(GetStringPointer()));
                 }
                 break;
 
+            case kLazyObjectFlag:
+            case kLazyArrayFlag:
+                Allocator::Free(GetLazyPointer());
+                break;
+
             default:
                 break;  // Do nothing for other types.
             }
@@ -1029,6 +1182,8 @@ public:
 
         switch (GetType()) {
         case kObjectType: // Warning: O(n^2) inner-loop
+            Materialize();
+            rhs.Materialize();
             if (data_.o.size != rhs.data_.o.size)
                 return false;           
             for (ConstMemberIterator lhsMemberItr = MemberBegin(); lhsMemberItr != MemberEnd(); ++lhsMemberItr) {
@@ -1039,6 +1194,8 @@ public:
             return true;
             
         case kArrayType:
+            Materialize();
+            rhs.Materialize();
             if (data_.a.size != rhs.data_.a.size)
                 return false;
             for (SizeType i = 0; i < data_.a.size; i++)
@@ -1050,6 +1207,13 @@ public:
             return StringEqual(rhs);
 
         case kNumberType:
+            if (RAPIDJSON_UNLIKELY(IsRawNumber() || rhs.IsRawNumber())) {
+                GenericValue a;
+                RhsType b;
+                a.data_ = NumberData();
+                b.data_ = rhs.NumberData();
+                return a == b;
+            }
             if (IsDouble() || rhs.IsDouble()) {
                 double a = GetDouble();     // May convert from integer to double.
                 double b = rhs.GetDouble(); // Ditto
@@ -1113,16 +1277,24 @@ public:
     bool IsFalse()  const { return data_.f.flags == kFalseFlag; }
     bool IsTrue()   const { return data_.f.flags == kTrueFlag; }
     bool IsBool()   const { return (data_.f.flags & kBoolFlag) != 0; }
-    bool IsObject() const { return data_.f.flags == kObjectFlag; }
-    bool IsArray()  const { return data_.f.flags == kArrayFlag; }
+    bool IsObject() const { return GetType() == kObjectType; }
+    bool IsArray()  const { return GetType() == kArrayType; }
     bool IsNumber() const { return (data_.f.flags & kNumberFlag) != 0; }
-    bool IsInt()    const { return (data_.f.flags & kIntFlag) != 0; }
-    bool IsUint()   const { return (data_.f.flags & kUintFlag) != 0; }
-    bool IsInt64()  const { return (data_.f.flags & kInt64Flag) != 0; }
-    bool IsUint64() const { return (data_.f.flags & kUint64Flag) != 0; }
-    bool IsDouble() const { return (data_.f.flags & kDoubleFlag) != 0; }
+    bool IsInt()    const { return (NumberData().f.flags & kIntFlag) != 0; }
+    bool IsUint()   const { return (NumberData().f.flags & kUintFlag) != 0; }
+    bool IsInt64()  const { return (NumberData().f.flags & kInt64Flag) != 0; }
+    bool IsUint64() const { return (NumberData().f.flags & kUint64Flag) != 0; }
+    bool IsDouble() const { return (NumberData().f.flags & kDoubleFlag) != 0; }
     bool IsString() const { return (data_.f.flags & kStringFlag) != 0; }
 
+    //! Whether the value is a number kept as its text, see kParseLazyNumbersFlag.
+    /*! The other number functions convert the text each time they are called.
+    */
+    bool IsRawNumber() const { return (data_.f.flags & kRawNumberFlag) != 0; }
+
+    //! Whether the object or array is still kept as its text, see \ref kParseLazyContainersFlag.
+    bool IsLazy() const { return (data_.f.flags & kLazyFlag) != 0; }
+
     // Checks whether a number can be losslessly converted to a double.
     bool IsLosslessDouble() const {
         if (!IsNumber()) return false;
@@ -1145,7 +1317,7 @@ public:
 
     // Checks whether a number is a float (possible lossy).
     bool IsFloat() const  {
-        if ((data_.f.flags & kDoubleFlag) == 0)
+        if (!IsDouble())
             return false;
         double d = GetDouble();
         return d >= -3.4028234e38 && d <= 3.4028234e38;
@@ -1188,13 +1360,13 @@ public:
     GenericValue& SetObject() { this->~GenericValue(); new (this) GenericValue(kObjectType); return *this; }
 
     //! Get the number of members in the object.
-    SizeType MemberCount() const { RAPIDJSON_ASSERT(IsObject()); return data_.o.size; }
+    SizeType MemberCount() const { RAPIDJSON_ASSERT(IsObject()); Materialize(); return data_.o.size; }
 
     //! Get the capacity of object.
-    SizeType MemberCapacity() const { RAPIDJSON_ASSERT(IsObject()); return data_.o.capacity; }
+    SizeType MemberCapacity() const { RAPIDJSON_ASSERT(IsObject()); Materialize(); return data_.o.capacity; }
 
     //! Check whether the object is empty.
-    bool ObjectEmpty() const { RAPIDJSON_ASSERT(IsObject()); return data_.o.size == 0; }
+    bool ObjectEmpty() const { RAPIDJSON_ASSERT(IsObject()); Materialize(); return data_.o.size == 0; }
 
     //! Get a value from an object associated with the name.
     /*! \pre IsObject() == true
@@ -1257,6 +1429,18 @@ public:
     template <typename SourceAllocator>
     const GenericValue& operator[](const GenericValue<Encoding, SourceAllocator>& name) const { return const_cast<GenericValue&>(*this)[name]; }
 
+    //! Get a value from an object associated with the name, with a precomputed hash.
+    /*! \pre IsObject() == true
+        \see FindMember(const HashedStringRefType&)
+    */
+    GenericValue& operator[](const HashedStringRefType& name) {
+        MemberIterator member = FindMember(name);
+        if (member != MemberEnd())
+            return member->value;
+        return (*this)[GenericValue(static_cast<const StringRefType&>(name))]; // asserts, see above note
+    }
+    const GenericValue& operator[](const HashedStringRefType& name) const { return const_cast<GenericValue&>(*this)[name]; }
+
 #if RAPIDJSON_HAS_STDSTRING
     //! Get a value from an object associated with name (string object).
     GenericValue& operator[](const std::basic_string<Ch>& name) { return (*this)[GenericValue(StringRef(name))]; }
@@ -1265,16 +1449,16 @@ public:
 
     //! Const member iterator
     /*! \pre IsObject() == true */
-    ConstMemberIterator MemberBegin() const { RAPIDJSON_ASSERT(IsObject()); return ConstMemberIterator(GetMembersPointer()); }
+    ConstMemberIterator MemberBegin() const { RAPIDJSON_ASSERT(IsObject()); Materialize(); return ConstMemberIterator(GetMembersPointer()); }
     //! Const \em past-the-end member iterator
     /*! \pre IsObject() == true */
-    ConstMemberIterator MemberEnd() const   { RAPIDJSON_ASSERT(IsObject()); return ConstMemberIterator(GetMembersPointer() + data_.o.size); }
+    ConstMemberIterator MemberEnd() const   { RAPIDJSON_ASSERT(IsObject()); Materialize(); return ConstMemberIterator(GetMembersPointer() + data_.o.size); }
     //! Member iterator
     /*! \pre IsObject() == true */
-    MemberIterator MemberBegin()            { RAPIDJSON_ASSERT(IsObject()); return MemberIterator(GetMembersPointer()); }
+    MemberIterator MemberBegin()            { RAPIDJSON_ASSERT(IsObject()); Materialize(); return MemberIterator(GetMembersPointer()); }
     //! \em Past-the-end member iterator
     /*! \pre IsObject() == true */
-    MemberIterator MemberEnd()              { RAPIDJSON_ASSERT(IsObject()); return MemberIterator(GetMembersPointer() + data_.o.size); }
+    MemberIterator MemberEnd()              { RAPIDJSON_ASSERT(IsObject()); Materialize(); return MemberIterator(GetMembersPointer() + data_.o.size); }
 
     //! Request the object to have enough capacity to store members.
     /*! \param newCapacity  The capacity that the object at least need to have.
@@ -1284,6 +1468,7 @@ public:
     */
     GenericValue& MemberReserve(SizeType newCapacity, Allocator &allocator) {
         RAPIDJSON_ASSERT(IsObject());
+        Materialize();
         DoReserveMembers(newCapacity, allocator);
         return *this;
     }
@@ -1322,6 +1507,15 @@ public:
     template <typename SourceAllocator>
     bool HasMember(const GenericValue<Encoding, SourceAllocator>& name) const { return FindMember(name) != MemberEnd(); }
 
+    //! Check whether a member exists in the object, with a precomputed hash.
+    /*!
+        \param name Member name to be searched.
+        \pre IsObject() == true
+        \return Whether a member with that name exists.
+        \see FindMember(const HashedStringRefType&)
+    */
+    bool HasMember(const HashedStringRefType& name) const { return FindMember(name) != MemberEnd(); }
+
     //! Find member by name.
     /*!
         \param name Member name to be searched.
@@ -1358,10 +1552,30 @@ public:
     MemberIterator FindMember(const GenericValue<Encoding, SourceAllocator>& name) {
         RAPIDJSON_ASSERT(IsObject());
         RAPIDJSON_ASSERT(name.IsString());
+        Materialize();
         return DoFindMember(name);
     }
     template <typename SourceAllocator> ConstMemberIterator FindMember(const GenericValue<Encoding, SourceAllocator>& name) const { return const_cast<GenericValue&>(*this).FindMember(name); }
 
+    //! Find member by name, with a precomputed hash.
+    /*!
+        This version does not need to hash or StrLen() the name, which is
+        done once when constructing \c name.
+        \param name Member name to be searched.
+        \pre IsObject() == true
+        \return Iterator to member, if it exists.
+            Otherwise returns \ref MemberEnd().
+        \note Linear time complexity, constant with \ref RAPIDJSON_USE_MEMBERSMAP
+            for objects with a capacity of at least \ref RAPIDJSON_MEMBERSMAP_THRESHOLD.
+    */
+    MemberIterator FindMember(const HashedStringRefType& name) {
+        RAPIDJSON_ASSERT(IsObject());
+        Materialize();
+        GenericValue n(static_cast<const StringRefType&>(name));
+        return DoFindMember(n, name.hash);
+    }
+    ConstMemberIterator FindMember(const HashedStringRefType& name) const { return const_cast<GenericValue&>(*this).FindMember(name); }
+
 #if RAPIDJSON_HAS_STDSTRING
     //! Find member by string object name.
     /*!
@@ -1387,6 +1601,7 @@ public:
     GenericValue& AddMember(GenericValue& name, GenericValue& value, Allocator& allocator) {
         RAPIDJSON_ASSERT(IsObject());
         RAPIDJSON_ASSERT(name.IsString());
+        Materialize();
         DoAddMember(name, value, allocator);
         return *this;
     }
@@ -1521,6 +1736,7 @@ public:
     */
     void RemoveAllMembers() {
         RAPIDJSON_ASSERT(IsObject()); 
+        Materialize();
         DoClearMembers();
     }
 
@@ -1640,13 +1856,13 @@ public:
     GenericValue& SetArray() { this->~GenericValue(); new (this) GenericValue(kArrayType); return *this; }
 
     //! Get the number of elements in array.
-    SizeType Size() const { RAPIDJSON_ASSERT(IsArray()); return data_.a.size; }
+    SizeType Size() const { RAPIDJSON_ASSERT(IsArray()); Materialize(); return data_.a.size; }
 
     //! Get the capacity of array.
-    SizeType Capacity() const { RAPIDJSON_ASSERT(IsArray()); return data_.a.capacity; }
+    SizeType Capacity() const { RAPIDJSON_ASSERT(IsArray()); Materialize(); return data_.a.capacity; }
 
     //! Check whether the array is empty.
-    bool Empty() const { RAPIDJSON_ASSERT(IsArray()); return data_.a.size == 0; }
+    bool Empty() const { RAPIDJSON_ASSERT(IsArray()); Materialize(); return data_.a.size == 0; }
 
     //! Remove all elements in the array.
     /*! This function do not deallocate memory in the array, i.e. the capacity is unchanged.
@@ -1654,6 +1870,7 @@ public:
     */
     void Clear() {
         RAPIDJSON_ASSERT(IsArray()); 
+        Materialize();
         GenericValue* e = GetElementsPointer();
         for (GenericValue* v = e; v != e + data_.a.size; ++v)
             v->~GenericValue();
@@ -1667,6 +1884,7 @@ public:
     */
     GenericValue& operator[](SizeType index) {
         RAPIDJSON_ASSERT(IsArray());
+        Materialize();
         RAPIDJSON_ASSERT(index < data_.a.size);
         return GetElementsPointer()[index];
     }
@@ -1674,10 +1892,10 @@ public:
 
     //! Element iterator
     /*! \pre IsArray() == true */
-    ValueIterator Begin() { RAPIDJSON_ASSERT(IsArray()); return GetElementsPointer(); }
+    ValueIterator Begin() { RAPIDJSON_ASSERT(IsArray()); Materialize(); return GetElementsPointer(); }
     //! \em Past-the-end element iterator
     /*! \pre IsArray() == true */
-    ValueIterator End() { RAPIDJSON_ASSERT(IsArray()); return GetElementsPointer() + data_.a.size; }
+    ValueIterator End() { RAPIDJSON_ASSERT(IsArray()); Materialize(); return GetElementsPointer() + data_.a.size; }
     //! Constant element iterator
     /*! \pre IsArray() == true */
     ConstValueIterator Begin() const { return const_cast<GenericValue&>(*this).Begin(); }
@@ -1693,6 +1911,7 @@ public:
     */
     GenericValue& Reserve(SizeType newCapacity, Allocator &allocator) {
         RAPIDJSON_ASSERT(IsArray());
+        Materialize();
         if (newCapacity > data_.a.capacity) {
             SetElementsPointer(reinterpret_cast<GenericValue*>(allocator.Realloc(GetElementsPointer(), data_.a.capacity * sizeof(GenericValue), newCapacity * sizeof(GenericValue))));
             data_.a.capacity = newCapacity;
@@ -1712,6 +1931,7 @@ public:
     */
     GenericValue& PushBack(GenericValue& value, Allocator& allocator) {
         RAPIDJSON_ASSERT(IsArray());
+        Materialize();
         if (data_.a.size >= data_.a.capacity)
             Reserve(data_.a.capacity == 0 ? kDefaultArrayCapacity : (data_.a.capacity + (data_.a.capacity + 1) / 2), allocator);
         GetElementsPointer()[data_.a.size++].RawAssign(value);
@@ -1767,6 +1987,7 @@ public:
     */
     GenericValue& PopBack() {
         RAPIDJSON_ASSERT(IsArray());
+        Materialize();
         RAPIDJSON_ASSERT(!Empty());
         GetElementsPointer()[--data_.a.size].~GenericValue();
         return *this;
@@ -1814,21 +2035,22 @@ public:
     //!@name Number
     //@{
 
-    int GetInt() const          { RAPIDJSON_ASSERT(data_.f.flags & kIntFlag);   return data_.n.i.i;   }
-    unsigned GetUint() const    { RAPIDJSON_ASSERT(data_.f.flags & kUintFlag);  return data_.n.u.u;   }
-    int64_t GetInt64() const    { RAPIDJSON_ASSERT(data_.f.flags & kInt64Flag); return data_.n.i64; }
-    uint64_t GetUint64() const  { RAPIDJSON_ASSERT(data_.f.flags & kUint64Flag); return data_.n.u64; }
+    int GetInt() const          { const Data d = NumberData(); RAPIDJSON_ASSERT(d.f.flags & kIntFlag);   return d.n.i.i;   }
+    unsigned GetUint() const    { const Data d = NumberData(); RAPIDJSON_ASSERT(d.f.flags & kUintFlag);  return d.n.u.u;   }
+    int64_t GetInt64() const    { const Data d = NumberData(); RAPIDJSON_ASSERT(d.f.flags & kInt64Flag); return d.n.i64; }
+    uint64_t GetUint64() const  { const Data d = NumberData(); RAPIDJSON_ASSERT(d.f.flags & kUint64Flag); return d.n.u64; }
 
     //! Get the value as double type.
     /*! \note If the value is 64-bit integer type, it may lose precision. Use \c IsLosslessDouble() to check whether the converison is lossless.
     */
     double GetDouble() const {
         RAPIDJSON_ASSERT(IsNumber());
-        if ((data_.f.flags & kDoubleFlag) != 0)                return data_.n.d;   // exact type, no conversion.
-        if ((data_.f.flags & kIntFlag) != 0)                   return data_.n.i.i; // int -> double
-        if ((data_.f.flags & kUintFlag) != 0)                  return data_.n.u.u; // unsigned -> double
-        if ((data_.f.flags & kInt64Flag) != 0)                 return static_cast<double>(data_.n.i64); // int64_t -> double (may lose precision)
-        RAPIDJSON_ASSERT((data_.f.flags & kUint64Flag) != 0);  return static_cast<double>(data_.n.u64); // uint64_t -> double (may lose precision)
+        const Data d = NumberData();
+        if ((d.f.flags & kDoubleFlag) != 0)                return d.n.d;   // exact type, no conversion.
+        if ((d.f.flags & kIntFlag) != 0)                   return d.n.i.i; // int -> double
+        if ((d.f.flags & kUintFlag) != 0)                  return d.n.u.u; // unsigned -> double
+        if ((d.f.flags & kInt64Flag) != 0)                 return static_cast<double>(d.n.i64); // int64_t -> double (may lose precision)
+        RAPIDJSON_ASSERT((d.f.flags & kUint64Flag) != 0);  return static_cast<double>(d.n.u64); // uint64_t -> double (may lose precision)
     }
 
     //! Get the value as float type.
@@ -1845,6 +2067,12 @@ public:
     GenericValue& SetDouble(double d)       { this->~GenericValue(); new (this) GenericValue(d);    return *this; }
     GenericValue& SetFloat(float f)         { this->~GenericValue(); new (this) GenericValue(static_cast<double>(f)); return *this; }
 
+    //! Get the text of a raw number, which is not null-terminated after in situ parsing.
+    const Ch* GetRawNumber() const { RAPIDJSON_ASSERT(IsRawNumber()); return DataString(data_); }
+
+    //! Get the length of the text of a raw number.
+    SizeType GetRawNumberLength() const { RAPIDJSON_ASSERT(IsRawNumber()); return DataStringLength(data_); }
+
     //@}
 
     //!@name String
@@ -1976,7 +2204,8 @@ public:
     
         default:
             RAPIDJSON_ASSERT(GetType() == kNumberType);
-            if (IsDouble())         return handler.Double(data_.n.d);
+            if (IsRawNumber())      return handler.RawNumber(GetRawNumber(), GetRawNumberLength(), (data_.f.flags & kCopyFlag) != 0);
+            else if (IsDouble())    return handler.Double(data_.n.d);
             else if (IsInt())       return handler.Int(data_.n.i.i);
             else if (IsUint())      return handler.Uint(data_.n.u.u);
             else if (IsInt64())     return handler.Int64(data_.n.i64);
@@ -1999,6 +2228,8 @@ private:
         kStringFlag     = 0x0400,
         kCopyFlag       = 0x0800,
         kInlineStrFlag  = 0x1000,
+        kRawNumberFlag  = 0x2000,
+        kLazyFlag       = 0x4000,
 
         // Initial flags of different types.
         kNullFlag = kNullType,
@@ -2014,8 +2245,13 @@ private:
         kConstStringFlag = static_cast<int>(kStringType) | static_cast<int>(kStringFlag),
         kCopyStringFlag = static_cast<int>(kStringType) | static_cast<int>(kStringFlag | kCopyFlag),
         kShortStringFlag = static_cast<int>(kStringType) | static_cast<int>(kStringFlag | kCopyFlag | kInlineStrFlag),
+        kConstRawNumberFlag = static_cast<int>(kNumberType) | static_cast<int>(kNumberFlag | kRawNumberFlag),
+        kCopyRawNumberFlag = static_cast<int>(kNumberType) | static_cast<int>(kNumberFlag | kRawNumberFlag | kCopyFlag),
+        kShortRawNumberFlag = static_cast<int>(kNumberType) | static_cast<int>(kNumberFlag | kRawNumberFlag | kCopyFlag | kInlineStrFlag),
         kObjectFlag = kObjectType,
         kArrayFlag = kArrayType,
+        kLazyObjectFlag = static_cast<int>(kObjectType) | static_cast<int>(kLazyFlag),
+        kLazyArrayFlag = static_cast<int>(kArrayType) | static_cast<int>(kLazyFlag),
 
         kTypeMask = 0x07
     };
@@ -2120,147 +2356,165 @@ private:
 
 #if RAPIDJSON_USE_MEMBERSMAP
 
-    struct MapTraits {
-        struct Less {
-            bool operator()(const Data& s1, const Data& s2) const {
-                SizeType n1 = DataStringLength(s1), n2 = DataStringLength(s2);
-                int cmp = std::memcmp(DataString(s1), DataString(s2), sizeof(Ch) * (n1 < n2 ? n1 : n2));
-                return cmp < 0 || (cmp == 0 && n1 < n2);
-            }
-        };
-        typedef std::pair<const Data, SizeType> Pair;
-        typedef std::multimap<Data, SizeType, Less, StdAllocator<Pair, Allocator> > Map;
-        typedef typename Map::iterator Iterator;
-    };
-    typedef typename MapTraits::Map         Map;
-    typedef typename MapTraits::Less        MapLess;
-    typedef typename MapTraits::Pair        MapPair;
-    typedef typename MapTraits::Iterator    MapIterator;
-
     //
-    // Layout of the members' map/array, re(al)located according to the needed capacity:
+    // Layout of the members' array, re(al)located according to the needed capacity:
     //
-    //    {Map*}<>{capacity}<>{Member[capacity]}<>{MapIterator[capacity]}
+    //    {Member[capacity]}<>{uint32_t[capacity]}                      if capacity < RAPIDJSON_MEMBERSMAP_THRESHOLD
+    //    {Member[capacity]}<>{MapSlot[GetMapBucketCount(capacity)]}   otherwise
     //
     // (where <> stands for the RAPIDJSON_ALIGN-ment, if needed)
     //
+    // Small objects keep the hash of each member name and are searched linearly,
+    // comparing names only when their hashes match. Larger ones get an
+    // open-addressing hash index with linear probing instead. Both are rebuilt
+    // whenever the array is reallocated.
+    //
 
-    static RAPIDJSON_FORCEINLINE size_t GetMapLayoutSize(SizeType capacity) {
-        return RAPIDJSON_ALIGN(sizeof(Map*)) +
-               RAPIDJSON_ALIGN(sizeof(SizeType)) +
-               RAPIDJSON_ALIGN(capacity * sizeof(Member)) +
-               capacity * sizeof(MapIterator);
-    }
+    struct MapSlot {
+        uint32_t hash;
+        SizeType member;    //!< Index of the member plus one, 0 for an empty slot.
+    };
 
-    static RAPIDJSON_FORCEINLINE SizeType &GetMapCapacity(Map* &map) {
-        return *reinterpret_cast<SizeType*>(reinterpret_cast<uintptr_t>(&map) +
-                                            RAPIDJSON_ALIGN(sizeof(Map*)));
+    static RAPIDJSON_FORCEINLINE SizeType GetMapBucketCount(SizeType capacity) {
+        if (capacity < RAPIDJSON_MEMBERSMAP_THRESHOLD)
+            return 0;
+        // Power of two, at least twice the capacity, without overflowing SizeType
+        static const SizeType kMaxCount = ~(~SizeType(0) >> 1);
+        RAPIDJSON_ASSERT(capacity <= kMaxCount / 2);
+        SizeType count = 2;
+        while (count / 2 < capacity && count != kMaxCount)
+            count *= 2;
+        return count;
     }
 
-    static RAPIDJSON_FORCEINLINE Member* GetMapMembers(Map* &map) {
-        return reinterpret_cast<Member*>(reinterpret_cast<uintptr_t>(&map) +
-                                         RAPIDJSON_ALIGN(sizeof(Map*)) +
-                                         RAPIDJSON_ALIGN(sizeof(SizeType)));
+    static RAPIDJSON_FORCEINLINE size_t GetMapLayoutSize(SizeType capacity) {
+        return RAPIDJSON_ALIGN(capacity * sizeof(Member)) +
+               (capacity < RAPIDJSON_MEMBERSMAP_THRESHOLD ? capacity * sizeof(uint32_t) :
+                                                            GetMapBucketCount(capacity) * sizeof(MapSlot));
     }
 
-    static RAPIDJSON_FORCEINLINE MapIterator* GetMapIterators(Map* &map) {
-        return reinterpret_cast<MapIterator*>(reinterpret_cast<uintptr_t>(&map) +
-                                              RAPIDJSON_ALIGN(sizeof(Map*)) +
-                                              RAPIDJSON_ALIGN(sizeof(SizeType)) +
-                                              RAPIDJSON_ALIGN(GetMapCapacity(map) * sizeof(Member)));
+    static RAPIDJSON_FORCEINLINE uint32_t* GetMapHashes(Member* members, SizeType capacity) {
+        return reinterpret_cast<uint32_t*>(reinterpret_cast<uintptr_t>(members) +
+                                           RAPIDJSON_ALIGN(capacity * sizeof(Member)));
     }
 
-    static RAPIDJSON_FORCEINLINE Map* &GetMap(Member* members) {
-        RAPIDJSON_ASSERT(members != 0);
-        return *reinterpret_cast<Map**>(reinterpret_cast<uintptr_t>(members) -
-                                        RAPIDJSON_ALIGN(sizeof(SizeType)) -
-                                        RAPIDJSON_ALIGN(sizeof(Map*)));
+    static RAPIDJSON_FORCEINLINE MapSlot* GetMapSlots(Member* members, SizeType capacity) {
+        return reinterpret_cast<MapSlot*>(reinterpret_cast<uintptr_t>(members) +
+                                          RAPIDJSON_ALIGN(capacity * sizeof(Member)));
     }
 
-    // Some compilers' debug mechanisms want all iterators to be destroyed, for their accounting..
-    RAPIDJSON_FORCEINLINE MapIterator DropMapIterator(MapIterator& rhs) {
-#if RAPIDJSON_HAS_CXX11
-        MapIterator ret = std::move(rhs);
-#else
-        MapIterator ret = rhs;
-#endif
-        rhs.~MapIterator();
-        return ret;
+    static RAPIDJSON_FORCEINLINE uint32_t GetMapHash(const GenericValue& name) {
+        return internal::StrHash(name.GetString(), name.GetStringLength());
     }
 
-    Map* &DoReallocMap(Map** oldMap, SizeType newCapacity, Allocator& allocator) {
-        Map **newMap = static_cast<Map**>(allocator.Malloc(GetMapLayoutSize(newCapacity)));
-        GetMapCapacity(*newMap) = newCapacity;
-        if (!oldMap) {
-            *newMap = new (allocator.Malloc(sizeof(Map))) Map(MapLess(), allocator);
+    //! Index member \c i, whose name must not be indexed yet.
+    void DoMapInsert(SizeType i) {
+        Member* members = GetMembersPointer();
+        const uint32_t hash = GetMapHash(members[i].name);
+        const SizeType count = GetMapBucketCount(data_.o.capacity);
+        if (!count) {
+            GetMapHashes(members, data_.o.capacity)[i] = hash;
+            return;
         }
-        else {
-            *newMap = *oldMap;
-            size_t count = (*oldMap)->size();
-            std::memcpy(static_cast<void*>(GetMapMembers(*newMap)),
-                        static_cast<void*>(GetMapMembers(*oldMap)),
-                        count * sizeof(Member));
-            MapIterator *oldIt = GetMapIterators(*oldMap),
-                        *newIt = GetMapIterators(*newMap);
-            while (count--) {
-                new (&newIt[count]) MapIterator(DropMapIterator(oldIt[count]));
+        const SizeType mask = count - 1;
+        MapSlot* slots = GetMapSlots(members, data_.o.capacity);
+        SizeType s = hash & mask;
+        while (slots[s].member)
+            s = (s + 1) & mask;
+        slots[s].hash = hash;
+        slots[s].member = i + 1;
+    }
+
+    //! Slot of the indexed member \c i.
+    SizeType DoMapFind(SizeType i) const {
+        const SizeType mask = GetMapBucketCount(data_.o.capacity) - 1;
+        Member* members = GetMembersPointer();
+        MapSlot* slots = GetMapSlots(members, data_.o.capacity);
+        SizeType s = GetMapHash(members[i].name) & mask;
+        while (slots[s].member != i + 1) {
+            RAPIDJSON_ASSERT(slots[s].member != 0);
+            s = (s + 1) & mask;
+        }
+        return s;
+    }
+
+    //! Remove member \c i from the index, shifting back the slots of its probe sequence.
+    void DoMapErase(SizeType i) {
+        const SizeType mask = GetMapBucketCount(data_.o.capacity) - 1;
+        MapSlot* slots = GetMapSlots(GetMembersPointer(), data_.o.capacity);
+        SizeType hole = DoMapFind(i);
+        for (SizeType s = (hole + 1) & mask; slots[s].member; s = (s + 1) & mask) {
+            // Move the slot to the hole unless its home bucket lies cyclically in (hole, s]
+            const SizeType home = slots[s].hash & mask;
+            if (((s - home) & mask) >= ((s - hole) & mask)) {
+                slots[hole] = slots[s];
+                hole = s;
             }
-            Allocator::Free(oldMap);
         }
-        return *newMap;
+        slots[hole].member = 0;
+    }
+
+    //! (Re)build the hashes or the index of all members.
+    void DoMapBuild() {
+        if (SizeType count = GetMapBucketCount(data_.o.capacity))
+            std::memset(static_cast<void*>(GetMapSlots(GetMembersPointer(), data_.o.capacity)), 0, count * sizeof(MapSlot));
+        for (SizeType i = 0; i < data_.o.size; i++)
+            DoMapInsert(i);
     }
 
     RAPIDJSON_FORCEINLINE Member* DoAllocMembers(SizeType capacity, Allocator& allocator) {
-        return GetMapMembers(DoReallocMap(0, capacity, allocator));
+        return static_cast<Member*>(allocator.Malloc(GetMapLayoutSize(capacity)));
     }
 
     void DoReserveMembers(SizeType newCapacity, Allocator& allocator) {
         ObjectData& o = data_.o;
         if (newCapacity > o.capacity) {
             Member* oldMembers = GetMembersPointer();
-            Map **oldMap = oldMembers ? &GetMap(oldMembers) : 0,
-                *&newMap = DoReallocMap(oldMap, newCapacity, allocator);
-            RAPIDJSON_SETPOINTER(Member, o.members, GetMapMembers(newMap));
+            void* newMembers = allocator.Realloc(oldMembers, oldMembers ? GetMapLayoutSize(o.capacity) : 0, GetMapLayoutSize(newCapacity));
+            RAPIDJSON_SETPOINTER(Member, o.members, static_cast<Member*>(newMembers));
             o.capacity = newCapacity;
+            DoMapBuild();
         }
     }
 
     template <typename SourceAllocator>
     MemberIterator DoFindMember(const GenericValue<Encoding, SourceAllocator>& name) {
-        if (Member* members = GetMembersPointer()) {
-            Map* &map = GetMap(members);
-            MapIterator mit = map->find(reinterpret_cast<const Data&>(name.data_));
-            if (mit != map->end()) {
-                return MemberIterator(&members[mit->second]);
-            }
+        if (!GetMapBucketCount(data_.o.capacity)) { // Cheaper than hashing the name
+            MemberIterator member = MemberBegin();
+            for ( ; member != MemberEnd(); ++member)
+                if (name.StringEqual(member->name))
+                    break;
+            return member;
         }
-        return MemberEnd();
+        return DoFindMember(name, internal::StrHash(name.GetString(), name.GetStringLength()));
     }
 
-    void DoClearMembers() {
-        if (Member* members = GetMembersPointer()) {
-            Map* &map = GetMap(members);
-            MapIterator* mit = GetMapIterators(map);
-            for (SizeType i = 0; i < data_.o.size; i++) {
-                map->erase(DropMapIterator(mit[i]));
-                members[i].~Member();
-            }
-            data_.o.size = 0;
+    template <typename SourceAllocator>
+    MemberIterator DoFindMember(const GenericValue<Encoding, SourceAllocator>& name, uint32_t hash) {
+        RAPIDJSON_ASSERT(hash == internal::StrHash(name.GetString(), name.GetStringLength()));
+        Member* members = GetMembersPointer();
+        const SizeType count = GetMapBucketCount(data_.o.capacity);
+        if (!count) {
+            const uint32_t* hashes = GetMapHashes(members, data_.o.capacity);
+            for (SizeType i = 0; i < data_.o.size; i++)
+                if (hashes[i] == hash && name.StringEqual(members[i].name))
+                    return MemberIterator(&members[i]);
+            return MemberEnd();
         }
+
+        const SizeType mask = count - 1;
+        const MapSlot* slots = GetMapSlots(members, data_.o.capacity);
+        for (SizeType s = hash & mask; slots[s].member; s = (s + 1) & mask)
+            if (slots[s].hash == hash && name.StringEqual(members[slots[s].member - 1].name))
+                return MemberIterator(&members[slots[s].member - 1]);
+        return MemberEnd();
     }
 
-    void DoFreeMembers() {
-        if (Member* members = GetMembersPointer()) {
-            GetMap(members)->~Map();
-            for (SizeType i = 0; i < data_.o.size; i++) {
-                members[i].~Member();
-            }
-            if (Allocator::kNeedFree) { // Shortcut by Allocator's trait
-                Map** map = &GetMap(members);
-                Allocator::Free(*map);
-                Allocator::Free(map);
-            }
-        }
+    void DoClearMembers() {
+        for (MemberIterator m = MemberBegin(); m != MemberEnd(); ++m)
+            m->~Member();
+        data_.o.size = 0;
+        DoMapBuild();
     }
 
 #else // !RAPIDJSON_USE_MEMBERSMAP
@@ -2287,20 +2541,25 @@ private:
         return member;
     }
 
+    template <typename SourceAllocator>
+    MemberIterator DoFindMember(const GenericValue<Encoding, SourceAllocator>& name, uint32_t) {
+        return DoFindMember(name); // No member hashes to compare with
+    }
+
     void DoClearMembers() {
         for (MemberIterator m = MemberBegin(); m != MemberEnd(); ++m)
             m->~Member();
         data_.o.size = 0;
     }
 
+#endif // !RAPIDJSON_USE_MEMBERSMAP
+
     void DoFreeMembers() {
         for (MemberIterator m = MemberBegin(); m != MemberEnd(); ++m)
             m->~Member();
         Allocator::Free(GetMembersPointer());
     }
 
-#endif // !RAPIDJSON_USE_MEMBERSMAP
-
     void DoAddMember(GenericValue& name, GenericValue& value, Allocator& allocator) {
         ObjectData& o = data_.o;
         if (o.size >= o.capacity)
@@ -2310,9 +2569,7 @@ private:
         m->name.RawAssign(name);
         m->value.RawAssign(value);
 #if RAPIDJSON_USE_MEMBERSMAP
-        Map* &map = GetMap(members);
-        MapIterator* mit = GetMapIterators(map);
-        new (&mit[o.size]) MapIterator(map->insert(MapPair(m->name.data_, o.size)));
+        DoMapInsert(o.size);
 #endif
         ++o.size;
     }
@@ -2320,18 +2577,20 @@ private:
     MemberIterator DoRemoveMember(MemberIterator m) {
         ObjectData& o = data_.o;
         Member* members = GetMembersPointer();
+        MemberIterator last(members + (o.size - 1));
 #if RAPIDJSON_USE_MEMBERSMAP
-        Map* &map = GetMap(members);
-        MapIterator* mit = GetMapIterators(map);
         SizeType mpos = static_cast<SizeType>(&*m - members);
-        map->erase(DropMapIterator(mit[mpos]));
+        if (!GetMapBucketCount(o.capacity)) {
+            uint32_t* hashes = GetMapHashes(members, o.capacity);
+            hashes[mpos] = hashes[o.size - 1];
+        }
+        else {
+            DoMapErase(mpos);
+            if (m != last)
+                GetMapSlots(members, o.capacity)[DoMapFind(o.size - 1)].member = mpos + 1;
+        }
 #endif
-        MemberIterator last(members + (o.size - 1));
         if (o.size > 1 && m != last) {
-#if RAPIDJSON_USE_MEMBERSMAP
-            new (&mit[mpos]) MapIterator(DropMapIterator(mit[&*last - members]));
-            mit[mpos]->second = mpos;
-#endif
             *m = *last; // Move the last one to this place
         }
         else {
@@ -2346,32 +2605,15 @@ private:
         MemberIterator beg = MemberBegin(),
                        pos = beg + (first - beg),
                        end = MemberEnd();
-#if RAPIDJSON_USE_MEMBERSMAP
-        Map* &map = GetMap(GetMembersPointer());
-        MapIterator* mit = GetMapIterators(map);
-#endif
-        for (MemberIterator itr = pos; itr != last; ++itr) {
-#if RAPIDJSON_USE_MEMBERSMAP
-            map->erase(DropMapIterator(mit[itr - beg]));
-#endif
+        for (MemberIterator itr = pos; itr != last; ++itr)
             itr->~Member();
-        }
-#if RAPIDJSON_USE_MEMBERSMAP
-        if (first != last) {
-            // Move remaining members/iterators
-            MemberIterator next = pos + (last - first);
-            for (MemberIterator itr = pos; next != end; ++itr, ++next) {
-                std::memcpy(static_cast<void*>(&*itr), &*next, sizeof(Member));
-                SizeType mpos = static_cast<SizeType>(itr - beg);
-                new (&mit[mpos]) MapIterator(DropMapIterator(mit[next - beg]));
-                mit[mpos]->second = mpos;
-            }
-        }
-#else
         std::memmove(static_cast<void*>(&*pos), &*last,
                      static_cast<size_t>(end - last) * sizeof(Member));
-#endif
         o.size -= static_cast<SizeType>(last - first);
+#if RAPIDJSON_USE_MEMBERSMAP
+        if (first != last)
+            DoMapBuild();
+#endif
         return pos;
     }
 
@@ -2383,19 +2625,15 @@ private:
         SizeType count = rhs.data_.o.size;
         Member* lm = DoAllocMembers(count, allocator);
         const typename GenericValue<Encoding,SourceAllocator>::Member* rm = rhs.GetMembersPointer();
-#if RAPIDJSON_USE_MEMBERSMAP
-        Map* &map = GetMap(lm);
-        MapIterator* mit = GetMapIterators(map);
-#endif
         for (SizeType i = 0; i < count; i++) {
             new (&lm[i].name) GenericValue(rm[i].name, allocator, copyConstStrings);
             new (&lm[i].value) GenericValue(rm[i].value, allocator, copyConstStrings);
-#if RAPIDJSON_USE_MEMBERSMAP
-            new (&mit[i]) MapIterator(map->insert(MapPair(lm[i].name.data_, i)));
-#endif
         }
         data_.o.size = data_.o.capacity = count;
         SetMembersPointer(lm);
+#if RAPIDJSON_USE_MEMBERSMAP
+        DoMapBuild();
+#endif
     }
 
     // Initialize this value as array with initial data, without calling destructor.
@@ -2418,17 +2656,14 @@ private:
             Member* m = DoAllocMembers(count, allocator);
             SetMembersPointer(m);
             std::memcpy(static_cast<void*>(m), members, count * sizeof(Member));
-#if RAPIDJSON_USE_MEMBERSMAP
-            Map* &map = GetMap(m);
-            MapIterator* mit = GetMapIterators(map);
-            for (SizeType i = 0; i < count; i++) {
-                new (&mit[i]) MapIterator(map->insert(MapPair(m[i].name.data_, i)));
-            }
-#endif
         }
         else
             SetMembersPointer(0);
         data_.o.size = data_.o.capacity = count;
+#if RAPIDJSON_USE_MEMBERSMAP
+        if (count)
+            DoMapBuild();
+#endif
     }
 
     //! Initialize this value as constant string, without calling destructor.
@@ -2456,6 +2691,81 @@ private:
         str[s.length] = '\0';
     }
 
+    //! Initialize this value as raw number, copied if an allocator is given, without calling destructor.
+    void SetRawNumberRaw(StringRefType s, Allocator* allocator) {
+        if (allocator) {
+            SetStringRaw(s, *allocator);
+            data_.f.flags = static_cast<uint16_t>(kConstRawNumberFlag | (data_.f.flags & (kCopyFlag | kInlineStrFlag)));
+        }
+        else {
+            SetStringRaw(s);
+            data_.f.flags = kConstRawNumberFlag;
+        }
+    }
+
+    //! Data of a number, converted from the text of a raw number.
+    RAPIDJSON_FORCEINLINE Data NumberData() const {
+        return RAPIDJSON_LIKELY((data_.f.flags & kRawNumberFlag) == 0) ? data_ : DecodeRawNumber();
+    }
+
+    //! Convert the text of a raw number, in full precision, on a stack buffer for long numbers.
+    Data DecodeRawNumber() const {
+        GenericValue number;
+        internal::RawNumberHandler<GenericValue> handler(number);
+        internal::RawNumberStream<Encoding> is(DataString(data_), DataStringLength(data_));
+        char buffer[256];
+        MemoryPoolAllocator<> stackAllocator(buffer, sizeof(buffer));
+        GenericReader<Encoding, Encoding, MemoryPoolAllocator<> > reader(&stackAllocator, 64);
+        reader.template Parse<kParseFullPrecisionFlag | kParseNanAndInfFlag>(is, handler);
+        RAPIDJSON_ASSERT(number.IsNumber());
+        return number.data_;
+    }
+
+    //! Text of an object or array kept by GenericDocument, see kParseLazyContainersFlag.
+    struct LazyData {
+        const Ch* str;          //!< Text of the value, not null-terminated.
+        SizeType length;
+        Allocator* allocator;   //!< Allocator of the values parsed from the text.
+        bool (*parse)(GenericValue& value, const LazyData& lazy); //!< Parses the text into a null value.
+    };
+
+    LazyData* GetLazyPointer() const { return reinterpret_cast<LazyData*>(GetMembersPointer()); }
+
+    //! Initialize this value as a lazy object or array, copying its text if asked, without calling destructor.
+    void SetLazyRaw(const Ch* str, SizeType length, bool copy, Allocator& allocator, bool (*parse)(GenericValue&, const LazyData&)) {
+        RAPIDJSON_ASSERT(length >= 2 && (*str == '{' || *str == '['));
+        LazyData* lazy = static_cast<LazyData*>(allocator.Malloc(sizeof(LazyData) + (copy ? (length + 1) * sizeof(Ch) : 0)));
+        if (copy) {
+            Ch* text = reinterpret_cast<Ch*>(lazy + 1);
+            std::memcpy(text, str, length * sizeof(Ch));
+            text[length] = '\0';
+            str = text;
+        }
+        lazy->str = str;
+        lazy->length = length;
+        lazy->allocator = &allocator;
+        lazy->parse = parse;
+        data_.f.flags = static_cast<uint16_t>(*str == '{' ? kLazyObjectFlag : kLazyArrayFlag);
+        data_.o.size = data_.o.capacity = 0;
+        SetMembersPointer(reinterpret_cast<Member*>(lazy));
+    }
+
+    //! Parse the text of a lazy object or array, when it is first accessed.
+    RAPIDJSON_FORCEINLINE void Materialize() const {
+        if (RAPIDJSON_UNLIKELY(data_.f.flags & kLazyFlag))
+            const_cast<GenericValue*>(this)->DoMaterialize();
+    }
+
+    void DoMaterialize() {
+        LazyData* lazy = GetLazyPointer();
+        GenericValue value;
+        if (!lazy->parse(value, *lazy))
+            new (&value) GenericValue(GetType()); // Leave it empty, its syntax errors are only found now
+        if (Allocator::kNeedFree)
+            Allocator::Free(lazy);
+        RawAssign(value);
+    }
+
     //! Assignment without calling destructor
     void RawAssign(GenericValue& rhs) RAPIDJSON_NOEXCEPT {
         data_ = rhs.data_;
@@ -2512,7 +2822,7 @@ public:
         \param stackAllocator   Optional allocator for allocating memory for stack.
     */
     explicit GenericDocument(Type type, Allocator* allocator = 0, size_t stackCapacity = kDefaultStackCapacity, StackAllocator* stackAllocator = 0) :
-        GenericValue<Encoding, Allocator>(type),  allocator_(allocator), ownAllocator_(0), stack_(stackAllocator, stackCapacity), parseResult_()
+        GenericValue<Encoding, Allocator>(type),  allocator_(allocator), ownAllocator_(0), stack_(stackAllocator, stackCapacity), parseResult_(), lazyNumbers_(), lazyParse_()
     {
         if (!allocator_)
             ownAllocator_ = allocator_ = RAPIDJSON_NEW(Allocator)();
@@ -2525,7 +2835,7 @@ public:
         \param stackAllocator   Optional allocator for allocating memory for stack.
     */
     GenericDocument(Allocator* allocator = 0, size_t stackCapacity = kDefaultStackCapacity, StackAllocator* stackAllocator = 0) : 
-        allocator_(allocator), ownAllocator_(0), stack_(stackAllocator, stackCapacity), parseResult_()
+        allocator_(allocator), ownAllocator_(0), stack_(stackAllocator, stackCapacity), parseResult_(), lazyNumbers_(), lazyParse_()
     {
         if (!allocator_)
             ownAllocator_ = allocator_ = RAPIDJSON_NEW(Allocator)();
@@ -2538,7 +2848,9 @@ public:
           allocator_(rhs.allocator_),
           ownAllocator_(rhs.ownAllocator_),
           stack_(std::move(rhs.stack_)),
-          parseResult_(rhs.parseResult_)
+          parseResult_(rhs.parseResult_),
+          lazyNumbers_(rhs.lazyNumbers_),
+          lazyParse_(rhs.lazyParse_)
     {
         rhs.allocator_ = 0;
         rhs.ownAllocator_ = 0;
@@ -2572,6 +2884,8 @@ public:
         ownAllocator_ = rhs.ownAllocator_;
         stack_ = std::move(rhs.stack_);
         parseResult_ = rhs.parseResult_;
+        lazyNumbers_ = rhs.lazyNumbers_;
+        lazyParse_ = rhs.lazyParse_;
 
         rhs.allocator_ = 0;
         rhs.ownAllocator_ = 0;
@@ -2593,6 +2907,8 @@ public:
         internal::Swap(allocator_, rhs.allocator_);
         internal::Swap(ownAllocator_, rhs.ownAllocator_);
         internal::Swap(parseResult_, rhs.parseResult_);
+        internal::Swap(lazyNumbers_, rhs.lazyNumbers_);
+        internal::Swap(lazyParse_, rhs.lazyParse_);
         return *this;
     }
 
@@ -2644,7 +2960,9 @@ public:
         GenericReader<SourceEncoding, Encoding, StackAllocator> reader(
             stack_.HasAllocator() ? &stack_.GetAllocator() : 0);
         ClearStackOnExit scope(*this);
-        parseResult_ = reader.template Parse<parseFlags>(is, *this);
+        lazyNumbers_ = (parseFlags & kParseLazyNumbersFlag) != 0;
+        lazyParse_ = GetLazyParse<parseFlags>(internal::BoolType<(parseFlags & kParseLazyContainersFlag) != 0>());
+        parseResult_ = reader.template Parse<(parseFlags & kParseLazyNumbersFlag) ? (parseFlags | kParseNumbersAsStringsFlag) : parseFlags>(is, *this);
         if (parseResult_) {
             RAPIDJSON_ASSERT(stack_.GetSize() == sizeof(ValueType)); // Got one and only one root object
             ValueType::operator=(*stack_.template Pop<ValueType>(1));// Move value from stack to document
@@ -2827,7 +3145,9 @@ public:
     bool Double(double d) { new (stack_.template Push<ValueType>()) ValueType(d); return true; }
 
     bool RawNumber(const Ch* str, SizeType length, bool copy) { 
-        if (copy) 
+        if (lazyNumbers_)
+            (new (stack_.template Push<ValueType>()) ValueType())->SetRawNumberRaw(StringRef(str, length), copy ? &GetAllocator() : 0);
+        else if (copy) 
             new (stack_.template Push<ValueType>()) ValueType(str, length, GetAllocator());
         else
             new (stack_.template Push<ValueType>()) ValueType(str, length);
@@ -2842,6 +3162,12 @@ public:
         return true;
     }
 
+    bool RawContainer(const Ch* str, SizeType length, bool copy) {
+        RAPIDJSON_ASSERT(lazyParse_ != 0); // Only with kParseLazyContainersFlag in ParseStream()
+        (new (stack_.template Push<ValueType>()) ValueType())->SetLazyRaw(str, length, copy, GetAllocator(), lazyParse_);
+        return true;
+    }
+
     bool StartObject() { new (stack_.template Push<ValueType>()) ValueType(kObjectType); return true; }
     
     bool Key(const Ch* str, SizeType length, bool copy) { return String(str, length, copy); }
@@ -2879,11 +3205,36 @@ private:
         RAPIDJSON_DELETE(ownAllocator_);
     }
 
+    typedef bool (*LazyParseFunction)(ValueType& value, const typename ValueType::LazyData& lazy);
+
+    template <unsigned parseFlags>
+    static LazyParseFunction GetLazyParse(internal::FalseType) { return 0; }
+
+    template <unsigned parseFlags>
+    static LazyParseFunction GetLazyParse(internal::TrueType) { return &ParseLazy<parseFlags>; }
+
+    //! Parse the text of a lazy object or array into a null value, with the flags of the document.
+    template <unsigned parseFlags>
+    static bool ParseLazy(ValueType& value, const typename ValueType::LazyData& lazy) {
+        typedef typename internal::SelectIfCond<(parseFlags & kParseInsituFlag) != 0,
+            GenericInsituStringStream<Encoding>, GenericStringStream<Encoding> >::Type Stream;
+        Stream s(const_cast<Ch*>(lazy.str));
+        GenericDocument d(lazy.allocator);
+        d.template ParseStream<parseFlags | kParseStopWhenDoneFlag, Encoding>(s);
+        if (d.HasParseError())
+            return false;
+        RAPIDJSON_ASSERT(s.Tell() == lazy.length);
+        value.RawAssign(d);
+        return true;
+    }
+
     static const size_t kDefaultStackCapacity = 1024;
     Allocator* allocator_;
     Allocator* ownAllocator_;
     internal::Stack<StackAllocator> stack_;
     ParseResult parseResult_;
+    bool lazyNumbers_;  //!< Whether RawNumber() makes raw numbers rather than strings, see kParseLazyNumbersFlag.
+    LazyParseFunction lazyParse_;   //!< Parses the objects and arrays made by RawContainer(), see kParseLazyContainersFlag.
 };
 
 //! GenericDocument with UTF8 encoding
@@ -78,6 +78,11 @@ public:
     Ch Take() { return is_.Take(); }
     size_t Tell() const { return is_.Tell(); }
 
+    // BufferedStream concept
+    const Ch* Window() const { return is_.src_; }
+    size_t WindowSize() const { return static_cast<size_t>(is_.end_ - is_.src_); }
+    void Consume(size_t n) { RAPIDJSON_ASSERT(n <= WindowSize()); is_.src_ += n; }
+
     // Not implemented
     void Put(Ch) {}
     void Flush() {} 
@@ -91,6 +96,11 @@ private:
     EncodedInputStream& operator=(const EncodedInputStream&);
 };
 
+template<>
+struct BufferedStreamTraits<EncodedInputStream<UTF8<>, MemoryStream> > {
+    enum { buffered = 1 };
+};
+
 //! Output byte stream wrapper with statically bound encoding.
 /*!
     \tparam Encoding The interpretation of encoding of the stream. Either UTF8, UTF16LE, UTF16BE, UTF32LE, UTF32BE.
@@ -62,6 +62,18 @@ public:
         return (current_ + 4 - !eof_ <= bufferLast_) ? current_ : 0;
     }
 
+    // BufferedStream concept, the null character ending the file is not part of the window.
+    const Ch* Window() const { return current_; }
+    size_t WindowSize() const { return static_cast<size_t>(bufferLast_ - current_) + !eof_; }
+    void Consume(size_t n) {
+        RAPIDJSON_ASSERT(n <= WindowSize());
+        current_ += n;
+        if (current_ > bufferLast_) {
+            current_ = bufferLast_;
+            Read();
+        }
+    }
+
 private:
     void Read() {
         if (current_ < bufferLast_)
@@ -90,6 +102,11 @@ private:
     bool eof_;
 };
 
+template<>
+struct BufferedStreamTraits<FileReadStream> {
+    enum { buffered = 1 };
+};
+
 RAPIDJSON_NAMESPACE_END
 
 #ifdef __clang__
@@ -27,7 +27,7 @@ RAPIDJSON_NAMESPACE_BEGIN
 
 //! Wrapper of C file stream for output using fwrite().
 /*!
-    \note implements Stream concept
+    \note implements Stream and BufferedOutputStream concepts
 */
 class FileWriteStream {
 public:
@@ -71,6 +71,18 @@ public:
         }
     }
 
+    // BufferedOutputStream concept
+    char* PutWindow(size_t& size) {
+        if (current_ >= bufferEnd_)
+            Flush();
+        size = static_cast<size_t>(bufferEnd_ - current_);
+        return current_;
+    }
+    void PutCommit(size_t n) {
+        RAPIDJSON_ASSERT(n <= static_cast<size_t>(bufferEnd_ - current_));
+        current_ += n;
+    }
+
     // Not implemented
     char Peek() const { RAPIDJSON_ASSERT(false); return 0; }
     char Take() { RAPIDJSON_ASSERT(false); return 0; }
@@ -95,6 +107,11 @@ inline void PutN(FileWriteStream& stream, char c, size_t n) {
     stream.PutN(c, n);
 }
 
+template<>
+struct BufferedOutputStreamTraits<FileWriteStream> {
+    enum { buffered = 1 };
+};
+
 RAPIDJSON_NAMESPACE_END
 
 #ifdef __clang__
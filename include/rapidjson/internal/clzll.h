@@ -21,8 +21,10 @@
 #include <intrin.h>
 #if defined(_WIN64)
 #pragma intrinsic(_BitScanReverse64)
+#pragma intrinsic(_BitScanForward64)
 #else
 #pragma intrinsic(_BitScanReverse)
+#pragma intrinsic(_BitScanForward)
 #endif
 #endif
 
@@ -65,6 +67,42 @@ inline uint32_t clzll(uint64_t x) {
 
 #define RAPIDJSON_CLZLL RAPIDJSON_NAMESPACE::internal::clzll
 
+inline uint32_t ctzll(uint64_t x) {
+    // Passing 0 to __builtin_ctzll is UB in GCC.
+    RAPIDJSON_ASSERT(x != 0);
+
+#if defined(_MSC_VER) && !defined(UNDER_CE)
+    unsigned long r = 0;
+#if defined(_WIN64)
+    _BitScanForward64(&r, x);
+#else
+    // Scan the low 32 bits.
+    if (_BitScanForward(&r, static_cast<uint32_t>(x & 0xFFFFFFFF)))
+        return r;
+
+    // Scan the high 32 bits.
+    _BitScanForward(&r, static_cast<uint32_t>(x >> 32));
+    r += 32;
+#endif // _WIN64
+
+    return r;
+#elif (defined(__GNUC__) && __GNUC__ >= 4) || RAPIDJSON_HAS_BUILTIN(__builtin_ctzll)
+    // __builtin_ctzll wrapper
+    return static_cast<uint32_t>(__builtin_ctzll(x));
+#else
+    // naive version
+    uint32_t r = 0;
+    while (!(x & 1u)) {
+        x >>= 1;
+        ++r;
+    }
+
+    return r;
+#endif // _MSC_VER
+}
+
+#define RAPIDJSON_CTZLL RAPIDJSON_NAMESPACE::internal::ctzll
+
 } // namespace internal
 RAPIDJSON_NAMESPACE_END
 
@@ -0,0 +1,775 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+// 
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed 
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR 
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the 
+// specific language governing permissions and limitations under the License.
+
+// This is a C++ header-only implementation of the Eisel-Lemire algorithm from the publication:
+// Lemire, Daniel. "Number parsing at a gigabyte per second." Software: Practice and
+// Experience 51.8 (2021): 1700-1727.
+// Its product approximation is sufficient for all 19-digit decimals, see:
+// Mushtak, Noble and Lemire, Daniel. "Fast number parsing without fallback."
+// Software: Practice and Experience 53.6 (2023): 1467-1471.
+
+#ifndef RAPIDJSON_EISELLEMIRE_
+#define RAPIDJSON_EISELLEMIRE_
+
+#include "ieee754.h"
+#include "clzll.h"
+#include <limits>
+
+#if defined(_MSC_VER) && defined(_M_AMD64) && !defined(__INTEL_COMPILER)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+namespace internal {
+
+//! Returns the 128 most significant bits of 5^q, rounded up for q < 0, as { high, low }.
+inline const uint64_t* EiselLemirePow5(int q) {
+    // Generated with exact integer arithmetic, for q in [-342, 308]
+    static const uint64_t kPow5[651][2] = {
+        { RAPIDJSON_UINT64_C2(0xEEF453D6, 0x923BD65A), RAPIDJSON_UINT64_C2(0x113FAA29, 0x06A13B3F) },
+        { RAPIDJSON_UINT64_C2(0x9558B466, 0x1B6565F8), RAPIDJSON_UINT64_C2(0x4AC7CA59, 0xA424C507) },
+        { RAPIDJSON_UINT64_C2(0xBAAEE17F, 0xA23EBF76), RAPIDJSON_UINT64_C2(0x5D79BCF0, 0x0D2DF649) },
+        { RAPIDJSON_UINT64_C2(0xE95A99DF, 0x8ACE6F53), RAPIDJSON_UINT64_C2(0xF4D82C2C, 0x107973DC) },
+        { RAPIDJSON_UINT64_C2(0x91D8A02B, 0xB6C10594), RAPIDJSON_UINT64_C2(0x79071B9B, 0x8A4BE869) },
+        { RAPIDJSON_UINT64_C2(0xB64EC836, 0xA47146F9), RAPIDJSON_UINT64_C2(0x9748E282, 0x6CDEE284) },
+        { RAPIDJSON_UINT64_C2(0xE3E27A44, 0x4D8D98B7), RAPIDJSON_UINT64_C2(0xFD1B1B23, 0x08169B25) },
+        { RAPIDJSON_UINT64_C2(0x8E6D8C6A, 0xB0787F72), RAPIDJSON_UINT64_C2(0xFE30F0F5, 0xE50E20F7) },
+        { RAPIDJSON_UINT64_C2(0xB208EF85, 0x5C969F4F), RAPIDJSON_UINT64_C2(0xBDBD2D33, 0x5E51A935) },
+        { RAPIDJSON_UINT64_C2(0xDE8B2B66, 0xB3BC4723), RAPIDJSON_UINT64_C2(0xAD2C7880, 0x35E61382) },
+        { RAPIDJSON_UINT64_C2(0x8B16FB20, 0x3055AC76), RAPIDJSON_UINT64_C2(0x4C3BCB50, 0x21AFCC31) },
+        { RAPIDJSON_UINT64_C2(0xADDCB9E8, 0x3C6B1793), RAPIDJSON_UINT64_C2(0xDF4ABE24, 0x2A1BBF3D) },
+        { RAPIDJSON_UINT64_C2(0xD953E862, 0x4B85DD78), RAPIDJSON_UINT64_C2(0xD71D6DAD, 0x34A2AF0D) },
+        { RAPIDJSON_UINT64_C2(0x87D4713D, 0x6F33AA6B), RAPIDJSON_UINT64_C2(0x8672648C, 0x40E5AD68) },
+        { RAPIDJSON_UINT64_C2(0xA9C98D8C, 0xCB009506), RAPIDJSON_UINT64_C2(0x680EFDAF, 0x511F18C2) },
+        { RAPIDJSON_UINT64_C2(0xD43BF0EF, 0xFDC0BA48), RAPIDJSON_UINT64_C2(0x0212BD1B, 0x2566DEF2) },
+        { RAPIDJSON_UINT64_C2(0x84A57695, 0xFE98746D), RAPIDJSON_UINT64_C2(0x014BB630, 0xF7604B57) },
+        { RAPIDJSON_UINT64_C2(0xA5CED43B, 0x7E3E9188), RAPIDJSON_UINT64_C2(0x419EA3BD, 0x35385E2D) },
+        { RAPIDJSON_UINT64_C2(0xCF42894A, 0x5DCE35EA), RAPIDJSON_UINT64_C2(0x52064CAC, 0x828675B9) },
+        { RAPIDJSON_UINT64_C2(0x818995CE, 0x7AA0E1B2), RAPIDJSON_UINT64_C2(0x7343EFEB, 0xD1940993) },
+        { RAPIDJSON_UINT64_C2(0xA1EBFB42, 0x19491A1F), RAPIDJSON_UINT64_C2(0x1014EBE6, 0xC5F90BF8) },
+        { RAPIDJSON_UINT64_C2(0xCA66FA12, 0x9F9B60A6), RAPIDJSON_UINT64_C2(0xD41A26E0, 0x77774EF6) },
+        { RAPIDJSON_UINT64_C2(0xFD00B897, 0x478238D0), RAPIDJSON_UINT64_C2(0x8920B098, 0x955522B4) },
+        { RAPIDJSON_UINT64_C2(0x9E20735E, 0x8CB16382), RAPIDJSON_UINT64_C2(0x55B46E5F, 0x5D5535B0) },
+        { RAPIDJSON_UINT64_C2(0xC5A89036, 0x2FDDBC62), RAPIDJSON_UINT64_C2(0xEB2189F7, 0x34AA831D) },
+        { RAPIDJSON_UINT64_C2(0xF712B443, 0xBBD52B7B), RAPIDJSON_UINT64_C2(0xA5E9EC75, 0x01D523E4) },
+        { RAPIDJSON_UINT64_C2(0x9A6BB0AA, 0x55653B2D), RAPIDJSON_UINT64_C2(0x47B233C9, 0x2125366E) },
+        { RAPIDJSON_UINT64_C2(0xC1069CD4, 0xEABE89F8), RAPIDJSON_UINT64_C2(0x999EC0BB, 0x696E840A) },
+        { RAPIDJSON_UINT64_C2(0xF148440A, 0x256E2C76), RAPIDJSON_UINT64_C2(0xC00670EA, 0x43CA250D) },
+        { RAPIDJSON_UINT64_C2(0x96CD2A86, 0x5764DBCA), RAPIDJSON_UINT64_C2(0x38040692, 0x6A5E5728) },
+        { RAPIDJSON_UINT64_C2(0xBC807527, 0xED3E12BC), RAPIDJSON_UINT64_C2(0xC6050837, 0x04F5ECF2) },
+        { RAPIDJSON_UINT64_C2(0xEBA09271, 0xE88D976B), RAPIDJSON_UINT64_C2(0xF7864A44, 0xC633682E) },
+        { RAPIDJSON_UINT64_C2(0x93445B87, 0x31587EA3), RAPIDJSON_UINT64_C2(0x7AB3EE6A, 0xFBE0211D) },
+        { RAPIDJSON_UINT64_C2(0xB8157268, 0xFDAE9E4C), RAPIDJSON_UINT64_C2(0x5960EA05, 0xBAD82964) },
+        { RAPIDJSON_UINT64_C2(0xE61ACF03, 0x3D1A45DF), RAPIDJSON_UINT64_C2(0x6FB92487, 0x298E33BD) },
+        { RAPIDJSON_UINT64_C2(0x8FD0C162, 0x06306BAB), RAPIDJSON_UINT64_C2(0xA5D3B6D4, 0x79F8E056) },
+        { RAPIDJSON_UINT64_C2(0xB3C4F1BA, 0x87BC8696), RAPIDJSON_UINT64_C2(0x8F48A489, 0x9877186C) },
+        { RAPIDJSON_UINT64_C2(0xE0B62E29, 0x29ABA83C), RAPIDJSON_UINT64_C2(0x331ACDAB, 0xFE94DE87) },
+        { RAPIDJSON_UINT64_C2(0x8C71DCD9, 0xBA0B4925), RAPIDJSON_UINT64_C2(0x9FF0C08B, 0x7F1D0B14) },
+        { RAPIDJSON_UINT64_C2(0xAF8E5410, 0x288E1B6F), RAPIDJSON_UINT64_C2(0x07ECF0AE, 0x5EE44DD9) },
+        { RAPIDJSON_UINT64_C2(0xDB71E914, 0x32B1A24A), RAPIDJSON_UINT64_C2(0xC9E82CD9, 0xF69D6150) },
+        { RAPIDJSON_UINT64_C2(0x892731AC, 0x9FAF056E), RAPIDJSON_UINT64_C2(0xBE311C08, 0x3A225CD2) },
+        { RAPIDJSON_UINT64_C2(0xAB70FE17, 0xC79AC6CA), RAPIDJSON_UINT64_C2(0x6DBD630A, 0x48AAF406) },
+        { RAPIDJSON_UINT64_C2(0xD64D3D9D, 0xB981787D), RAPIDJSON_UINT64_C2(0x092CBBCC, 0xDAD5B108) },
+        { RAPIDJSON_UINT64_C2(0x85F04682, 0x93F0EB4E), RAPIDJSON_UINT64_C2(0x25BBF560, 0x08C58EA5) },
+        { RAPIDJSON_UINT64_C2(0xA76C5823, 0x38ED2621), RAPIDJSON_UINT64_C2(0xAF2AF2B8, 0x0AF6F24E) },
+        { RAPIDJSON_UINT64_C2(0xD1476E2C, 0x07286FAA), RAPIDJSON_UINT64_C2(0x1AF5AF66, 0x0DB4AEE1) },
+        { RAPIDJSON_UINT64_C2(0x82CCA4DB, 0x847945CA), RAPIDJSON_UINT64_C2(0x50D98D9F, 0xC890ED4D) },
+        { RAPIDJSON_UINT64_C2(0xA37FCE12, 0x6597973C), RAPIDJSON_UINT64_C2(0xE50FF107, 0xBAB528A0) },
+        { RAPIDJSON_UINT64_C2(0xCC5FC196, 0xFEFD7D0C), RAPIDJSON_UINT64_C2(0x1E53ED49, 0xA96272C8) },
+        { RAPIDJSON_UINT64_C2(0xFF77B1FC, 0xBEBCDC4F), RAPIDJSON_UINT64_C2(0x25E8E89C, 0x13BB0F7A) },
+        { RAPIDJSON_UINT64_C2(0x9FAACF3D, 0xF73609B1), RAPIDJSON_UINT64_C2(0x77B19161, 0x8C54E9AC) },
+        { RAPIDJSON_UINT64_C2(0xC795830D, 0x75038C1D), RAPIDJSON_UINT64_C2(0xD59DF5B9, 0xEF6A2417) },
+        { RAPIDJSON_UINT64_C2(0xF97AE3D0, 0xD2446F25), RAPIDJSON_UINT64_C2(0x4B057328, 0x6B44AD1D) },
+        { RAPIDJSON_UINT64_C2(0x9BECCE62, 0x836AC577), RAPIDJSON_UINT64_C2(0x4EE367F9, 0x430AEC32) },
+        { RAPIDJSON_UINT64_C2(0xC2E801FB, 0x244576D5), RAPIDJSON_UINT64_C2(0x229C41F7, 0x93CDA73F) },
+        { RAPIDJSON_UINT64_C2(0xF3A20279, 0xED56D48A), RAPIDJSON_UINT64_C2(0x6B435275, 0x78C1110F) },
+        { RAPIDJSON_UINT64_C2(0x9845418C, 0x345644D6), RAPIDJSON_UINT64_C2(0x830A1389, 0x6B78AAA9) },
+        { RAPIDJSON_UINT64_C2(0xBE5691EF, 0x416BD60C), RAPIDJSON_UINT64_C2(0x23CC986B, 0xC656D553) },
+        { RAPIDJSON_UINT64_C2(0xEDEC366B, 0x11C6CB8F), RAPIDJSON_UINT64_C2(0x2CBFBE86, 0xB7EC8AA8) },
+        { RAPIDJSON_UINT64_C2(0x94B3A202, 0xEB1C3F39), RAPIDJSON_UINT64_C2(0x7BF7D714, 0x32F3D6A9) },
+        { RAPIDJSON_UINT64_C2(0xB9E08A83, 0xA5E34F07), RAPIDJSON_UINT64_C2(0xDAF5CCD9, 0x3FB0CC53) },
+        { RAPIDJSON_UINT64_C2(0xE858AD24, 0x8F5C22C9), RAPIDJSON_UINT64_C2(0xD1B3400F, 0x8F9CFF68) },
+        { RAPIDJSON_UINT64_C2(0x91376C36, 0xD99995BE), RAPIDJSON_UINT64_C2(0x23100809, 0xB9C21FA1) },
+        { RAPIDJSON_UINT64_C2(0xB5854744, 0x8FFFFB2D), RAPIDJSON_UINT64_C2(0xABD40A0C, 0x2832A78A) },
+        { RAPIDJSON_UINT64_C2(0xE2E69915, 0xB3FFF9F9), RAPIDJSON_UINT64_C2(0x16C90C8F, 0x323F516C) },
+        { RAPIDJSON_UINT64_C2(0x8DD01FAD, 0x907FFC3B), RAPIDJSON_UINT64_C2(0xAE3DA7D9, 0x7F6792E3) },
+        { RAPIDJSON_UINT64_C2(0xB1442798, 0xF49FFB4A), RAPIDJSON_UINT64_C2(0x99CD11CF, 0xDF41779C) },
+        { RAPIDJSON_UINT64_C2(0xDD95317F, 0x31C7FA1D), RAPIDJSON_UINT64_C2(0x40405643, 0xD711D583) },
+        { RAPIDJSON_UINT64_C2(0x8A7D3EEF, 0x7F1CFC52), RAPIDJSON_UINT64_C2(0x482835EA, 0x666B2572) },
+        { RAPIDJSON_UINT64_C2(0xAD1C8EAB, 0x5EE43B66), RAPIDJSON_UINT64_C2(0xDA324365, 0x0005EECF) },
+        { RAPIDJSON_UINT64_C2(0xD863B256, 0x369D4A40), RAPIDJSON_UINT64_C2(0x90BED43E, 0x40076A82) },
+        { RAPIDJSON_UINT64_C2(0x873E4F75, 0xE2224E68), RAPIDJSON_UINT64_C2(0x5A7744A6, 0xE804A291) },
+        { RAPIDJSON_UINT64_C2(0xA90DE353, 0x5AAAE202), RAPIDJSON_UINT64_C2(0x711515D0, 0xA205CB36) },
+        { RAPIDJSON_UINT64_C2(0xD3515C28, 0x31559A83), RAPIDJSON_UINT64_C2(0x0D5A5B44, 0xCA873E03) },
+        { RAPIDJSON_UINT64_C2(0x8412D999, 0x1ED58091), RAPIDJSON_UINT64_C2(0xE858790A, 0xFE9486C2) },
+        { RAPIDJSON_UINT64_C2(0xA5178FFF, 0x668AE0B6), RAPIDJSON_UINT64_C2(0x626E974D, 0xBE39A872) },
+        { RAPIDJSON_UINT64_C2(0xCE5D73FF, 0x402D98E3), RAPIDJSON_UINT64_C2(0xFB0A3D21, 0x2DC8128F) },
+        { RAPIDJSON_UINT64_C2(0x80FA687F, 0x881C7F8E), RAPIDJSON_UINT64_C2(0x7CE66634, 0xBC9D0B99) },
+        { RAPIDJSON_UINT64_C2(0xA139029F, 0x6A239F72), RAPIDJSON_UINT64_C2(0x1C1FFFC1, 0xEBC44E80) },
+        { RAPIDJSON_UINT64_C2(0xC9874347, 0x44AC874E), RAPIDJSON_UINT64_C2(0xA327FFB2, 0x66B56220) },
+        { RAPIDJSON_UINT64_C2(0xFBE91419, 0x15D7A922), RAPIDJSON_UINT64_C2(0x4BF1FF9F, 0x0062BAA8) },
+        { RAPIDJSON_UINT64_C2(0x9D71AC8F, 0xADA6C9B5), RAPIDJSON_UINT64_C2(0x6F773FC3, 0x603DB4A9) },
+        { RAPIDJSON_UINT64_C2(0xC4CE17B3, 0x99107C22), RAPIDJSON_UINT64_C2(0xCB550FB4, 0x384D21D3) },
+        { RAPIDJSON_UINT64_C2(0xF6019DA0, 0x7F549B2B), RAPIDJSON_UINT64_C2(0x7E2A53A1, 0x46606A48) },
+        { RAPIDJSON_UINT64_C2(0x99C10284, 0x4F94E0FB), RAPIDJSON_UINT64_C2(0x2EDA7444, 0xCBFC426D) },
+        { RAPIDJSON_UINT64_C2(0xC0314325, 0x637A1939), RAPIDJSON_UINT64_C2(0xFA911155, 0xFEFB5308) },
+        { RAPIDJSON_UINT64_C2(0xF03D93EE, 0xBC589F88), RAPIDJSON_UINT64_C2(0x793555AB, 0x7EBA27CA) },
+        { RAPIDJSON_UINT64_C2(0x96267C75, 0x35B763B5), RAPIDJSON_UINT64_C2(0x4BC1558B, 0x2F3458DE) },
+        { RAPIDJSON_UINT64_C2(0xBBB01B92, 0x83253CA2), RAPIDJSON_UINT64_C2(0x9EB1AAED, 0xFB016F16) },
+        { RAPIDJSON_UINT64_C2(0xEA9C2277, 0x23EE8BCB), RAPIDJSON_UINT64_C2(0x465E15A9, 0x79C1CADC) },
+        { RAPIDJSON_UINT64_C2(0x92A1958A, 0x7675175F), RAPIDJSON_UINT64_C2(0x0BFACD89, 0xEC191EC9) },
+        { RAPIDJSON_UINT64_C2(0xB749FAED, 0x14125D36), RAPIDJSON_UINT64_C2(0xCEF980EC, 0x671F667B) },
+        { RAPIDJSON_UINT64_C2(0xE51C79A8, 0x5916F484), RAPIDJSON_UINT64_C2(0x82B7E127, 0x80E7401A) },
+        { RAPIDJSON_UINT64_C2(0x8F31CC09, 0x37AE58D2), RAPIDJSON_UINT64_C2(0xD1B2ECB8, 0xB0908810) },
+        { RAPIDJSON_UINT64_C2(0xB2FE3F0B, 0x8599EF07), RAPIDJSON_UINT64_C2(0x861FA7E6, 0xDCB4AA15) },
+        { RAPIDJSON_UINT64_C2(0xDFBDCECE, 0x67006AC9), RAPIDJSON_UINT64_C2(0x67A791E0, 0x93E1D49A) },
+        { RAPIDJSON_UINT64_C2(0x8BD6A141, 0x006042BD), RAPIDJSON_UINT64_C2(0xE0C8BB2C, 0x5C6D24E0) },
+        { RAPIDJSON_UINT64_C2(0xAECC4991, 0x4078536D), RAPIDJSON_UINT64_C2(0x58FAE9F7, 0x73886E18) },
+        { RAPIDJSON_UINT64_C2(0xDA7F5BF5, 0x90966848), RAPIDJSON_UINT64_C2(0xAF39A475, 0x506A899E) },
+        { RAPIDJSON_UINT64_C2(0x888F9979, 0x7A5E012D), RAPIDJSON_UINT64_C2(0x6D8406C9, 0x52429603) },
+        { RAPIDJSON_UINT64_C2(0xAAB37FD7, 0xD8F58178), RAPIDJSON_UINT64_C2(0xC8E5087B, 0xA6D33B83) },
+        { RAPIDJSON_UINT64_C2(0xD5605FCD, 0xCF32E1D6), RAPIDJSON_UINT64_C2(0xFB1E4A9A, 0x90880A64) },
+        { RAPIDJSON_UINT64_C2(0x855C3BE0, 0xA17FCD26), RAPIDJSON_UINT64_C2(0x5CF2EEA0, 0x9A55067F) },
+        { RAPIDJSON_UINT64_C2(0xA6B34AD8, 0xC9DFC06F), RAPIDJSON_UINT64_C2(0xF42FAA48, 0xC0EA481E) },
+        { RAPIDJSON_UINT64_C2(0xD0601D8E, 0xFC57B08B), RAPIDJSON_UINT64_C2(0xF13B94DA, 0xF124DA26) },
+        { RAPIDJSON_UINT64_C2(0x823C1279, 0x5DB6CE57), RAPIDJSON_UINT64_C2(0x76C53D08, 0xD6B70858) },
+        { RAPIDJSON_UINT64_C2(0xA2CB1717, 0xB52481ED), RAPIDJSON_UINT64_C2(0x54768C4B, 0x0C64CA6E) },
+        { RAPIDJSON_UINT64_C2(0xCB7DDCDD, 0xA26DA268), RAPIDJSON_UINT64_C2(0xA9942F5D, 0xCF7DFD09) },
+        { RAPIDJSON_UINT64_C2(0xFE5D5415, 0x0B090B02), RAPIDJSON_UINT64_C2(0xD3F93B35, 0x435D7C4C) },
+        { RAPIDJSON_UINT64_C2(0x9EFA548D, 0x26E5A6E1), RAPIDJSON_UINT64_C2(0xC47BC501, 0x4A1A6DAF) },
+        { RAPIDJSON_UINT64_C2(0xC6B8E9B0, 0x709F109A), RAPIDJSON_UINT64_C2(0x359AB641, 0x9CA1091B) },
+        { RAPIDJSON_UINT64_C2(0xF867241C, 0x8CC6D4C0), RAPIDJSON_UINT64_C2(0xC30163D2, 0x03C94B62) },
+        { RAPIDJSON_UINT64_C2(0x9B407691, 0xD7FC44F8), RAPIDJSON_UINT64_C2(0x79E0DE63, 0x425DCF1D) },
+        { RAPIDJSON_UINT64_C2(0xC2109436, 0x4DFB5636), RAPIDJSON_UINT64_C2(0x985915FC, 0x12F542E4) },
+        { RAPIDJSON_UINT64_C2(0xF294B943, 0xE17A2BC4), RAPIDJSON_UINT64_C2(0x3E6F5B7B, 0x17B2939D) },
+        { RAPIDJSON_UINT64_C2(0x979CF3CA, 0x6CEC5B5A), RAPIDJSON_UINT64_C2(0xA705992C, 0xEECF9C42) },
+        { RAPIDJSON_UINT64_C2(0xBD8430BD, 0x08277231), RAPIDJSON_UINT64_C2(0x50C6FF78, 0x2A838353) },
+        { RAPIDJSON_UINT64_C2(0xECE53CEC, 0x4A314EBD), RAPIDJSON_UINT64_C2(0xA4F8BF56, 0x35246428) },
+        { RAPIDJSON_UINT64_C2(0x940F4613, 0xAE5ED136), RAPIDJSON_UINT64_C2(0x871B7795, 0xE136BE99) },
+        { RAPIDJSON_UINT64_C2(0xB9131798, 0x99F68584), RAPIDJSON_UINT64_C2(0x28E2557B, 0x59846E3F) },
+        { RAPIDJSON_UINT64_C2(0xE757DD7E, 0xC07426E5), RAPIDJSON_UINT64_C2(0x331AEADA, 0x2FE589CF) },
+        { RAPIDJSON_UINT64_C2(0x9096EA6F, 0x3848984F), RAPIDJSON_UINT64_C2(0x3FF0D2C8, 0x5DEF7621) },
+        { RAPIDJSON_UINT64_C2(0xB4BCA50B, 0x065ABE63), RAPIDJSON_UINT64_C2(0x0FED077A, 0x756B53A9) },
+        { RAPIDJSON_UINT64_C2(0xE1EBCE4D, 0xC7F16DFB), RAPIDJSON_UINT64_C2(0xD3E84959, 0x12C62894) },
+        { RAPIDJSON_UINT64_C2(0x8D3360F0, 0x9CF6E4BD), RAPIDJSON_UINT64_C2(0x64712DD7, 0xABBBD95C) },
+        { RAPIDJSON_UINT64_C2(0xB080392C, 0xC4349DEC), RAPIDJSON_UINT64_C2(0xBD8D794D, 0x96AACFB3) },
+        { RAPIDJSON_UINT64_C2(0xDCA04777, 0xF541C567), RAPIDJSON_UINT64_C2(0xECF0D7A0, 0xFC5583A0) },
+        { RAPIDJSON_UINT64_C2(0x89E42CAA, 0xF9491B60), RAPIDJSON_UINT64_C2(0xF41686C4, 0x9DB57244) },
+        { RAPIDJSON_UINT64_C2(0xAC5D37D5, 0xB79B6239), RAPIDJSON_UINT64_C2(0x311C2875, 0xC522CED5) },
+        { RAPIDJSON_UINT64_C2(0xD77485CB, 0x25823AC7), RAPIDJSON_UINT64_C2(0x7D633293, 0x366B828B) },
+        { RAPIDJSON_UINT64_C2(0x86A8D39E, 0xF77164BC), RAPIDJSON_UINT64_C2(0xAE5DFF9C, 0x02033197) },
+        { RAPIDJSON_UINT64_C2(0xA8530886, 0xB54DBDEB), RAPIDJSON_UINT64_C2(0xD9F57F83, 0x0283FDFC) },
+        { RAPIDJSON_UINT64_C2(0xD267CAA8, 0x62A12D66), RAPIDJSON_UINT64_C2(0xD072DF63, 0xC324FD7B) },
+        { RAPIDJSON_UINT64_C2(0x8380DEA9, 0x3DA4BC60), RAPIDJSON_UINT64_C2(0x4247CB9E, 0x59F71E6D) },
+        { RAPIDJSON_UINT64_C2(0xA4611653, 0x8D0DEB78), RAPIDJSON_UINT64_C2(0x52D9BE85, 0xF074E608) },
+        { RAPIDJSON_UINT64_C2(0xCD795BE8, 0x70516656), RAPIDJSON_UINT64_C2(0x67902E27, 0x6C921F8B) },
+        { RAPIDJSON_UINT64_C2(0x806BD971, 0x4632DFF6), RAPIDJSON_UINT64_C2(0x00BA1CD8, 0xA3DB53B6) },
+        { RAPIDJSON_UINT64_C2(0xA086CFCD, 0x97BF97F3), RAPIDJSON_UINT64_C2(0x80E8A40E, 0xCCD228A4) },
+        { RAPIDJSON_UINT64_C2(0xC8A883C0, 0xFDAF7DF0), RAPIDJSON_UINT64_C2(0x6122CD12, 0x8006B2CD) },
+        { RAPIDJSON_UINT64_C2(0xFAD2A4B1, 0x3D1B5D6C), RAPIDJSON_UINT64_C2(0x796B8057, 0x20085F81) },
+        { RAPIDJSON_UINT64_C2(0x9CC3A6EE, 0xC6311A63), RAPIDJSON_UINT64_C2(0xCBE33036, 0x74053BB0) },
+        { RAPIDJSON_UINT64_C2(0xC3F490AA, 0x77BD60FC), RAPIDJSON_UINT64_C2(0xBEDBFC44, 0x11068A9C) },
+        { RAPIDJSON_UINT64_C2(0xF4F1B4D5, 0x15ACB93B), RAPIDJSON_UINT64_C2(0xEE92FB55, 0x15482D44) },
+        { RAPIDJSON_UINT64_C2(0x99171105, 0x2D8BF3C5), RAPIDJSON_UINT64_C2(0x751BDD15, 0x2D4D1C4A) },
+        { RAPIDJSON_UINT64_C2(0xBF5CD546, 0x78EEF0B6), RAPIDJSON_UINT64_C2(0xD262D45A, 0x78A0635D) },
+        { RAPIDJSON_UINT64_C2(0xEF340A98, 0x172AACE4), RAPIDJSON_UINT64_C2(0x86FB8971, 0x16C87C34) },
+        { RAPIDJSON_UINT64_C2(0x9580869F, 0x0E7AAC0E), RAPIDJSON_UINT64_C2(0xD45D35E6, 0xAE3D4DA0) },
+        { RAPIDJSON_UINT64_C2(0xBAE0A846, 0xD2195712), RAPIDJSON_UINT64_C2(0x89748360, 0x59CCA109) },
+        { RAPIDJSON_UINT64_C2(0xE998D258, 0x869FACD7), RAPIDJSON_UINT64_C2(0x2BD1A438, 0x703FC94B) },
+        { RAPIDJSON_UINT64_C2(0x91FF8377, 0x5423CC06), RAPIDJSON_UINT64_C2(0x7B6306A3, 0x4627DDCF) },
+        { RAPIDJSON_UINT64_C2(0xB67F6455, 0x292CBF08), RAPIDJSON_UINT64_C2(0x1A3BC84C, 0x17B1D542) },
+        { RAPIDJSON_UINT64_C2(0xE41F3D6A, 0x7377EECA), RAPIDJSON_UINT64_C2(0x20CABA5F, 0x1D9E4A93) },
+        { RAPIDJSON_UINT64_C2(0x8E938662, 0x882AF53E), RAPIDJSON_UINT64_C2(0x547EB47B, 0x7282EE9C) },
+        { RAPIDJSON_UINT64_C2(0xB23867FB, 0x2A35B28D), RAPIDJSON_UINT64_C2(0xE99E619A, 0x4F23AA43) },
+        { RAPIDJSON_UINT64_C2(0xDEC681F9, 0xF4C31F31), RAPIDJSON_UINT64_C2(0x6405FA00, 0xE2EC94D4) },
+        { RAPIDJSON_UINT64_C2(0x8B3C113C, 0x38F9F37E), RAPIDJSON_UINT64_C2(0xDE83BC40, 0x8DD3DD04) },
+        { RAPIDJSON_UINT64_C2(0xAE0B158B, 0x4738705E), RAPIDJSON_UINT64_C2(0x9624AB50, 0xB148D445) },
+        { RAPIDJSON_UINT64_C2(0xD98DDAEE, 0x19068C76), RAPIDJSON_UINT64_C2(0x3BADD624, 0xDD9B0957) },
+        { RAPIDJSON_UINT64_C2(0x87F8A8D4, 0xCFA417C9), RAPIDJSON_UINT64_C2(0xE54CA5D7, 0x0A80E5D6) },
+        { RAPIDJSON_UINT64_C2(0xA9F6D30A, 0x038D1DBC), RAPIDJSON_UINT64_C2(0x5E9FCF4C, 0xCD211F4C) },
+        { RAPIDJSON_UINT64_C2(0xD47487CC, 0x8470652B), RAPIDJSON_UINT64_C2(0x7647C320, 0x0069671F) },
+        { RAPIDJSON_UINT64_C2(0x84C8D4DF, 0xD2C63F3B), RAPIDJSON_UINT64_C2(0x29ECD9F4, 0x0041E073) },
+        { RAPIDJSON_UINT64_C2(0xA5FB0A17, 0xC777CF09), RAPIDJSON_UINT64_C2(0xF4681071, 0x00525890) },
+        { RAPIDJSON_UINT64_C2(0xCF79CC9D, 0xB955C2CC), RAPIDJSON_UINT64_C2(0x7182148D, 0x4066EEB4) },
+        { RAPIDJSON_UINT64_C2(0x81AC1FE2, 0x93D599BF), RAPIDJSON_UINT64_C2(0xC6F14CD8, 0x48405530) },
+        { RAPIDJSON_UINT64_C2(0xA21727DB, 0x38CB002F), RAPIDJSON_UINT64_C2(0xB8ADA00E, 0x5A506A7C) },
+        { RAPIDJSON_UINT64_C2(0xCA9CF1D2, 0x06FDC03B), RAPIDJSON_UINT64_C2(0xA6D90811, 0xF0E4851C) },
+        { RAPIDJSON_UINT64_C2(0xFD442E46, 0x88BD304A), RAPIDJSON_UINT64_C2(0x908F4A16, 0x6D1DA663) },
+        { RAPIDJSON_UINT64_C2(0x9E4A9CEC, 0x15763E2E), RAPIDJSON_UINT64_C2(0x9A598E4E, 0x043287FE) },
+        { RAPIDJSON_UINT64_C2(0xC5DD4427, 0x1AD3CDBA), RAPIDJSON_UINT64_C2(0x40EFF1E1, 0x853F29FD) },
+        { RAPIDJSON_UINT64_C2(0xF7549530, 0xE188C128), RAPIDJSON_UINT64_C2(0xD12BEE59, 0xE68EF47C) },
+        { RAPIDJSON_UINT64_C2(0x9A94DD3E, 0x8CF578B9), RAPIDJSON_UINT64_C2(0x82BB74F8, 0x301958CE) },
+        { RAPIDJSON_UINT64_C2(0xC13A148E, 0x3032D6E7), RAPIDJSON_UINT64_C2(0xE36A5236, 0x3C1FAF01) },
+        { RAPIDJSON_UINT64_C2(0xF18899B1, 0xBC3F8CA1), RAPIDJSON_UINT64_C2(0xDC44E6C3, 0xCB279AC1) },
+        { RAPIDJSON_UINT64_C2(0x96F5600F, 0x15A7B7E5), RAPIDJSON_UINT64_C2(0x29AB103A, 0x5EF8C0B9) },
+        { RAPIDJSON_UINT64_C2(0xBCB2B812, 0xDB11A5DE), RAPIDJSON_UINT64_C2(0x7415D448, 0xF6B6F0E7) },
+        { RAPIDJSON_UINT64_C2(0xEBDF6617, 0x91D60F56), RAPIDJSON_UINT64_C2(0x111B495B, 0x3464AD21) },
+        { RAPIDJSON_UINT64_C2(0x936B9FCE, 0xBB25C995), RAPIDJSON_UINT64_C2(0xCAB10DD9, 0x00BEEC34) },
+        { RAPIDJSON_UINT64_C2(0xB84687C2, 0x69EF3BFB), RAPIDJSON_UINT64_C2(0x3D5D514F, 0x40EEA742) },
+        { RAPIDJSON_UINT64_C2(0xE65829B3, 0x046B0AFA), RAPIDJSON_UINT64_C2(0x0CB4A5A3, 0x112A5112) },
+        { RAPIDJSON_UINT64_C2(0x8FF71A0F, 0xE2C2E6DC), RAPIDJSON_UINT64_C2(0x47F0E785, 0xEABA72AB) },
+        { RAPIDJSON_UINT64_C2(0xB3F4E093, 0xDB73A093), RAPIDJSON_UINT64_C2(0x59ED2167, 0x65690F56) },
+        { RAPIDJSON_UINT64_C2(0xE0F218B8, 0xD25088B8), RAPIDJSON_UINT64_C2(0x306869C1, 0x3EC3532C) },
+        { RAPIDJSON_UINT64_C2(0x8C974F73, 0x83725573), RAPIDJSON_UINT64_C2(0x1E414218, 0xC73A13FB) },
+        { RAPIDJSON_UINT64_C2(0xAFBD2350, 0x644EEACF), RAPIDJSON_UINT64_C2(0xE5D1929E, 0xF90898FA) },
+        { RAPIDJSON_UINT64_C2(0xDBAC6C24, 0x7D62A583), RAPIDJSON_UINT64_C2(0xDF45F746, 0xB74ABF39) },
+        { RAPIDJSON_UINT64_C2(0x894BC396, 0xCE5DA772), RAPIDJSON_UINT64_C2(0x6B8BBA8C, 0x328EB783) },
+        { RAPIDJSON_UINT64_C2(0xAB9EB47C, 0x81F5114F), RAPIDJSON_UINT64_C2(0x066EA92F, 0x3F326564) },
+        { RAPIDJSON_UINT64_C2(0xD686619B, 0xA27255A2), RAPIDJSON_UINT64_C2(0xC80A537B, 0x0EFEFEBD) },
+        { RAPIDJSON_UINT64_C2(0x8613FD01, 0x45877585), RAPIDJSON_UINT64_C2(0xBD06742C, 0xE95F5F36) },
+        { RAPIDJSON_UINT64_C2(0xA798FC41, 0x96E952E7), RAPIDJSON_UINT64_C2(0x2C481138, 0x23B73704) },
+        { RAPIDJSON_UINT64_C2(0xD17F3B51, 0xFCA3A7A0), RAPIDJSON_UINT64_C2(0xF75A1586, 0x2CA504C5) },
+        { RAPIDJSON_UINT64_C2(0x82EF8513, 0x3DE648C4), RAPIDJSON_UINT64_C2(0x9A984D73, 0xDBE722FB) },
+        { RAPIDJSON_UINT64_C2(0xA3AB6658, 0x0D5FDAF5), RAPIDJSON_UINT64_C2(0xC13E60D0, 0xD2E0EBBA) },
+        { RAPIDJSON_UINT64_C2(0xCC963FEE, 0x10B7D1B3), RAPIDJSON_UINT64_C2(0x318DF905, 0x079926A8) },
+        { RAPIDJSON_UINT64_C2(0xFFBBCFE9, 0x94E5C61F), RAPIDJSON_UINT64_C2(0xFDF17746, 0x497F7052) },
+        { RAPIDJSON_UINT64_C2(0x9FD561F1, 0xFD0F9BD3), RAPIDJSON_UINT64_C2(0xFEB6EA8B, 0xEDEFA633) },
+        { RAPIDJSON_UINT64_C2(0xC7CABA6E, 0x7C5382C8), RAPIDJSON_UINT64_C2(0xFE64A52E, 0xE96B8FC0) },
+        { RAPIDJSON_UINT64_C2(0xF9BD690A, 0x1B68637B), RAPIDJSON_UINT64_C2(0x3DFDCE7A, 0xA3C673B0) },
+        { RAPIDJSON_UINT64_C2(0x9C1661A6, 0x51213E2D), RAPIDJSON_UINT64_C2(0x06BEA10C, 0xA65C084E) },
+        { RAPIDJSON_UINT64_C2(0xC31BFA0F, 0xE5698DB8), RAPIDJSON_UINT64_C2(0x486E494F, 0xCFF30A62) },
+        { RAPIDJSON_UINT64_C2(0xF3E2F893, 0xDEC3F126), RAPIDJSON_UINT64_C2(0x5A89DBA3, 0xC3EFCCFA) },
+        { RAPIDJSON_UINT64_C2(0x986DDB5C, 0x6B3A76B7), RAPIDJSON_UINT64_C2(0xF8962946, 0x5A75E01C) },
+        { RAPIDJSON_UINT64_C2(0xBE895233, 0x86091465), RAPIDJSON_UINT64_C2(0xF6BBB397, 0xF1135823) },
+        { RAPIDJSON_UINT64_C2(0xEE2BA6C0, 0x678B597F), RAPIDJSON_UINT64_C2(0x746AA07D, 0xED582E2C) },
+        { RAPIDJSON_UINT64_C2(0x94DB4838, 0x40B717EF), RAPIDJSON_UINT64_C2(0xA8C2A44E, 0xB4571CDC) },
+        { RAPIDJSON_UINT64_C2(0xBA121A46, 0x50E4DDEB), RAPIDJSON_UINT64_C2(0x92F34D62, 0x616CE413) },
+        { RAPIDJSON_UINT64_C2(0xE896A0D7, 0xE51E1566), RAPIDJSON_UINT64_C2(0x77B020BA, 0xF9C81D17) },
+        { RAPIDJSON_UINT64_C2(0x915E2486, 0xEF32CD60), RAPIDJSON_UINT64_C2(0x0ACE1474, 0xDC1D122E) },
+        { RAPIDJSON_UINT64_C2(0xB5B5ADA8, 0xAAFF80B8), RAPIDJSON_UINT64_C2(0x0D819992, 0x132456BA) },
+        { RAPIDJSON_UINT64_C2(0xE3231912, 0xD5BF60E6), RAPIDJSON_UINT64_C2(0x10E1FFF6, 0x97ED6C69) },
+        { RAPIDJSON_UINT64_C2(0x8DF5EFAB, 0xC5979C8F), RAPIDJSON_UINT64_C2(0xCA8D3FFA, 0x1EF463C1) },
+        { RAPIDJSON_UINT64_C2(0xB1736B96, 0xB6FD83B3), RAPIDJSON_UINT64_C2(0xBD308FF8, 0xA6B17CB2) },
+        { RAPIDJSON_UINT64_C2(0xDDD0467C, 0x64BCE4A0), RAPIDJSON_UINT64_C2(0xAC7CB3F6, 0xD05DDBDE) },
+        { RAPIDJSON_UINT64_C2(0x8AA22C0D, 0xBEF60EE4), RAPIDJSON_UINT64_C2(0x6BCDF07A, 0x423AA96B) },
+        { RAPIDJSON_UINT64_C2(0xAD4AB711, 0x2EB3929D), RAPIDJSON_UINT64_C2(0x86C16C98, 0xD2C953C6) },
+        { RAPIDJSON_UINT64_C2(0xD89D64D5, 0x7A607744), RAPIDJSON_UINT64_C2(0xE871C7BF, 0x077BA8B7) },
+        { RAPIDJSON_UINT64_C2(0x87625F05, 0x6C7C4A8B), RAPIDJSON_UINT64_C2(0x11471CD7, 0x64AD4972) },
+        { RAPIDJSON_UINT64_C2(0xA93AF6C6, 0xC79B5D2D), RAPIDJSON_UINT64_C2(0xD598E40D, 0x3DD89BCF) },
+        { RAPIDJSON_UINT64_C2(0xD389B478, 0x79823479), RAPIDJSON_UINT64_C2(0x4AFF1D10, 0x8D4EC2C3) },
+        { RAPIDJSON_UINT64_C2(0x843610CB, 0x4BF160CB), RAPIDJSON_UINT64_C2(0xCEDF722A, 0x585139BA) },
+        { RAPIDJSON_UINT64_C2(0xA54394FE, 0x1EEDB8FE), RAPIDJSON_UINT64_C2(0xC2974EB4, 0xEE658828) },
+        { RAPIDJSON_UINT64_C2(0xCE947A3D, 0xA6A9273E), RAPIDJSON_UINT64_C2(0x733D2262, 0x29FEEA32) },
+        { RAPIDJSON_UINT64_C2(0x811CCC66, 0x8829B887), RAPIDJSON_UINT64_C2(0x0806357D, 0x5A3F525F) },
+        { RAPIDJSON_UINT64_C2(0xA163FF80, 0x2A3426A8), RAPIDJSON_UINT64_C2(0xCA07C2DC, 0xB0CF26F7) },
+        { RAPIDJSON_UINT64_C2(0xC9BCFF60, 0x34C13052), RAPIDJSON_UINT64_C2(0xFC89B393, 0xDD02F0B5) },
+        { RAPIDJSON_UINT64_C2(0xFC2C3F38, 0x41F17C67), RAPIDJSON_UINT64_C2(0xBBAC2078, 0xD443ACE2) },
+        { RAPIDJSON_UINT64_C2(0x9D9BA783, 0x2936EDC0), RAPIDJSON_UINT64_C2(0xD54B944B, 0x84AA4C0D) },
+        { RAPIDJSON_UINT64_C2(0xC5029163, 0xF384A931), RAPIDJSON_UINT64_C2(0x0A9E795E, 0x65D4DF11) },
+        { RAPIDJSON_UINT64_C2(0xF64335BC, 0xF065D37D), RAPIDJSON_UINT64_C2(0x4D4617B5, 0xFF4A16D5) },
+        { RAPIDJSON_UINT64_C2(0x99EA0196, 0x163FA42E), RAPIDJSON_UINT64_C2(0x504BCED1, 0xBF8E4E45) },
+        { RAPIDJSON_UINT64_C2(0xC06481FB, 0x9BCF8D39), RAPIDJSON_UINT64_C2(0xE45EC286, 0x2F71E1D6) },
+        { RAPIDJSON_UINT64_C2(0xF07DA27A, 0x82C37088), RAPIDJSON_UINT64_C2(0x5D767327, 0xBB4E5A4C) },
+        { RAPIDJSON_UINT64_C2(0x964E858C, 0x91BA2655), RAPIDJSON_UINT64_C2(0x3A6A07F8, 0xD510F86F) },
+        { RAPIDJSON_UINT64_C2(0xBBE226EF, 0xB628AFEA), RAPIDJSON_UINT64_C2(0x890489F7, 0x0A55368B) },
+        { RAPIDJSON_UINT64_C2(0xEADAB0AB, 0xA3B2DBE5), RAPIDJSON_UINT64_C2(0x2B45AC74, 0xCCEA842E) },
+        { RAPIDJSON_UINT64_C2(0x92C8AE6B, 0x464FC96F), RAPIDJSON_UINT64_C2(0x3B0B8BC9, 0x0012929D) },
+        { RAPIDJSON_UINT64_C2(0xB77ADA06, 0x17E3BBCB), RAPIDJSON_UINT64_C2(0x09CE6EBB, 0x40173744) },
+        { RAPIDJSON_UINT64_C2(0xE5599087, 0x9DDCAABD), RAPIDJSON_UINT64_C2(0xCC420A6A, 0x101D0515) },
+        { RAPIDJSON_UINT64_C2(0x8F57FA54, 0xC2A9EAB6), RAPIDJSON_UINT64_C2(0x9FA94682, 0x4A12232D) },
+        { RAPIDJSON_UINT64_C2(0xB32DF8E9, 0xF3546564), RAPIDJSON_UINT64_C2(0x47939822, 0xDC96ABF9) },
+        { RAPIDJSON_UINT64_C2(0xDFF97724, 0x70297EBD), RAPIDJSON_UINT64_C2(0x59787E2B, 0x93BC56F7) },
+        { RAPIDJSON_UINT64_C2(0x8BFBEA76, 0xC619EF36), RAPIDJSON_UINT64_C2(0x57EB4EDB, 0x3C55B65A) },
+        { RAPIDJSON_UINT64_C2(0xAEFAE514, 0x77A06B03), RAPIDJSON_UINT64_C2(0xEDE62292, 0x0B6B23F1) },
+        { RAPIDJSON_UINT64_C2(0xDAB99E59, 0x958885C4), RAPIDJSON_UINT64_C2(0xE95FAB36, 0x8E45ECED) },
+        { RAPIDJSON_UINT64_C2(0x88B402F7, 0xFD75539B), RAPIDJSON_UINT64_C2(0x11DBCB02, 0x18EBB414) },
+        { RAPIDJSON_UINT64_C2(0xAAE103B5, 0xFCD2A881), RAPIDJSON_UINT64_C2(0xD652BDC2, 0x9F26A119) },
+        { RAPIDJSON_UINT64_C2(0xD59944A3, 0x7C0752A2), RAPIDJSON_UINT64_C2(0x4BE76D33, 0x46F0495F) },
+        { RAPIDJSON_UINT64_C2(0x857FCAE6, 0x2D8493A5), RAPIDJSON_UINT64_C2(0x6F70A440, 0x0C562DDB) },
+        { RAPIDJSON_UINT64_C2(0xA6DFBD9F, 0xB8E5B88E), RAPIDJSON_UINT64_C2(0xCB4CCD50, 0x0F6BB952) },
+        { RAPIDJSON_UINT64_C2(0xD097AD07, 0xA71F26B2), RAPIDJSON_UINT64_C2(0x7E2000A4, 0x1346A7A7) },
+        { RAPIDJSON_UINT64_C2(0x825ECC24, 0xC873782F), RAPIDJSON_UINT64_C2(0x8ED40066, 0x8C0C28C8) },
+        { RAPIDJSON_UINT64_C2(0xA2F67F2D, 0xFA90563B), RAPIDJSON_UINT64_C2(0x72890080, 0x2F0F32FA) },
+        { RAPIDJSON_UINT64_C2(0xCBB41EF9, 0x79346BCA), RAPIDJSON_UINT64_C2(0x4F2B40A0, 0x3AD2FFB9) },
+        { RAPIDJSON_UINT64_C2(0xFEA126B7, 0xD78186BC), RAPIDJSON_UINT64_C2(0xE2F610C8, 0x4987BFA8) },
+        { RAPIDJSON_UINT64_C2(0x9F24B832, 0xE6B0F436), RAPIDJSON_UINT64_C2(0x0DD9CA7D, 0x2DF4D7C9) },
+        { RAPIDJSON_UINT64_C2(0xC6EDE63F, 0xA05D3143), RAPIDJSON_UINT64_C2(0x91503D1C, 0x79720DBB) },
+        { RAPIDJSON_UINT64_C2(0xF8A95FCF, 0x88747D94), RAPIDJSON_UINT64_C2(0x75A44C63, 0x97CE912A) },
+        { RAPIDJSON_UINT64_C2(0x9B69DBE1, 0xB548CE7C), RAPIDJSON_UINT64_C2(0xC986AFBE, 0x3EE11ABA) },
+        { RAPIDJSON_UINT64_C2(0xC24452DA, 0x229B021B), RAPIDJSON_UINT64_C2(0xFBE85BAD, 0xCE996168) },
+        { RAPIDJSON_UINT64_C2(0xF2D56790, 0xAB41C2A2), RAPIDJSON_UINT64_C2(0xFAE27299, 0x423FB9C3) },
+        { RAPIDJSON_UINT64_C2(0x97C560BA, 0x6B0919A5), RAPIDJSON_UINT64_C2(0xDCCD879F, 0xC967D41A) },
+        { RAPIDJSON_UINT64_C2(0xBDB6B8E9, 0x05CB600F), RAPIDJSON_UINT64_C2(0x5400E987, 0xBBC1C920) },
+        { RAPIDJSON_UINT64_C2(0xED246723, 0x473E3813), RAPIDJSON_UINT64_C2(0x290123E9, 0xAAB23B68) },
+        { RAPIDJSON_UINT64_C2(0x9436C076, 0x0C86E30B), RAPIDJSON_UINT64_C2(0xF9A0B672, 0x0AAF6521) },
+        { RAPIDJSON_UINT64_C2(0xB9447093, 0x8FA89BCE), RAPIDJSON_UINT64_C2(0xF808E40E, 0x8D5B3E69) },
+        { RAPIDJSON_UINT64_C2(0xE7958CB8, 0x7392C2C2), RAPIDJSON_UINT64_C2(0xB60B1D12, 0x30B20E04) },
+        { RAPIDJSON_UINT64_C2(0x90BD77F3, 0x483BB9B9), RAPIDJSON_UINT64_C2(0xB1C6F22B, 0x5E6F48C2) },
+        { RAPIDJSON_UINT64_C2(0xB4ECD5F0, 0x1A4AA828), RAPIDJSON_UINT64_C2(0x1E38AEB6, 0x360B1AF3) },
+        { RAPIDJSON_UINT64_C2(0xE2280B6C, 0x20DD5232), RAPIDJSON_UINT64_C2(0x25C6DA63, 0xC38DE1B0) },
+        { RAPIDJSON_UINT64_C2(0x8D590723, 0x948A535F), RAPIDJSON_UINT64_C2(0x579C487E, 0x5A38AD0E) },
+        { RAPIDJSON_UINT64_C2(0xB0AF48EC, 0x79ACE837), RAPIDJSON_UINT64_C2(0x2D835A9D, 0xF0C6D851) },
+        { RAPIDJSON_UINT64_C2(0xDCDB1B27, 0x98182244), RAPIDJSON_UINT64_C2(0xF8E43145, 0x6CF88E65) },
+        { RAPIDJSON_UINT64_C2(0x8A08F0F8, 0xBF0F156B), RAPIDJSON_UINT64_C2(0x1B8E9ECB, 0x641B58FF) },
+        { RAPIDJSON_UINT64_C2(0xAC8B2D36, 0xEED2DAC5), RAPIDJSON_UINT64_C2(0xE272467E, 0x3D222F3F) },
+        { RAPIDJSON_UINT64_C2(0xD7ADF884, 0xAA879177), RAPIDJSON_UINT64_C2(0x5B0ED81D, 0xCC6ABB0F) },
+        { RAPIDJSON_UINT64_C2(0x86CCBB52, 0xEA94BAEA), RAPIDJSON_UINT64_C2(0x98E94712, 0x9FC2B4E9) },
+        { RAPIDJSON_UINT64_C2(0xA87FEA27, 0xA539E9A5), RAPIDJSON_UINT64_C2(0x3F2398D7, 0x47B36224) },
+        { RAPIDJSON_UINT64_C2(0xD29FE4B1, 0x8E88640E), RAPIDJSON_UINT64_C2(0x8EEC7F0D, 0x19A03AAD) },
+        { RAPIDJSON_UINT64_C2(0x83A3EEEE, 0xF9153E89), RAPIDJSON_UINT64_C2(0x1953CF68, 0x300424AC) },
+        { RAPIDJSON_UINT64_C2(0xA48CEAAA, 0xB75A8E2B), RAPIDJSON_UINT64_C2(0x5FA8C342, 0x3C052DD7) },
+        { RAPIDJSON_UINT64_C2(0xCDB02555, 0x653131B6), RAPIDJSON_UINT64_C2(0x3792F412, 0xCB06794D) },
+        { RAPIDJSON_UINT64_C2(0x808E1755, 0x5F3EBF11), RAPIDJSON_UINT64_C2(0xE2BBD88B, 0xBEE40BD0) },
+        { RAPIDJSON_UINT64_C2(0xA0B19D2A, 0xB70E6ED6), RAPIDJSON_UINT64_C2(0x5B6ACEAE, 0xAE9D0EC4) },
+        { RAPIDJSON_UINT64_C2(0xC8DE0475, 0x64D20A8B), RAPIDJSON_UINT64_C2(0xF245825A, 0x5A445275) },
+        { RAPIDJSON_UINT64_C2(0xFB158592, 0xBE068D2E), RAPIDJSON_UINT64_C2(0xEED6E2F0, 0xF0D56712) },
+        { RAPIDJSON_UINT64_C2(0x9CED737B, 0xB6C4183D), RAPIDJSON_UINT64_C2(0x55464DD6, 0x9685606B) },
+        { RAPIDJSON_UINT64_C2(0xC428D05A, 0xA4751E4C), RAPIDJSON_UINT64_C2(0xAA97E14C, 0x3C26B886) },
+        { RAPIDJSON_UINT64_C2(0xF5330471, 0x4D9265DF), RAPIDJSON_UINT64_C2(0xD53DD99F, 0x4B3066A8) },
+        { RAPIDJSON_UINT64_C2(0x993FE2C6, 0xD07B7FAB), RAPIDJSON_UINT64_C2(0xE546A803, 0x8EFE4029) },
+        { RAPIDJSON_UINT64_C2(0xBF8FDB78, 0x849A5F96), RAPIDJSON_UINT64_C2(0xDE985204, 0x72BDD033) },
+        { RAPIDJSON_UINT64_C2(0xEF73D256, 0xA5C0F77C), RAPIDJSON_UINT64_C2(0x963E6685, 0x8F6D4440) },
+        { RAPIDJSON_UINT64_C2(0x95A86376, 0x27989AAD), RAPIDJSON_UINT64_C2(0xDDE70013, 0x79A44AA8) },
+        { RAPIDJSON_UINT64_C2(0xBB127C53, 0xB17EC159), RAPIDJSON_UINT64_C2(0x5560C018, 0x580D5D52) },
+        { RAPIDJSON_UINT64_C2(0xE9D71B68, 0x9DDE71AF), RAPIDJSON_UINT64_C2(0xAAB8F01E, 0x6E10B4A6) },
+        { RAPIDJSON_UINT64_C2(0x92267121, 0x62AB070D), RAPIDJSON_UINT64_C2(0xCAB39613, 0x04CA70E8) },
+        { RAPIDJSON_UINT64_C2(0xB6B00D69, 0xBB55C8D1), RAPIDJSON_UINT64_C2(0x3D607B97, 0xC5FD0D22) },
+        { RAPIDJSON_UINT64_C2(0xE45C10C4, 0x2A2B3B05), RAPIDJSON_UINT64_C2(0x8CB89A7D, 0xB77C506A) },
+        { RAPIDJSON_UINT64_C2(0x8EB98A7A, 0x9A5B04E3), RAPIDJSON_UINT64_C2(0x77F3608E, 0x92ADB242) },
+        { RAPIDJSON_UINT64_C2(0xB267ED19, 0x40F1C61C), RAPIDJSON_UINT64_C2(0x55F038B2, 0x37591ED3) },
+        { RAPIDJSON_UINT64_C2(0xDF01E85F, 0x912E37A3), RAPIDJSON_UINT64_C2(0x6B6C46DE, 0xC52F6688) },
+        { RAPIDJSON_UINT64_C2(0x8B61313B, 0xBABCE2C6), RAPIDJSON_UINT64_C2(0x2323AC4B, 0x3B3DA015) },
+        { RAPIDJSON_UINT64_C2(0xAE397D8A, 0xA96C1B77), RAPIDJSON_UINT64_C2(0xABEC975E, 0x0A0D081A) },
+        { RAPIDJSON_UINT64_C2(0xD9C7DCED, 0x53C72255), RAPIDJSON_UINT64_C2(0x96E7BD35, 0x8C904A21) },
+        { RAPIDJSON_UINT64_C2(0x881CEA14, 0x545C7575), RAPIDJSON_UINT64_C2(0x7E50D641, 0x77DA2E54) },
+        { RAPIDJSON_UINT64_C2(0xAA242499, 0x697392D2), RAPIDJSON_UINT64_C2(0xDDE50BD1, 0xD5D0B9E9) },
+        { RAPIDJSON_UINT64_C2(0xD4AD2DBF, 0xC3D07787), RAPIDJSON_UINT64_C2(0x955E4EC6, 0x4B44E864) },
+        { RAPIDJSON_UINT64_C2(0x84EC3C97, 0xDA624AB4), RAPIDJSON_UINT64_C2(0xBD5AF13B, 0xEF0B113E) },
+        { RAPIDJSON_UINT64_C2(0xA6274BBD, 0xD0FADD61), RAPIDJSON_UINT64_C2(0xECB1AD8A, 0xEACDD58E) },
+        { RAPIDJSON_UINT64_C2(0xCFB11EAD, 0x453994BA), RAPIDJSON_UINT64_C2(0x67DE18ED, 0xA5814AF2) },
+        { RAPIDJSON_UINT64_C2(0x81CEB32C, 0x4B43FCF4), RAPIDJSON_UINT64_C2(0x80EACF94, 0x8770CED7) },
+        { RAPIDJSON_UINT64_C2(0xA2425FF7, 0x5E14FC31), RAPIDJSON_UINT64_C2(0xA1258379, 0xA94D028D) },
+        { RAPIDJSON_UINT64_C2(0xCAD2F7F5, 0x359A3B3E), RAPIDJSON_UINT64_C2(0x096EE458, 0x13A04330) },
+        { RAPIDJSON_UINT64_C2(0xFD87B5F2, 0x8300CA0D), RAPIDJSON_UINT64_C2(0x8BCA9D6E, 0x188853FC) },
+        { RAPIDJSON_UINT64_C2(0x9E74D1B7, 0x91E07E48), RAPIDJSON_UINT64_C2(0x775EA264, 0xCF55347E) },
+        { RAPIDJSON_UINT64_C2(0xC6120625, 0x76589DDA), RAPIDJSON_UINT64_C2(0x95364AFE, 0x032A819E) },
+        { RAPIDJSON_UINT64_C2(0xF79687AE, 0xD3EEC551), RAPIDJSON_UINT64_C2(0x3A83DDBD, 0x83F52205) },
+        { RAPIDJSON_UINT64_C2(0x9ABE14CD, 0x44753B52), RAPIDJSON_UINT64_C2(0xC4926A96, 0x72793543) },
+        { RAPIDJSON_UINT64_C2(0xC16D9A00, 0x95928A27), RAPIDJSON_UINT64_C2(0x75B7053C, 0x0F178294) },
+        { RAPIDJSON_UINT64_C2(0xF1C90080, 0xBAF72CB1), RAPIDJSON_UINT64_C2(0x5324C68B, 0x12DD6339) },
+        { RAPIDJSON_UINT64_C2(0x971DA050, 0x74DA7BEE), RAPIDJSON_UINT64_C2(0xD3F6FC16, 0xEBCA5E04) },
+        { RAPIDJSON_UINT64_C2(0xBCE50864, 0x92111AEA), RAPIDJSON_UINT64_C2(0x88F4BB1C, 0xA6BCF585) },
+        { RAPIDJSON_UINT64_C2(0xEC1E4A7D, 0xB69561A5), RAPIDJSON_UINT64_C2(0x2B31E9E3, 0xD06C32E6) },
+        { RAPIDJSON_UINT64_C2(0x9392EE8E, 0x921D5D07), RAPIDJSON_UINT64_C2(0x3AFF322E, 0x62439FD0) },
+        { RAPIDJSON_UINT64_C2(0xB877AA32, 0x36A4B449), RAPIDJSON_UINT64_C2(0x09BEFEB9, 0xFAD487C3) },
+        { RAPIDJSON_UINT64_C2(0xE69594BE, 0xC44DE15B), RAPIDJSON_UINT64_C2(0x4C2EBE68, 0x7989A9B4) },
+        { RAPIDJSON_UINT64_C2(0x901D7CF7, 0x3AB0ACD9), RAPIDJSON_UINT64_C2(0x0F9D3701, 0x4BF60A11) },
+        { RAPIDJSON_UINT64_C2(0xB424DC35, 0x095CD80F), RAPIDJSON_UINT64_C2(0x538484C1, 0x9EF38C95) },
+        { RAPIDJSON_UINT64_C2(0xE12E1342, 0x4BB40E13), RAPIDJSON_UINT64_C2(0x2865A5F2, 0x06B06FBA) },
+        { RAPIDJSON_UINT64_C2(0x8CBCCC09, 0x6F5088CB), RAPIDJSON_UINT64_C2(0xF93F87B7, 0x442E45D4) },
+        { RAPIDJSON_UINT64_C2(0xAFEBFF0B, 0xCB24AAFE), RAPIDJSON_UINT64_C2(0xF78F69A5, 0x1539D749) },
+        { RAPIDJSON_UINT64_C2(0xDBE6FECE, 0xBDEDD5BE), RAPIDJSON_UINT64_C2(0xB573440E, 0x5A884D1C) },
+        { RAPIDJSON_UINT64_C2(0x89705F41, 0x36B4A597), RAPIDJSON_UINT64_C2(0x31680A88, 0xF8953031) },
+        { RAPIDJSON_UINT64_C2(0xABCC7711, 0x8461CEFC), RAPIDJSON_UINT64_C2(0xFDC20D2B, 0x36BA7C3E) },
+        { RAPIDJSON_UINT64_C2(0xD6BF94D5, 0xE57A42BC), RAPIDJSON_UINT64_C2(0x3D329076, 0x04691B4D) },
+        { RAPIDJSON_UINT64_C2(0x8637BD05, 0xAF6C69B5), RAPIDJSON_UINT64_C2(0xA63F9A49, 0xC2C1B110) },
+        { RAPIDJSON_UINT64_C2(0xA7C5AC47, 0x1B478423), RAPIDJSON_UINT64_C2(0x0FCF80DC, 0x33721D54) },
+        { RAPIDJSON_UINT64_C2(0xD1B71758, 0xE219652B), RAPIDJSON_UINT64_C2(0xD3C36113, 0x404EA4A9) },
+        { RAPIDJSON_UINT64_C2(0x83126E97, 0x8D4FDF3B), RAPIDJSON_UINT64_C2(0x645A1CAC, 0x083126EA) },
+        { RAPIDJSON_UINT64_C2(0xA3D70A3D, 0x70A3D70A), RAPIDJSON_UINT64_C2(0x3D70A3D7, 0x0A3D70A4) },
+        { RAPIDJSON_UINT64_C2(0xCCCCCCCC, 0xCCCCCCCC), RAPIDJSON_UINT64_C2(0xCCCCCCCC, 0xCCCCCCCD) },
+        { RAPIDJSON_UINT64_C2(0x80000000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xA0000000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xC8000000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xFA000000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x9C400000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xC3500000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xF4240000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x98968000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xBEBC2000, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xEE6B2800, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x9502F900, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xBA43B740, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xE8D4A510, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x9184E72A, 0x00000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xB5E620F4, 0x80000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xE35FA931, 0xA0000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x8E1BC9BF, 0x04000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xB1A2BC2E, 0xC5000000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xDE0B6B3A, 0x76400000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x8AC72304, 0x89E80000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xAD78EBC5, 0xAC620000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xD8D726B7, 0x177A8000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x87867832, 0x6EAC9000), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xA968163F, 0x0A57B400), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xD3C21BCE, 0xCCEDA100), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x84595161, 0x401484A0), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xA56FA5B9, 0x9019A5C8), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xCECB8F27, 0xF4200F3A), RAPIDJSON_UINT64_C2(0x00000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x813F3978, 0xF8940984), RAPIDJSON_UINT64_C2(0x40000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xA18F07D7, 0x36B90BE5), RAPIDJSON_UINT64_C2(0x50000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xC9F2C9CD, 0x04674EDE), RAPIDJSON_UINT64_C2(0xA4000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xFC6F7C40, 0x45812296), RAPIDJSON_UINT64_C2(0x4D000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x9DC5ADA8, 0x2B70B59D), RAPIDJSON_UINT64_C2(0xF0200000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xC5371912, 0x364CE305), RAPIDJSON_UINT64_C2(0x6C280000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xF684DF56, 0xC3E01BC6), RAPIDJSON_UINT64_C2(0xC7320000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x9A130B96, 0x3A6C115C), RAPIDJSON_UINT64_C2(0x3C7F4000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xC097CE7B, 0xC90715B3), RAPIDJSON_UINT64_C2(0x4B9F1000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xF0BDC21A, 0xBB48DB20), RAPIDJSON_UINT64_C2(0x1E86D400, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x96769950, 0xB50D88F4), RAPIDJSON_UINT64_C2(0x13144480, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xBC143FA4, 0xE250EB31), RAPIDJSON_UINT64_C2(0x17D955A0, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xEB194F8E, 0x1AE525FD), RAPIDJSON_UINT64_C2(0x5DCFAB08, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x92EFD1B8, 0xD0CF37BE), RAPIDJSON_UINT64_C2(0x5AA1CAE5, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0xB7ABC627, 0x050305AD), RAPIDJSON_UINT64_C2(0xF14A3D9E, 0x40000000) },
+        { RAPIDJSON_UINT64_C2(0xE596B7B0, 0xC643C719), RAPIDJSON_UINT64_C2(0x6D9CCD05, 0xD0000000) },
+        { RAPIDJSON_UINT64_C2(0x8F7E32CE, 0x7BEA5C6F), RAPIDJSON_UINT64_C2(0xE4820023, 0xA2000000) },
+        { RAPIDJSON_UINT64_C2(0xB35DBF82, 0x1AE4F38B), RAPIDJSON_UINT64_C2(0xDDA2802C, 0x8A800000) },
+        { RAPIDJSON_UINT64_C2(0xE0352F62, 0xA19E306E), RAPIDJSON_UINT64_C2(0xD50B2037, 0xAD200000) },
+        { RAPIDJSON_UINT64_C2(0x8C213D9D, 0xA502DE45), RAPIDJSON_UINT64_C2(0x4526F422, 0xCC340000) },
+        { RAPIDJSON_UINT64_C2(0xAF298D05, 0x0E4395D6), RAPIDJSON_UINT64_C2(0x9670B12B, 0x7F410000) },
+        { RAPIDJSON_UINT64_C2(0xDAF3F046, 0x51D47B4C), RAPIDJSON_UINT64_C2(0x3C0CDD76, 0x5F114000) },
+        { RAPIDJSON_UINT64_C2(0x88D8762B, 0xF324CD0F), RAPIDJSON_UINT64_C2(0xA5880A69, 0xFB6AC800) },
+        { RAPIDJSON_UINT64_C2(0xAB0E93B6, 0xEFEE0053), RAPIDJSON_UINT64_C2(0x8EEA0D04, 0x7A457A00) },
+        { RAPIDJSON_UINT64_C2(0xD5D238A4, 0xABE98068), RAPIDJSON_UINT64_C2(0x72A49045, 0x98D6D880) },
+        { RAPIDJSON_UINT64_C2(0x85A36366, 0xEB71F041), RAPIDJSON_UINT64_C2(0x47A6DA2B, 0x7F864750) },
+        { RAPIDJSON_UINT64_C2(0xA70C3C40, 0xA64E6C51), RAPIDJSON_UINT64_C2(0x999090B6, 0x5F67D924) },
+        { RAPIDJSON_UINT64_C2(0xD0CF4B50, 0xCFE20765), RAPIDJSON_UINT64_C2(0xFFF4B4E3, 0xF741CF6D) },
+        { RAPIDJSON_UINT64_C2(0x82818F12, 0x81ED449F), RAPIDJSON_UINT64_C2(0xBFF8F10E, 0x7A8921A4) },
+        { RAPIDJSON_UINT64_C2(0xA321F2D7, 0x226895C7), RAPIDJSON_UINT64_C2(0xAFF72D52, 0x192B6A0D) },
+        { RAPIDJSON_UINT64_C2(0xCBEA6F8C, 0xEB02BB39), RAPIDJSON_UINT64_C2(0x9BF4F8A6, 0x9F764490) },
+        { RAPIDJSON_UINT64_C2(0xFEE50B70, 0x25C36A08), RAPIDJSON_UINT64_C2(0x02F236D0, 0x4753D5B4) },
+        { RAPIDJSON_UINT64_C2(0x9F4F2726, 0x179A2245), RAPIDJSON_UINT64_C2(0x01D76242, 0x2C946590) },
+        { RAPIDJSON_UINT64_C2(0xC722F0EF, 0x9D80AAD6), RAPIDJSON_UINT64_C2(0x424D3AD2, 0xB7B97EF5) },
+        { RAPIDJSON_UINT64_C2(0xF8EBAD2B, 0x84E0D58B), RAPIDJSON_UINT64_C2(0xD2E08987, 0x65A7DEB2) },
+        { RAPIDJSON_UINT64_C2(0x9B934C3B, 0x330C8577), RAPIDJSON_UINT64_C2(0x63CC55F4, 0x9F88EB2F) },
+        { RAPIDJSON_UINT64_C2(0xC2781F49, 0xFFCFA6D5), RAPIDJSON_UINT64_C2(0x3CBF6B71, 0xC76B25FB) },
+        { RAPIDJSON_UINT64_C2(0xF316271C, 0x7FC3908A), RAPIDJSON_UINT64_C2(0x8BEF464E, 0x3945EF7A) },
+        { RAPIDJSON_UINT64_C2(0x97EDD871, 0xCFDA3A56), RAPIDJSON_UINT64_C2(0x97758BF0, 0xE3CBB5AC) },
+        { RAPIDJSON_UINT64_C2(0xBDE94E8E, 0x43D0C8EC), RAPIDJSON_UINT64_C2(0x3D52EEED, 0x1CBEA317) },
+        { RAPIDJSON_UINT64_C2(0xED63A231, 0xD4C4FB27), RAPIDJSON_UINT64_C2(0x4CA7AAA8, 0x63EE4BDD) },
+        { RAPIDJSON_UINT64_C2(0x945E455F, 0x24FB1CF8), RAPIDJSON_UINT64_C2(0x8FE8CAA9, 0x3E74EF6A) },
+        { RAPIDJSON_UINT64_C2(0xB975D6B6, 0xEE39E436), RAPIDJSON_UINT64_C2(0xB3E2FD53, 0x8E122B44) },
+        { RAPIDJSON_UINT64_C2(0xE7D34C64, 0xA9C85D44), RAPIDJSON_UINT64_C2(0x60DBBCA8, 0x7196B616) },
+        { RAPIDJSON_UINT64_C2(0x90E40FBE, 0xEA1D3A4A), RAPIDJSON_UINT64_C2(0xBC8955E9, 0x46FE31CD) },
+        { RAPIDJSON_UINT64_C2(0xB51D13AE, 0xA4A488DD), RAPIDJSON_UINT64_C2(0x6BABAB63, 0x98BDBE41) },
+        { RAPIDJSON_UINT64_C2(0xE264589A, 0x4DCDAB14), RAPIDJSON_UINT64_C2(0xC696963C, 0x7EED2DD1) },
+        { RAPIDJSON_UINT64_C2(0x8D7EB760, 0x70A08AEC), RAPIDJSON_UINT64_C2(0xFC1E1DE5, 0xCF543CA2) },
+        { RAPIDJSON_UINT64_C2(0xB0DE6538, 0x8CC8ADA8), RAPIDJSON_UINT64_C2(0x3B25A55F, 0x43294BCB) },
+        { RAPIDJSON_UINT64_C2(0xDD15FE86, 0xAFFAD912), RAPIDJSON_UINT64_C2(0x49EF0EB7, 0x13F39EBE) },
+        { RAPIDJSON_UINT64_C2(0x8A2DBF14, 0x2DFCC7AB), RAPIDJSON_UINT64_C2(0x6E356932, 0x6C784337) },
+        { RAPIDJSON_UINT64_C2(0xACB92ED9, 0x397BF996), RAPIDJSON_UINT64_C2(0x49C2C37F, 0x07965404) },
+        { RAPIDJSON_UINT64_C2(0xD7E77A8F, 0x87DAF7FB), RAPIDJSON_UINT64_C2(0xDC33745E, 0xC97BE906) },
+        { RAPIDJSON_UINT64_C2(0x86F0AC99, 0xB4E8DAFD), RAPIDJSON_UINT64_C2(0x69A028BB, 0x3DED71A3) },
+        { RAPIDJSON_UINT64_C2(0xA8ACD7C0, 0x222311BC), RAPIDJSON_UINT64_C2(0xC40832EA, 0x0D68CE0C) },
+        { RAPIDJSON_UINT64_C2(0xD2D80DB0, 0x2AABD62B), RAPIDJSON_UINT64_C2(0xF50A3FA4, 0x90C30190) },
+        { RAPIDJSON_UINT64_C2(0x83C7088E, 0x1AAB65DB), RAPIDJSON_UINT64_C2(0x792667C6, 0xDA79E0FA) },
+        { RAPIDJSON_UINT64_C2(0xA4B8CAB1, 0xA1563F52), RAPIDJSON_UINT64_C2(0x577001B8, 0x91185938) },
+        { RAPIDJSON_UINT64_C2(0xCDE6FD5E, 0x09ABCF26), RAPIDJSON_UINT64_C2(0xED4C0226, 0xB55E6F86) },
+        { RAPIDJSON_UINT64_C2(0x80B05E5A, 0xC60B6178), RAPIDJSON_UINT64_C2(0x544F8158, 0x315B05B4) },
+        { RAPIDJSON_UINT64_C2(0xA0DC75F1, 0x778E39D6), RAPIDJSON_UINT64_C2(0x696361AE, 0x3DB1C721) },
+        { RAPIDJSON_UINT64_C2(0xC913936D, 0xD571C84C), RAPIDJSON_UINT64_C2(0x03BC3A19, 0xCD1E38E9) },
+        { RAPIDJSON_UINT64_C2(0xFB587849, 0x4ACE3A5F), RAPIDJSON_UINT64_C2(0x04AB48A0, 0x4065C723) },
+        { RAPIDJSON_UINT64_C2(0x9D174B2D, 0xCEC0E47B), RAPIDJSON_UINT64_C2(0x62EB0D64, 0x283F9C76) },
+        { RAPIDJSON_UINT64_C2(0xC45D1DF9, 0x42711D9A), RAPIDJSON_UINT64_C2(0x3BA5D0BD, 0x324F8394) },
+        { RAPIDJSON_UINT64_C2(0xF5746577, 0x930D6500), RAPIDJSON_UINT64_C2(0xCA8F44EC, 0x7EE36479) },
+        { RAPIDJSON_UINT64_C2(0x9968BF6A, 0xBBE85F20), RAPIDJSON_UINT64_C2(0x7E998B13, 0xCF4E1ECB) },
+        { RAPIDJSON_UINT64_C2(0xBFC2EF45, 0x6AE276E8), RAPIDJSON_UINT64_C2(0x9E3FEDD8, 0xC321A67E) },
+        { RAPIDJSON_UINT64_C2(0xEFB3AB16, 0xC59B14A2), RAPIDJSON_UINT64_C2(0xC5CFE94E, 0xF3EA101E) },
+        { RAPIDJSON_UINT64_C2(0x95D04AEE, 0x3B80ECE5), RAPIDJSON_UINT64_C2(0xBBA1F1D1, 0x58724A12) },
+        { RAPIDJSON_UINT64_C2(0xBB445DA9, 0xCA61281F), RAPIDJSON_UINT64_C2(0x2A8A6E45, 0xAE8EDC97) },
+        { RAPIDJSON_UINT64_C2(0xEA157514, 0x3CF97226), RAPIDJSON_UINT64_C2(0xF52D09D7, 0x1A3293BD) },
+        { RAPIDJSON_UINT64_C2(0x924D692C, 0xA61BE758), RAPIDJSON_UINT64_C2(0x593C2626, 0x705F9C56) },
+        { RAPIDJSON_UINT64_C2(0xB6E0C377, 0xCFA2E12E), RAPIDJSON_UINT64_C2(0x6F8B2FB0, 0x0C77836C) },
+        { RAPIDJSON_UINT64_C2(0xE498F455, 0xC38B997A), RAPIDJSON_UINT64_C2(0x0B6DFB9C, 0x0F956447) },
+        { RAPIDJSON_UINT64_C2(0x8EDF98B5, 0x9A373FEC), RAPIDJSON_UINT64_C2(0x4724BD41, 0x89BD5EAC) },
+        { RAPIDJSON_UINT64_C2(0xB2977EE3, 0x00C50FE7), RAPIDJSON_UINT64_C2(0x58EDEC91, 0xEC2CB657) },
+        { RAPIDJSON_UINT64_C2(0xDF3D5E9B, 0xC0F653E1), RAPIDJSON_UINT64_C2(0x2F2967B6, 0x6737E3ED) },
+        { RAPIDJSON_UINT64_C2(0x8B865B21, 0x5899F46C), RAPIDJSON_UINT64_C2(0xBD79E0D2, 0x0082EE74) },
+        { RAPIDJSON_UINT64_C2(0xAE67F1E9, 0xAEC07187), RAPIDJSON_UINT64_C2(0xECD85906, 0x80A3AA11) },
+        { RAPIDJSON_UINT64_C2(0xDA01EE64, 0x1A708DE9), RAPIDJSON_UINT64_C2(0xE80E6F48, 0x20CC9495) },
+        { RAPIDJSON_UINT64_C2(0x884134FE, 0x908658B2), RAPIDJSON_UINT64_C2(0x3109058D, 0x147FDCDD) },
+        { RAPIDJSON_UINT64_C2(0xAA51823E, 0x34A7EEDE), RAPIDJSON_UINT64_C2(0xBD4B46F0, 0x599FD415) },
+        { RAPIDJSON_UINT64_C2(0xD4E5E2CD, 0xC1D1EA96), RAPIDJSON_UINT64_C2(0x6C9E18AC, 0x7007C91A) },
+        { RAPIDJSON_UINT64_C2(0x850FADC0, 0x9923329E), RAPIDJSON_UINT64_C2(0x03E2CF6B, 0xC604DDB0) },
+        { RAPIDJSON_UINT64_C2(0xA6539930, 0xBF6BFF45), RAPIDJSON_UINT64_C2(0x84DB8346, 0xB786151C) },
+        { RAPIDJSON_UINT64_C2(0xCFE87F7C, 0xEF46FF16), RAPIDJSON_UINT64_C2(0xE6126418, 0x65679A63) },
+        { RAPIDJSON_UINT64_C2(0x81F14FAE, 0x158C5F6E), RAPIDJSON_UINT64_C2(0x4FCB7E8F, 0x3F60C07E) },
+        { RAPIDJSON_UINT64_C2(0xA26DA399, 0x9AEF7749), RAPIDJSON_UINT64_C2(0xE3BE5E33, 0x0F38F09D) },
+        { RAPIDJSON_UINT64_C2(0xCB090C80, 0x01AB551C), RAPIDJSON_UINT64_C2(0x5CADF5BF, 0xD3072CC5) },
+        { RAPIDJSON_UINT64_C2(0xFDCB4FA0, 0x02162A63), RAPIDJSON_UINT64_C2(0x73D9732F, 0xC7C8F7F6) },
+        { RAPIDJSON_UINT64_C2(0x9E9F11C4, 0x014DDA7E), RAPIDJSON_UINT64_C2(0x2867E7FD, 0xDCDD9AFA) },
+        { RAPIDJSON_UINT64_C2(0xC646D635, 0x01A1511D), RAPIDJSON_UINT64_C2(0xB281E1FD, 0x541501B8) },
+        { RAPIDJSON_UINT64_C2(0xF7D88BC2, 0x4209A565), RAPIDJSON_UINT64_C2(0x1F225A7C, 0xA91A4226) },
+        { RAPIDJSON_UINT64_C2(0x9AE75759, 0x6946075F), RAPIDJSON_UINT64_C2(0x3375788D, 0xE9B06958) },
+        { RAPIDJSON_UINT64_C2(0xC1A12D2F, 0xC3978937), RAPIDJSON_UINT64_C2(0x0052D6B1, 0x641C83AE) },
+        { RAPIDJSON_UINT64_C2(0xF209787B, 0xB47D6B84), RAPIDJSON_UINT64_C2(0xC0678C5D, 0xBD23A49A) },
+        { RAPIDJSON_UINT64_C2(0x9745EB4D, 0x50CE6332), RAPIDJSON_UINT64_C2(0xF840B7BA, 0x963646E0) },
+        { RAPIDJSON_UINT64_C2(0xBD176620, 0xA501FBFF), RAPIDJSON_UINT64_C2(0xB650E5A9, 0x3BC3D898) },
+        { RAPIDJSON_UINT64_C2(0xEC5D3FA8, 0xCE427AFF), RAPIDJSON_UINT64_C2(0xA3E51F13, 0x8AB4CEBE) },
+        { RAPIDJSON_UINT64_C2(0x93BA47C9, 0x80E98CDF), RAPIDJSON_UINT64_C2(0xC66F336C, 0x36B10137) },
+        { RAPIDJSON_UINT64_C2(0xB8A8D9BB, 0xE123F017), RAPIDJSON_UINT64_C2(0xB80B0047, 0x445D4184) },
+        { RAPIDJSON_UINT64_C2(0xE6D3102A, 0xD96CEC1D), RAPIDJSON_UINT64_C2(0xA60DC059, 0x157491E5) },
+        { RAPIDJSON_UINT64_C2(0x9043EA1A, 0xC7E41392), RAPIDJSON_UINT64_C2(0x87C89837, 0xAD68DB2F) },
+        { RAPIDJSON_UINT64_C2(0xB454E4A1, 0x79DD1877), RAPIDJSON_UINT64_C2(0x29BABE45, 0x98C311FB) },
+        { RAPIDJSON_UINT64_C2(0xE16A1DC9, 0xD8545E94), RAPIDJSON_UINT64_C2(0xF4296DD6, 0xFEF3D67A) },
+        { RAPIDJSON_UINT64_C2(0x8CE2529E, 0x2734BB1D), RAPIDJSON_UINT64_C2(0x1899E4A6, 0x5F58660C) },
+        { RAPIDJSON_UINT64_C2(0xB01AE745, 0xB101E9E4), RAPIDJSON_UINT64_C2(0x5EC05DCF, 0xF72E7F8F) },
+        { RAPIDJSON_UINT64_C2(0xDC21A117, 0x1D42645D), RAPIDJSON_UINT64_C2(0x76707543, 0xF4FA1F73) },
+        { RAPIDJSON_UINT64_C2(0x899504AE, 0x72497EBA), RAPIDJSON_UINT64_C2(0x6A06494A, 0x791C53A8) },
+        { RAPIDJSON_UINT64_C2(0xABFA45DA, 0x0EDBDE69), RAPIDJSON_UINT64_C2(0x0487DB9D, 0x17636892) },
+        { RAPIDJSON_UINT64_C2(0xD6F8D750, 0x9292D603), RAPIDJSON_UINT64_C2(0x45A9D284, 0x5D3C42B6) },
+        { RAPIDJSON_UINT64_C2(0x865B8692, 0x5B9BC5C2), RAPIDJSON_UINT64_C2(0x0B8A2392, 0xBA45A9B2) },
+        { RAPIDJSON_UINT64_C2(0xA7F26836, 0xF282B732), RAPIDJSON_UINT64_C2(0x8E6CAC77, 0x68D7141E) },
+        { RAPIDJSON_UINT64_C2(0xD1EF0244, 0xAF2364FF), RAPIDJSON_UINT64_C2(0x3207D795, 0x430CD926) },
+        { RAPIDJSON_UINT64_C2(0x8335616A, 0xED761F1F), RAPIDJSON_UINT64_C2(0x7F44E6BD, 0x49E807B8) },
+        { RAPIDJSON_UINT64_C2(0xA402B9C5, 0xA8D3A6E7), RAPIDJSON_UINT64_C2(0x5F16206C, 0x9C6209A6) },
+        { RAPIDJSON_UINT64_C2(0xCD036837, 0x130890A1), RAPIDJSON_UINT64_C2(0x36DBA887, 0xC37A8C0F) },
+        { RAPIDJSON_UINT64_C2(0x80222122, 0x6BE55A64), RAPIDJSON_UINT64_C2(0xC2494954, 0xDA2C9789) },
+        { RAPIDJSON_UINT64_C2(0xA02AA96B, 0x06DEB0FD), RAPIDJSON_UINT64_C2(0xF2DB9BAA, 0x10B7BD6C) },
+        { RAPIDJSON_UINT64_C2(0xC83553C5, 0xC8965D3D), RAPIDJSON_UINT64_C2(0x6F928294, 0x94E5ACC7) },
+        { RAPIDJSON_UINT64_C2(0xFA42A8B7, 0x3ABBF48C), RAPIDJSON_UINT64_C2(0xCB772339, 0xBA1F17F9) },
+        { RAPIDJSON_UINT64_C2(0x9C69A972, 0x84B578D7), RAPIDJSON_UINT64_C2(0xFF2A7604, 0x14536EFB) },
+        { RAPIDJSON_UINT64_C2(0xC38413CF, 0x25E2D70D), RAPIDJSON_UINT64_C2(0xFEF51385, 0x19684ABA) },
+        { RAPIDJSON_UINT64_C2(0xF46518C2, 0xEF5B8CD1), RAPIDJSON_UINT64_C2(0x7EB25866, 0x5FC25D69) },
+        { RAPIDJSON_UINT64_C2(0x98BF2F79, 0xD5993802), RAPIDJSON_UINT64_C2(0xEF2F773F, 0xFBD97A61) },
+        { RAPIDJSON_UINT64_C2(0xBEEEFB58, 0x4AFF8603), RAPIDJSON_UINT64_C2(0xAAFB550F, 0xFACFD8FA) },
+        { RAPIDJSON_UINT64_C2(0xEEAABA2E, 0x5DBF6784), RAPIDJSON_UINT64_C2(0x95BA2A53, 0xF983CF38) },
+        { RAPIDJSON_UINT64_C2(0x952AB45C, 0xFA97A0B2), RAPIDJSON_UINT64_C2(0xDD945A74, 0x7BF26183) },
+        { RAPIDJSON_UINT64_C2(0xBA756174, 0x393D88DF), RAPIDJSON_UINT64_C2(0x94F97111, 0x9AEEF9E4) },
+        { RAPIDJSON_UINT64_C2(0xE912B9D1, 0x478CEB17), RAPIDJSON_UINT64_C2(0x7A37CD56, 0x01AAB85D) },
+        { RAPIDJSON_UINT64_C2(0x91ABB422, 0xCCB812EE), RAPIDJSON_UINT64_C2(0xAC62E055, 0xC10AB33A) },
+        { RAPIDJSON_UINT64_C2(0xB616A12B, 0x7FE617AA), RAPIDJSON_UINT64_C2(0x577B986B, 0x314D6009) },
+        { RAPIDJSON_UINT64_C2(0xE39C4976, 0x5FDF9D94), RAPIDJSON_UINT64_C2(0xED5A7E85, 0xFDA0B80B) },
+        { RAPIDJSON_UINT64_C2(0x8E41ADE9, 0xFBEBC27D), RAPIDJSON_UINT64_C2(0x14588F13, 0xBE847307) },
+        { RAPIDJSON_UINT64_C2(0xB1D21964, 0x7AE6B31C), RAPIDJSON_UINT64_C2(0x596EB2D8, 0xAE258FC8) },
+        { RAPIDJSON_UINT64_C2(0xDE469FBD, 0x99A05FE3), RAPIDJSON_UINT64_C2(0x6FCA5F8E, 0xD9AEF3BB) },
+        { RAPIDJSON_UINT64_C2(0x8AEC23D6, 0x80043BEE), RAPIDJSON_UINT64_C2(0x25DE7BB9, 0x480D5854) },
+        { RAPIDJSON_UINT64_C2(0xADA72CCC, 0x20054AE9), RAPIDJSON_UINT64_C2(0xAF561AA7, 0x9A10AE6A) },
+        { RAPIDJSON_UINT64_C2(0xD910F7FF, 0x28069DA4), RAPIDJSON_UINT64_C2(0x1B2BA151, 0x8094DA04) },
+        { RAPIDJSON_UINT64_C2(0x87AA9AFF, 0x79042286), RAPIDJSON_UINT64_C2(0x90FB44D2, 0xF05D0842) },
+        { RAPIDJSON_UINT64_C2(0xA99541BF, 0x57452B28), RAPIDJSON_UINT64_C2(0x353A1607, 0xAC744A53) },
+        { RAPIDJSON_UINT64_C2(0xD3FA922F, 0x2D1675F2), RAPIDJSON_UINT64_C2(0x42889B89, 0x97915CE8) },
+        { RAPIDJSON_UINT64_C2(0x847C9B5D, 0x7C2E09B7), RAPIDJSON_UINT64_C2(0x69956135, 0xFEBADA11) },
+        { RAPIDJSON_UINT64_C2(0xA59BC234, 0xDB398C25), RAPIDJSON_UINT64_C2(0x43FAB983, 0x7E699095) },
+        { RAPIDJSON_UINT64_C2(0xCF02B2C2, 0x1207EF2E), RAPIDJSON_UINT64_C2(0x94F967E4, 0x5E03F4BB) },
+        { RAPIDJSON_UINT64_C2(0x8161AFB9, 0x4B44F57D), RAPIDJSON_UINT64_C2(0x1D1BE0EE, 0xBAC278F5) },
+        { RAPIDJSON_UINT64_C2(0xA1BA1BA7, 0x9E1632DC), RAPIDJSON_UINT64_C2(0x6462D92A, 0x69731732) },
+        { RAPIDJSON_UINT64_C2(0xCA28A291, 0x859BBF93), RAPIDJSON_UINT64_C2(0x7D7B8F75, 0x03CFDCFE) },
+        { RAPIDJSON_UINT64_C2(0xFCB2CB35, 0xE702AF78), RAPIDJSON_UINT64_C2(0x5CDA7352, 0x44C3D43E) },
+        { RAPIDJSON_UINT64_C2(0x9DEFBF01, 0xB061ADAB), RAPIDJSON_UINT64_C2(0x3A088813, 0x6AFA64A7) },
+        { RAPIDJSON_UINT64_C2(0xC56BAEC2, 0x1C7A1916), RAPIDJSON_UINT64_C2(0x088AAA18, 0x45B8FDD0) },
+        { RAPIDJSON_UINT64_C2(0xF6C69A72, 0xA3989F5B), RAPIDJSON_UINT64_C2(0x8AAD549E, 0x57273D45) },
+        { RAPIDJSON_UINT64_C2(0x9A3C2087, 0xA63F6399), RAPIDJSON_UINT64_C2(0x36AC54E2, 0xF678864B) },
+        { RAPIDJSON_UINT64_C2(0xC0CB28A9, 0x8FCF3C7F), RAPIDJSON_UINT64_C2(0x84576A1B, 0xB416A7DD) },
+        { RAPIDJSON_UINT64_C2(0xF0FDF2D3, 0xF3C30B9F), RAPIDJSON_UINT64_C2(0x656D44A2, 0xA11C51D5) },
+        { RAPIDJSON_UINT64_C2(0x969EB7C4, 0x7859E743), RAPIDJSON_UINT64_C2(0x9F644AE5, 0xA4B1B325) },
+        { RAPIDJSON_UINT64_C2(0xBC4665B5, 0x96706114), RAPIDJSON_UINT64_C2(0x873D5D9F, 0x0DDE1FEE) },
+        { RAPIDJSON_UINT64_C2(0xEB57FF22, 0xFC0C7959), RAPIDJSON_UINT64_C2(0xA90CB506, 0xD155A7EA) },
+        { RAPIDJSON_UINT64_C2(0x9316FF75, 0xDD87CBD8), RAPIDJSON_UINT64_C2(0x09A7F124, 0x42D588F2) },
+        { RAPIDJSON_UINT64_C2(0xB7DCBF53, 0x54E9BECE), RAPIDJSON_UINT64_C2(0x0C11ED6D, 0x538AEB2F) },
+        { RAPIDJSON_UINT64_C2(0xE5D3EF28, 0x2A242E81), RAPIDJSON_UINT64_C2(0x8F1668C8, 0xA86DA5FA) },
+        { RAPIDJSON_UINT64_C2(0x8FA47579, 0x1A569D10), RAPIDJSON_UINT64_C2(0xF96E017D, 0x694487BC) },
+        { RAPIDJSON_UINT64_C2(0xB38D92D7, 0x60EC4455), RAPIDJSON_UINT64_C2(0x37C981DC, 0xC395A9AC) },
+        { RAPIDJSON_UINT64_C2(0xE070F78D, 0x3927556A), RAPIDJSON_UINT64_C2(0x85BBE253, 0xF47B1417) },
+        { RAPIDJSON_UINT64_C2(0x8C469AB8, 0x43B89562), RAPIDJSON_UINT64_C2(0x93956D74, 0x78CCEC8E) },
+        { RAPIDJSON_UINT64_C2(0xAF584166, 0x54A6BABB), RAPIDJSON_UINT64_C2(0x387AC8D1, 0x970027B2) },
+        { RAPIDJSON_UINT64_C2(0xDB2E51BF, 0xE9D0696A), RAPIDJSON_UINT64_C2(0x06997B05, 0xFCC0319E) },
+        { RAPIDJSON_UINT64_C2(0x88FCF317, 0xF22241E2), RAPIDJSON_UINT64_C2(0x441FECE3, 0xBDF81F03) },
+        { RAPIDJSON_UINT64_C2(0xAB3C2FDD, 0xEEAAD25A), RAPIDJSON_UINT64_C2(0xD527E81C, 0xAD7626C3) },
+        { RAPIDJSON_UINT64_C2(0xD60B3BD5, 0x6A5586F1), RAPIDJSON_UINT64_C2(0x8A71E223, 0xD8D3B074) },
+        { RAPIDJSON_UINT64_C2(0x85C70565, 0x62757456), RAPIDJSON_UINT64_C2(0xF6872D56, 0x67844E49) },
+        { RAPIDJSON_UINT64_C2(0xA738C6BE, 0xBB12D16C), RAPIDJSON_UINT64_C2(0xB428F8AC, 0x016561DB) },
+        { RAPIDJSON_UINT64_C2(0xD106F86E, 0x69D785C7), RAPIDJSON_UINT64_C2(0xE13336D7, 0x01BEBA52) },
+        { RAPIDJSON_UINT64_C2(0x82A45B45, 0x0226B39C), RAPIDJSON_UINT64_C2(0xECC00246, 0x61173473) },
+        { RAPIDJSON_UINT64_C2(0xA34D7216, 0x42B06084), RAPIDJSON_UINT64_C2(0x27F002D7, 0xF95D0190) },
+        { RAPIDJSON_UINT64_C2(0xCC20CE9B, 0xD35C78A5), RAPIDJSON_UINT64_C2(0x31EC038D, 0xF7B441F4) },
+        { RAPIDJSON_UINT64_C2(0xFF290242, 0xC83396CE), RAPIDJSON_UINT64_C2(0x7E670471, 0x75A15271) },
+        { RAPIDJSON_UINT64_C2(0x9F79A169, 0xBD203E41), RAPIDJSON_UINT64_C2(0x0F0062C6, 0xE984D386) },
+        { RAPIDJSON_UINT64_C2(0xC75809C4, 0x2C684DD1), RAPIDJSON_UINT64_C2(0x52C07B78, 0xA3E60868) },
+        { RAPIDJSON_UINT64_C2(0xF92E0C35, 0x37826145), RAPIDJSON_UINT64_C2(0xA7709A56, 0xCCDF8A82) },
+        { RAPIDJSON_UINT64_C2(0x9BBCC7A1, 0x42B17CCB), RAPIDJSON_UINT64_C2(0x88A66076, 0x400BB691) },
+        { RAPIDJSON_UINT64_C2(0xC2ABF989, 0x935DDBFE), RAPIDJSON_UINT64_C2(0x6ACFF893, 0xD00EA435) },
+        { RAPIDJSON_UINT64_C2(0xF356F7EB, 0xF83552FE), RAPIDJSON_UINT64_C2(0x0583F6B8, 0xC4124D43) },
+        { RAPIDJSON_UINT64_C2(0x98165AF3, 0x7B2153DE), RAPIDJSON_UINT64_C2(0xC3727A33, 0x7A8B704A) },
+        { RAPIDJSON_UINT64_C2(0xBE1BF1B0, 0x59E9A8D6), RAPIDJSON_UINT64_C2(0x744F18C0, 0x592E4C5C) },
+        { RAPIDJSON_UINT64_C2(0xEDA2EE1C, 0x7064130C), RAPIDJSON_UINT64_C2(0x1162DEF0, 0x6F79DF73) },
+        { RAPIDJSON_UINT64_C2(0x9485D4D1, 0xC63E8BE7), RAPIDJSON_UINT64_C2(0x8ADDCB56, 0x45AC2BA8) },
+        { RAPIDJSON_UINT64_C2(0xB9A74A06, 0x37CE2EE1), RAPIDJSON_UINT64_C2(0x6D953E2B, 0xD7173692) },
+        { RAPIDJSON_UINT64_C2(0xE8111C87, 0xC5C1BA99), RAPIDJSON_UINT64_C2(0xC8FA8DB6, 0xCCDD0437) },
+        { RAPIDJSON_UINT64_C2(0x910AB1D4, 0xDB9914A0), RAPIDJSON_UINT64_C2(0x1D9C9892, 0x400A22A2) },
+        { RAPIDJSON_UINT64_C2(0xB54D5E4A, 0x127F59C8), RAPIDJSON_UINT64_C2(0x2503BEB6, 0xD00CAB4B) },
+        { RAPIDJSON_UINT64_C2(0xE2A0B5DC, 0x971F303A), RAPIDJSON_UINT64_C2(0x2E44AE64, 0x840FD61D) },
+        { RAPIDJSON_UINT64_C2(0x8DA471A9, 0xDE737E24), RAPIDJSON_UINT64_C2(0x5CEAECFE, 0xD289E5D2) },
+        { RAPIDJSON_UINT64_C2(0xB10D8E14, 0x56105DAD), RAPIDJSON_UINT64_C2(0x7425A83E, 0x872C5F47) },
+        { RAPIDJSON_UINT64_C2(0xDD50F199, 0x6B947518), RAPIDJSON_UINT64_C2(0xD12F124E, 0x28F77719) },
+        { RAPIDJSON_UINT64_C2(0x8A5296FF, 0xE33CC92F), RAPIDJSON_UINT64_C2(0x82BD6B70, 0xD99AAA6F) },
+        { RAPIDJSON_UINT64_C2(0xACE73CBF, 0xDC0BFB7B), RAPIDJSON_UINT64_C2(0x636CC64D, 0x1001550B) },
+        { RAPIDJSON_UINT64_C2(0xD8210BEF, 0xD30EFA5A), RAPIDJSON_UINT64_C2(0x3C47F7E0, 0x5401AA4E) },
+        { RAPIDJSON_UINT64_C2(0x8714A775, 0xE3E95C78), RAPIDJSON_UINT64_C2(0x65ACFAEC, 0x34810A71) },
+        { RAPIDJSON_UINT64_C2(0xA8D9D153, 0x5CE3B396), RAPIDJSON_UINT64_C2(0x7F1839A7, 0x41A14D0D) },
+        { RAPIDJSON_UINT64_C2(0xD31045A8, 0x341CA07C), RAPIDJSON_UINT64_C2(0x1EDE4811, 0x1209A050) },
+        { RAPIDJSON_UINT64_C2(0x83EA2B89, 0x2091E44D), RAPIDJSON_UINT64_C2(0x934AED0A, 0xAB460432) },
+        { RAPIDJSON_UINT64_C2(0xA4E4B66B, 0x68B65D60), RAPIDJSON_UINT64_C2(0xF81DA84D, 0x5617853F) },
+        { RAPIDJSON_UINT64_C2(0xCE1DE406, 0x42E3F4B9), RAPIDJSON_UINT64_C2(0x36251260, 0xAB9D668E) },
+        { RAPIDJSON_UINT64_C2(0x80D2AE83, 0xE9CE78F3), RAPIDJSON_UINT64_C2(0xC1D72B7C, 0x6B426019) },
+        { RAPIDJSON_UINT64_C2(0xA1075A24, 0xE4421730), RAPIDJSON_UINT64_C2(0xB24CF65B, 0x8612F81F) },
+        { RAPIDJSON_UINT64_C2(0xC94930AE, 0x1D529CFC), RAPIDJSON_UINT64_C2(0xDEE033F2, 0x6797B627) },
+        { RAPIDJSON_UINT64_C2(0xFB9B7CD9, 0xA4A7443C), RAPIDJSON_UINT64_C2(0x169840EF, 0x017DA3B1) },
+        { RAPIDJSON_UINT64_C2(0x9D412E08, 0x06E88AA5), RAPIDJSON_UINT64_C2(0x8E1F2895, 0x60EE864E) },
+        { RAPIDJSON_UINT64_C2(0xC491798A, 0x08A2AD4E), RAPIDJSON_UINT64_C2(0xF1A6F2BA, 0xB92A27E2) },
+        { RAPIDJSON_UINT64_C2(0xF5B5D7EC, 0x8ACB58A2), RAPIDJSON_UINT64_C2(0xAE10AF69, 0x6774B1DB) },
+        { RAPIDJSON_UINT64_C2(0x9991A6F3, 0xD6BF1765), RAPIDJSON_UINT64_C2(0xACCA6DA1, 0xE0A8EF29) },
+        { RAPIDJSON_UINT64_C2(0xBFF610B0, 0xCC6EDD3F), RAPIDJSON_UINT64_C2(0x17FD090A, 0x58D32AF3) },
+        { RAPIDJSON_UINT64_C2(0xEFF394DC, 0xFF8A948E), RAPIDJSON_UINT64_C2(0xDDFC4B4C, 0xEF07F5B0) },
+        { RAPIDJSON_UINT64_C2(0x95F83D0A, 0x1FB69CD9), RAPIDJSON_UINT64_C2(0x4ABDAF10, 0x1564F98E) },
+        { RAPIDJSON_UINT64_C2(0xBB764C4C, 0xA7A4440F), RAPIDJSON_UINT64_C2(0x9D6D1AD4, 0x1ABE37F1) },
+        { RAPIDJSON_UINT64_C2(0xEA53DF5F, 0xD18D5513), RAPIDJSON_UINT64_C2(0x84C86189, 0x216DC5ED) },
+        { RAPIDJSON_UINT64_C2(0x92746B9B, 0xE2F8552C), RAPIDJSON_UINT64_C2(0x32FD3CF5, 0xB4E49BB4) },
+        { RAPIDJSON_UINT64_C2(0xB7118682, 0xDBB66A77), RAPIDJSON_UINT64_C2(0x3FBC8C33, 0x221DC2A1) },
+        { RAPIDJSON_UINT64_C2(0xE4D5E823, 0x92A40515), RAPIDJSON_UINT64_C2(0x0FABAF3F, 0xEAA5334A) },
+        { RAPIDJSON_UINT64_C2(0x8F05B116, 0x3BA6832D), RAPIDJSON_UINT64_C2(0x29CB4D87, 0xF2A7400E) },
+        { RAPIDJSON_UINT64_C2(0xB2C71D5B, 0xCA9023F8), RAPIDJSON_UINT64_C2(0x743E20E9, 0xEF511012) },
+        { RAPIDJSON_UINT64_C2(0xDF78E4B2, 0xBD342CF6), RAPIDJSON_UINT64_C2(0x914DA924, 0x6B255416) },
+        { RAPIDJSON_UINT64_C2(0x8BAB8EEF, 0xB6409C1A), RAPIDJSON_UINT64_C2(0x1AD089B6, 0xC2F7548E) },
+        { RAPIDJSON_UINT64_C2(0xAE9672AB, 0xA3D0C320), RAPIDJSON_UINT64_C2(0xA184AC24, 0x73B529B1) },
+        { RAPIDJSON_UINT64_C2(0xDA3C0F56, 0x8CC4F3E8), RAPIDJSON_UINT64_C2(0xC9E5D72D, 0x90A2741E) },
+        { RAPIDJSON_UINT64_C2(0x88658996, 0x17FB1871), RAPIDJSON_UINT64_C2(0x7E2FA67C, 0x7A658892) },
+        { RAPIDJSON_UINT64_C2(0xAA7EEBFB, 0x9DF9DE8D), RAPIDJSON_UINT64_C2(0xDDBB901B, 0x98FEEAB7) },
+        { RAPIDJSON_UINT64_C2(0xD51EA6FA, 0x85785631), RAPIDJSON_UINT64_C2(0x552A7422, 0x7F3EA565) },
+        { RAPIDJSON_UINT64_C2(0x8533285C, 0x936B35DE), RAPIDJSON_UINT64_C2(0xD53A8895, 0x8F87275F) },
+        { RAPIDJSON_UINT64_C2(0xA67FF273, 0xB8460356), RAPIDJSON_UINT64_C2(0x8A892ABA, 0xF368F137) },
+        { RAPIDJSON_UINT64_C2(0xD01FEF10, 0xA657842C), RAPIDJSON_UINT64_C2(0x2D2B7569, 0xB0432D85) },
+        { RAPIDJSON_UINT64_C2(0x8213F56A, 0x67F6B29B), RAPIDJSON_UINT64_C2(0x9C3B2962, 0x0E29FC73) },
+        { RAPIDJSON_UINT64_C2(0xA298F2C5, 0x01F45F42), RAPIDJSON_UINT64_C2(0x8349F3BA, 0x91B47B8F) },
+        { RAPIDJSON_UINT64_C2(0xCB3F2F76, 0x42717713), RAPIDJSON_UINT64_C2(0x241C70A9, 0x36219A73) },
+        { RAPIDJSON_UINT64_C2(0xFE0EFB53, 0xD30DD4D7), RAPIDJSON_UINT64_C2(0xED238CD3, 0x83AA0110) },
+        { RAPIDJSON_UINT64_C2(0x9EC95D14, 0x63E8A506), RAPIDJSON_UINT64_C2(0xF4363804, 0x324A40AA) },
+        { RAPIDJSON_UINT64_C2(0xC67BB459, 0x7CE2CE48), RAPIDJSON_UINT64_C2(0xB143C605, 0x3EDCD0D5) },
+        { RAPIDJSON_UINT64_C2(0xF81AA16F, 0xDC1B81DA), RAPIDJSON_UINT64_C2(0xDD94B786, 0x8E94050A) },
+        { RAPIDJSON_UINT64_C2(0x9B10A4E5, 0xE9913128), RAPIDJSON_UINT64_C2(0xCA7CF2B4, 0x191C8326) },
+        { RAPIDJSON_UINT64_C2(0xC1D4CE1F, 0x63F57D72), RAPIDJSON_UINT64_C2(0xFD1C2F61, 0x1F63A3F0) },
+        { RAPIDJSON_UINT64_C2(0xF24A01A7, 0x3CF2DCCF), RAPIDJSON_UINT64_C2(0xBC633B39, 0x673C8CEC) },
+        { RAPIDJSON_UINT64_C2(0x976E4108, 0x8617CA01), RAPIDJSON_UINT64_C2(0xD5BE0503, 0xE085D813) },
+        { RAPIDJSON_UINT64_C2(0xBD49D14A, 0xA79DBC82), RAPIDJSON_UINT64_C2(0x4B2D8644, 0xD8A74E18) },
+        { RAPIDJSON_UINT64_C2(0xEC9C459D, 0x51852BA2), RAPIDJSON_UINT64_C2(0xDDF8E7D6, 0x0ED1219E) },
+        { RAPIDJSON_UINT64_C2(0x93E1AB82, 0x52F33B45), RAPIDJSON_UINT64_C2(0xCABB90E5, 0xC942B503) },
+        { RAPIDJSON_UINT64_C2(0xB8DA1662, 0xE7B00A17), RAPIDJSON_UINT64_C2(0x3D6A751F, 0x3B936243) },
+        { RAPIDJSON_UINT64_C2(0xE7109BFB, 0xA19C0C9D), RAPIDJSON_UINT64_C2(0x0CC51267, 0x0A783AD4) },
+        { RAPIDJSON_UINT64_C2(0x906A617D, 0x450187E2), RAPIDJSON_UINT64_C2(0x27FB2B80, 0x668B24C5) },
+        { RAPIDJSON_UINT64_C2(0xB484F9DC, 0x9641E9DA), RAPIDJSON_UINT64_C2(0xB1F9F660, 0x802DEDF6) },
+        { RAPIDJSON_UINT64_C2(0xE1A63853, 0xBBD26451), RAPIDJSON_UINT64_C2(0x5E7873F8, 0xA0396973) },
+        { RAPIDJSON_UINT64_C2(0x8D07E334, 0x55637EB2), RAPIDJSON_UINT64_C2(0xDB0B487B, 0x6423E1E8) },
+        { RAPIDJSON_UINT64_C2(0xB049DC01, 0x6ABC5E5F), RAPIDJSON_UINT64_C2(0x91CE1A9A, 0x3D2CDA62) },
+        { RAPIDJSON_UINT64_C2(0xDC5C5301, 0xC56B75F7), RAPIDJSON_UINT64_C2(0x7641A140, 0xCC7810FB) },
+        { RAPIDJSON_UINT64_C2(0x89B9B3E1, 0x1B6329BA), RAPIDJSON_UINT64_C2(0xA9E904C8, 0x7FCB0A9D) },
+        { RAPIDJSON_UINT64_C2(0xAC2820D9, 0x623BF429), RAPIDJSON_UINT64_C2(0x546345FA, 0x9FBDCD44) },
+        { RAPIDJSON_UINT64_C2(0xD732290F, 0xBACAF133), RAPIDJSON_UINT64_C2(0xA97C1779, 0x47AD4095) },
+        { RAPIDJSON_UINT64_C2(0x867F59A9, 0xD4BED6C0), RAPIDJSON_UINT64_C2(0x49ED8EAB, 0xCCCC485D) },
+        { RAPIDJSON_UINT64_C2(0xA81F3014, 0x49EE8C70), RAPIDJSON_UINT64_C2(0x5C68F256, 0xBFFF5A74) },
+        { RAPIDJSON_UINT64_C2(0xD226FC19, 0x5C6A2F8C), RAPIDJSON_UINT64_C2(0x73832EEC, 0x6FFF3111) },
+        { RAPIDJSON_UINT64_C2(0x83585D8F, 0xD9C25DB7), RAPIDJSON_UINT64_C2(0xC831FD53, 0xC5FF7EAB) },
+        { RAPIDJSON_UINT64_C2(0xA42E74F3, 0xD032F525), RAPIDJSON_UINT64_C2(0xBA3E7CA8, 0xB77F5E55) },
+        { RAPIDJSON_UINT64_C2(0xCD3A1230, 0xC43FB26F), RAPIDJSON_UINT64_C2(0x28CE1BD2, 0xE55F35EB) },
+        { RAPIDJSON_UINT64_C2(0x80444B5E, 0x7AA7CF85), RAPIDJSON_UINT64_C2(0x7980D163, 0xCF5B81B3) },
+        { RAPIDJSON_UINT64_C2(0xA0555E36, 0x1951C366), RAPIDJSON_UINT64_C2(0xD7E105BC, 0xC332621F) },
+        { RAPIDJSON_UINT64_C2(0xC86AB5C3, 0x9FA63440), RAPIDJSON_UINT64_C2(0x8DD9472B, 0xF3FEFAA7) },
+        { RAPIDJSON_UINT64_C2(0xFA856334, 0x878FC150), RAPIDJSON_UINT64_C2(0xB14F98F6, 0xF0FEB951) },
+        { RAPIDJSON_UINT64_C2(0x9C935E00, 0xD4B9D8D2), RAPIDJSON_UINT64_C2(0x6ED1BF9A, 0x569F33D3) },
+        { RAPIDJSON_UINT64_C2(0xC3B83581, 0x09E84F07), RAPIDJSON_UINT64_C2(0x0A862F80, 0xEC4700C8) },
+        { RAPIDJSON_UINT64_C2(0xF4A642E1, 0x4C6262C8), RAPIDJSON_UINT64_C2(0xCD27BB61, 0x2758C0FA) },
+        { RAPIDJSON_UINT64_C2(0x98E7E9CC, 0xCFBD7DBD), RAPIDJSON_UINT64_C2(0x8038D51C, 0xB897789C) },
+        { RAPIDJSON_UINT64_C2(0xBF21E440, 0x03ACDD2C), RAPIDJSON_UINT64_C2(0xE0470A63, 0xE6BD56C3) },
+        { RAPIDJSON_UINT64_C2(0xEEEA5D50, 0x04981478), RAPIDJSON_UINT64_C2(0x1858CCFC, 0xE06CAC74) },
+        { RAPIDJSON_UINT64_C2(0x95527A52, 0x02DF0CCB), RAPIDJSON_UINT64_C2(0x0F37801E, 0x0C43EBC8) },
+        { RAPIDJSON_UINT64_C2(0xBAA718E6, 0x8396CFFD), RAPIDJSON_UINT64_C2(0xD3056025, 0x8F54E6BA) },
+        { RAPIDJSON_UINT64_C2(0xE950DF20, 0x247C83FD), RAPIDJSON_UINT64_C2(0x47C6B82E, 0xF32A2069) },
+        { RAPIDJSON_UINT64_C2(0x91D28B74, 0x16CDD27E), RAPIDJSON_UINT64_C2(0x4CDC331D, 0x57FA5441) },
+        { RAPIDJSON_UINT64_C2(0xB6472E51, 0x1C81471D), RAPIDJSON_UINT64_C2(0xE0133FE4, 0xADF8E952) },
+        { RAPIDJSON_UINT64_C2(0xE3D8F9E5, 0x63A198E5), RAPIDJSON_UINT64_C2(0x58180FDD, 0xD97723A6) },
+        { RAPIDJSON_UINT64_C2(0x8E679C2F, 0x5E44FF8F), RAPIDJSON_UINT64_C2(0x570F09EA, 0xA7EA7648) }
+    };
+    RAPIDJSON_ASSERT(q >= -342 && q <= 308);
+    return kPow5[q + 342];
+}
+
+//! Returns the low 64 bits of a * b, and the high ones in high.
+inline uint64_t EiselLemireMul128(uint64_t a, uint64_t b, uint64_t* high) {
+#if defined(_MSC_VER) && defined(_M_AMD64)
+    return _umul128(a, b, high);
+#elif defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)) && defined(__x86_64__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 p = static_cast<uint128>(a) * static_cast<uint128>(b);
+    *high = static_cast<uint64_t>(p >> 64);
+    return static_cast<uint64_t>(p);
+#else
+    const uint64_t M32 = 0xFFFFFFFF;
+    const uint64_t a0 = a & M32, a1 = a >> 32, b0 = b & M32, b1 = b >> 32;
+    const uint64_t x00 = a0 * b0, x01 = a0 * b1, x10 = a1 * b0, x11 = a1 * b1;
+    const uint64_t mid = (x00 >> 32) + (x01 & M32) + (x10 & M32);
+    *high = x11 + (x01 >> 32) + (x10 >> 32) + (mid >> 32);
+    return (x00 & M32) | (mid << 32);
+#endif
+}
+
+//! Computes the double nearest to w * 10^q, rounded to even.
+/*! \param w Decimal significand, not zero.
+    \param q Decimal exponent in [-342, 308].
+*/
+inline double EiselLemire(uint64_t w, int q) {
+    RAPIDJSON_ASSERT(w != 0);
+    const int kMantissaBits = 52;
+
+    // Normalized w times the 128 most significant bits of 5^q
+    const int lz = static_cast<int>(clzll(w));
+    w <<= lz;
+    const uint64_t* pow5 = EiselLemirePow5(q);
+    uint64_t high;
+    uint64_t low = EiselLemireMul128(w, pow5[0], &high);
+    if ((high & 0x1FF) == 0x1FF) { // The 55 bits needed may be off by one: add the next 64 bits of 5^q
+        uint64_t high2;
+        EiselLemireMul128(w, pow5[1], &high2);
+        low += high2;
+        if (high2 > low)
+            ++high;
+    }
+
+    // 54 bits, one for rounding
+    const int upperBit = static_cast<int>(high >> 63);
+    const int shift = upperBit + 64 - kMantissaBits - 3;
+    uint64_t mantissa = high >> shift;
+    // floor(log2(10^q)) + 63, biased
+    int power2 = (((152170 + 65536) * q) >> 16) + 63 + upperBit - lz + 1023;
+
+    if (power2 <= 0) { // Subnormal, no tie to round to even at such small powers
+        if (-power2 + 1 >= 64)
+            return 0.0;
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        // The mantissa may have been rounded up to the smallest normal
+        power2 = mantissa < (static_cast<uint64_t>(1) << kMantissaBits) ? 0 : 1;
+        return Double((static_cast<uint64_t>(power2) << kMantissaBits) | mantissa).Value();
+    }
+
+    // An exact tie, only possible for small powers, rounds down to even
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == high)
+        mantissa &= ~static_cast<uint64_t>(1);
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (static_cast<uint64_t>(2) << kMantissaBits)) {
+        mantissa = static_cast<uint64_t>(1) << kMantissaBits;
+        power2++;
+    }
+    mantissa &= ~(static_cast<uint64_t>(1) << kMantissaBits);
+    if (power2 >= 0x7FF)
+        return std::numeric_limits<double>::infinity();
+    return Double((static_cast<uint64_t>(power2) << kMantissaBits) | mantissa).Value();
+}
+
+} // namespace internal
+RAPIDJSON_NAMESPACE_END
+
+#endif // RAPIDJSON_EISELLEMIRE_
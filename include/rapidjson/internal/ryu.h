@@ -0,0 +1,941 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+// 
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed 
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR 
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the 
+// specific language governing permissions and limitations under the License.
+
+// This is a C++ header-only implementation of the Ryu algorithm from the publication:
+// Adams, Ulf. "Ryu: fast float-to-string conversion." Proceedings of the 39th ACM
+// SIGPLAN Conference on Programming Language Design and Implementation (2018): 270-282.
+
+#ifndef RAPIDJSON_RYU_
+#define RAPIDJSON_RYU_
+
+#include "dtoa.h" // Prettify()
+
+#if defined(_MSC_VER) && defined(_M_AMD64) && !defined(__INTEL_COMPILER)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#pragma intrinsic(__shiftright128)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+namespace internal {
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+//! Bits of the multipliers in the tables below, besides those of 5^q or 5^-q.
+static const int kRyuPow5InvBitCount = 125;
+static const int kRyuPow5BitCount = 125;
+
+//! Returns floor(2^k / 5^q) + 1 for k = ceil(log2(5^q)) - 1 + 125, as { low, high }.
+inline const uint64_t* RyuPow5InvSplit(int q) {
+    // Generated with exact integer arithmetic, for q in [0, 290]
+    static const uint64_t kPow5InvSplit[291][2] = {
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000001), RAPIDJSON_UINT64_C2(0x20000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x99999999, 0x9999999A), RAPIDJSON_UINT64_C2(0x19999999, 0x99999999) },
+        { RAPIDJSON_UINT64_C2(0x47AE147A, 0xE147AE15), RAPIDJSON_UINT64_C2(0x147AE147, 0xAE147AE1) },
+        { RAPIDJSON_UINT64_C2(0x6C8B4395, 0x810624DE), RAPIDJSON_UINT64_C2(0x10624DD2, 0xF1A9FBE7) },
+        { RAPIDJSON_UINT64_C2(0x7A786C22, 0x6809D496), RAPIDJSON_UINT64_C2(0x1A36E2EB, 0x1C432CA5) },
+        { RAPIDJSON_UINT64_C2(0x61F9F01B, 0x866E43AB), RAPIDJSON_UINT64_C2(0x14F8B588, 0xE368F084) },
+        { RAPIDJSON_UINT64_C2(0xB4C7F349, 0x38583622), RAPIDJSON_UINT64_C2(0x10C6F7A0, 0xB5ED8D36) },
+        { RAPIDJSON_UINT64_C2(0x87A6520E, 0xC08D236A), RAPIDJSON_UINT64_C2(0x1AD7F29A, 0xBCAF4857) },
+        { RAPIDJSON_UINT64_C2(0x9FB841A5, 0x66D74F88), RAPIDJSON_UINT64_C2(0x15798EE2, 0x308C39DF) },
+        { RAPIDJSON_UINT64_C2(0xE62D0151, 0x1F12A607), RAPIDJSON_UINT64_C2(0x112E0BE8, 0x26D694B2) },
+        { RAPIDJSON_UINT64_C2(0xD6AE6881, 0xCB5109A4), RAPIDJSON_UINT64_C2(0x1B7CDFD9, 0xD7BDBAB7) },
+        { RAPIDJSON_UINT64_C2(0xDEF1ED34, 0xA2A73AEA), RAPIDJSON_UINT64_C2(0x15FD7FE1, 0x7964955F) },
+        { RAPIDJSON_UINT64_C2(0x7F27F0F6, 0xE885C8BB), RAPIDJSON_UINT64_C2(0x11979981, 0x2DEA1119) },
+        { RAPIDJSON_UINT64_C2(0x650CB4BE, 0x40D60DF8), RAPIDJSON_UINT64_C2(0x1C25C268, 0x497681C2) },
+        { RAPIDJSON_UINT64_C2(0xEA709098, 0x33DE7193), RAPIDJSON_UINT64_C2(0x16849B86, 0xA12B9B01) },
+        { RAPIDJSON_UINT64_C2(0x21F3A6E0, 0x297EC143), RAPIDJSON_UINT64_C2(0x1203AF9E, 0xE756159B) },
+        { RAPIDJSON_UINT64_C2(0x6985D7CD, 0x0F313537), RAPIDJSON_UINT64_C2(0x1CD2B297, 0xD889BC2B) },
+        { RAPIDJSON_UINT64_C2(0x2137DFD7, 0x3F5A90F9), RAPIDJSON_UINT64_C2(0x170EF546, 0x46D49689) },
+        { RAPIDJSON_UINT64_C2(0xE75FE645, 0xCC4873FA), RAPIDJSON_UINT64_C2(0x12725DD1, 0xD243ABA0) },
+        { RAPIDJSON_UINT64_C2(0xA5663D3C, 0x7A0D865D), RAPIDJSON_UINT64_C2(0x1D83C94F, 0xB6D2AC34) },
+        { RAPIDJSON_UINT64_C2(0x511E9763, 0x94D79EB1), RAPIDJSON_UINT64_C2(0x179CA10C, 0x9242235D) },
+        { RAPIDJSON_UINT64_C2(0xDA7EDF82, 0xDD794BC1), RAPIDJSON_UINT64_C2(0x12E3B40A, 0x0E9B4F7D) },
+        { RAPIDJSON_UINT64_C2(0x2A6498D1, 0x625BAC68), RAPIDJSON_UINT64_C2(0x1E392010, 0x175EE596) },
+        { RAPIDJSON_UINT64_C2(0xEEB6E0A7, 0x81E2F053), RAPIDJSON_UINT64_C2(0x182DB340, 0x12B25144) },
+        { RAPIDJSON_UINT64_C2(0x58924D52, 0xCE4F26A9), RAPIDJSON_UINT64_C2(0x1357C299, 0xA88EA76A) },
+        { RAPIDJSON_UINT64_C2(0x27507BB7, 0xB07EA441), RAPIDJSON_UINT64_C2(0x1EF2D0F5, 0xDA7DD8AA) },
+        { RAPIDJSON_UINT64_C2(0x52A6C95F, 0xC0655034), RAPIDJSON_UINT64_C2(0x18C240C4, 0xAECB13BB) },
+        { RAPIDJSON_UINT64_C2(0x0EEBD44C, 0x99EAA690), RAPIDJSON_UINT64_C2(0x13CE9A36, 0xF23C0FC9) },
+        { RAPIDJSON_UINT64_C2(0xB17953AD, 0xC3110A80), RAPIDJSON_UINT64_C2(0x1FB0F6BE, 0x50601941) },
+        { RAPIDJSON_UINT64_C2(0xC12DDC8B, 0x02740867), RAPIDJSON_UINT64_C2(0x195A5EFE, 0xA6B34767) },
+        { RAPIDJSON_UINT64_C2(0x3424B06F, 0x3529A052), RAPIDJSON_UINT64_C2(0x14484BFE, 0xEBC29F86) },
+        { RAPIDJSON_UINT64_C2(0x901D59F2, 0x90EE19DB), RAPIDJSON_UINT64_C2(0x1039D665, 0x89687F9E) },
+        { RAPIDJSON_UINT64_C2(0x4CFBC31D, 0xB4B0295F), RAPIDJSON_UINT64_C2(0x19F623D5, 0xA8A73297) },
+        { RAPIDJSON_UINT64_C2(0x3D9635B1, 0x5D59BAB2), RAPIDJSON_UINT64_C2(0x14C4E977, 0xBA1F5BAC) },
+        { RAPIDJSON_UINT64_C2(0x97AB5E27, 0x7DE16228), RAPIDJSON_UINT64_C2(0x109D8792, 0xFB4C4956) },
+        { RAPIDJSON_UINT64_C2(0xF2ABC9D8, 0xC9689D0D), RAPIDJSON_UINT64_C2(0x1A95A5B7, 0xF87A0EF0) },
+        { RAPIDJSON_UINT64_C2(0x5BBCA17A, 0x3ABA173E), RAPIDJSON_UINT64_C2(0x15448493, 0x2D2E725A) },
+        { RAPIDJSON_UINT64_C2(0xAFCA1AC8, 0x2EFB45CB), RAPIDJSON_UINT64_C2(0x11039D42, 0x8A8B8EAE) },
+        { RAPIDJSON_UINT64_C2(0xB2DCF7A6, 0xB1920945), RAPIDJSON_UINT64_C2(0x1B38FB9D, 0xAA78E44A) },
+        { RAPIDJSON_UINT64_C2(0xF57D92EB, 0xC141A104), RAPIDJSON_UINT64_C2(0x15C72FB1, 0x552D836E) },
+        { RAPIDJSON_UINT64_C2(0xC4647589, 0x6767B403), RAPIDJSON_UINT64_C2(0x116C2627, 0x77579C58) },
+        { RAPIDJSON_UINT64_C2(0x6D6D88DB, 0xD8A5ECD2), RAPIDJSON_UINT64_C2(0x1BE03D0B, 0xF225C6F4) },
+        { RAPIDJSON_UINT64_C2(0x8ABE0716, 0x46EB23DB), RAPIDJSON_UINT64_C2(0x164CFDA3, 0x281E38C3) },
+        { RAPIDJSON_UINT64_C2(0x6EFE6C11, 0xD255B649), RAPIDJSON_UINT64_C2(0x11D7314F, 0x534B609C) },
+        { RAPIDJSON_UINT64_C2(0xB197134F, 0xB6EF8A0E), RAPIDJSON_UINT64_C2(0x1C8B8218, 0x85456760) },
+        { RAPIDJSON_UINT64_C2(0x27AC0F72, 0xF8BFA1A5), RAPIDJSON_UINT64_C2(0x16D601AD, 0x376AB91A) },
+        { RAPIDJSON_UINT64_C2(0xB95672C2, 0x60994E1E), RAPIDJSON_UINT64_C2(0x1244CE24, 0x2C5560E1) },
+        { RAPIDJSON_UINT64_C2(0xF5571E03, 0xCDC21695), RAPIDJSON_UINT64_C2(0x1D3AE36D, 0x13BBCE35) },
+        { RAPIDJSON_UINT64_C2(0x2AAC1803, 0x0B01ABAB), RAPIDJSON_UINT64_C2(0x17624F8A, 0x762FD82B) },
+        { RAPIDJSON_UINT64_C2(0xBBBCE002, 0x6F348956), RAPIDJSON_UINT64_C2(0x12B50C6E, 0xC4F31355) },
+        { RAPIDJSON_UINT64_C2(0x92C7CCD0, 0xB1EDA889), RAPIDJSON_UINT64_C2(0x1DEE7A4A, 0xD4B81EEF) },
+        { RAPIDJSON_UINT64_C2(0xDBD30A40, 0x8E57BA07), RAPIDJSON_UINT64_C2(0x17F1FB6F, 0x10934BF2) },
+        { RAPIDJSON_UINT64_C2(0x7CA8D500, 0x71DFC806), RAPIDJSON_UINT64_C2(0x1327FC58, 0xDA0F6FF5) },
+        { RAPIDJSON_UINT64_C2(0xFAA7BB33, 0xE9660CD6), RAPIDJSON_UINT64_C2(0x1EA6608E, 0x29B24CBB) },
+        { RAPIDJSON_UINT64_C2(0x9552FC29, 0x8784D711), RAPIDJSON_UINT64_C2(0x18851A0B, 0x548EA3C9) },
+        { RAPIDJSON_UINT64_C2(0xAAA8C9BA, 0xD2D0AC0E), RAPIDJSON_UINT64_C2(0x139DAE6F, 0x76D88307) },
+        { RAPIDJSON_UINT64_C2(0xDDDADC5E, 0x1E1AACE3), RAPIDJSON_UINT64_C2(0x1F62B0B2, 0x57C0D1A5) },
+        { RAPIDJSON_UINT64_C2(0x7E48B04B, 0x4B488A4F), RAPIDJSON_UINT64_C2(0x191BC08E, 0xAC9A4151) },
+        { RAPIDJSON_UINT64_C2(0xCB6D59D5, 0xD5D3A1D9), RAPIDJSON_UINT64_C2(0x141633A5, 0x56E1CDDA) },
+        { RAPIDJSON_UINT64_C2(0x3C577B11, 0x77DC817B), RAPIDJSON_UINT64_C2(0x1011C2EA, 0xABE7D7E2) },
+        { RAPIDJSON_UINT64_C2(0xC6F25E82, 0x5960CF2A), RAPIDJSON_UINT64_C2(0x19B604AA, 0xACA62636) },
+        { RAPIDJSON_UINT64_C2(0x6BF51868, 0x4780A5BB), RAPIDJSON_UINT64_C2(0x14919D55, 0x56EB51C5) },
+        { RAPIDJSON_UINT64_C2(0x232A79ED, 0x06008496), RAPIDJSON_UINT64_C2(0x10747DDD, 0xDF22A7D1) },
+        { RAPIDJSON_UINT64_C2(0xD1DD8FE1, 0xA3340756), RAPIDJSON_UINT64_C2(0x1A53FC96, 0x31D10C81) },
+        { RAPIDJSON_UINT64_C2(0xA7E4731A, 0xE8F66C45), RAPIDJSON_UINT64_C2(0x150FFD44, 0xF4A73D34) },
+        { RAPIDJSON_UINT64_C2(0x531D28E2, 0x53F8569E), RAPIDJSON_UINT64_C2(0x10D9976A, 0x5D52975D) },
+        { RAPIDJSON_UINT64_C2(0xEB61DB03, 0xB98D5762), RAPIDJSON_UINT64_C2(0x1AF5BF10, 0x9550F22E) },
+        { RAPIDJSON_UINT64_C2(0xBC4E48CF, 0xC7A445E8), RAPIDJSON_UINT64_C2(0x159165A6, 0xDDDA5B58) },
+        { RAPIDJSON_UINT64_C2(0x6371D3D9, 0x6C836B20), RAPIDJSON_UINT64_C2(0x11411E1F, 0x17E1E2AD) },
+        { RAPIDJSON_UINT64_C2(0x9F1C8628, 0xAD9F11CD), RAPIDJSON_UINT64_C2(0x1B9B6364, 0xF3030448) },
+        { RAPIDJSON_UINT64_C2(0xE5B06B53, 0xBE18DB0B), RAPIDJSON_UINT64_C2(0x1615E91D, 0x8F359D06) },
+        { RAPIDJSON_UINT64_C2(0xEAF3890F, 0xCB4715A2), RAPIDJSON_UINT64_C2(0x11AB20E4, 0x72914A6B) },
+        { RAPIDJSON_UINT64_C2(0x44B8DB4C, 0x7871BC37), RAPIDJSON_UINT64_C2(0x1C45016D, 0x841BAA46) },
+        { RAPIDJSON_UINT64_C2(0x03C715D6, 0xC6C1635F), RAPIDJSON_UINT64_C2(0x169D9ABE, 0x03495505) },
+        { RAPIDJSON_UINT64_C2(0x3638DE45, 0x6BCDE919), RAPIDJSON_UINT64_C2(0x1217AEFE, 0x69077737) },
+        { RAPIDJSON_UINT64_C2(0x56C163A2, 0x461641C1), RAPIDJSON_UINT64_C2(0x1CF2B197, 0x0E725858) },
+        { RAPIDJSON_UINT64_C2(0xDF011C81, 0xD1AB67CE), RAPIDJSON_UINT64_C2(0x17288E12, 0x71F51379) },
+        { RAPIDJSON_UINT64_C2(0x7F3416CE, 0x4155ECA5), RAPIDJSON_UINT64_C2(0x1286D80E, 0xC190DC61) },
+        { RAPIDJSON_UINT64_C2(0x6520247D, 0x3556476E), RAPIDJSON_UINT64_C2(0x1DA48CE4, 0x68E7C702) },
+        { RAPIDJSON_UINT64_C2(0xEA801D30, 0xF7783925), RAPIDJSON_UINT64_C2(0x17B6D71D, 0x20B96C01) },
+        { RAPIDJSON_UINT64_C2(0xBB99B0F3, 0xF92CFA84), RAPIDJSON_UINT64_C2(0x12F8AC17, 0x4D612334) },
+        { RAPIDJSON_UINT64_C2(0x5F5C4E53, 0x2847F739), RAPIDJSON_UINT64_C2(0x1E5AACF2, 0x15683854) },
+        { RAPIDJSON_UINT64_C2(0x7F7D0B75, 0xB9D32C2E), RAPIDJSON_UINT64_C2(0x18488A5B, 0x44536043) },
+        { RAPIDJSON_UINT64_C2(0x9930D5F7, 0xC7DC2358), RAPIDJSON_UINT64_C2(0x136D3B7C, 0x36A919CF) },
+        { RAPIDJSON_UINT64_C2(0x8EB4898C, 0x72F9D226), RAPIDJSON_UINT64_C2(0x1F152BF9, 0xF10E8FB2) },
+        { RAPIDJSON_UINT64_C2(0x722A07A3, 0x8F2E41B8), RAPIDJSON_UINT64_C2(0x18DDBCC7, 0xF40BA628) },
+        { RAPIDJSON_UINT64_C2(0xC1BB394F, 0xA5BE9AFA), RAPIDJSON_UINT64_C2(0x13E49706, 0x5CD61E86) },
+        { RAPIDJSON_UINT64_C2(0x9C5EC219, 0x0930F7F6), RAPIDJSON_UINT64_C2(0x1FD424D6, 0xFAF030D7) },
+        { RAPIDJSON_UINT64_C2(0x49E56814, 0x075A5FF8), RAPIDJSON_UINT64_C2(0x197683DF, 0x2F268D79) },
+        { RAPIDJSON_UINT64_C2(0x6E512010, 0x05E1E660), RAPIDJSON_UINT64_C2(0x145ECFE5, 0xBF520AC7) },
+        { RAPIDJSON_UINT64_C2(0xF1DA800C, 0xD181851A), RAPIDJSON_UINT64_C2(0x104BD984, 0x990E6F05) },
+        { RAPIDJSON_UINT64_C2(0x4FC40014, 0x8268D4F5), RAPIDJSON_UINT64_C2(0x1A12F5A0, 0xF4E3E4D6) },
+        { RAPIDJSON_UINT64_C2(0xD96999AA, 0x01ED772B), RAPIDJSON_UINT64_C2(0x14DBF7B3, 0xF71CB711) },
+        { RAPIDJSON_UINT64_C2(0xADEE1488, 0x018AC5BC), RAPIDJSON_UINT64_C2(0x10AFF95C, 0xC5B09274) },
+        { RAPIDJSON_UINT64_C2(0x497CEDA6, 0x68DE092C), RAPIDJSON_UINT64_C2(0x1AB32894, 0x6F80EA54) },
+        { RAPIDJSON_UINT64_C2(0x3ACA57B8, 0x53E4D424), RAPIDJSON_UINT64_C2(0x155C2076, 0xBF9A5510) },
+        { RAPIDJSON_UINT64_C2(0x623B7960, 0x431D7683), RAPIDJSON_UINT64_C2(0x1116805E, 0xFFAEAA73) },
+        { RAPIDJSON_UINT64_C2(0x9D2BF566, 0xD1C8BD9E), RAPIDJSON_UINT64_C2(0x1B5733CB, 0x32B110B8) },
+        { RAPIDJSON_UINT64_C2(0x7DBCC452, 0x416D647F), RAPIDJSON_UINT64_C2(0x15DF5CA2, 0x8EF40D60) },
+        { RAPIDJSON_UINT64_C2(0xCAFD69DB, 0x678AB6CC), RAPIDJSON_UINT64_C2(0x117F7D4E, 0xD8C33DE6) },
+        { RAPIDJSON_UINT64_C2(0xAB2F0FC5, 0x72778ADF), RAPIDJSON_UINT64_C2(0x1BFF2EE4, 0x8E052FD7) },
+        { RAPIDJSON_UINT64_C2(0x88F27304, 0x5B92D580), RAPIDJSON_UINT64_C2(0x1665BF1D, 0x3E6A8CAC) },
+        { RAPIDJSON_UINT64_C2(0xD3F528D0, 0x49424466), RAPIDJSON_UINT64_C2(0x11EAFF4A, 0x98553D56) },
+        { RAPIDJSON_UINT64_C2(0xB988414D, 0x4203A0A3), RAPIDJSON_UINT64_C2(0x1CAB3210, 0xF3BB9557) },
+        { RAPIDJSON_UINT64_C2(0x6139CDD7, 0x6802E6E9), RAPIDJSON_UINT64_C2(0x16EF5B40, 0xC2FC7779) },
+        { RAPIDJSON_UINT64_C2(0xE7617179, 0x20025254), RAPIDJSON_UINT64_C2(0x125915CD, 0x68C9F92D) },
+        { RAPIDJSON_UINT64_C2(0xA568B58E, 0x999D5086), RAPIDJSON_UINT64_C2(0x1D5B5615, 0x74765B7C) },
+        { RAPIDJSON_UINT64_C2(0x5120913E, 0xE14AA6D2), RAPIDJSON_UINT64_C2(0x177C44DD, 0xF6C515FD) },
+        { RAPIDJSON_UINT64_C2(0xA74D40FF, 0x1AA21F0E), RAPIDJSON_UINT64_C2(0x12C9D0B1, 0x923744CA) },
+        { RAPIDJSON_UINT64_C2(0x0BAECE64, 0xF769CB4A), RAPIDJSON_UINT64_C2(0x1E0FB44F, 0x50586E11) },
+        { RAPIDJSON_UINT64_C2(0x3C8BD850, 0xC5EE3C3B), RAPIDJSON_UINT64_C2(0x180C903F, 0x7379F1A7) },
+        { RAPIDJSON_UINT64_C2(0xCA0979DA, 0x37F1C9C9), RAPIDJSON_UINT64_C2(0x133D4032, 0xC2C7F485) },
+        { RAPIDJSON_UINT64_C2(0xA9A8C2F6, 0xBFE942DB), RAPIDJSON_UINT64_C2(0x1EC866B7, 0x9E0CBA6F) },
+        { RAPIDJSON_UINT64_C2(0x2153CF2B, 0xCCBA9BE3), RAPIDJSON_UINT64_C2(0x18A0522C, 0x7E709526) },
+        { RAPIDJSON_UINT64_C2(0x1AA97289, 0x70954982), RAPIDJSON_UINT64_C2(0x13B374F0, 0x6526DDB8) },
+        { RAPIDJSON_UINT64_C2(0xF775840F, 0x1A88759D), RAPIDJSON_UINT64_C2(0x1F8587E7, 0x083E2F8C) },
+        { RAPIDJSON_UINT64_C2(0x5F913672, 0x7BA05E17), RAPIDJSON_UINT64_C2(0x19379FEC, 0x0698260A) },
+        { RAPIDJSON_UINT64_C2(0x1940F85B, 0x9619E4DF), RAPIDJSON_UINT64_C2(0x142C7FF0, 0x054684D5) },
+        { RAPIDJSON_UINT64_C2(0xE100C6AF, 0xAB47EA4C), RAPIDJSON_UINT64_C2(0x1023998C, 0xD1053710) },
+        { RAPIDJSON_UINT64_C2(0xCE67A44C, 0x453FDD47), RAPIDJSON_UINT64_C2(0x19D28F47, 0xB4D524E7) },
+        { RAPIDJSON_UINT64_C2(0xD852E9D6, 0x9DCCB106), RAPIDJSON_UINT64_C2(0x14A8729F, 0xC3DDB71F) },
+        { RAPIDJSON_UINT64_C2(0x79DBEE45, 0x4B0A2738), RAPIDJSON_UINT64_C2(0x1086C219, 0x697E2C19) },
+        { RAPIDJSON_UINT64_C2(0x295FE3A2, 0x11A9D859), RAPIDJSON_UINT64_C2(0x1A71368F, 0x0F30468F) },
+        { RAPIDJSON_UINT64_C2(0xBAB31C81, 0xA7BB137A), RAPIDJSON_UINT64_C2(0x15275ED8, 0xD8F36BA5) },
+        { RAPIDJSON_UINT64_C2(0x6228E39A, 0xEC95A92F), RAPIDJSON_UINT64_C2(0x10EC4BE0, 0xAD8F8951) },
+        { RAPIDJSON_UINT64_C2(0x9D0E38F7, 0xE0EF7517), RAPIDJSON_UINT64_C2(0x1B13AC9A, 0xAF4C0EE8) },
+        { RAPIDJSON_UINT64_C2(0xB0D82D93, 0x1A592A79), RAPIDJSON_UINT64_C2(0x15A956E2, 0x25D67253) },
+        { RAPIDJSON_UINT64_C2(0x8D79BE0F, 0x4847552E), RAPIDJSON_UINT64_C2(0x11544581, 0xB7DEC1DC) },
+        { RAPIDJSON_UINT64_C2(0x158F967E, 0xDA0BBB7C), RAPIDJSON_UINT64_C2(0x1BBA08CF, 0x8C979C94) },
+        { RAPIDJSON_UINT64_C2(0x77A611FF, 0x14D62F97), RAPIDJSON_UINT64_C2(0x162E6D72, 0xD6DFB076) },
+        { RAPIDJSON_UINT64_C2(0xF951A7FF, 0x43DE8C79), RAPIDJSON_UINT64_C2(0x11BEBDF5, 0x78B2F391) },
+        { RAPIDJSON_UINT64_C2(0xC21C3FFE, 0xD2FDAD8E), RAPIDJSON_UINT64_C2(0x1C646322, 0x5AB7EC1C) },
+        { RAPIDJSON_UINT64_C2(0x01B03332, 0x42648AD8), RAPIDJSON_UINT64_C2(0x16B6B5B5, 0x155FF017) },
+        { RAPIDJSON_UINT64_C2(0x0159C28E, 0x9B83A246), RAPIDJSON_UINT64_C2(0x122BC490, 0xDDE659AC) },
+        { RAPIDJSON_UINT64_C2(0xCEF60417, 0x5F3903A3), RAPIDJSON_UINT64_C2(0x1D12D41A, 0xFCA3C2AC) },
+        { RAPIDJSON_UINT64_C2(0x725E69AC, 0x4C2D9C83), RAPIDJSON_UINT64_C2(0x17424348, 0xCA1C9BBD) },
+        { RAPIDJSON_UINT64_C2(0xF5185489, 0xD68AE39C), RAPIDJSON_UINT64_C2(0x129B6907, 0x0816E2FD) },
+        { RAPIDJSON_UINT64_C2(0xEE8D540F, 0xBDAB05C6), RAPIDJSON_UINT64_C2(0x1DC574D8, 0x0CF16B2F) },
+        { RAPIDJSON_UINT64_C2(0xBED77672, 0xFE226B05), RAPIDJSON_UINT64_C2(0x17D12A46, 0x70C1228C) },
+        { RAPIDJSON_UINT64_C2(0xFF12C528, 0xCB4EBC04), RAPIDJSON_UINT64_C2(0x130DBB6B, 0x8D674ED6) },
+        { RAPIDJSON_UINT64_C2(0xCB513B74, 0x787DF9A0), RAPIDJSON_UINT64_C2(0x1E7C5F12, 0x7BD87E24) },
+        { RAPIDJSON_UINT64_C2(0x090DC929, 0xF9FE614D), RAPIDJSON_UINT64_C2(0x18637F41, 0xFCAD31B7) },
+        { RAPIDJSON_UINT64_C2(0xA0D7D421, 0x94CB810A), RAPIDJSON_UINT64_C2(0x1382CC34, 0xCA2427C5) },
+        { RAPIDJSON_UINT64_C2(0x67BFB9CF, 0x5478CE77), RAPIDJSON_UINT64_C2(0x1F37AD21, 0x436D0C6F) },
+        { RAPIDJSON_UINT64_C2(0x1FCC94A5, 0xDD2D71F9), RAPIDJSON_UINT64_C2(0x18F9574D, 0xCF8A7059) },
+        { RAPIDJSON_UINT64_C2(0x7FD6DD51, 0x7DBDF4C7), RAPIDJSON_UINT64_C2(0x13FAAC3E, 0x3FA1F37A) },
+        { RAPIDJSON_UINT64_C2(0xFFBE2EE8, 0xC92FEE0B), RAPIDJSON_UINT64_C2(0x1FF779FD, 0x329CB8C3) },
+        { RAPIDJSON_UINT64_C2(0x6631BF20, 0xA0F324D6), RAPIDJSON_UINT64_C2(0x1992C7FD, 0xC216FA36) },
+        { RAPIDJSON_UINT64_C2(0xB827CC1A, 0x1A5C1D78), RAPIDJSON_UINT64_C2(0x14756CCB, 0x01ABFB5E) },
+        { RAPIDJSON_UINT64_C2(0x935309AE, 0x7B7CE460), RAPIDJSON_UINT64_C2(0x105DF0A2, 0x67BCC918) },
+        { RAPIDJSON_UINT64_C2(0x1EEB42B0, 0xC594A099), RAPIDJSON_UINT64_C2(0x1A2FE76A, 0x3F9474F4) },
+        { RAPIDJSON_UINT64_C2(0xE5890227, 0x0476E6E1), RAPIDJSON_UINT64_C2(0x14F31F88, 0x32DD2A5C) },
+        { RAPIDJSON_UINT64_C2(0xB7A0CE85, 0x9D2BEBE7), RAPIDJSON_UINT64_C2(0x10C27FA0, 0x28B0EEB0) },
+        { RAPIDJSON_UINT64_C2(0x59014A6F, 0x61DFDFD8), RAPIDJSON_UINT64_C2(0x1AD0CC33, 0x744E4AB4) },
+        { RAPIDJSON_UINT64_C2(0xE0CDD525, 0xE7E64CAD), RAPIDJSON_UINT64_C2(0x1573D68F, 0x903EA229) },
+        { RAPIDJSON_UINT64_C2(0x4D717751, 0x8651D6F1), RAPIDJSON_UINT64_C2(0x11297872, 0xD9CBB4EE) },
+        { RAPIDJSON_UINT64_C2(0x7BE8BEE8, 0xD6E957E8), RAPIDJSON_UINT64_C2(0x1B758D84, 0x8FAC54B0) },
+        { RAPIDJSON_UINT64_C2(0xFCBA3253, 0xDF211320), RAPIDJSON_UINT64_C2(0x15F7A46A, 0x0C89DD59) },
+        { RAPIDJSON_UINT64_C2(0x63C82843, 0x18E74280), RAPIDJSON_UINT64_C2(0x1192E9EE, 0x706E4AAE) },
+        { RAPIDJSON_UINT64_C2(0x060D0D38, 0x27D86A66), RAPIDJSON_UINT64_C2(0x1C1E4317, 0x1A4A1117) },
+        { RAPIDJSON_UINT64_C2(0x6B3DA42C, 0xECAD21EB), RAPIDJSON_UINT64_C2(0x167E9C12, 0x7B6E7412) },
+        { RAPIDJSON_UINT64_C2(0x88FE1CF0, 0xBD574E56), RAPIDJSON_UINT64_C2(0x11FEE341, 0xFC585CDB) },
+        { RAPIDJSON_UINT64_C2(0x419694B4, 0x62254A23), RAPIDJSON_UINT64_C2(0x1CCB0536, 0x608D615F) },
+        { RAPIDJSON_UINT64_C2(0x67ABAA29, 0xE81DD4E9), RAPIDJSON_UINT64_C2(0x1708D0F8, 0x4D3DE77F) },
+        { RAPIDJSON_UINT64_C2(0xB95621BB, 0x2017DD87), RAPIDJSON_UINT64_C2(0x126D73F9, 0xD764B932) },
+        { RAPIDJSON_UINT64_C2(0xC223692B, 0x668C95A5), RAPIDJSON_UINT64_C2(0x1D7BECC2, 0xF23AC1EA) },
+        { RAPIDJSON_UINT64_C2(0xCE82BA89, 0x1ED6DE1D), RAPIDJSON_UINT64_C2(0x17965702, 0x5B6234BB) },
+        { RAPIDJSON_UINT64_C2(0xA5356207, 0x4BDF1818), RAPIDJSON_UINT64_C2(0x12DEAC01, 0xE2B4F6FC) },
+        { RAPIDJSON_UINT64_C2(0x3B889CD8, 0x7964F359), RAPIDJSON_UINT64_C2(0x1E311336, 0x3787F194) },
+        { RAPIDJSON_UINT64_C2(0xFC6D4A46, 0xC783F5E1), RAPIDJSON_UINT64_C2(0x18274291, 0xC6065ADC) },
+        { RAPIDJSON_UINT64_C2(0x30576E9F, 0x06032B1A), RAPIDJSON_UINT64_C2(0x13529BA7, 0xD19EAF17) },
+        { RAPIDJSON_UINT64_C2(0x1A257DCB, 0x3CD1DE90), RAPIDJSON_UINT64_C2(0x1EEA92A6, 0x1C311825) },
+        { RAPIDJSON_UINT64_C2(0x481DFE3C, 0x30A7E540), RAPIDJSON_UINT64_C2(0x18BBA884, 0xE35A79B7) },
+        { RAPIDJSON_UINT64_C2(0xD34B31C9, 0xC0865100), RAPIDJSON_UINT64_C2(0x13C9539D, 0x82AEC7C5) },
+        { RAPIDJSON_UINT64_C2(0x5211E942, 0xCDA3B4CD), RAPIDJSON_UINT64_C2(0x1FA885C8, 0xD117A609) },
+        { RAPIDJSON_UINT64_C2(0x74DB2102, 0x3E1C90A4), RAPIDJSON_UINT64_C2(0x19539E3A, 0x40DFB807) },
+        { RAPIDJSON_UINT64_C2(0xF715B401, 0xCB4A0D50), RAPIDJSON_UINT64_C2(0x1442E4FB, 0x67196005) },
+        { RAPIDJSON_UINT64_C2(0xF8DE299B, 0x09080AA7), RAPIDJSON_UINT64_C2(0x103583FC, 0x527AB337) },
+        { RAPIDJSON_UINT64_C2(0x8E304291, 0xA80CDDD7), RAPIDJSON_UINT64_C2(0x19EF3993, 0xB72AB859) },
+        { RAPIDJSON_UINT64_C2(0x3E8D020E, 0x200A4B13), RAPIDJSON_UINT64_C2(0x14BF6142, 0xF8EEF9E1) },
+        { RAPIDJSON_UINT64_C2(0x653D9B3E, 0x80083C0F), RAPIDJSON_UINT64_C2(0x10991A9B, 0xFA58C7E7) },
+        { RAPIDJSON_UINT64_C2(0x6EC8F864, 0x000D2CE4), RAPIDJSON_UINT64_C2(0x1A8E90F9, 0x908E0CA5) },
+        { RAPIDJSON_UINT64_C2(0x8BD3F9E9, 0x99A423EA), RAPIDJSON_UINT64_C2(0x153EDA61, 0x4071A3B7) },
+        { RAPIDJSON_UINT64_C2(0x3CA994BA, 0xE1501CBB), RAPIDJSON_UINT64_C2(0x10FF151A, 0x99F482F9) },
+        { RAPIDJSON_UINT64_C2(0xC775BAC4, 0x9BB3612B), RAPIDJSON_UINT64_C2(0x1B31BB5D, 0xC320D18E) },
+        { RAPIDJSON_UINT64_C2(0xD2C4956A, 0x16291A89), RAPIDJSON_UINT64_C2(0x15C162B1, 0x68E70E0B) },
+        { RAPIDJSON_UINT64_C2(0xDBD07788, 0x11BA7BA1), RAPIDJSON_UINT64_C2(0x11678227, 0x871F3E6F) },
+        { RAPIDJSON_UINT64_C2(0x2C80BF40, 0x1C5D929B), RAPIDJSON_UINT64_C2(0x1BD8D03F, 0x3E9863E6) },
+        { RAPIDJSON_UINT64_C2(0xBD33CC33, 0x49E47549), RAPIDJSON_UINT64_C2(0x16470CFF, 0x6546B651) },
+        { RAPIDJSON_UINT64_C2(0xCA8FD68F, 0x6E505DD4), RAPIDJSON_UINT64_C2(0x11D270CC, 0x51055EA7) },
+        { RAPIDJSON_UINT64_C2(0x4419574B, 0xE3B3C953), RAPIDJSON_UINT64_C2(0x1C83E7AD, 0x4E6EFDD9) },
+        { RAPIDJSON_UINT64_C2(0x03477909, 0x82F63AA9), RAPIDJSON_UINT64_C2(0x16CFEC8A, 0xA52597E1) },
+        { RAPIDJSON_UINT64_C2(0xCF6C60D4, 0x68C4FBBA), RAPIDJSON_UINT64_C2(0x123FF06E, 0xEA847980) },
+        { RAPIDJSON_UINT64_C2(0xE57A3487, 0x0E07F92A), RAPIDJSON_UINT64_C2(0x1D331A4B, 0x10D3F59A) },
+        { RAPIDJSON_UINT64_C2(0x512E906C, 0x0B399422), RAPIDJSON_UINT64_C2(0x175C1508, 0xDA432AE2) },
+        { RAPIDJSON_UINT64_C2(0xDA8BA6BC, 0xD5C7A9B5), RAPIDJSON_UINT64_C2(0x12B010D3, 0xE1CF5581) },
+        { RAPIDJSON_UINT64_C2(0x90DF712E, 0x22D90F87), RAPIDJSON_UINT64_C2(0x1DE68153, 0x02E5559C) },
+        { RAPIDJSON_UINT64_C2(0xDA4C5A8B, 0x4F140C6C), RAPIDJSON_UINT64_C2(0x17EB9AA8, 0xCF1DDE16) },
+        { RAPIDJSON_UINT64_C2(0xAEA37BA2, 0xA5A9A38A), RAPIDJSON_UINT64_C2(0x1322E220, 0xA5B17E78) },
+        { RAPIDJSON_UINT64_C2(0x7DD25F6A, 0xA2A905A9), RAPIDJSON_UINT64_C2(0x1E9E369A, 0xA2B59727) },
+        { RAPIDJSON_UINT64_C2(0x97DB7F88, 0x8220D154), RAPIDJSON_UINT64_C2(0x187E9215, 0x4EF7AC1F) },
+        { RAPIDJSON_UINT64_C2(0x797C6606, 0xCE80A777), RAPIDJSON_UINT64_C2(0x139874DD, 0xD8C6234C) },
+        { RAPIDJSON_UINT64_C2(0x8F2D700A, 0xE4010BF1), RAPIDJSON_UINT64_C2(0x1F5A5496, 0x27A36BAD) },
+        { RAPIDJSON_UINT64_C2(0x0C2459A2, 0x5000D65A), RAPIDJSON_UINT64_C2(0x19151078, 0x1FB5EFBE) },
+        { RAPIDJSON_UINT64_C2(0x701D1481, 0xD99A4515), RAPIDJSON_UINT64_C2(0x1410D9F9, 0xB2F7F2FE) },
+        { RAPIDJSON_UINT64_C2(0xC017439B, 0x147B6A77), RAPIDJSON_UINT64_C2(0x100D7B2E, 0x28C65BFE) },
+        { RAPIDJSON_UINT64_C2(0xCCF205C4, 0xED9243F2), RAPIDJSON_UINT64_C2(0x19AF2B7D, 0x0E0A2CCA) },
+        { RAPIDJSON_UINT64_C2(0x0A5B37D0, 0xBE0E9CC2), RAPIDJSON_UINT64_C2(0x148C22CA, 0x71A1BD6F) },
+        { RAPIDJSON_UINT64_C2(0x0848F973, 0xCB3EE3CE), RAPIDJSON_UINT64_C2(0x10701BD5, 0x27B4978C) },
+        { RAPIDJSON_UINT64_C2(0xDA0E5BEC, 0x78649FB0), RAPIDJSON_UINT64_C2(0x1A4CF955, 0x0C5425AC) },
+        { RAPIDJSON_UINT64_C2(0x7B3EAFF0, 0x60507FC0), RAPIDJSON_UINT64_C2(0x150A6110, 0xD6A9B7BD) },
+        { RAPIDJSON_UINT64_C2(0x95CBBFF3, 0x80406633), RAPIDJSON_UINT64_C2(0x10D51A73, 0xDEEE2C97) },
+        { RAPIDJSON_UINT64_C2(0xEFAC6652, 0x66CD7052), RAPIDJSON_UINT64_C2(0x1AEE90B9, 0x64B04758) },
+        { RAPIDJSON_UINT64_C2(0x2623850E, 0xB8A459DB), RAPIDJSON_UINT64_C2(0x158BA6FA, 0xB6F36C47) },
+        { RAPIDJSON_UINT64_C2(0x1E82D0D8, 0x93B6AE49), RAPIDJSON_UINT64_C2(0x113C8595, 0x5F29236C) },
+        { RAPIDJSON_UINT64_C2(0xFD9E1AF4, 0x1F8AB075), RAPIDJSON_UINT64_C2(0x1B9408EE, 0xFEA838AC) },
+        { RAPIDJSON_UINT64_C2(0x97B1AF29, 0xB2D559F7), RAPIDJSON_UINT64_C2(0x16100725, 0x988693BD) },
+        { RAPIDJSON_UINT64_C2(0xAC8E25BA, 0xF5777B2C), RAPIDJSON_UINT64_C2(0x11A66C1E, 0x139EDC97) },
+        { RAPIDJSON_UINT64_C2(0x7A7D092B, 0x2258C513), RAPIDJSON_UINT64_C2(0x1C3D79C9, 0xB8FE2DBF) },
+        { RAPIDJSON_UINT64_C2(0x61FDA0EF, 0x4EAD6A76), RAPIDJSON_UINT64_C2(0x169794A1, 0x60CB57CC) },
+        { RAPIDJSON_UINT64_C2(0xE7FE1A59, 0x0BBDEEC5), RAPIDJSON_UINT64_C2(0x1212DD4D, 0xE7091309) },
+        { RAPIDJSON_UINT64_C2(0xA6635D5B, 0x45FCB13A), RAPIDJSON_UINT64_C2(0x1CEAFBAF, 0xD80E84DC) },
+        { RAPIDJSON_UINT64_C2(0x851C4AAF, 0x6B308DC8), RAPIDJSON_UINT64_C2(0x172262F3, 0x133ED0B0) },
+        { RAPIDJSON_UINT64_C2(0xD0E36EF2, 0xBC26D7D4), RAPIDJSON_UINT64_C2(0x1281E8C2, 0x75CBDA26) },
+        { RAPIDJSON_UINT64_C2(0xB49F17EA, 0xC6A48C86), RAPIDJSON_UINT64_C2(0x1D9CA79D, 0x894629D7) },
+        { RAPIDJSON_UINT64_C2(0x2A18DFEF, 0x0550706B), RAPIDJSON_UINT64_C2(0x17B08617, 0xA104EE46) },
+        { RAPIDJSON_UINT64_C2(0x54E0B325, 0x9DD9F389), RAPIDJSON_UINT64_C2(0x12F39E79, 0x4D9D8B6B) },
+        { RAPIDJSON_UINT64_C2(0x87CDEB6F, 0x62F65274), RAPIDJSON_UINT64_C2(0x1E529728, 0x7C2F4578) },
+        { RAPIDJSON_UINT64_C2(0xD30B22BF, 0x825EA85D), RAPIDJSON_UINT64_C2(0x18421286, 0xC9BF6AC6) },
+        { RAPIDJSON_UINT64_C2(0x0F3C1BCC, 0x684BB9E4), RAPIDJSON_UINT64_C2(0x13680ED2, 0x3AFF889F) },
+        { RAPIDJSON_UINT64_C2(0x18602C7A, 0x4079296D), RAPIDJSON_UINT64_C2(0x1F0CE483, 0x9198DA98) },
+        { RAPIDJSON_UINT64_C2(0x46B356C8, 0x33942124), RAPIDJSON_UINT64_C2(0x18D71D36, 0x0E13E213) },
+        { RAPIDJSON_UINT64_C2(0x388F78A0, 0x29434DB6), RAPIDJSON_UINT64_C2(0x13DF4A91, 0xA4DCB4DC) },
+        { RAPIDJSON_UINT64_C2(0x5A7F2766, 0xA86BAF8A), RAPIDJSON_UINT64_C2(0x1FCBAA82, 0xA1612160) },
+        { RAPIDJSON_UINT64_C2(0x153285EB, 0xB9EFBFA2), RAPIDJSON_UINT64_C2(0x196FBB9B, 0xB44DB44D) },
+        { RAPIDJSON_UINT64_C2(0xAA8ED189, 0x618C994E), RAPIDJSON_UINT64_C2(0x145962E2, 0xF6A4903D) },
+        { RAPIDJSON_UINT64_C2(0xEED8A7A1, 0x1AD6E10C), RAPIDJSON_UINT64_C2(0x1047824F, 0x2BB6D9CA) },
+        { RAPIDJSON_UINT64_C2(0x7E27729B, 0x5E249B45), RAPIDJSON_UINT64_C2(0x1A0C03B1, 0xDF8AF611) },
+        { RAPIDJSON_UINT64_C2(0xFE85F549, 0x181D4904), RAPIDJSON_UINT64_C2(0x14D6695B, 0x193BF80D) },
+        { RAPIDJSON_UINT64_C2(0xCB9E5DD4, 0x134AA0D0), RAPIDJSON_UINT64_C2(0x10AB877C, 0x142FF9A4) },
+        { RAPIDJSON_UINT64_C2(0xDF63C953, 0x5211014D), RAPIDJSON_UINT64_C2(0x1AAC0BF9, 0xB9E65C3A) },
+        { RAPIDJSON_UINT64_C2(0x191CA10F, 0x74DA6771), RAPIDJSON_UINT64_C2(0x15566FFA, 0xFB1EB02F) },
+        { RAPIDJSON_UINT64_C2(0xADB080D9, 0x2A4852C1), RAPIDJSON_UINT64_C2(0x1111F32F, 0x2F4BC025) },
+        { RAPIDJSON_UINT64_C2(0x15E7348E, 0xAA0D5134), RAPIDJSON_UINT64_C2(0x1B4FEB7E, 0xB212CD09) },
+        { RAPIDJSON_UINT64_C2(0xAB1F5D3E, 0xEE710DC4), RAPIDJSON_UINT64_C2(0x15D98932, 0x280F0A6D) },
+        { RAPIDJSON_UINT64_C2(0xBC191765, 0x8B8DA49D), RAPIDJSON_UINT64_C2(0x117AD428, 0x200C0857) },
+        { RAPIDJSON_UINT64_C2(0x2CF4F23C, 0x127C3A94), RAPIDJSON_UINT64_C2(0x1BF7B9D9, 0xCCE00D59) },
+        { RAPIDJSON_UINT64_C2(0xF0C3F4FC, 0xDB969543), RAPIDJSON_UINT64_C2(0x165FC7E1, 0x70B33DE0) },
+        { RAPIDJSON_UINT64_C2(0x5A365D97, 0x16121103), RAPIDJSON_UINT64_C2(0x11E63981, 0x26F5CB1A) },
+        { RAPIDJSON_UINT64_C2(0x9056FC24, 0xF01CE804), RAPIDJSON_UINT64_C2(0x1CA38F35, 0x0B22DE90) },
+        { RAPIDJSON_UINT64_C2(0xD9DF301D, 0x8CE3ECD0), RAPIDJSON_UINT64_C2(0x16E93F5D, 0xA2824BA6) },
+        { RAPIDJSON_UINT64_C2(0xE17F59B1, 0x3D8323DA), RAPIDJSON_UINT64_C2(0x125432B1, 0x4ECEA2EB) },
+        { RAPIDJSON_UINT64_C2(0x68CBC2B5, 0x2F38395C), RAPIDJSON_UINT64_C2(0x1D53844E, 0xE47DD179) },
+        { RAPIDJSON_UINT64_C2(0x53D6355D, 0xBF602DE3), RAPIDJSON_UINT64_C2(0x17760372, 0x5064A794) },
+        { RAPIDJSON_UINT64_C2(0xA9782AB1, 0x65E68B1C), RAPIDJSON_UINT64_C2(0x12C4CF8E, 0xA6B6EC76) },
+        { RAPIDJSON_UINT64_C2(0x0F26AAB5, 0x6FD744FA), RAPIDJSON_UINT64_C2(0x1E07B27D, 0xD78B13F1) },
+        { RAPIDJSON_UINT64_C2(0x3F52222A, 0xBFDF6A62), RAPIDJSON_UINT64_C2(0x18062864, 0xAC6F4327) },
+        { RAPIDJSON_UINT64_C2(0x65DB4E88, 0x997F884E), RAPIDJSON_UINT64_C2(0x13382050, 0x89F29C1F) },
+        { RAPIDJSON_UINT64_C2(0x6FC54A74, 0x28CC0D4A), RAPIDJSON_UINT64_C2(0x1EC033B4, 0x0FEA9365) },
+        { RAPIDJSON_UINT64_C2(0x596AA1F6, 0x8709A43B), RAPIDJSON_UINT64_C2(0x1899C2F6, 0x73220F84) },
+        { RAPIDJSON_UINT64_C2(0xADEEE7F8, 0x6C07B696), RAPIDJSON_UINT64_C2(0x13AE3591, 0xF5B4D936) },
+        { RAPIDJSON_UINT64_C2(0x497E3FF3, 0xE00C5756), RAPIDJSON_UINT64_C2(0x1F7D2283, 0x22BAF524) },
+        { RAPIDJSON_UINT64_C2(0xD464FFF6, 0x4CD6AC45), RAPIDJSON_UINT64_C2(0x1930E868, 0xE89590E9) },
+        { RAPIDJSON_UINT64_C2(0x4383FFF8, 0x3D7889D1), RAPIDJSON_UINT64_C2(0x14272053, 0xED4473EE) },
+        { RAPIDJSON_UINT64_C2(0xCF9CCCC6, 0x9793A174), RAPIDJSON_UINT64_C2(0x101F4D0F, 0xF1038FF1) },
+        { RAPIDJSON_UINT64_C2(0x7F6147A4, 0x25B90252), RAPIDJSON_UINT64_C2(0x19CBAE7F, 0xE805B31C) },
+        { RAPIDJSON_UINT64_C2(0xCC4DD2E9, 0xB7C7350F), RAPIDJSON_UINT64_C2(0x14A2F1FF, 0xECD15C16) },
+        { RAPIDJSON_UINT64_C2(0x3D0B0F21, 0x5FD290D9), RAPIDJSON_UINT64_C2(0x10825B33, 0x23DAB012) },
+        { RAPIDJSON_UINT64_C2(0x61AB4B68, 0x9950E7C1), RAPIDJSON_UINT64_C2(0x1A6A2B85, 0x062AB350) },
+        { RAPIDJSON_UINT64_C2(0x4E22A2BA, 0x1440B967), RAPIDJSON_UINT64_C2(0x1521BC6A, 0x6B555C40) },
+        { RAPIDJSON_UINT64_C2(0x0B4EE894, 0xDD009453), RAPIDJSON_UINT64_C2(0x10E7C9EE, 0xBC4449CD) },
+        { RAPIDJSON_UINT64_C2(0x1217DA87, 0xC800ED51), RAPIDJSON_UINT64_C2(0x1B0C764A, 0xC6D3A948) },
+        { RAPIDJSON_UINT64_C2(0xDB46486C, 0xA000BDDA), RAPIDJSON_UINT64_C2(0x15A391D5, 0x6BDC876C) },
+        { RAPIDJSON_UINT64_C2(0x490506BD, 0x4CCD64AF), RAPIDJSON_UINT64_C2(0x114FA7DD, 0xEFE39F8A) },
+        { RAPIDJSON_UINT64_C2(0xA8080AC8, 0x7AE23AB1), RAPIDJSON_UINT64_C2(0x1BB2A62F, 0xE638FF43) },
+        { RAPIDJSON_UINT64_C2(0x5339A239, 0xFBE82EF4), RAPIDJSON_UINT64_C2(0x162884F3, 0x1E93FF69) },
+        { RAPIDJSON_UINT64_C2(0x75C7B4FB, 0x2FECF25D), RAPIDJSON_UINT64_C2(0x11BA03F5, 0xB20FFF87) },
+        { RAPIDJSON_UINT64_C2(0x22D92191, 0xE647EA2E), RAPIDJSON_UINT64_C2(0x1C5CD322, 0xB67FFF3F) },
+        { RAPIDJSON_UINT64_C2(0xB57A8141, 0x850654F2), RAPIDJSON_UINT64_C2(0x16B0A8E8, 0x91FFFF65) },
+        { RAPIDJSON_UINT64_C2(0xC4620101, 0x373843F5), RAPIDJSON_UINT64_C2(0x1226ED86, 0xDB3332B7) },
+        { RAPIDJSON_UINT64_C2(0x3A366801, 0xF1F39FEE), RAPIDJSON_UINT64_C2(0x1D0B15A4, 0x91EB8459) },
+        { RAPIDJSON_UINT64_C2(0xFB5EB99B, 0x27F6198B), RAPIDJSON_UINT64_C2(0x173C1150, 0x74BC69E0) },
+        { RAPIDJSON_UINT64_C2(0x2F7EFAE2, 0x865E7AD6), RAPIDJSON_UINT64_C2(0x12967440, 0x5D6387E7) },
+        { RAPIDJSON_UINT64_C2(0xE597F7D0, 0xD6FD9156), RAPIDJSON_UINT64_C2(0x1DBD86CD, 0x6238D971) },
+        { RAPIDJSON_UINT64_C2(0x8479930D, 0x78CADAAB), RAPIDJSON_UINT64_C2(0x17CAD23D, 0xE82D7AC1) },
+        { RAPIDJSON_UINT64_C2(0xD0614271, 0x2D6F1556), RAPIDJSON_UINT64_C2(0x1308A831, 0x868AC89A) },
+        { RAPIDJSON_UINT64_C2(0x4D686A4E, 0xAF182222), RAPIDJSON_UINT64_C2(0x1E74404F, 0x3DAADA91) },
+        { RAPIDJSON_UINT64_C2(0xA453883E, 0xF279B4E8), RAPIDJSON_UINT64_C2(0x185D003F, 0x6488AEDA) },
+        { RAPIDJSON_UINT64_C2(0xE9DC6CFF, 0x28615D87), RAPIDJSON_UINT64_C2(0x137D99CC, 0x506D58AE) },
+        { RAPIDJSON_UINT64_C2(0xA960AE65, 0x0D6895A4), RAPIDJSON_UINT64_C2(0x1F2F5C7A, 0x1A488DE4) },
+        { RAPIDJSON_UINT64_C2(0xBAB3BEB7, 0x3DED4483), RAPIDJSON_UINT64_C2(0x18F2B061, 0xAEA07183) }
+    };
+    RAPIDJSON_ASSERT(q >= 0 && q < 291);
+    return kPow5InvSplit[q];
+}
+
+//! Returns the 125 most significant bits of 5^i, as { low, high }.
+inline const uint64_t* RyuPow5Split(int i) {
+    // Generated with exact integer arithmetic, for i in [0, 325]
+    static const uint64_t kPow5Split[326][2] = {
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x10000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x14000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x19000000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1F400000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x13880000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x186A0000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1E848000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1312D000, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x17D78400, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1DCD6500, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x12A05F20, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x174876E8, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1D1A94A2, 0x00000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x12309CE5, 0x40000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x16BCC41E, 0x90000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1C6BF526, 0x34000000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x11C37937, 0xE0800000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x16345785, 0xD8A00000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1BC16D67, 0x4EC80000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1158E460, 0x913D0000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x15AF1D78, 0xB58C4000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1B1AE4D6, 0xE2EF5000) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x10F0CF06, 0x4DD59200) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x152D02C7, 0xE14AF680) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1A784379, 0xD99DB420) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x108B2A2C, 0x28029094) },
+        { RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_UINT64_C2(0x14ADF4B7, 0x320334B9) },
+        { RAPIDJSON_UINT64_C2(0x40000000, 0x00000000), RAPIDJSON_UINT64_C2(0x19D971E4, 0xFE8401E7) },
+        { RAPIDJSON_UINT64_C2(0x88000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1027E72F, 0x1F128130) },
+        { RAPIDJSON_UINT64_C2(0xAA000000, 0x00000000), RAPIDJSON_UINT64_C2(0x1431E0FA, 0xE6D7217C) },
+        { RAPIDJSON_UINT64_C2(0xD4800000, 0x00000000), RAPIDJSON_UINT64_C2(0x193E5939, 0xA08CE9DB) },
+        { RAPIDJSON_UINT64_C2(0xC9A00000, 0x00000000), RAPIDJSON_UINT64_C2(0x1F8DEF88, 0x08B02452) },
+        { RAPIDJSON_UINT64_C2(0xBE040000, 0x00000000), RAPIDJSON_UINT64_C2(0x13B8B5B5, 0x056E16B3) },
+        { RAPIDJSON_UINT64_C2(0xAD850000, 0x00000000), RAPIDJSON_UINT64_C2(0x18A6E322, 0x46C99C60) },
+        { RAPIDJSON_UINT64_C2(0xD8E64000, 0x00000000), RAPIDJSON_UINT64_C2(0x1ED09BEA, 0xD87C0378) },
+        { RAPIDJSON_UINT64_C2(0x878FE800, 0x00000000), RAPIDJSON_UINT64_C2(0x13426172, 0xC74D822B) },
+        { RAPIDJSON_UINT64_C2(0x6973E200, 0x00000000), RAPIDJSON_UINT64_C2(0x1812F9CF, 0x7920E2B6) },
+        { RAPIDJSON_UINT64_C2(0x03D0DA80, 0x00000000), RAPIDJSON_UINT64_C2(0x1E17B843, 0x57691B64) },
+        { RAPIDJSON_UINT64_C2(0x82628890, 0x00000000), RAPIDJSON_UINT64_C2(0x12CED32A, 0x16A1B11E) },
+        { RAPIDJSON_UINT64_C2(0x22FB2AB4, 0x00000000), RAPIDJSON_UINT64_C2(0x178287F4, 0x9C4A1D66) },
+        { RAPIDJSON_UINT64_C2(0xABB9F561, 0x00000000), RAPIDJSON_UINT64_C2(0x1D6329F1, 0xC35CA4BF) },
+        { RAPIDJSON_UINT64_C2(0xCB54395C, 0xA0000000), RAPIDJSON_UINT64_C2(0x125DFA37, 0x1A19E6F7) },
+        { RAPIDJSON_UINT64_C2(0xBE2947B3, 0xC8000000), RAPIDJSON_UINT64_C2(0x16F578C4, 0xE0A060B5) },
+        { RAPIDJSON_UINT64_C2(0x2DB399A0, 0xBA000000), RAPIDJSON_UINT64_C2(0x1CB2D6F6, 0x18C878E3) },
+        { RAPIDJSON_UINT64_C2(0xFC904004, 0x74400000), RAPIDJSON_UINT64_C2(0x11EFC659, 0xCF7D4B8D) },
+        { RAPIDJSON_UINT64_C2(0x7BB45005, 0x91500000), RAPIDJSON_UINT64_C2(0x166BB7F0, 0x435C9E71) },
+        { RAPIDJSON_UINT64_C2(0xDAA16406, 0xF5A40000), RAPIDJSON_UINT64_C2(0x1C06A5EC, 0x5433C60D) },
+        { RAPIDJSON_UINT64_C2(0xA8A4DE84, 0x59868000), RAPIDJSON_UINT64_C2(0x118427B3, 0xB4A05BC8) },
+        { RAPIDJSON_UINT64_C2(0xD2CE1625, 0x6FE82000), RAPIDJSON_UINT64_C2(0x15E531A0, 0xA1C872BA) },
+        { RAPIDJSON_UINT64_C2(0x87819BAE, 0xCBE22800), RAPIDJSON_UINT64_C2(0x1B5E7E08, 0xCA3A8F69) },
+        { RAPIDJSON_UINT64_C2(0xF4B1014D, 0x3F6D5900), RAPIDJSON_UINT64_C2(0x111B0EC5, 0x7E6499A1) },
+        { RAPIDJSON_UINT64_C2(0x71DD41A0, 0x8F48AF40), RAPIDJSON_UINT64_C2(0x1561D276, 0xDDFDC00A) },
+        { RAPIDJSON_UINT64_C2(0x0E549208, 0xB31ADB10), RAPIDJSON_UINT64_C2(0x1ABA4714, 0x957D300D) },
+        { RAPIDJSON_UINT64_C2(0x28F4DB45, 0x6FF0C8EA), RAPIDJSON_UINT64_C2(0x10B46C6C, 0xDD6E3E08) },
+        { RAPIDJSON_UINT64_C2(0x33321216, 0xCBECFB24), RAPIDJSON_UINT64_C2(0x14E18788, 0x14C9CD8A) },
+        { RAPIDJSON_UINT64_C2(0xBFFE969C, 0x7EE839ED), RAPIDJSON_UINT64_C2(0x1A19E96A, 0x19FC40EC) },
+        { RAPIDJSON_UINT64_C2(0xF7FF1E21, 0xCF512434), RAPIDJSON_UINT64_C2(0x105031E2, 0x503DA893) },
+        { RAPIDJSON_UINT64_C2(0xF5FEE5AA, 0x43256D41), RAPIDJSON_UINT64_C2(0x14643E5A, 0xE44D12B8) },
+        { RAPIDJSON_UINT64_C2(0x337E9F14, 0xD3EEC892), RAPIDJSON_UINT64_C2(0x197D4DF1, 0x9D605767) },
+        { RAPIDJSON_UINT64_C2(0x005E46DA, 0x08EA7AB6), RAPIDJSON_UINT64_C2(0x1FDCA16E, 0x04B86D41) },
+        { RAPIDJSON_UINT64_C2(0xA03AEC48, 0x45928CB2), RAPIDJSON_UINT64_C2(0x13E9E4E4, 0xC2F34448) },
+        { RAPIDJSON_UINT64_C2(0xC849A75A, 0x56F72FDE), RAPIDJSON_UINT64_C2(0x18E45E1D, 0xF3B0155A) },
+        { RAPIDJSON_UINT64_C2(0x7A5C1130, 0xECB4FBD6), RAPIDJSON_UINT64_C2(0x1F1D75A5, 0x709C1AB1) },
+        { RAPIDJSON_UINT64_C2(0xEC798ABE, 0x93F11D65), RAPIDJSON_UINT64_C2(0x13726987, 0x666190AE) },
+        { RAPIDJSON_UINT64_C2(0xA797ED6E, 0x38ED64BF), RAPIDJSON_UINT64_C2(0x184F03E9, 0x3FF9F4DA) },
+        { RAPIDJSON_UINT64_C2(0x517DE8C9, 0xC728BDEF), RAPIDJSON_UINT64_C2(0x1E62C4E3, 0x8FF87211) },
+        { RAPIDJSON_UINT64_C2(0xD2EEB17E, 0x1C7976B5), RAPIDJSON_UINT64_C2(0x12FDBB0E, 0x39FB474A) },
+        { RAPIDJSON_UINT64_C2(0x87AA5DDD, 0xA397D462), RAPIDJSON_UINT64_C2(0x17BD29D1, 0xC87A191D) },
+        { RAPIDJSON_UINT64_C2(0xE994F555, 0x0C7DC97B), RAPIDJSON_UINT64_C2(0x1DAC7446, 0x3A989F64) },
+        { RAPIDJSON_UINT64_C2(0x11FD1955, 0x27CE9DED), RAPIDJSON_UINT64_C2(0x128BC8AB, 0xE49F639F) },
+        { RAPIDJSON_UINT64_C2(0xD67C5FAA, 0x71C24568), RAPIDJSON_UINT64_C2(0x172EBAD6, 0xDDC73C86) },
+        { RAPIDJSON_UINT64_C2(0x8C1B7795, 0x0E32D6C2), RAPIDJSON_UINT64_C2(0x1CFA698C, 0x95390BA8) },
+        { RAPIDJSON_UINT64_C2(0x57912ABD, 0x28DFC639), RAPIDJSON_UINT64_C2(0x121C81F7, 0xDD43A749) },
+        { RAPIDJSON_UINT64_C2(0xAD75756C, 0x7317B7C8), RAPIDJSON_UINT64_C2(0x16A3A275, 0xD494911B) },
+        { RAPIDJSON_UINT64_C2(0x98D2D2C7, 0x8FDDA5BA), RAPIDJSON_UINT64_C2(0x1C4C8B13, 0x49B9B562) },
+        { RAPIDJSON_UINT64_C2(0x9F83C3BC, 0xB9EA8794), RAPIDJSON_UINT64_C2(0x11AFD6EC, 0x0E14115D) },
+        { RAPIDJSON_UINT64_C2(0x0764B4AB, 0xE8652979), RAPIDJSON_UINT64_C2(0x161BCCA7, 0x119915B5) },
+        { RAPIDJSON_UINT64_C2(0x493DE1D6, 0xE27E73D7), RAPIDJSON_UINT64_C2(0x1BA2BFD0, 0xD5FF5B22) },
+        { RAPIDJSON_UINT64_C2(0x6DC6AD26, 0x4D8F0866), RAPIDJSON_UINT64_C2(0x1145B7E2, 0x85BF98F5) },
+        { RAPIDJSON_UINT64_C2(0xC938586F, 0xE0F2CA80), RAPIDJSON_UINT64_C2(0x159725DB, 0x272F7F32) },
+        { RAPIDJSON_UINT64_C2(0x7B866E8B, 0xD92F7D20), RAPIDJSON_UINT64_C2(0x1AFCEF51, 0xF0FB5EFF) },
+        { RAPIDJSON_UINT64_C2(0xAD340517, 0x67BDAE34), RAPIDJSON_UINT64_C2(0x10DE1593, 0x369D1B5F) },
+        { RAPIDJSON_UINT64_C2(0x9881065D, 0x41AD19C1), RAPIDJSON_UINT64_C2(0x15159AF8, 0x04446237) },
+        { RAPIDJSON_UINT64_C2(0x7EA147F4, 0x92186032), RAPIDJSON_UINT64_C2(0x1A5B01B6, 0x05557AC5) },
+        { RAPIDJSON_UINT64_C2(0x6F24CCF8, 0xDB4F3C1F), RAPIDJSON_UINT64_C2(0x1078E111, 0xC3556CBB) },
+        { RAPIDJSON_UINT64_C2(0x4AEE0037, 0x12230B27), RAPIDJSON_UINT64_C2(0x14971956, 0x342AC7EA) },
+        { RAPIDJSON_UINT64_C2(0xDDA98044, 0xD6ABCDF0), RAPIDJSON_UINT64_C2(0x19BCDFAB, 0xC13579E4) },
+        { RAPIDJSON_UINT64_C2(0x0A89F02B, 0x062B60B6), RAPIDJSON_UINT64_C2(0x10160BCB, 0x58C16C2F) },
+        { RAPIDJSON_UINT64_C2(0xCD2C6C35, 0xC7B638E4), RAPIDJSON_UINT64_C2(0x141B8EBE, 0x2EF1C73A) },
+        { RAPIDJSON_UINT64_C2(0x80778743, 0x39A3C71D), RAPIDJSON_UINT64_C2(0x1922726D, 0xBAAE3909) },
+        { RAPIDJSON_UINT64_C2(0xE0956914, 0x080CB8E4), RAPIDJSON_UINT64_C2(0x1F6B0F09, 0x2959C74B) },
+        { RAPIDJSON_UINT64_C2(0x6C5D61AC, 0x8507F38E), RAPIDJSON_UINT64_C2(0x13A2E965, 0xB9D81C8F) },
+        { RAPIDJSON_UINT64_C2(0x4774BA17, 0xA649F072), RAPIDJSON_UINT64_C2(0x188BA3BF, 0x284E23B3) },
+        { RAPIDJSON_UINT64_C2(0x1951E89D, 0x8FDC6C8F), RAPIDJSON_UINT64_C2(0x1EAE8CAE, 0xF261ACA0) },
+        { RAPIDJSON_UINT64_C2(0x0FD33162, 0x79E9C3D9), RAPIDJSON_UINT64_C2(0x132D17ED, 0x577D0BE4) },
+        { RAPIDJSON_UINT64_C2(0x13C7FDBB, 0x186434CF), RAPIDJSON_UINT64_C2(0x17F85DE8, 0xAD5C4EDD) },
+        { RAPIDJSON_UINT64_C2(0x58B9FD29, 0xDE7D4203), RAPIDJSON_UINT64_C2(0x1DF67562, 0xD8B36294) },
+        { RAPIDJSON_UINT64_C2(0xB7743E3A, 0x2B0E4942), RAPIDJSON_UINT64_C2(0x12BA095D, 0xC7701D9C) },
+        { RAPIDJSON_UINT64_C2(0xE5514DC8, 0xB5D1DB92), RAPIDJSON_UINT64_C2(0x17688BB5, 0x394C2503) },
+        { RAPIDJSON_UINT64_C2(0xDEA5A13A, 0xE3465277), RAPIDJSON_UINT64_C2(0x1D42AEA2, 0x879F2E44) },
+        { RAPIDJSON_UINT64_C2(0x0B2784C4, 0xCE0BF38A), RAPIDJSON_UINT64_C2(0x1249AD25, 0x94C37CEB) },
+        { RAPIDJSON_UINT64_C2(0xCDF165F6, 0x018EF06D), RAPIDJSON_UINT64_C2(0x16DC186E, 0xF9F45C25) },
+        { RAPIDJSON_UINT64_C2(0x416DBF73, 0x81F2AC88), RAPIDJSON_UINT64_C2(0x1C931E8A, 0xB871732F) },
+        { RAPIDJSON_UINT64_C2(0x88E497A8, 0x3137ABD5), RAPIDJSON_UINT64_C2(0x11DBF316, 0xB346E7FD) },
+        { RAPIDJSON_UINT64_C2(0xEB1DBD92, 0x3D8596CA), RAPIDJSON_UINT64_C2(0x1652EFDC, 0x6018A1FC) },
+        { RAPIDJSON_UINT64_C2(0x25E52CF6, 0xCCE6FC7D), RAPIDJSON_UINT64_C2(0x1BE7ABD3, 0x781ECA7C) },
+        { RAPIDJSON_UINT64_C2(0x97AF3C1A, 0x40105DCE), RAPIDJSON_UINT64_C2(0x1170CB64, 0x2B133E8D) },
+        { RAPIDJSON_UINT64_C2(0xFD9B0B20, 0xD0147542), RAPIDJSON_UINT64_C2(0x15CCFE3D, 0x35D80E30) },
+        { RAPIDJSON_UINT64_C2(0x3D01CDE9, 0x04199292), RAPIDJSON_UINT64_C2(0x1B403DCC, 0x834E11BD) },
+        { RAPIDJSON_UINT64_C2(0x462120B1, 0xA28FFB9B), RAPIDJSON_UINT64_C2(0x1108269F, 0xD210CB16) },
+        { RAPIDJSON_UINT64_C2(0xD7A968DE, 0x0B33FA82), RAPIDJSON_UINT64_C2(0x154A3047, 0xC694FDDB) },
+        { RAPIDJSON_UINT64_C2(0xCD93C315, 0x8E00F923), RAPIDJSON_UINT64_C2(0x1A9CBC59, 0xB83A3D52) },
+        { RAPIDJSON_UINT64_C2(0xC07C59ED, 0x78C09BB6), RAPIDJSON_UINT64_C2(0x10A1F5B8, 0x13246653) },
+        { RAPIDJSON_UINT64_C2(0xB09B7068, 0xD6F0C2A3), RAPIDJSON_UINT64_C2(0x14CA7326, 0x17ED7FE8) },
+        { RAPIDJSON_UINT64_C2(0xDCC24C83, 0x0CACF34C), RAPIDJSON_UINT64_C2(0x19FD0FEF, 0x9DE8DFE2) },
+        { RAPIDJSON_UINT64_C2(0xC9F96FD1, 0xE7EC180F), RAPIDJSON_UINT64_C2(0x103E29F5, 0xC2B18BED) },
+        { RAPIDJSON_UINT64_C2(0x3C77CBC6, 0x61E71E13), RAPIDJSON_UINT64_C2(0x144DB473, 0x335DEEE9) },
+        { RAPIDJSON_UINT64_C2(0x8B95BEB7, 0xFA60E598), RAPIDJSON_UINT64_C2(0x19612190, 0x00356AA3) },
+        { RAPIDJSON_UINT64_C2(0x6E7B2E65, 0xF8F91EFE), RAPIDJSON_UINT64_C2(0x1FB969F4, 0x0042C54C) },
+        { RAPIDJSON_UINT64_C2(0xC50CFCFF, 0xBB9BB35F), RAPIDJSON_UINT64_C2(0x13D3E238, 0x8029BB4F) },
+        { RAPIDJSON_UINT64_C2(0xB6503C3F, 0xAA82A037), RAPIDJSON_UINT64_C2(0x18C8DAC6, 0xA0342A23) },
+        { RAPIDJSON_UINT64_C2(0xA3E44B4F, 0x95234844), RAPIDJSON_UINT64_C2(0x1EFB1178, 0x484134AC) },
+        { RAPIDJSON_UINT64_C2(0xE66EAF11, 0xBD360D2B), RAPIDJSON_UINT64_C2(0x135CEAEB, 0x2D28C0EB) },
+        { RAPIDJSON_UINT64_C2(0xE00A5AD6, 0x2C839075), RAPIDJSON_UINT64_C2(0x183425A5, 0xF872F126) },
+        { RAPIDJSON_UINT64_C2(0x980CF18B, 0xB7A47493), RAPIDJSON_UINT64_C2(0x1E412F0F, 0x768FAD70) },
+        { RAPIDJSON_UINT64_C2(0x5F0816F7, 0x52C6C8DC), RAPIDJSON_UINT64_C2(0x12E8BD69, 0xAA19CC66) },
+        { RAPIDJSON_UINT64_C2(0xF6CA1CB5, 0x27787B13), RAPIDJSON_UINT64_C2(0x17A2ECC4, 0x14A03F7F) },
+        { RAPIDJSON_UINT64_C2(0xF47CA3E2, 0x715699D7), RAPIDJSON_UINT64_C2(0x1D8BA7F5, 0x19C84F5F) },
+        { RAPIDJSON_UINT64_C2(0xF8CDE66D, 0x86D62026), RAPIDJSON_UINT64_C2(0x127748F9, 0x301D319B) },
+        { RAPIDJSON_UINT64_C2(0xF7016008, 0xE88BA830), RAPIDJSON_UINT64_C2(0x17151B37, 0x7C247E02) },
+        { RAPIDJSON_UINT64_C2(0xB4C1B80B, 0x22AE923C), RAPIDJSON_UINT64_C2(0x1CDA6205, 0x5B2D9D83) },
+        { RAPIDJSON_UINT64_C2(0x50F91306, 0xF5AD1B65), RAPIDJSON_UINT64_C2(0x12087D43, 0x58FC8272) },
+        { RAPIDJSON_UINT64_C2(0xE53757C8, 0xB318623F), RAPIDJSON_UINT64_C2(0x168A9C94, 0x2F3BA30E) },
+        { RAPIDJSON_UINT64_C2(0x9E852DBA, 0xDFDE7ACF), RAPIDJSON_UINT64_C2(0x1C2D43B9, 0x3B0A8BD2) },
+        { RAPIDJSON_UINT64_C2(0xA3133C94, 0xCBEB0CC1), RAPIDJSON_UINT64_C2(0x119C4A53, 0xC4E69763) },
+        { RAPIDJSON_UINT64_C2(0x8BD80BB9, 0xFEE5CFF1), RAPIDJSON_UINT64_C2(0x16035CE8, 0xB6203D3C) },
+        { RAPIDJSON_UINT64_C2(0xAECE0EA8, 0x7E9F43EE), RAPIDJSON_UINT64_C2(0x1B843422, 0xE3A84C8B) },
+        { RAPIDJSON_UINT64_C2(0x4D40C929, 0x4F238A75), RAPIDJSON_UINT64_C2(0x1132A095, 0xCE492FD7) },
+        { RAPIDJSON_UINT64_C2(0x2090FB73, 0xA2EC6D12), RAPIDJSON_UINT64_C2(0x157F48BB, 0x41DB7BCD) },
+        { RAPIDJSON_UINT64_C2(0x68B53A50, 0x8BA78856), RAPIDJSON_UINT64_C2(0x1ADF1AEA, 0x12525AC0) },
+        { RAPIDJSON_UINT64_C2(0x41714472, 0x5748B536), RAPIDJSON_UINT64_C2(0x10CB70D2, 0x4B7378B8) },
+        { RAPIDJSON_UINT64_C2(0x51CD958E, 0xED1AE283), RAPIDJSON_UINT64_C2(0x14FE4D06, 0xDE5056E6) },
+        { RAPIDJSON_UINT64_C2(0xE640FAF2, 0xA8619B24), RAPIDJSON_UINT64_C2(0x1A3DE048, 0x95E46C9F) },
+        { RAPIDJSON_UINT64_C2(0xEFE89CD7, 0xA93D00F7), RAPIDJSON_UINT64_C2(0x1066AC2D, 0x5DAEC3E3) },
+        { RAPIDJSON_UINT64_C2(0xEBE2C40D, 0x938C4134), RAPIDJSON_UINT64_C2(0x14805738, 0xB51A74DC) },
+        { RAPIDJSON_UINT64_C2(0x26DB7510, 0xF86F5181), RAPIDJSON_UINT64_C2(0x19A06D06, 0xE2611214) },
+        { RAPIDJSON_UINT64_C2(0x9849292A, 0x9B4592F1), RAPIDJSON_UINT64_C2(0x10044424, 0x4D7CAB4C) },
+        { RAPIDJSON_UINT64_C2(0xBE5B7375, 0x4216F7AD), RAPIDJSON_UINT64_C2(0x1405552D, 0x60DBD61F) },
+        { RAPIDJSON_UINT64_C2(0xADF25052, 0x929CB598), RAPIDJSON_UINT64_C2(0x1906AA78, 0xB912CBA7) },
+        { RAPIDJSON_UINT64_C2(0x996EE467, 0x3743E2FF), RAPIDJSON_UINT64_C2(0x1F485516, 0xE7577E91) },
+        { RAPIDJSON_UINT64_C2(0xFFE54EC0, 0x828A6DDF), RAPIDJSON_UINT64_C2(0x138D352E, 0x5096AF1A) },
+        { RAPIDJSON_UINT64_C2(0xBFDEA270, 0xA32D0957), RAPIDJSON_UINT64_C2(0x18708279, 0xE4BC5AE1) },
+        { RAPIDJSON_UINT64_C2(0x2FD64B0C, 0xCBF84BAD), RAPIDJSON_UINT64_C2(0x1E8CA318, 0x5DEB719A) },
+        { RAPIDJSON_UINT64_C2(0x5DE5EEE7, 0xFF7B2F4C), RAPIDJSON_UINT64_C2(0x1317E5EF, 0x3AB32700) },
+        { RAPIDJSON_UINT64_C2(0x755F6AA1, 0xFF59FB1F), RAPIDJSON_UINT64_C2(0x17DDDF6B, 0x095FF0C0) },
+        { RAPIDJSON_UINT64_C2(0x92B7454A, 0x7F3079E7), RAPIDJSON_UINT64_C2(0x1DD55745, 0xCBB7ECF0) },
+        { RAPIDJSON_UINT64_C2(0x5BB28B4E, 0x8F7E4C30), RAPIDJSON_UINT64_C2(0x12A5568B, 0x9F52F416) },
+        { RAPIDJSON_UINT64_C2(0xF29F2E22, 0x335DDF3C), RAPIDJSON_UINT64_C2(0x174EAC2E, 0x8727B11B) },
+        { RAPIDJSON_UINT64_C2(0xEF46F9AA, 0xC035570B), RAPIDJSON_UINT64_C2(0x1D22573A, 0x28F19D62) },
+        { RAPIDJSON_UINT64_C2(0xD58C5C0A, 0xB8215667), RAPIDJSON_UINT64_C2(0x12357684, 0x5997025D) },
+        { RAPIDJSON_UINT64_C2(0x4AEF730D, 0x6629AC01), RAPIDJSON_UINT64_C2(0x16C2D425, 0x6FFCC2F5) },
+        { RAPIDJSON_UINT64_C2(0x9DAB4FD0, 0xBFB41701), RAPIDJSON_UINT64_C2(0x1C73892E, 0xCBFBF3B2) },
+        { RAPIDJSON_UINT64_C2(0xA28B11E2, 0x77D08E60), RAPIDJSON_UINT64_C2(0x11C835BD, 0x3F7D784F) },
+        { RAPIDJSON_UINT64_C2(0x8B2DD65B, 0x15C4B1F9), RAPIDJSON_UINT64_C2(0x163A432C, 0x8F5CD663) },
+        { RAPIDJSON_UINT64_C2(0x6DF94BF1, 0xDB35DE77), RAPIDJSON_UINT64_C2(0x1BC8D3F7, 0xB3340BFC) },
+        { RAPIDJSON_UINT64_C2(0xC4BBCF77, 0x2901AB0A), RAPIDJSON_UINT64_C2(0x115D847A, 0xD000877D) },
+        { RAPIDJSON_UINT64_C2(0x35EAC354, 0xF34215CD), RAPIDJSON_UINT64_C2(0x15B4E599, 0x8400A95D) },
+        { RAPIDJSON_UINT64_C2(0x8365742A, 0x30129B40), RAPIDJSON_UINT64_C2(0x1B221EFF, 0xE500D3B4) },
+        { RAPIDJSON_UINT64_C2(0xD21F689A, 0x5E0BA108), RAPIDJSON_UINT64_C2(0x10F5535F, 0xEF208450) },
+        { RAPIDJSON_UINT64_C2(0x06A742C0, 0xF58E894A), RAPIDJSON_UINT64_C2(0x1532A837, 0xEAE8A565) },
+        { RAPIDJSON_UINT64_C2(0x48511371, 0x32F22B9D), RAPIDJSON_UINT64_C2(0x1A7F5245, 0xE5A2CEBE) },
+        { RAPIDJSON_UINT64_C2(0xED32AC26, 0xBFD75B42), RAPIDJSON_UINT64_C2(0x108F936B, 0xAF85C136) },
+        { RAPIDJSON_UINT64_C2(0xA87F5730, 0x6FCD3212), RAPIDJSON_UINT64_C2(0x14B37846, 0x9B673184) },
+        { RAPIDJSON_UINT64_C2(0xD29F2CFC, 0x8BC07E97), RAPIDJSON_UINT64_C2(0x19E05658, 0x4240FDE5) },
+        { RAPIDJSON_UINT64_C2(0xA3A37C1D, 0xD7584F1E), RAPIDJSON_UINT64_C2(0x102C35F7, 0x29689EAF) },
+        { RAPIDJSON_UINT64_C2(0x8C8C5B25, 0x4D2E62E6), RAPIDJSON_UINT64_C2(0x14374374, 0xF3C2C65B) },
+        { RAPIDJSON_UINT64_C2(0x6FAF71EE, 0xA079FB9F), RAPIDJSON_UINT64_C2(0x19451452, 0x30B377F2) },
+        { RAPIDJSON_UINT64_C2(0x0B9B4E6A, 0x48987A87), RAPIDJSON_UINT64_C2(0x1F965966, 0xBCE055EF) },
+        { RAPIDJSON_UINT64_C2(0x67411102, 0x6D5F4C94), RAPIDJSON_UINT64_C2(0x13BDF7E0, 0x360C35B5) },
+        { RAPIDJSON_UINT64_C2(0xC1115543, 0x08B71FBA), RAPIDJSON_UINT64_C2(0x18AD75D8, 0x438F4322) },
+        { RAPIDJSON_UINT64_C2(0x7155AA93, 0xCAE4E7A8), RAPIDJSON_UINT64_C2(0x1ED8D34E, 0x547313EB) },
+        { RAPIDJSON_UINT64_C2(0x26D58A9C, 0x5ECF10C9), RAPIDJSON_UINT64_C2(0x13478410, 0xF4C7EC73) },
+        { RAPIDJSON_UINT64_C2(0xF08AED43, 0x7682D4FB), RAPIDJSON_UINT64_C2(0x18196515, 0x31F9E78F) },
+        { RAPIDJSON_UINT64_C2(0xECADA894, 0x54238A3A), RAPIDJSON_UINT64_C2(0x1E1FBE5A, 0x7E786173) },
+        { RAPIDJSON_UINT64_C2(0x73EC895C, 0xB4963664), RAPIDJSON_UINT64_C2(0x12D3D6F8, 0x8F0B3CE8) },
+        { RAPIDJSON_UINT64_C2(0x90E7ABB3, 0xE1BBC3FD), RAPIDJSON_UINT64_C2(0x1788CCB6, 0xB2CE0C22) },
+        { RAPIDJSON_UINT64_C2(0x352196A0, 0xDA2AB4FD), RAPIDJSON_UINT64_C2(0x1D6AFFE4, 0x5F818F2B) },
+        { RAPIDJSON_UINT64_C2(0x0134FE24, 0x885AB11E), RAPIDJSON_UINT64_C2(0x1262DFEE, 0xBBB0F97B) },
+        { RAPIDJSON_UINT64_C2(0xC1823DAD, 0xAA715D65), RAPIDJSON_UINT64_C2(0x16FB97EA, 0x6A9D37D9) },
+        { RAPIDJSON_UINT64_C2(0x31E2CD19, 0x150DB4BF), RAPIDJSON_UINT64_C2(0x1CBA7DE5, 0x054485D0) },
+        { RAPIDJSON_UINT64_C2(0x1F2DC02F, 0xAD2890F7), RAPIDJSON_UINT64_C2(0x11F48EAF, 0x234AD3A2) },
+        { RAPIDJSON_UINT64_C2(0xA6F9303B, 0x9872B535), RAPIDJSON_UINT64_C2(0x1671B25A, 0xEC1D888A) },
+        { RAPIDJSON_UINT64_C2(0x50B77C4A, 0x7E8F6282), RAPIDJSON_UINT64_C2(0x1C0E1EF1, 0xA724EAAD) },
+        { RAPIDJSON_UINT64_C2(0x5272ADAE, 0x8F199D91), RAPIDJSON_UINT64_C2(0x1188D357, 0x087712AC) },
+        { RAPIDJSON_UINT64_C2(0x670F591A, 0x32E004F6), RAPIDJSON_UINT64_C2(0x15EB082C, 0xCA94D757) },
+        { RAPIDJSON_UINT64_C2(0x40D32F60, 0xBF980633), RAPIDJSON_UINT64_C2(0x1B65CA37, 0xFD3A0D2D) },
+        { RAPIDJSON_UINT64_C2(0x4883FD9C, 0x77BF03E0), RAPIDJSON_UINT64_C2(0x111F9E62, 0xFE44483C) },
+        { RAPIDJSON_UINT64_C2(0x5AA4FD03, 0x95AEC4D8), RAPIDJSON_UINT64_C2(0x156785FB, 0xBDD55A4B) },
+        { RAPIDJSON_UINT64_C2(0x314E3C44, 0x7B1A760E), RAPIDJSON_UINT64_C2(0x1AC1677A, 0xAD4AB0DE) },
+        { RAPIDJSON_UINT64_C2(0xDED0E5AA, 0xCCF089C9), RAPIDJSON_UINT64_C2(0x10B8E0AC, 0xAC4EAE8A) },
+        { RAPIDJSON_UINT64_C2(0x96851F15, 0x802CAC3B), RAPIDJSON_UINT64_C2(0x14E718D7, 0xD7625A2D) },
+        { RAPIDJSON_UINT64_C2(0xFC2666DA, 0xE037D74A), RAPIDJSON_UINT64_C2(0x1A20DF0D, 0xCD3AF0B8) },
+        { RAPIDJSON_UINT64_C2(0x9D980048, 0xCC22E68E), RAPIDJSON_UINT64_C2(0x10548B68, 0xA044D673) },
+        { RAPIDJSON_UINT64_C2(0x84FE005A, 0xFF2BA032), RAPIDJSON_UINT64_C2(0x1469AE42, 0xC8560C10) },
+        { RAPIDJSON_UINT64_C2(0xA63D8071, 0xBEF6883E), RAPIDJSON_UINT64_C2(0x198419D3, 0x7A6B8F14) },
+        { RAPIDJSON_UINT64_C2(0xCFCCE08E, 0x2EB42A4E), RAPIDJSON_UINT64_C2(0x1FE52048, 0x590672D9) },
+        { RAPIDJSON_UINT64_C2(0x21E00C58, 0xDD309A70), RAPIDJSON_UINT64_C2(0x13EF342D, 0x37A407C8) },
+        { RAPIDJSON_UINT64_C2(0x2A580F6F, 0x147CC10D), RAPIDJSON_UINT64_C2(0x18EB0138, 0x858D09BA) },
+        { RAPIDJSON_UINT64_C2(0xB4EE134A, 0xD99BF150), RAPIDJSON_UINT64_C2(0x1F25C186, 0xA6F04C28) },
+        { RAPIDJSON_UINT64_C2(0x7114CC0E, 0xC80176D2), RAPIDJSON_UINT64_C2(0x137798F4, 0x28562F99) },
+        { RAPIDJSON_UINT64_C2(0xCD59FF12, 0x7A01D486), RAPIDJSON_UINT64_C2(0x18557F31, 0x326BBB7F) },
+        { RAPIDJSON_UINT64_C2(0xC0B07ED7, 0x188249A8), RAPIDJSON_UINT64_C2(0x1E6ADEFD, 0x7F06AA5F) },
+        { RAPIDJSON_UINT64_C2(0xD86E4F46, 0x6F516E09), RAPIDJSON_UINT64_C2(0x1302CB5E, 0x6F642A7B) },
+        { RAPIDJSON_UINT64_C2(0xCE89E318, 0x0B25C98B), RAPIDJSON_UINT64_C2(0x17C37E36, 0x0B3D351A) },
+        { RAPIDJSON_UINT64_C2(0x822C5BDE, 0x0DEF3BEE), RAPIDJSON_UINT64_C2(0x1DB45DC3, 0x8E0C8261) },
+        { RAPIDJSON_UINT64_C2(0xF15BB96A, 0xC8B58575), RAPIDJSON_UINT64_C2(0x1290BA9A, 0x38C7D17C) },
+        { RAPIDJSON_UINT64_C2(0x2DB2A7C5, 0x7AE2E6D2), RAPIDJSON_UINT64_C2(0x1734E940, 0xC6F9C5DC) },
+        { RAPIDJSON_UINT64_C2(0x391F51B6, 0xD99BA086), RAPIDJSON_UINT64_C2(0x1D022390, 0xF8B83753) },
+        { RAPIDJSON_UINT64_C2(0x03B39312, 0x48014454), RAPIDJSON_UINT64_C2(0x1221563A, 0x9B732294) },
+        { RAPIDJSON_UINT64_C2(0x04A077D6, 0xDA019569), RAPIDJSON_UINT64_C2(0x16A9ABC9, 0x424FEB39) },
+        { RAPIDJSON_UINT64_C2(0x45C895CC, 0x9081FAC3), RAPIDJSON_UINT64_C2(0x1C5416BB, 0x92E3E607) },
+        { RAPIDJSON_UINT64_C2(0x8B9D5D9F, 0xDA513CBA), RAPIDJSON_UINT64_C2(0x11B48E35, 0x3BCE6FC4) },
+        { RAPIDJSON_UINT64_C2(0xAE84B507, 0xD0E58BE8), RAPIDJSON_UINT64_C2(0x1621B1C2, 0x8AC20BB5) },
+        { RAPIDJSON_UINT64_C2(0x1A25E249, 0xC51EEEE3), RAPIDJSON_UINT64_C2(0x1BAA1E33, 0x2D728EA3) },
+        { RAPIDJSON_UINT64_C2(0xF057AD6E, 0x1B33554D), RAPIDJSON_UINT64_C2(0x114A52DF, 0xFC679925) },
+        { RAPIDJSON_UINT64_C2(0x6C6D98C9, 0xA2002AA1), RAPIDJSON_UINT64_C2(0x159CE797, 0xFB817F6F) },
+        { RAPIDJSON_UINT64_C2(0x4788FEFC, 0x0A803549), RAPIDJSON_UINT64_C2(0x1B04217D, 0xFA61DF4B) },
+        { RAPIDJSON_UINT64_C2(0x0CB59F5D, 0x8690214E), RAPIDJSON_UINT64_C2(0x10E294EE, 0xBC7D2B8F) },
+        { RAPIDJSON_UINT64_C2(0xCFE30734, 0xE83429A1), RAPIDJSON_UINT64_C2(0x151B3A2A, 0x6B9C7672) },
+        { RAPIDJSON_UINT64_C2(0x83DBC902, 0x2241340A), RAPIDJSON_UINT64_C2(0x1A6208B5, 0x0683940F) },
+        { RAPIDJSON_UINT64_C2(0xB2695DA1, 0x5568C086), RAPIDJSON_UINT64_C2(0x107D4571, 0x24123C89) },
+        { RAPIDJSON_UINT64_C2(0x1F03B509, 0xAAC2F0A7), RAPIDJSON_UINT64_C2(0x149C96CD, 0x6D16CBAC) },
+        { RAPIDJSON_UINT64_C2(0x26C4A24C, 0x1573ACD1), RAPIDJSON_UINT64_C2(0x19C3BC80, 0xC85C7E97) },
+        { RAPIDJSON_UINT64_C2(0x783AE56F, 0x8D684C03), RAPIDJSON_UINT64_C2(0x101A55D0, 0x7D39CF1E) },
+        { RAPIDJSON_UINT64_C2(0x16499ECB, 0x70C25F03), RAPIDJSON_UINT64_C2(0x1420EB44, 0x9C8842E6) },
+        { RAPIDJSON_UINT64_C2(0x9BDC067E, 0x4CF2F6C4), RAPIDJSON_UINT64_C2(0x19292615, 0xC3AA539F) },
+        { RAPIDJSON_UINT64_C2(0x82D3081D, 0xE02FB476), RAPIDJSON_UINT64_C2(0x1F736F9B, 0x3494E887) },
+        { RAPIDJSON_UINT64_C2(0xB1C3E512, 0xAC1DD0C9), RAPIDJSON_UINT64_C2(0x13A825C1, 0x00DD1154) },
+        { RAPIDJSON_UINT64_C2(0xDE34DE57, 0x572544FC), RAPIDJSON_UINT64_C2(0x18922F31, 0x411455A9) },
+        { RAPIDJSON_UINT64_C2(0x55C215ED, 0x2CEE963B), RAPIDJSON_UINT64_C2(0x1EB6BAFD, 0x91596B14) },
+        { RAPIDJSON_UINT64_C2(0xB5994DB4, 0x3C151DE5), RAPIDJSON_UINT64_C2(0x133234DE, 0x7AD7E2EC) },
+        { RAPIDJSON_UINT64_C2(0xE2FFA121, 0x4B1A655E), RAPIDJSON_UINT64_C2(0x17FEC216, 0x198DDBA7) },
+        { RAPIDJSON_UINT64_C2(0xDBBF8969, 0x9DE0FEB6), RAPIDJSON_UINT64_C2(0x1DFE729B, 0x9FF15291) },
+        { RAPIDJSON_UINT64_C2(0x2957B5E2, 0x02AC9F31), RAPIDJSON_UINT64_C2(0x12BF07A1, 0x43F6D39B) },
+        { RAPIDJSON_UINT64_C2(0xF3ADA35A, 0x8357C6FE), RAPIDJSON_UINT64_C2(0x176EC989, 0x94F48881) },
+        { RAPIDJSON_UINT64_C2(0x70990C31, 0x242DB8BD), RAPIDJSON_UINT64_C2(0x1D4A7BEB, 0xFA31AAA2) },
+        { RAPIDJSON_UINT64_C2(0x865FA79E, 0xB69C9376), RAPIDJSON_UINT64_C2(0x124E8D73, 0x7C5F0AA5) },
+        { RAPIDJSON_UINT64_C2(0xE7F79186, 0x6443B854), RAPIDJSON_UINT64_C2(0x16E230D0, 0x5B76CD4E) },
+        { RAPIDJSON_UINT64_C2(0xA1F575E7, 0xFD54A669), RAPIDJSON_UINT64_C2(0x1C9ABD04, 0x725480A2) },
+        { RAPIDJSON_UINT64_C2(0xA53969B0, 0xFE54E801), RAPIDJSON_UINT64_C2(0x11E0B622, 0xC774D065) },
+        { RAPIDJSON_UINT64_C2(0x0E87C41D, 0x3DEA2202), RAPIDJSON_UINT64_C2(0x1658E3AB, 0x7952047F) },
+        { RAPIDJSON_UINT64_C2(0xD229B524, 0x8D64AA82), RAPIDJSON_UINT64_C2(0x1BEF1C96, 0x57A6859E) },
+        { RAPIDJSON_UINT64_C2(0x435A1136, 0xD85EEA91), RAPIDJSON_UINT64_C2(0x117571DD, 0xF6C81383) },
+        { RAPIDJSON_UINT64_C2(0x14309584, 0x8E76A536), RAPIDJSON_UINT64_C2(0x15D2CE55, 0x747A1864) },
+        { RAPIDJSON_UINT64_C2(0x193CBAE5, 0xB2144E83), RAPIDJSON_UINT64_C2(0x1B4781EA, 0xD1989E7D) },
+        { RAPIDJSON_UINT64_C2(0x2FC5F4CF, 0x8F4CB112), RAPIDJSON_UINT64_C2(0x110CB132, 0xC2FF630E) },
+        { RAPIDJSON_UINT64_C2(0xBBB77203, 0x731FDD56), RAPIDJSON_UINT64_C2(0x154FDD7F, 0x73BF3BD1) },
+        { RAPIDJSON_UINT64_C2(0x2AA54E84, 0x4FE7D4AC), RAPIDJSON_UINT64_C2(0x1AA3D4DF, 0x50AF0AC6) },
+        { RAPIDJSON_UINT64_C2(0xDAA75112, 0xB1F0E4EB), RAPIDJSON_UINT64_C2(0x10A6650B, 0x926D66BB) },
+        { RAPIDJSON_UINT64_C2(0xD1512557, 0x5E6D1E26), RAPIDJSON_UINT64_C2(0x14CFFE4E, 0x7708C06A) },
+        { RAPIDJSON_UINT64_C2(0x85A56EAD, 0x360865B0), RAPIDJSON_UINT64_C2(0x1A03FDE2, 0x14CAF085) },
+        { RAPIDJSON_UINT64_C2(0x7387652C, 0x41C53F8E), RAPIDJSON_UINT64_C2(0x10427EAD, 0x4CFED653) },
+        { RAPIDJSON_UINT64_C2(0x50693E77, 0x52368F71), RAPIDJSON_UINT64_C2(0x14531E58, 0xA03E8BE8) },
+        { RAPIDJSON_UINT64_C2(0x64838E15, 0x26C4334E), RAPIDJSON_UINT64_C2(0x1967E5EE, 0xC84E2EE2) },
+        { RAPIDJSON_UINT64_C2(0xFDA4719A, 0x70754022), RAPIDJSON_UINT64_C2(0x1FC1DF6A, 0x7A61BA9A) },
+        { RAPIDJSON_UINT64_C2(0xDE86C700, 0x86494815), RAPIDJSON_UINT64_C2(0x13D92BA2, 0x8C7D14A0) },
+        { RAPIDJSON_UINT64_C2(0x162878C0, 0xA7DB9A1A), RAPIDJSON_UINT64_C2(0x18CF768B, 0x2F9C59C9) },
+        { RAPIDJSON_UINT64_C2(0x5BB296F0, 0xD1D280A1), RAPIDJSON_UINT64_C2(0x1F03542D, 0xFB83703B) },
+        { RAPIDJSON_UINT64_C2(0x194F9E56, 0x83239064), RAPIDJSON_UINT64_C2(0x1362149C, 0xBD322625) },
+        { RAPIDJSON_UINT64_C2(0x5FA385EC, 0x23EC747E), RAPIDJSON_UINT64_C2(0x183A99C3, 0xEC7EAFAE) },
+        { RAPIDJSON_UINT64_C2(0xF78C6767, 0x2CE7919D), RAPIDJSON_UINT64_C2(0x1E494034, 0xE79E5B99) },
+        { RAPIDJSON_UINT64_C2(0x3AB7C0A0, 0x7C10BB02), RAPIDJSON_UINT64_C2(0x12EDC821, 0x10C2F940) },
+        { RAPIDJSON_UINT64_C2(0x4965B0C8, 0x9B14E9C3), RAPIDJSON_UINT64_C2(0x17A93A29, 0x54F3B790) },
+        { RAPIDJSON_UINT64_C2(0x5BBF1CFA, 0xC1DA2433), RAPIDJSON_UINT64_C2(0x1D9388B3, 0xAA30A574) },
+        { RAPIDJSON_UINT64_C2(0xB957721C, 0xB92856A0), RAPIDJSON_UINT64_C2(0x127C3570, 0x4A5E6768) },
+        { RAPIDJSON_UINT64_C2(0xE7AD4EA3, 0xE7726C48), RAPIDJSON_UINT64_C2(0x171B42CC, 0x5CF60142) },
+        { RAPIDJSON_UINT64_C2(0xA198A24C, 0xE14F075A), RAPIDJSON_UINT64_C2(0x1CE2137F, 0x74338193) },
+        { RAPIDJSON_UINT64_C2(0x44FF6570, 0x0CD16498), RAPIDJSON_UINT64_C2(0x120D4C2F, 0xA8A030FC) },
+        { RAPIDJSON_UINT64_C2(0x563F3ECC, 0x1005BDBE), RAPIDJSON_UINT64_C2(0x16909F3B, 0x92C83D3B) },
+        { RAPIDJSON_UINT64_C2(0x2BCF0E7F, 0x14072D2E), RAPIDJSON_UINT64_C2(0x1C34C70A, 0x777A4C8A) },
+        { RAPIDJSON_UINT64_C2(0x5B61690F, 0x6C847C3D), RAPIDJSON_UINT64_C2(0x11A0FC66, 0x8AAC6FD6) },
+        { RAPIDJSON_UINT64_C2(0xF239C353, 0x47A59B4C), RAPIDJSON_UINT64_C2(0x16093B80, 0x2D578BCB) },
+        { RAPIDJSON_UINT64_C2(0xEEC83428, 0x198F021F), RAPIDJSON_UINT64_C2(0x1B8B8A60, 0x38AD6EBE) },
+        { RAPIDJSON_UINT64_C2(0x553D2099, 0x0FF96153), RAPIDJSON_UINT64_C2(0x1137367C, 0x236C6537) },
+        { RAPIDJSON_UINT64_C2(0x2A8C68BF, 0x53F7B9A8), RAPIDJSON_UINT64_C2(0x1585041B, 0x2C477E85) },
+        { RAPIDJSON_UINT64_C2(0x752F82EF, 0x28F5A812), RAPIDJSON_UINT64_C2(0x1AE64521, 0xF7595E26) },
+        { RAPIDJSON_UINT64_C2(0x093DB1D5, 0x7999890B), RAPIDJSON_UINT64_C2(0x10CFEB35, 0x3A97DAD8) },
+        { RAPIDJSON_UINT64_C2(0x0B8D1E4A, 0xD7FFEB4E), RAPIDJSON_UINT64_C2(0x1503E602, 0x893DD18E) },
+        { RAPIDJSON_UINT64_C2(0x8E7065DD, 0x8DFFE622), RAPIDJSON_UINT64_C2(0x1A44DF83, 0x2B8D45F1) },
+        { RAPIDJSON_UINT64_C2(0xF9063FAA, 0x78BFEFD5), RAPIDJSON_UINT64_C2(0x106B0BB1, 0xFB384BB6) },
+        { RAPIDJSON_UINT64_C2(0xB747CF95, 0x16EFEBCA), RAPIDJSON_UINT64_C2(0x1485CE9E, 0x7A065EA4) },
+        { RAPIDJSON_UINT64_C2(0xE519C37A, 0x5CABE6BD), RAPIDJSON_UINT64_C2(0x19A74246, 0x1887F64D) },
+        { RAPIDJSON_UINT64_C2(0xAF301A2C, 0x79EB7036), RAPIDJSON_UINT64_C2(0x1008896B, 0xCF54F9F0) },
+        { RAPIDJSON_UINT64_C2(0xDAFC20B7, 0x98664C43), RAPIDJSON_UINT64_C2(0x140AABC6, 0xC32A386C) },
+        { RAPIDJSON_UINT64_C2(0x11BB28E5, 0x7E7FDF54), RAPIDJSON_UINT64_C2(0x190D56B8, 0x73F4C688) },
+        { RAPIDJSON_UINT64_C2(0x1629F31E, 0xDE1FD72A), RAPIDJSON_UINT64_C2(0x1F50AC66, 0x90F1F82A) },
+        { RAPIDJSON_UINT64_C2(0x4DDA37F3, 0x4AD3E67A), RAPIDJSON_UINT64_C2(0x13926BC0, 0x1A973B1A) },
+        { RAPIDJSON_UINT64_C2(0xE150C5F0, 0x1D88E019), RAPIDJSON_UINT64_C2(0x187706B0, 0x213D09E0) },
+        { RAPIDJSON_UINT64_C2(0x19A4F76C, 0x24EB181F), RAPIDJSON_UINT64_C2(0x1E94C85C, 0x298C4C59) },
+        { RAPIDJSON_UINT64_C2(0xB0071AA3, 0x9712EF13), RAPIDJSON_UINT64_C2(0x131CFD39, 0x99F7AFB7) },
+        { RAPIDJSON_UINT64_C2(0x9C08E14C, 0x7CD7AAD8), RAPIDJSON_UINT64_C2(0x17E43C88, 0x00759BA5) },
+        { RAPIDJSON_UINT64_C2(0x030B199F, 0x9C0D958E), RAPIDJSON_UINT64_C2(0x1DDD4BAA, 0x0093028F) },
+        { RAPIDJSON_UINT64_C2(0x61E6F003, 0xC1887D79), RAPIDJSON_UINT64_C2(0x12AA4F4A, 0x405BE199) },
+        { RAPIDJSON_UINT64_C2(0xBA60AC04, 0xB1EA9CD7), RAPIDJSON_UINT64_C2(0x1754E31C, 0xD072D9FF) },
+        { RAPIDJSON_UINT64_C2(0xA8F8D705, 0xDE65440D), RAPIDJSON_UINT64_C2(0x1D2A1BE4, 0x048F907F) },
+        { RAPIDJSON_UINT64_C2(0xC99B8663, 0xAAFF4A88), RAPIDJSON_UINT64_C2(0x123A516E, 0x82D9BA4F) },
+        { RAPIDJSON_UINT64_C2(0xBC0267FC, 0x95BF1D2A), RAPIDJSON_UINT64_C2(0x16C8E5CA, 0x239028E3) },
+        { RAPIDJSON_UINT64_C2(0xAB0301FB, 0xBB2EE474), RAPIDJSON_UINT64_C2(0x1C7B1F3C, 0xAC74331C) },
+        { RAPIDJSON_UINT64_C2(0xEAE1E13D, 0x54FD4EC9), RAPIDJSON_UINT64_C2(0x11CCF385, 0xEBC89FF1) },
+        { RAPIDJSON_UINT64_C2(0x659A598C, 0xAA3CA27B), RAPIDJSON_UINT64_C2(0x16403067, 0x66BAC7EE) },
+        { RAPIDJSON_UINT64_C2(0xFF00EFEF, 0xD4CBCB1A), RAPIDJSON_UINT64_C2(0x1BD03C81, 0x406979E9) },
+        { RAPIDJSON_UINT64_C2(0x3F6095F5, 0xE4FF5EF0), RAPIDJSON_UINT64_C2(0x116225D0, 0xC841EC32) },
+        { RAPIDJSON_UINT64_C2(0xCF38BB73, 0x5E3F36AC), RAPIDJSON_UINT64_C2(0x15BAAF44, 0xFA52673E) },
+        { RAPIDJSON_UINT64_C2(0x8306EA50, 0x35CF0457), RAPIDJSON_UINT64_C2(0x1B295B16, 0x38E7010E) },
+        { RAPIDJSON_UINT64_C2(0x11E45272, 0x21A162B6), RAPIDJSON_UINT64_C2(0x10F9D8ED, 0xE39060A9) },
+        { RAPIDJSON_UINT64_C2(0x565D670E, 0xAA09BB64), RAPIDJSON_UINT64_C2(0x15384F29, 0x5C7478D3) },
+        { RAPIDJSON_UINT64_C2(0x2BF4C0D2, 0x548C2A3D), RAPIDJSON_UINT64_C2(0x1A8662F3, 0xB3919708) },
+        { RAPIDJSON_UINT64_C2(0x1B78F883, 0x74D79A66), RAPIDJSON_UINT64_C2(0x1093FDD8, 0x503AFE65) },
+        { RAPIDJSON_UINT64_C2(0x625736A4, 0x520D8100), RAPIDJSON_UINT64_C2(0x14B8FD4E, 0x6449BDFE) },
+        { RAPIDJSON_UINT64_C2(0xFAED044D, 0x6690E140), RAPIDJSON_UINT64_C2(0x19E73CA1, 0xFD5C2D7D) },
+        { RAPIDJSON_UINT64_C2(0xBCD422B0, 0x601A8CC8), RAPIDJSON_UINT64_C2(0x103085E5, 0x3E599C6E) },
+        { RAPIDJSON_UINT64_C2(0x6C092B5C, 0x78212FFA), RAPIDJSON_UINT64_C2(0x143CA75E, 0x8DF0038A) },
+        { RAPIDJSON_UINT64_C2(0x070B7633, 0x96297BF8), RAPIDJSON_UINT64_C2(0x194BD136, 0x316C046D) },
+        { RAPIDJSON_UINT64_C2(0x48CE53C0, 0x7BB3DAF6), RAPIDJSON_UINT64_C2(0x1F9EC583, 0xBDC70588) },
+        { RAPIDJSON_UINT64_C2(0x2D80F458, 0x4D5068DA), RAPIDJSON_UINT64_C2(0x13C33B72, 0x569C6375) },
+        { RAPIDJSON_UINT64_C2(0x78E1316E, 0x60A48310), RAPIDJSON_UINT64_C2(0x18B40A4E, 0xEC437C52) }
+    };
+    RAPIDJSON_ASSERT(i >= 0 && i < 326);
+    return kPow5Split[i];
+}
+
+//! ceil(log2(5^e)), or 1 for e == 0.
+inline int RyuPow5Bits(int e) {
+    return static_cast<int>((static_cast<uint32_t>(e) * 1217359) >> 19) + 1;
+}
+
+//! floor(log10(2^e)) for e in [0, 1650].
+inline uint32_t RyuLog10Pow2(int e) {
+    return (static_cast<uint32_t>(e) * 78913) >> 18;
+}
+
+//! floor(log10(5^e)) for e in [0, 2620].
+inline uint32_t RyuLog10Pow5(int e) {
+    return (static_cast<uint32_t>(e) * 732923) >> 20;
+}
+
+inline bool RyuMultipleOfPowerOf5(uint64_t value, uint32_t p) {
+    uint32_t count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        ++count;
+    }
+    return count >= p;
+}
+
+inline bool RyuMultipleOfPowerOf2(uint64_t value, uint32_t p) {
+    return (value & ((static_cast<uint64_t>(1) << p) - 1)) == 0;
+}
+
+//! Returns (m * mul) >> j, for m < 2^55, a 125-bit mul and j in [65, 127].
+inline uint64_t RyuMulShift(uint64_t m, const uint64_t* mul, int j) {
+    RAPIDJSON_ASSERT(j > 64 && j < 128);
+#if defined(_MSC_VER) && defined(_M_AMD64)
+    uint64_t high0;
+    _umul128(m, mul[0], &high0);
+    uint64_t high1;
+    const uint64_t low1 = _umul128(m, mul[1], &high1);
+    const uint64_t sum = high0 + low1;
+    if (sum < high0)
+        ++high1;
+    return __shiftright128(sum, high1, static_cast<unsigned char>(j - 64));
+#elif defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)) && defined(__x86_64__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 b0 = static_cast<uint128>(m) * mul[0];
+    const uint128 b2 = static_cast<uint128>(m) * mul[1];
+    return static_cast<uint64_t>(((b0 >> 64) + b2) >> (j - 64));
+#else
+    const uint64_t M32 = 0xFFFFFFFF;
+    const uint64_t mLow = m & M32;
+    const uint64_t mHigh = m >> 32;
+    // High 64 bits of m * mul[0]
+    const uint64_t a = mLow * (mul[0] & M32);
+    const uint64_t b = mLow * (mul[0] >> 32);
+    const uint64_t c = mHigh * (mul[0] & M32);
+    const uint64_t d = mHigh * (mul[0] >> 32);
+    const uint64_t mid0 = (a >> 32) + (b & M32) + (c & M32);
+    const uint64_t high0 = d + (b >> 32) + (c >> 32) + (mid0 >> 32);
+    // m * mul[1]
+    const uint64_t e = mLow * (mul[1] & M32);
+    const uint64_t f = mLow * (mul[1] >> 32);
+    const uint64_t g = mHigh * (mul[1] & M32);
+    const uint64_t h = mHigh * (mul[1] >> 32);
+    const uint64_t mid1 = (e >> 32) + (f & M32) + (g & M32);
+    const uint64_t low1 = (e & M32) | (mid1 << 32);
+    uint64_t high1 = h + (f >> 32) + (g >> 32) + (mid1 >> 32);
+    const uint64_t sum = high0 + low1;
+    if (sum < high0)
+        ++high1;
+    const int dist = j - 64;
+    return (high1 << (64 - dist)) | (sum >> dist);
+#endif
+}
+
+//! Computes the shortest decimal digits of a positive double, closest to it when several are as short.
+/*! \param value Positive finite double.
+    \param[out] K Decimal exponent: value is written digits * 10^K.
+    \return Digits, at most 17.
+*/
+inline uint64_t Ryu(double value, int* K) {
+    const int kMantissaBits = 52;
+    const int kExponentBias = 1023;
+    const Double d(value);
+    const uint64_t ieeeMantissa = d.Uint64Value() & ((static_cast<uint64_t>(1) << kMantissaBits) - 1);
+    const int ieeeExponent = static_cast<int>(d.Uint64Value() >> kMantissaBits) & 0x7FF;
+
+    // Step 1: decode the double as m2 * 2^e2, with two extra bits for the interval bounds
+    int e2;
+    uint64_t m2;
+    if (ieeeExponent == 0) {
+        e2 = 1 - kExponentBias - kMantissaBits - 2;
+        m2 = ieeeMantissa;
+    }
+    else {
+        e2 = ieeeExponent - kExponentBias - kMantissaBits - 2;
+        m2 = (static_cast<uint64_t>(1) << kMantissaBits) | ieeeMantissa;
+    }
+    const bool acceptBounds = (m2 & 1) == 0;
+
+    // Step 2: interval of the decimal representations rounding to the value, [mm, mp] around mv
+    const uint64_t mv = 4 * m2;
+    const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+
+    // Step 3: convert the interval to a decimal power base
+    uint64_t vr, vp, vm;
+    int e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    if (e2 >= 0) {
+        const uint32_t q = RyuLog10Pow2(e2) - (e2 > 3);
+        e10 = static_cast<int>(q);
+        const int k = kRyuPow5InvBitCount + RyuPow5Bits(static_cast<int>(q)) - 1;
+        const int i = -e2 + static_cast<int>(q) + k;
+        const uint64_t* mul = RyuPow5InvSplit(static_cast<int>(q));
+        vr = RyuMulShift(4 * m2, mul, i);
+        vp = RyuMulShift(4 * m2 + 2, mul, i);
+        vm = RyuMulShift(4 * m2 - 1 - mmShift, mul, i);
+        if (q <= 21) {
+            // Only one of mp, mv and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0)
+                vrIsTrailingZeros = RyuMultipleOfPowerOf5(mv, q);
+            else if (acceptBounds)
+                vmIsTrailingZeros = RyuMultipleOfPowerOf5(mv - 1 - mmShift, q);
+            else
+                vp -= RyuMultipleOfPowerOf5(mv + 2, q);
+        }
+    }
+    else {
+        const uint32_t q = RyuLog10Pow5(-e2) - (-e2 > 1);
+        e10 = static_cast<int>(q) + e2;
+        const int i = -e2 - static_cast<int>(q);
+        const int k = RyuPow5Bits(i) - kRyuPow5BitCount;
+        const int j = static_cast<int>(q) - k;
+        const uint64_t* mul = RyuPow5Split(i);
+        vr = RyuMulShift(4 * m2, mul, j);
+        vp = RyuMulShift(4 * m2 + 2, mul, j);
+        vm = RyuMulShift(4 * m2 - 1 - mmShift, mul, j);
+        if (q <= 1) {
+            // mv = 4 * m2 has at least two trailing zero bits.
+            vrIsTrailingZeros = true;
+            if (acceptBounds)
+                vmIsTrailingZeros = mmShift == 1; // mm = mv - 1 - mmShift
+            else
+                --vp;                             // mp = mv + 2
+        }
+        else if (q < 63)
+            vrIsTrailingZeros = RyuMultipleOfPowerOf2(mv, q);
+    }
+
+    // Step 4: remove the digits shared by the interval bounds
+    int removed = 0;
+    uint64_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        // General case, rare
+        uint32_t lastRemovedDigit = 0;
+        while (vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = static_cast<uint32_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vmIsTrailingZeros) {
+            while (vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = static_cast<uint32_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+            lastRemovedDigit = 4; // Round to even if the exact value is .....50..0
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+    }
+    else {
+        // Common case: vr has no exact tie, so only the first digit removed rounds.
+        // Remove four, then two digits at a time while possible, then one.
+        uint64_t removedDigits = 0, unit = 1;
+        while (vp / 10000 > vm / 10000) {
+            removedDigits = vr % 10000;
+            unit = 10000;
+            vr /= 10000;
+            vp /= 10000;
+            vm /= 10000;
+            removed += 4;
+        }
+        if (vp / 100 > vm / 100) {
+            removedDigits = vr % 100;
+            unit = 100;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        if (vp / 10 > vm / 10) {
+            removedDigits = vr % 10;
+            unit = 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        const bool roundUp = unit > 1 && removedDigits >= unit / 2;
+        output = vr + (vr == vm || roundUp);
+    }
+    *K = e10 + removed;
+    return output;
+}
+
+//! Writes the decimal digits of n, returns their count.
+inline int RyuWriteDigits(uint64_t n, char* buffer) {
+    int length = 1;
+    for (uint64_t t = n; t >= 10; t /= 10)
+        ++length;
+    const char* lut = GetDigitsLut();
+    char* p = buffer + length;
+    while (n >= 100) {
+        const unsigned i = static_cast<unsigned>(n % 100) << 1;
+        n /= 100;
+        *--p = lut[i + 1];
+        *--p = lut[i];
+    }
+    if (n >= 10) {
+        const unsigned i = static_cast<unsigned>(n) << 1;
+        *--p = lut[i + 1];
+        *--p = lut[i];
+    }
+    else
+        *--p = static_cast<char>('0' + static_cast<char>(n));
+    return length;
+}
+
+//! Same as dtoa(), with the shortest digits computed by Ryu instead of Grisu2.
+inline char* RyuDtoa(double value, char* buffer, int maxDecimalPlaces = 324) {
+    RAPIDJSON_ASSERT(maxDecimalPlaces >= 1);
+    Double d(value);
+    if (d.IsZero()) {
+        if (d.Sign())
+            *buffer++ = '-';     // -0.0, Issue #289
+        buffer[0] = '0';
+        buffer[1] = '.';
+        buffer[2] = '0';
+        return &buffer[3];
+    }
+    else {
+        if (value < 0) {
+            *buffer++ = '-';
+            value = -value;
+        }
+        int K;
+        const int length = RyuWriteDigits(Ryu(value, &K), buffer);
+        return Prettify(buffer, length, K, maxDecimalPlaces);
+    }
+}
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
+
+} // namespace internal
+RAPIDJSON_NAMESPACE_END
+
+#endif // RAPIDJSON_RYU_
@@ -0,0 +1,398 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_INTERNAL_SIMDDISPATCH_H_
+#define RAPIDJSON_INTERNAL_SIMDDISPATCH_H_
+
+#include "../rapidjson.h"
+#include "clzll.h"
+
+// Runtime dispatch is only implemented for x86/x86-64 with GCC, Clang or MSVC.
+// Everywhere else the dispatch table falls back to the scalar kernels.
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) \
+    && (defined(__GNUC__) || defined(_MSC_VER))
+#define RAPIDJSON_SIMD_DISPATCH_X86 1
+#endif
+
+#ifdef RAPIDJSON_SIMD_DISPATCH_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#endif
+
+#if defined(RAPIDJSON_SIMD_DISPATCH_X86) && !defined(_MSC_VER)
+#define RAPIDJSON_SIMD_TARGET(x) __attribute__((target(x)))
+#else
+#define RAPIDJSON_SIMD_TARGET(x)
+#endif
+
+#include "utf8validate.h"
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(old-style-cast)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+namespace internal {
+
+//! SIMD instruction set levels, ordered by capability.
+enum SimdLevel {
+    kSimdScalar = 0,
+    kSimdSSE2,
+    kSimdSSE42,
+    kSimdAVX2
+};
+
+//! Detect the best SIMD level supported by the running processor and OS.
+inline SimdLevel DetectSimdLevel() {
+#ifdef RAPIDJSON_SIMD_DISPATCH_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    if (maxLeaf < 1)
+        return kSimdScalar;
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool sse42 = (info[2] & (1 << 20)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) { // OS saves XMM and YMM state
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+
+    return avx2 ? kSimdAVX2 : sse42 ? kSimdSSE42 : sse2 ? kSimdSSE2 : kSimdScalar;
+#else
+    // __builtin_cpu_supports() also checks OS support of the AVX register state.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return kSimdAVX2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return kSimdSSE42;
+    if (__builtin_cpu_supports("sse2"))
+        return kSimdSSE2;
+    return kSimdScalar;
+#endif // _MSC_VER
+#else
+    return kSimdScalar;
+#endif // RAPIDJSON_SIMD_DISPATCH_X86
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+
+//! Returns the first non-whitespace character of a null-terminated string.
+inline const char* SkipWhitespace_Scalar(const char* p) {
+    while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+        ++p;
+    return p;
+}
+
+//! Returns the first non-whitespace character in [p, end), or end.
+inline const char* SkipWhitespace_Scalar(const char* p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+    return p;
+}
+
+//! Returns the first '\"', '\\' or control character of a null-terminated string.
+inline const char* ScanUnescaped_Scalar(const char* p) {
+    while (*p != '\"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20)
+        ++p;
+    return p;
+}
+
+//! Returns the first '\"', '\\' or control character in [p, end), or end.
+inline const char* ScanUnescaped_Scalar(const char* p, const char* end) {
+    while (p != end && *p != '\"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20)
+        ++p;
+    return p;
+}
+
+//! Leaves UTF-8 validation to the caller: scans nothing.
+inline const char* ScanValidUTF8Unescaped_Scalar(const char* p) {
+    return p;
+}
+
+#ifdef RAPIDJSON_SIMD_DISPATCH_X86
+///////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+//
+// The null-terminated variants scan one by one until alignment, since an
+// unaligned load may cross a page boundary past the terminator and crash.
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline unsigned SkipWhitespaceMask_SSE2(__m128i s) {
+    __m128i x = _mm_cmpeq_epi8(s, _mm_set1_epi8(' '));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\n')));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\r')));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\t')));
+    return ~static_cast<unsigned>(_mm_movemask_epi8(x)) & 0xFFFFu;
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline unsigned ScanUnescapedMask_SSE2(__m128i s) {
+    const __m128i sp = _mm_set1_epi8(0x1F);
+    const __m128i t1 = _mm_cmpeq_epi8(s, _mm_set1_epi8('\"'));
+    const __m128i t2 = _mm_cmpeq_epi8(s, _mm_set1_epi8('\\'));
+    const __m128i t3 = _mm_cmpeq_epi8(_mm_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(t1, t2), t3)));
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline const char* SkipWhitespace_SSE2(const char* p) {
+    const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 15) & static_cast<size_t>(~15));
+    for (; p != nextAligned; ++p)
+        if (*p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+            return p;
+
+    for (;; p += 16) {
+        const unsigned r = SkipWhitespaceMask_SSE2(_mm_load_si128(reinterpret_cast<const __m128i *>(p)));
+        if (r != 0)
+            return p + ctzll(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline const char* SkipWhitespace_SSE2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        const unsigned r = SkipWhitespaceMask_SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+        if (r != 0)
+            return p + ctzll(r);
+    }
+    return SkipWhitespace_Scalar(p, end);
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline const char* ScanUnescaped_SSE2(const char* p) {
+    const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 15) & static_cast<size_t>(~15));
+    for (; p != nextAligned; ++p)
+        if (*p == '\"' || *p == '\\' || static_cast<unsigned char>(*p) < 0x20)
+            return p;
+
+    for (;; p += 16) {
+        const unsigned r = ScanUnescapedMask_SSE2(_mm_load_si128(reinterpret_cast<const __m128i *>(p)));
+        if (r != 0)
+            return p + ctzll(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline const char* ScanUnescaped_SSE2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        const unsigned r = ScanUnescapedMask_SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+        if (r != 0)
+            return p + ctzll(r);
+    }
+    return ScanUnescaped_Scalar(p, end);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SSE4.2 kernels
+
+RAPIDJSON_SIMD_TARGET("sse4.2")
+inline const char* SkipWhitespace_SSE42(const char* p) {
+    const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 15) & static_cast<size_t>(~15));
+    for (; p != nextAligned; ++p)
+        if (*p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+            return p;
+
+    static const char whitespace[16] = " \n\r\t";
+    const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&whitespace[0]));
+
+    for (;; p += 16) {
+        const __m128i s = _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+        const int r = _mm_cmpistri(w, s, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT | _SIDD_NEGATIVE_POLARITY);
+        if (r != 16)    // some of characters is non-whitespace
+            return p + r;
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("sse4.2")
+inline const char* SkipWhitespace_SSE42(const char* p, const char* end) {
+    static const char whitespace[16] = " \n\r\t";
+    const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&whitespace[0]));
+
+    for (; end - p >= 16; p += 16) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const int r = _mm_cmpistri(w, s, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT | _SIDD_NEGATIVE_POLARITY);
+        if (r != 16)    // some of characters is non-whitespace
+            return p + r;
+    }
+    return SkipWhitespace_Scalar(p, end);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX2 kernels
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline uint32_t SkipWhitespaceMask_AVX2(__m256i s) {
+    __m256i x = _mm256_cmpeq_epi8(s, _mm256_set1_epi8(' '));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\n')));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\r')));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\t')));
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(x));
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline uint32_t ScanUnescapedMask_AVX2(__m256i s) {
+    const __m256i sp = _mm256_set1_epi8(0x1F);
+    const __m256i t1 = _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\"'));
+    const __m256i t2 = _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\\'));
+    const __m256i t3 = _mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(t1, t2), t3)));
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* SkipWhitespace_AVX2(const char* p) {
+    const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 31) & static_cast<size_t>(~31));
+    for (; p != nextAligned; ++p)
+        if (*p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+            return p;
+
+    for (;; p += 32) {
+        const uint32_t r = SkipWhitespaceMask_AVX2(_mm256_load_si256(reinterpret_cast<const __m256i *>(p)));
+        if (r != 0)
+            return p + ctzll(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* SkipWhitespace_AVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        const uint32_t r = SkipWhitespaceMask_AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+        if (r != 0)
+            return p + ctzll(r);
+    }
+    return SkipWhitespace_Scalar(p, end);
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* ScanUnescaped_AVX2(const char* p) {
+    const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 31) & static_cast<size_t>(~31));
+    for (; p != nextAligned; ++p)
+        if (*p == '\"' || *p == '\\' || static_cast<unsigned char>(*p) < 0x20)
+            return p;
+
+    for (;; p += 32) {
+        const uint32_t r = ScanUnescapedMask_AVX2(_mm256_load_si256(reinterpret_cast<const __m256i *>(p)));
+        if (r != 0)
+            return p + ctzll(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* ScanUnescaped_AVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        const uint32_t r = ScanUnescapedMask_AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+        if (r != 0)
+            return p + ctzll(r);
+    }
+    return ScanUnescaped_Scalar(p, end);
+}
+#endif // RAPIDJSON_SIMD_DISPATCH_X86
+
+///////////////////////////////////////////////////////////////////////////////
+// SimdKernels
+
+//! Table of string scanning kernels for one SIMD level.
+struct SimdKernels {
+    const char* (*skipWhitespace)(const char* p);
+    const char* (*skipWhitespaceN)(const char* p, const char* end);
+    const char* (*scanUnescaped)(const char* p);
+    const char* (*scanUnescapedN)(const char* p, const char* end);
+    const char* (*scanValidUTF8Unescaped)(const char* p);    //!< See ScanValidUTF8Unescaped_SSE42().
+};
+
+//! Get the kernel table of a given SIMD level.
+/*! \note Levels not supported by the build fall back to the best available one.
+*/
+inline SimdKernels GetSimdKernels(SimdLevel level) {
+    SimdKernels k;
+    k.skipWhitespace = &SkipWhitespace_Scalar;
+    k.skipWhitespaceN = &SkipWhitespace_Scalar;
+    k.scanUnescaped = &ScanUnescaped_Scalar;
+    k.scanUnescapedN = &ScanUnescaped_Scalar;
+    k.scanValidUTF8Unescaped = &ScanValidUTF8Unescaped_Scalar;
+#ifdef RAPIDJSON_SIMD_DISPATCH_X86
+    switch (level) {
+    case kSimdAVX2:
+        k.skipWhitespace = &SkipWhitespace_AVX2;
+        k.skipWhitespaceN = &SkipWhitespace_AVX2;
+        k.scanUnescaped = &ScanUnescaped_AVX2;
+        k.scanUnescapedN = &ScanUnescaped_AVX2;
+        k.scanValidUTF8Unescaped = &ScanValidUTF8Unescaped_AVX2;
+        break;
+    case kSimdSSE42:
+        // pcmpistri only helps whitespace skipping, the SSE2 code is as fast for the rest.
+        k.skipWhitespace = &SkipWhitespace_SSE42;
+        k.skipWhitespaceN = &SkipWhitespace_SSE42;
+        k.scanUnescaped = &ScanUnescaped_SSE2;
+        k.scanUnescapedN = &ScanUnescaped_SSE2;
+        k.scanValidUTF8Unescaped = &ScanValidUTF8Unescaped_SSE42;
+        break;
+    case kSimdSSE2:
+        k.skipWhitespace = &SkipWhitespace_SSE2;
+        k.skipWhitespaceN = &SkipWhitespace_SSE2;
+        k.scanUnescaped = &ScanUnescaped_SSE2;
+        k.scanUnescapedN = &ScanUnescaped_SSE2;
+        break;
+    default:
+        break;
+    }
+#else
+    (void)level;
+#endif
+    return k;
+}
+
+//! Kernel table of the running processor.
+/*! Filled in during static initialization, before main() starts threads, so
+    that no lazily guarded local static (unsafe before C++11 and on older
+    MSVC) is involved. A template is used to keep the definition in the header.
+*/
+template <typename T = void>
+struct SimdKernelTable {
+    static const SimdKernels kDetected;
+};
+
+template <typename T>
+const SimdKernels SimdKernelTable<T>::kDetected = GetSimdKernels(DetectSimdLevel());
+
+//! Get the kernel table of the running processor.
+/*! Calls made from other static initializers may run before the table is
+    filled in; they get the scalar kernels, which are constant-initialized.
+*/
+inline const SimdKernels& GetSimdKernels() {
+    static const SimdKernels kScalar = {
+        &SkipWhitespace_Scalar, &SkipWhitespace_Scalar, &ScanUnescaped_Scalar, &ScanUnescaped_Scalar,
+        &ScanValidUTF8Unescaped_Scalar };
+    const SimdKernels& detected = SimdKernelTable<>::kDetected;
+    return detected.skipWhitespace ? detected : kScalar;
+}
+
+} // namespace internal
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_INTERNAL_SIMDDISPATCH_H_
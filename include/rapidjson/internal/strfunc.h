@@ -59,6 +59,30 @@ inline int StrCmp(const Ch* s1, const Ch* s2) {
     return static_cast<unsigned>(*s1) < static_cast<unsigned>(*s2) ? -1 : static_cast<unsigned>(*s1) > static_cast<unsigned>(*s2);
 }
 
+//! 32-bit FNV-1a hash of a string, one code unit at a time.
+/*! \tparam Ch Character type (e.g. char, wchar_t, short)
+    \param s Input string, not necessarily null-terminated.
+    \param length Number of characters in the string.
+*/
+template<typename Ch>
+inline uint32_t StrHash(const Ch* s, SizeType length) {
+    RAPIDJSON_ASSERT(s != 0 || length == 0);
+    uint32_t h = 2166136261u;
+    for (SizeType i = 0; i < length; i++) {
+        h ^= static_cast<uint32_t>(s[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+//! Same as StrHash(), usable in constant expressions when RAPIDJSON_CONSTEXPR is \c constexpr.
+/*! Recursive, as C++11 \c constexpr functions cannot loop: meant for string literals.
+*/
+template<typename Ch>
+inline RAPIDJSON_CONSTEXPR uint32_t StrHashLiteral(const Ch* s, SizeType length, uint32_t h = 2166136261u) {
+    return length == 0 ? h : StrHashLiteral(s + 1, length - 1, (h ^ static_cast<uint32_t>(*s)) * 16777619u);
+}
+
 //! Returns number of code points in a encoded string.
 template<typename Encoding>
 bool CountStringCodePoint(const typename Encoding::Ch* s, SizeType length, SizeType* outCount) {
@@ -18,6 +18,7 @@
 #include "ieee754.h"
 #include "biginteger.h"
 #include "diyfp.h"
+#include "eisellemire.h"
 #include "pow10.h"
 #include <climits>
 #include <limits>
@@ -206,6 +207,20 @@ inline bool StrtodDiyFp(const Ch* decimals, int dLen, int dExp, double* result)
     return halfWay - static_cast<unsigned>(error) >= precisionBits || precisionBits >= halfWay + static_cast<unsigned>(error);
 }
 
+// Eisel-Lemire with the first 19 digits, exact unless more digits change the result
+template<typename Ch>
+inline bool StrtodEiselLemire(const Ch* decimals, int dLen, int dExp, double* result) {
+    const int kMaxDigits = 19; // 10^19 - 1 < 2^64
+    const int n = dLen < kMaxDigits ? dLen : kMaxDigits;
+    uint64_t w = 0;
+    for (int i = 0; i < n; i++)
+        w = w * 10u + static_cast<unsigned>(decimals[i] - Ch('0'));
+    const int q = dExp + dLen - n;
+
+    *result = EiselLemire(w, q);
+    return n == dLen || Double(EiselLemire(w + 1, q)).Uint64Value() == Double(*result).Uint64Value();
+}
+
 template<typename Ch>
 inline double StrtodBigInteger(double approx, const Ch* decimals, int dLen, int dExp) {
     RAPIDJSON_ASSERT(dLen >= 0);
@@ -280,6 +295,9 @@ inline double StrtodFullPrecision(double d, int p, const Ch* decimals, size_t le
     if (dLen + dExp > 309)
         return std::numeric_limits<double>::infinity();
 
+    if (StrtodEiselLemire(decimals, dLen, dExp, &result))
+        return result;
+
     if (StrtodDiyFp(decimals, dLen, dExp, &result))
         return result;
 
@@ -0,0 +1,268 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_INTERNAL_STRUCTURALINDEX_H_
+#define RAPIDJSON_INTERNAL_STRUCTURALINDEX_H_
+
+#include "stack.h"
+#include "clzll.h"
+#include <cstring>
+
+#ifdef RAPIDJSON_AVX512
+#include <immintrin.h>
+#elif defined(RAPIDJSON_SSE42)
+#include <nmmintrin.h>
+#elif defined(RAPIDJSON_SSE2)
+#include <emmintrin.h>
+#elif defined(RAPIDJSON_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(old-style-cast)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+namespace internal {
+
+///////////////////////////////////////////////////////////////////////////////
+// StructuralBlock
+
+//! Character class bitmaps of a 64-byte block, bit i describes byte i.
+struct StructuralBlock {
+    uint64_t whitespace;    //!< ' ', '\t', '\n', '\r'
+    uint64_t op;            //!< '{', '}', '[', ']', ':', ','
+    uint64_t quote;         //!< '"'
+    uint64_t backslash;     //!< '\\'
+};
+
+#if defined(RAPIDJSON_AVX512)
+inline void ClassifyStructuralBlock(const char* p, StructuralBlock& b) {
+    const __m512i s = _mm512_loadu_si512(reinterpret_cast<const void*>(p));
+    b.whitespace = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(' ')) | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\t'))
+                 | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\n')) | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\r'));
+    // '[' ']' '{' '}' only differ in bit 0x20 and 0x02 from '['
+    const __m512i t = _mm512_or_si512(s, _mm512_set1_epi8(0x20));
+    b.op = _mm512_cmpeq_epi8_mask(t, _mm512_set1_epi8('{')) | _mm512_cmpeq_epi8_mask(t, _mm512_set1_epi8('}'))
+         | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(':')) | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(','));
+    b.quote = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\"'));
+    b.backslash = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\\'));
+}
+#elif defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
+inline void ClassifyStructuralBlock(const char* p, StructuralBlock& b) {
+    b.whitespace = b.op = b.quote = b.backslash = 0;
+    for (unsigned i = 0; i < 64; i += 16) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        // '[' ']' '{' '}' only differ in bit 0x20 and 0x02 from '['
+        const __m128i t = _mm_or_si128(s, _mm_set1_epi8(0x20));
+        __m128i w = _mm_cmpeq_epi8(s, _mm_set1_epi8(' '));
+        w = _mm_or_si128(w, _mm_cmpeq_epi8(s, _mm_set1_epi8('\t')));
+        w = _mm_or_si128(w, _mm_cmpeq_epi8(s, _mm_set1_epi8('\n')));
+        w = _mm_or_si128(w, _mm_cmpeq_epi8(s, _mm_set1_epi8('\r')));
+        __m128i o = _mm_cmpeq_epi8(t, _mm_set1_epi8('{'));
+        o = _mm_or_si128(o, _mm_cmpeq_epi8(t, _mm_set1_epi8('}')));
+        o = _mm_or_si128(o, _mm_cmpeq_epi8(s, _mm_set1_epi8(':')));
+        o = _mm_or_si128(o, _mm_cmpeq_epi8(s, _mm_set1_epi8(',')));
+        b.whitespace |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(w))) << i;
+        b.op |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(o))) << i;
+        b.quote |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8('\"'))))) << i;
+        b.backslash |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8('\\'))))) << i;
+    }
+}
+#else
+inline void ClassifyStructuralBlock(const char* p, StructuralBlock& b) {
+    // 1: whitespace, 2: operator, 4: quote, 8: backslash
+    static const unsigned char kClass[256] = {
+        0,0,0,0,0,0,0,0,0,1,1,0,0,1,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, // 00~1F
+        1,0,4,0,0,0,0,0,0,0,0,0,2,0,0,0, 0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0, // 20~3F
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,2,8,2,0,0, // 40~5F
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,2,0,2,0,0, // 60~7F
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, // 80~9F
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, // A0~BF
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, // C0~DF
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0  // E0~FF
+    };
+    b.whitespace = b.op = b.quote = b.backslash = 0;
+    for (unsigned i = 0; i < 64; i++) {
+        const unsigned c = kClass[static_cast<unsigned char>(p[i])];
+        b.whitespace |= static_cast<uint64_t>(c & 1) << i;
+        b.op |= static_cast<uint64_t>((c >> 1) & 1) << i;
+        b.quote |= static_cast<uint64_t>((c >> 2) & 1) << i;
+        b.backslash |= static_cast<uint64_t>(c >> 3) << i;
+    }
+}
+#endif
+
+//! Prefix XOR: bit i of the result is the parity of bits 0..i of x.
+inline uint64_t PrefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// StructuralIndexer
+
+//! Quote-aware scanner of the structural characters of a JSON text.
+/*! Classifies 64-byte blocks with branch-light bitmap operations, so that
+    operators (<tt>{ } [ ] : ,</tt>) inside strings, escaped quotes included,
+    are told apart from those of the text. Used by GenericParallelArrayParser
+    to split a root array between threads.
+*/
+class StructuralIndexer {
+public:
+    //! Quote-aware pre-scan of a JSON text whose root is an array.
+    /*! Finds the brackets of the root array and, for each target offset, the
+        first comma separating two elements of the root array at or after it.
+        Brackets are only counted, not matched: the chunks between the
+        returned offsets still need to be parsed to validate them.
+        \tparam Allocator Allocator of the bounds stack.
+        \param json JSON text, not necessarily null-terminated.
+        \param length Length of the JSON text in bytes.
+        \param targets Increasing target offsets.
+        \param targetCount Number of targets.
+        \param bounds Stack receiving size_t offsets: the opening bracket,
+            the commas found (at most one per target), then the closing bracket.
+        \return Whether the root is an array whose brackets balance, outside
+            of strings, followed by whitespace only.
+    */
+    template <typename Allocator>
+    static bool SplitArray(const char* json, size_t length, const size_t* targets, size_t targetCount, Stack<Allocator>& bounds) {
+        StructuralIndexer indexer;
+        ArraySplit split(targets, targetCount);
+        size_t offset = 0;
+        for (; length - offset >= 64; offset += 64)
+            if (!indexer.SplitStep(json + offset, offset, split, bounds))
+                return false;
+
+        if (offset != length) {
+            // Pad the last partial block with whitespace
+            char buffer[64];
+            std::memset(buffer, ' ', sizeof(buffer));
+            std::memcpy(buffer, json + offset, length - offset);
+            if (!indexer.SplitStep(buffer, offset, split, bounds))
+                return false;
+        }
+        return split.closed && indexer.prevInString_ == 0;
+    }
+
+private:
+    StructuralIndexer() : prevEscaped_(0), prevInString_(0) {}
+
+    //! State of SplitArray().
+    struct ArraySplit {
+        ArraySplit(const size_t* t, size_t count) : targets(t), targetEnd(t + count), depth(0), opened(false), closed(false) {}
+        const size_t* targets;
+        const size_t* targetEnd;
+        size_t depth;
+        bool opened;
+        bool closed;
+    };
+
+    //! Bitmap of characters escaped by a preceding unescaped backslash.
+    RAPIDJSON_FORCEINLINE uint64_t Escaped(uint64_t backslash) {
+        uint64_t escaped = prevEscaped_;
+        backslash &= ~prevEscaped_;
+        prevEscaped_ = 0;
+        // Backslash runs are rare, so iterate over them: the lowest remaining
+        // backslash is never escaped itself, and it escapes the next character.
+        while (RAPIDJSON_UNLIKELY(backslash != 0)) {
+            const uint64_t bit = backslash & (~backslash + 1);
+            const uint64_t next = bit << 1;
+            if (next == 0)
+                prevEscaped_ = 1;
+            escaped |= next;
+            backslash &= ~(bit | next);
+        }
+        return escaped;
+    }
+
+    //! Classify a block and compute its unescaped quotes and in-string bitmaps.
+    RAPIDJSON_FORCEINLINE void Classify(const char* p, StructuralBlock& b, uint64_t& quote, uint64_t& inString) {
+        ClassifyStructuralBlock(p, b);
+
+        quote = b.quote & ~Escaped(b.backslash);
+
+        // In-string bitmap covers the opening quote up to (excluding) the closing quote.
+        inString = PrefixXor(quote) ^ prevInString_;
+        prevInString_ = static_cast<uint64_t>(0) - (inString >> 63);
+    }
+
+    template <typename Allocator>
+    bool SplitStep(const char* p, size_t offset, ArraySplit& split, Stack<Allocator>& bounds) {
+        StructuralBlock b;
+        uint64_t quote, inString;
+        Classify(p, b, quote, inString);
+
+        // Everything but whitespace, including the closing quotes of strings
+        uint64_t significant = ~(b.whitespace | inString) | (inString & quote);
+        if (split.closed)
+            return significant == 0;
+        if (!split.opened) {
+            if (significant == 0)
+                return true;
+            if (p[ctzll(significant)] != '[')
+                return false;
+            split.opened = true;
+        }
+
+        for (uint64_t op = b.op & ~inString; op != 0; op &= op - 1) {
+            const unsigned i = ctzll(op);
+            switch (p[i]) {
+            case '[':
+            case '{':
+                if (split.depth++ == 0)
+                    *bounds.template Push<size_t>() = offset + i;   // Opening bracket
+                break;
+            case ']':
+            case '}':
+                if (split.depth == 0)
+                    return false;
+                if (--split.depth == 0) {
+                    split.closed = true;
+                    *bounds.template Push<size_t>() = offset + i;
+                    return i == 63 || (significant >> (i + 1)) == 0;
+                }
+                break;
+            case ',':
+                if (split.depth == 1 && split.targets != split.targetEnd && offset + i >= *split.targets) {
+                    *bounds.template Push<size_t>() = offset + i;
+                    while (split.targets != split.targetEnd && *split.targets <= offset + i)
+                        ++split.targets;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        return true;
+    }
+
+    uint64_t prevEscaped_;      //!< 1 if the first character of next block is escaped.
+    uint64_t prevInString_;     //!< All ones if the next block begins inside a string.
+};
+
+} // namespace internal
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_INTERNAL_STRUCTURALINDEX_H_
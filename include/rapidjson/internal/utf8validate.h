@@ -0,0 +1,291 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_INTERNAL_UTF8VALIDATE_H_
+#define RAPIDJSON_INTERNAL_UTF8VALIDATE_H_
+
+#include "../rapidjson.h"
+#include "clzll.h"
+
+#ifdef RAPIDJSON_SSE42
+#include <nmmintrin.h>
+#endif
+#ifdef RAPIDJSON_AVX2
+#include <immintrin.h>
+#endif
+
+// The runtime dispatch build includes this file from internal/simddispatch.h,
+// which compiles the kernels of every instruction set with target attributes.
+#ifdef RAPIDJSON_SIMD_DISPATCH_X86
+#define RAPIDJSON_UTF8_SSE42
+#define RAPIDJSON_UTF8_AVX2
+#define RAPIDJSON_UTF8_TARGET(x) RAPIDJSON_SIMD_TARGET(x)
+#else
+#ifdef RAPIDJSON_SSE42
+#define RAPIDJSON_UTF8_SSE42
+#ifdef RAPIDJSON_AVX2
+#define RAPIDJSON_UTF8_AVX2
+#endif
+#endif
+#define RAPIDJSON_UTF8_TARGET(x)
+#endif
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(old-style-cast)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+namespace internal {
+
+#if defined(RAPIDJSON_UTF8_SSE42) || defined(RAPIDJSON_UTF8_AVX2)
+
+// Block-wise UTF-8 validation with nibble lookup tables (Keiser & Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte", 2021).
+// Every pair of adjacent bytes is classified by three 16-entry tables indexed
+// by the high and low nibble of the first byte and the high nibble of the
+// second one; an error bit survives the AND of the three lookups only if the
+// pair is invalid. Third and fourth continuation bytes are checked separately
+// from the lead byte two or three positions back.
+
+enum UTF8Table {
+    kUTF8Byte1High,
+    kUTF8Byte1Low,
+    kUTF8Byte2High,
+    kUTF8Max        //!< Largest byte at each of the last 3 positions of a complete block.
+};
+
+//! 16-byte lookup tables of the kernels.
+inline const unsigned char* GetUTF8Table(UTF8Table table) {
+    // Error bits:
+    //   0x01 too short     lead byte not followed by a continuation
+    //   0x02 too long      continuation byte after ASCII
+    //   0x04 overlong 3    E0 80..9F
+    //   0x08 too large     F4 90..BF, F5..FF
+    //   0x10 surrogate     ED A0..BF
+    //   0x20 overlong 2    C0..C1
+    //   0x40 overlong 4 / too large (F0 80..8F, F5..FF 80..8F)
+    //   0x80 two continuations, cleared when expected
+    static const unsigned char kTables[4][16] = {
+        {   // kUTF8Byte1High
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,     // 0___
+            0x80, 0x80, 0x80, 0x80,                             // 10__
+            0x21, 0x01, 0x15, 0x49                              // 1100, 1101, 1110, 1111
+        },
+        {   // kUTF8Byte1Low
+            0xE7, 0xA3, 0x83, 0x83, 0x8B, 0xCB, 0xCB, 0xCB,
+            0xCB, 0xCB, 0xCB, 0xCB, 0xCB, 0xDB, 0xCB, 0xCB
+        },
+        {   // kUTF8Byte2High
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,     // 0___
+            0xE6, 0xAE, 0xBA, 0xBA,                             // 1000, 1001, 101_
+            0x01, 0x01, 0x01, 0x01                              // 11__
+        },
+        {   // kUTF8Max
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+        }
+    };
+    return kTables[table];
+}
+
+//! Leave out of a scanned run [begin, p) a sequence that the stopping byte would have to complete.
+inline const char* UTF8RunEnd(const char* begin, const char* p) {
+    const size_t length = static_cast<size_t>(p - begin);
+    if (length >= 1 && static_cast<unsigned char>(p[-1]) >= 0xC0)
+        return p - 1;
+    if (length >= 2 && static_cast<unsigned char>(p[-2]) >= 0xE0)
+        return p - 2;
+    if (length >= 3 && static_cast<unsigned char>(p[-3]) >= 0xF0)
+        return p - 3;
+    return p;
+}
+
+#endif // RAPIDJSON_UTF8_SSE42 || RAPIDJSON_UTF8_AVX2
+
+#ifdef RAPIDJSON_UTF8_SSE42
+
+RAPIDJSON_UTF8_TARGET("sse4.2")
+inline __m128i UTF8Table_SSE42(UTF8Table table) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(GetUTF8Table(table)));
+}
+
+RAPIDJSON_UTF8_TARGET("sse4.2")
+inline __m128i UTF8Nibble_SSE42(__m128i s) {
+    return _mm_and_si128(_mm_srli_epi16(s, 4), _mm_set1_epi8(0x0F));
+}
+
+//! Error bits of block \c s, given the previous block \c prev.
+RAPIDJSON_UTF8_TARGET("sse4.2")
+inline __m128i UTF8BlockErrors_SSE42(__m128i s, __m128i prev) {
+    const __m128i prev1 = _mm_alignr_epi8(s, prev, 15);
+    const __m128i special = _mm_and_si128(
+        _mm_and_si128(_mm_shuffle_epi8(UTF8Table_SSE42(kUTF8Byte1High), UTF8Nibble_SSE42(prev1)),
+                      _mm_shuffle_epi8(UTF8Table_SSE42(kUTF8Byte1Low), _mm_and_si128(prev1, _mm_set1_epi8(0x0F)))),
+        _mm_shuffle_epi8(UTF8Table_SSE42(kUTF8Byte2High), UTF8Nibble_SSE42(s)));
+
+    // A byte must be a continuation if the byte 2 back is 111_____ or the byte 3 back is 1111____.
+    const __m128i prev2 = _mm_alignr_epi8(s, prev, 14);
+    const __m128i prev3 = _mm_alignr_epi8(s, prev, 13);
+    const __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0x60)), _mm_subs_epu8(prev3, _mm_set1_epi8(0x70)));
+    return _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80))), special);
+}
+
+//! Scan a run of string characters that need no unescaping and are valid UTF-8, 16 bytes at a time.
+/*! Scans aligned 16-byte blocks, which never cross a page boundary; the
+    bytes of the first block before \c p are taken as ASCII letters. The scan
+    stops at the first '"', '\\' or control character, or at the first byte
+    found invalid, leaving out a multi-byte sequence ending there. The caller
+    validates the rest one code point at a time and reports errors at their
+    exact position.
+    \param p Position at the beginning of a code point.
+    \return End of the scanned run. [p, return) is complete, valid UTF-8.
+*/
+RAPIDJSON_UTF8_TARGET("sse4.2")
+inline const char* ScanValidUTF8Unescaped_SSE42(const char* p) {
+    const __m128i dq = _mm_set1_epi8('\"');
+    const __m128i bs = _mm_set1_epi8('\\');
+    const __m128i sp = _mm_set1_epi8(0x1F);
+    const __m128i zero = _mm_setzero_si128();
+
+    const size_t misalign = reinterpret_cast<size_t>(p) & 15;
+    const char* q = p - misalign;
+    __m128i s = _mm_load_si128(reinterpret_cast<const __m128i *>(q));
+    s = _mm_blendv_epi8(s, _mm_set1_epi8('a'), _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(misalign)),
+        _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)));
+
+    __m128i prev = zero;
+    for (;;) {
+        const __m128i t1 = _mm_cmpeq_epi8(s, dq);
+        const __m128i t2 = _mm_cmpeq_epi8(s, bs);
+        const __m128i t3 = _mm_cmpeq_epi8(_mm_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+        const unsigned stop = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(t1, t2), t3)));
+
+        const bool ascii = _mm_movemask_epi8(s) == 0;
+        const __m128i error = ascii ?
+            _mm_subs_epu8(prev, UTF8Table_SSE42(kUTF8Max)) :  // ASCII block, only a sequence left open by the previous block is invalid
+            UTF8BlockErrors_SSE42(s, prev);
+        if (RAPIDJSON_UNLIKELY(stop != 0 || !_mm_testz_si128(error, error))) {
+            // Error bits are set at the byte where a sequence turns out invalid,
+            // except for a sequence left open, reported at the first byte
+            const unsigned invalid = _mm_testz_si128(error, error) ? 0u : ascii ? 1u :
+                ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(error, zero))) & 0xFFFFu;
+            q += ctzll(stop | invalid);
+            break;
+        }
+        prev = s;
+        q += 16;
+        s = _mm_load_si128(reinterpret_cast<const __m128i *>(q));
+    }
+    return UTF8RunEnd(p, q);
+}
+
+#endif // RAPIDJSON_UTF8_SSE42
+
+#ifdef RAPIDJSON_UTF8_AVX2
+
+// Same algorithm on 32-byte blocks. The byte shuffles work within 128-bit
+// lanes: the tables are broadcast to both lanes, and the previous bytes of
+// the upper lane come from the lower one.
+
+RAPIDJSON_UTF8_TARGET("avx2")
+inline __m256i UTF8Table_AVX2(UTF8Table table) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(GetUTF8Table(table))));
+}
+
+RAPIDJSON_UTF8_TARGET("avx2")
+inline __m256i UTF8Nibble_AVX2(__m256i s) {
+    return _mm256_and_si256(_mm256_srli_epi16(s, 4), _mm256_set1_epi8(0x0F));
+}
+
+//! Error bits of block \c s, given the previous block \c prev.
+RAPIDJSON_UTF8_TARGET("avx2")
+inline __m256i UTF8BlockErrors_AVX2(__m256i s, __m256i prev) {
+    const __m256i carry = _mm256_permute2x128_si256(prev, s, 0x21);  // Upper lane of prev, lower lane of s
+    const __m256i prev1 = _mm256_alignr_epi8(s, carry, 15);
+    const __m256i special = _mm256_and_si256(
+        _mm256_and_si256(_mm256_shuffle_epi8(UTF8Table_AVX2(kUTF8Byte1High), UTF8Nibble_AVX2(prev1)),
+                         _mm256_shuffle_epi8(UTF8Table_AVX2(kUTF8Byte1Low), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)))),
+        _mm256_shuffle_epi8(UTF8Table_AVX2(kUTF8Byte2High), UTF8Nibble_AVX2(s)));
+
+    const __m256i prev2 = _mm256_alignr_epi8(s, carry, 14);
+    const __m256i prev3 = _mm256_alignr_epi8(s, carry, 13);
+    const __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60)), _mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70)));
+    return _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80))), special);
+}
+
+//! Same as ScanValidUTF8Unescaped_SSE42(), 32 bytes at a time.
+RAPIDJSON_UTF8_TARGET("avx2")
+inline const char* ScanValidUTF8Unescaped_AVX2(const char* p) {
+    const __m256i dq = _mm256_set1_epi8('\"');
+    const __m256i bs = _mm256_set1_epi8('\\');
+    const __m256i sp = _mm256_set1_epi8(0x1F);
+    const __m256i zero = _mm256_setzero_si256();
+    // Only the last 3 bytes of the upper lane can leave a sequence open
+    const __m256i max = _mm256_inserti128_si256(_mm256_set1_epi8(static_cast<char>(0xFF)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(GetUTF8Table(kUTF8Max))), 1);
+
+    const size_t misalign = reinterpret_cast<size_t>(p) & 31;
+    const char* q = p - misalign;
+    __m256i s = _mm256_load_si256(reinterpret_cast<const __m256i *>(q));
+    s = _mm256_blendv_epi8(s, _mm256_set1_epi8('a'), _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(misalign)),
+        _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                         16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31)));
+
+    __m256i prev = zero;
+    for (;;) {
+        const __m256i t1 = _mm256_cmpeq_epi8(s, dq);
+        const __m256i t2 = _mm256_cmpeq_epi8(s, bs);
+        const __m256i t3 = _mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp);
+        const unsigned stop = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(t1, t2), t3)));
+
+        const bool ascii = _mm256_movemask_epi8(s) == 0;
+        const __m256i error = ascii ?
+            _mm256_subs_epu8(prev, max) :
+            UTF8BlockErrors_AVX2(s, prev);
+        if (RAPIDJSON_UNLIKELY(stop != 0 || !_mm256_testz_si256(error, error))) {
+            const unsigned invalid = _mm256_testz_si256(error, error) ? 0u : ascii ? 1u :
+                ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(error, zero)));
+            q += ctzll(stop | invalid);
+            break;
+        }
+        prev = s;
+        q += 32;
+        s = _mm256_load_si256(reinterpret_cast<const __m256i *>(q));
+    }
+    return UTF8RunEnd(p, q);
+}
+
+#endif // RAPIDJSON_UTF8_AVX2
+
+#if defined(RAPIDJSON_SSE42) && defined(RAPIDJSON_AVX2)
+//! Widest kernel enabled at compile time.
+inline const char* ScanValidUTF8Unescaped(const char* p) { return ScanValidUTF8Unescaped_AVX2(p); }
+#elif defined(RAPIDJSON_SSE42)
+//! Widest kernel enabled at compile time.
+inline const char* ScanValidUTF8Unescaped(const char* p) { return ScanValidUTF8Unescaped_SSE42(p); }
+#endif
+
+} // namespace internal
+RAPIDJSON_NAMESPACE_END
+
+#undef RAPIDJSON_UTF8_SSE42
+#undef RAPIDJSON_UTF8_AVX2
+#undef RAPIDJSON_UTF8_TARGET
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_INTERNAL_UTF8VALIDATE_H_
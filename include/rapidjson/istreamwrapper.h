@@ -84,6 +84,18 @@ public:
         return (current_ + 4 - !eof_ <= bufferLast_) ? current_ : 0;
     }
 
+    // BufferedStream concept, the null character ending the stream is not part of the window.
+    const Ch* Window() const { return current_; }
+    size_t WindowSize() const { return static_cast<size_t>(bufferLast_ - current_) + !eof_; }
+    void Consume(size_t n) {
+        RAPIDJSON_ASSERT(n <= WindowSize());
+        current_ += n;
+        if (current_ > bufferLast_) {
+            current_ = bufferLast_;
+            Read();
+        }
+    }
+
 private:
     BasicIStreamWrapper();
     BasicIStreamWrapper(const BasicIStreamWrapper&);
@@ -116,6 +128,11 @@ private:
     bool eof_;
 };
 
+template <typename StreamType>
+struct BufferedStreamTraits<BasicIStreamWrapper<StreamType> > {
+    enum { buffered = sizeof(typename StreamType::char_type) == 1 };
+};
+
 typedef BasicIStreamWrapper<std::istream> IStreamWrapper;
 typedef BasicIStreamWrapper<std::wistream> WIStreamWrapper;
 
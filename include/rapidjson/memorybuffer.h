@@ -31,7 +31,7 @@ RAPIDJSON_NAMESPACE_BEGIN
     2. StringBuffer::GetString() returns a null-terminated string. MemoryBuffer::GetBuffer() returns a buffer without terminator.
 
     \tparam Allocator type for allocating memory buffer.
-    \note implements Stream concept
+    \note implements Stream and BufferedOutputStream concepts
 */
 template <typename Allocator = CrtAllocator>
 struct GenericMemoryBuffer {
@@ -47,6 +47,15 @@ struct GenericMemoryBuffer {
     Ch* Push(size_t count) { return stack_.template Push<Ch>(count); }
     void Pop(size_t count) { stack_.template Pop<Ch>(count); }
 
+    // BufferedOutputStream concept
+    Ch* PutWindow(size_t& size) {
+        if (stack_.GetCapacity() == stack_.GetSize())
+            stack_.template Reserve<Ch>(1);
+        size = stack_.GetCapacity() - stack_.GetSize();
+        return stack_.template End<Ch>();
+    }
+    void PutCommit(size_t n) { stack_.template PushUnsafe<Ch>(n); }
+
     const Ch* GetBuffer() const {
         return stack_.template Bottom<Ch>();
     }
@@ -59,6 +68,11 @@ struct GenericMemoryBuffer {
 
 typedef GenericMemoryBuffer<> MemoryBuffer;
 
+template<typename Allocator>
+struct BufferedOutputStreamTraits<GenericMemoryBuffer<Allocator> > {
+    enum { buffered = 1 };
+};
+
 //! Implement specialized version of PutN() with memset() for better performance.
 template<>
 inline void PutN(MemoryBuffer& memoryBuffer, char c, size_t n) {
@@ -56,12 +56,22 @@ struct MemoryStream {
         return Tell() + 4 <= size_ ? src_ : 0;
     }
 
+    // BufferedStream concept
+    const Ch* Window() const { return src_; }
+    size_t WindowSize() const { return static_cast<size_t>(end_ - src_); }
+    void Consume(size_t n) { RAPIDJSON_ASSERT(n <= WindowSize()); src_ += n; }
+
     const Ch* src_;     //!< Current read position.
     const Ch* begin_;   //!< Original head of the string.
     const Ch* end_;     //!< End of stream.
     size_t size_;       //!< Size of the stream.
 };
 
+template<>
+struct BufferedStreamTraits<MemoryStream> {
+    enum { buffered = 1 };
+};
+
 RAPIDJSON_NAMESPACE_END
 
 #ifdef __clang__
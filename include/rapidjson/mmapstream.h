@@ -0,0 +1,178 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_MMAPSTREAM_H_
+#define RAPIDJSON_MMAPSTREAM_H_
+
+/*! \file mmapstream.h
+    \brief Input streams over memory-mapped files, for POSIX systems.
+*/
+
+#include "reader.h"
+
+/*! \def RAPIDJSON_HAS_MMAP
+    \ingroup RAPIDJSON_CONFIG
+    \brief Whether MmapReadStream and MmapInsituStream are available (POSIX systems).
+*/
+#ifndef RAPIDJSON_HAS_MMAP
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#define RAPIDJSON_HAS_MMAP 1
+#else
+#define RAPIDJSON_HAS_MMAP 0
+#endif
+#endif
+
+#if RAPIDJSON_HAS_MMAP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+namespace internal {
+
+//! Private mapping of a whole file, followed by a null character.
+/*! The mapping is rounded up to a page past the end of the file, and the
+    bytes after the file are zero pages: the text is null-terminated without
+    a copy, and SIMD loads of aligned blocks stay within mapped pages.
+*/
+class FileMapping {
+public:
+    FileMapping(const char* filename, bool writable, bool sequential) : data_(&empty_), size_(0), mapSize_(0), empty_('\0') {
+        RAPIDJSON_ASSERT(filename != 0);
+        const int fd = ::open(filename, O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            const size_t size = static_cast<size_t>(st.st_size);
+            const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            const size_t mapSize = (size / pageSize + 1) * pageSize;
+            const int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            void* p = ::mmap(0, mapSize, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED) {
+                // Map the file over the zero pages
+                if (size == 0 || ::mmap(p, size, prot, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED) {
+                    data_ = static_cast<char*>(p);
+                    size_ = size;
+                    mapSize_ = mapSize;
+                    if (sequential && size != 0)
+                        ::madvise(p, size, MADV_SEQUENTIAL);
+                }
+                else
+                    ::munmap(p, mapSize);
+            }
+        }
+        ::close(fd);
+    }
+
+    ~FileMapping() {
+        if (mapSize_)
+            ::munmap(data_, mapSize_);
+    }
+
+    char* data_;        //!< Mapped file, or an empty string.
+    size_t size_;       //!< Size of the file.
+    size_t mapSize_;    //!< Size of the mapping, 0 if the file could not be mapped.
+
+private:
+    FileMapping(const FileMapping&);
+    FileMapping& operator=(const FileMapping&);
+
+    char empty_;
+};
+
+} // namespace internal
+
+//! Read-only input byte stream over a memory-mapped file.
+/*! The whole file is mapped in memory and read as a StringStream, with no
+    copy: the parser uses the SIMD specializations of StringStream.
+
+    If the file cannot be mapped, the stream is empty and IsMapped() is false.
+    \note implements Stream concept
+*/
+class MmapReadStream : private internal::FileMapping, public StringStream {
+public:
+    //! Constructor.
+    /*! \param filename Name of a regular file.
+        \param sequential Advise the kernel that the file is read sequentially, with \c MADV_SEQUENTIAL.
+    */
+    explicit MmapReadStream(const char* filename, bool sequential = true) : FileMapping(filename, false, sequential), StringStream(data_) {}
+
+    //! Whether the file is mapped.
+    bool IsMapped() const { return mapSize_ != 0; }
+
+    //! Beginning of the mapped file.
+    const Ch* GetData() const { return data_; }
+
+    //! Size of the mapped file in bytes.
+    size_t GetSize() const { return size_; }
+};
+
+//! Input byte stream over a private copy-on-write mapping of a file, for in situ parsing.
+/*! Strings are decoded in place in the mapping: the pages they are in are
+    copied by the kernel on the first write, and the file itself is never
+    modified. Parsed strings are valid while the stream lives.
+
+    If the file cannot be mapped, the stream is empty and IsMapped() is false.
+    \note implements Stream concept
+*/
+class MmapInsituStream : private internal::FileMapping, public InsituStringStream {
+public:
+    //! Constructor.
+    /*! \param filename Name of a regular file.
+        \param sequential Advise the kernel that the file is read sequentially, with \c MADV_SEQUENTIAL.
+    */
+    explicit MmapInsituStream(const char* filename, bool sequential = true) : FileMapping(filename, true, sequential), InsituStringStream(data_) {}
+
+    //! Whether the file is mapped.
+    bool IsMapped() const { return mapSize_ != 0; }
+
+    //! Beginning of the mapped file.
+    Ch* GetData() const { return data_; }
+
+    //! Size of the mapped file in bytes.
+    size_t GetSize() const { return size_; }
+};
+
+namespace internal {
+
+template <>
+struct ReaderStream<MmapReadStream> {
+    typedef StringStream Type;
+};
+
+template <>
+struct ReaderStream<MmapInsituStream> {
+    typedef InsituStringStream Type;
+};
+
+} // namespace internal
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_HAS_MMAP
+
+#endif // RAPIDJSON_MMAPSTREAM_H_
@@ -0,0 +1,271 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_NDJSON_H_
+#define RAPIDJSON_NDJSON_H_
+
+/*! \file ndjson.h */
+
+#include "document.h"
+
+#if RAPIDJSON_HAS_CXX11
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+namespace internal {
+
+template <typename Allocator>
+inline void NdjsonClearAllocator(Allocator&) {}
+
+template <typename BaseAllocator>
+inline void NdjsonClearAllocator(MemoryPoolAllocator<BaseAllocator>& allocator) { allocator.Clear(); }
+
+} // namespace internal
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericNdjsonReader
+
+//! Parallel reader of newline-delimited JSON (NDJSON) records.
+/*!
+    Parses a buffer holding one JSON text per line, e.g. a log file mapped in
+    memory, on a pool of threads. The buffer is cut into batches of about
+    \c batchSize bytes at line boundaries; each thread claims batches in
+    increasing order and parses their records with its own \c Allocator and
+    \ref GenericDocument (hence its own parsing stack). Empty and blank lines
+    are skipped.
+
+    Each record is delivered to a callback, called as
+    \code
+    bool callback(size_t offset, DocumentType& document);
+    \endcode
+    where \c offset is the position of the record in the buffer. The document,
+    and the memory of its values, are reused after the callback returns:
+    copy out whatever must outlive it. Returning \c false stops parsing with
+    \ref kParseErrorTermination. The callback must not throw.
+
+    In ordered mode, the callback is called one record at a time, in the order
+    of the records in the buffer. Otherwise it is called concurrently from all
+    threads as soon as each record is parsed, and must be thread-safe.
+
+    Parsing stops at the first invalid record. All records before it are
+    delivered; in unordered mode, some records after it may be delivered too.
+
+    \tparam Encoding Encoding of the documents (the buffer is UTF-8).
+    \tparam Allocator Allocator of the documents, one per thread. A
+        MemoryPoolAllocator is cleared after each batch.
+    \tparam StackAllocator Allocator of the parsing stacks.
+    \note Requires C++11.
+*/
+template <typename Encoding, typename Allocator = RAPIDJSON_DEFAULT_ALLOCATOR, typename StackAllocator = RAPIDJSON_DEFAULT_STACK_ALLOCATOR>
+class GenericNdjsonReader {
+public:
+    typedef GenericDocument<Encoding, Allocator, StackAllocator> DocumentType;  //!< Document type of the records.
+    typedef typename DocumentType::ValueType ValueType;                         //!< Value type of the records.
+
+    static const size_t kDefaultBatchSize = 256 * 1024;
+
+    //! Constructor.
+    /*! \param threadCount Number of threads, including the calling one. 0 for \c std::thread::hardware_concurrency().
+        \param batchSize Size in bytes of the batches of records claimed by the threads.
+    */
+    explicit GenericNdjsonReader(unsigned threadCount = 0, size_t batchSize = kDefaultBatchSize) :
+        threadCount_(threadCount ? threadCount : (std::max)(1u, std::thread::hardware_concurrency())),
+        batchSize_(batchSize ? batchSize : 1) {}
+
+    //! Parse the records of a buffer.
+    /*! \tparam parseFlags Combination of \ref ParseFlag, applied to each record. Insitu parsing is not supported.
+        \tparam Callback Callable as <tt>bool(size_t offset, DocumentType& document)</tt>.
+        \param buffer UTF-8 NDJSON text, not necessarily null-terminated.
+        \param length Length of \c buffer in bytes.
+        \param callback Receives each parsed record.
+        \param ordered Deliver records one at a time, in buffer order.
+        \return Result of parsing, with the error offset relative to \c buffer.
+    */
+    template <unsigned parseFlags, typename Callback>
+    ParseResult Parse(const char* buffer, size_t length, Callback callback, bool ordered = true) {
+        RAPIDJSON_STATIC_ASSERT(!(parseFlags & kParseInsituFlag));
+        State state(buffer, length, batchSize_);
+        const size_t threadCount = (std::min)(static_cast<size_t>(threadCount_), state.batchCount);
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; i++)
+            threads.emplace_back([&] { Work<parseFlags>(state, callback, ordered); });
+        Work<parseFlags>(state, callback, ordered);  // The calling thread is a worker too
+        for (std::thread& t : threads)
+            t.join();
+        return state.result;
+    }
+
+    //! Parse the records of a buffer, with default parse flags.
+    template <typename Callback>
+    ParseResult Parse(const char* buffer, size_t length, Callback callback, bool ordered = true) {
+        return Parse<kParseDefaultFlags>(buffer, length, callback, ordered);
+    }
+
+    //! Number of threads used by Parse().
+    unsigned GetThreadCount() const { return threadCount_; }
+
+private:
+    static const size_t kNoBatch = ~static_cast<size_t>(0);
+
+    struct State {
+        State(const char* b, size_t l, size_t s) :
+            buffer(b), length(l), batchSize(s), batchCount((l + s - 1) / s),
+            next(0), stopBatch(kNoBatch), delivered(0), mutex(), turn(), result() {}
+
+        //! Start of the first line at or after \c pos.
+        size_t LineStart(size_t pos) const {
+            if (pos == 0 || pos >= length)
+                return (std::min)(pos, length);
+            const void* eol = std::memchr(buffer + pos - 1, '\n', length - pos + 1);
+            return eol ? static_cast<size_t>(static_cast<const char*>(eol) - buffer) + 1 : length;
+        }
+
+        //! Stop parsing batches after \c batch, keeping the error of the earliest one.
+        void Fail(size_t batch, const ParseResult& error) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (batch < stopBatch) {
+                stopBatch = batch;
+                result = error;
+            }
+            turn.notify_all();
+        }
+
+        const char* buffer;
+        size_t length;
+        size_t batchSize;
+        size_t batchCount;
+        std::atomic<size_t> next;       //!< Next batch to claim.
+        std::atomic<size_t> stopBatch;  //!< Earliest batch with an error, written under mutex.
+        size_t delivered;               //!< Number of batches delivered in ordered mode, under mutex.
+        std::mutex mutex;
+        std::condition_variable turn;
+        ParseResult result;
+
+    private:
+        State(const State&) = delete;
+        State& operator=(const State&) = delete;
+    };
+
+    struct Record {
+        Record() : offset(), value() {}
+        size_t offset;
+        ValueType value;
+    };
+
+    static bool IsBlank(const char* p, const char* end) {
+        for (; p != end; ++p)
+            if (*p != ' ' && *p != '\t' && *p != '\r')
+                return false;
+        return true;
+    }
+
+    template <unsigned parseFlags, typename Callback>
+    static void Work(State& state, Callback& callback, bool ordered) {
+        Allocator allocator;
+        DocumentType document(&allocator);
+        DocumentType output(&allocator);        // Delivered records, with no parse error
+        internal::Stack<StackAllocator> records(0, 64 * sizeof(Record));   // Parsed records waiting for their turn
+
+        for (;;) {
+            const size_t batch = state.next.fetch_add(1);
+            if (batch >= state.batchCount || batch > state.stopBatch)
+                break;
+
+            ParseResult error;
+            const char* const end = state.buffer + state.LineStart((batch + 1) * state.batchSize);
+            for (const char* p = state.buffer + state.LineStart(batch * state.batchSize); p < end; ) {
+                const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+                if (!eol)
+                    eol = end;
+                const size_t offset = static_cast<size_t>(p - state.buffer);
+                if (!IsBlank(p, eol)) {
+                    document.template Parse<parseFlags, UTF8<> >(p, static_cast<size_t>(eol - p));
+                    if (document.HasParseError()) {
+                        error.Set(document.GetParseError(), offset + document.GetErrorOffset());
+                        state.Fail(batch, error);
+                        break;
+                    }
+                    if (ordered) {
+                        Record* r = new (records.template Push<Record>()) Record();
+                        r->offset = offset;
+                        r->value.Swap(document);
+                    }
+                    else if (!callback(offset, document)) {
+                        error.Set(kParseErrorTermination, offset);
+                        state.Fail(batch, error);
+                        break;
+                    }
+                    if (batch > state.stopBatch)
+                        break;
+                }
+                p = eol + 1;
+            }
+
+            if (ordered) {
+                std::unique_lock<std::mutex> lock(state.mutex);
+                state.turn.wait(lock, [&] { return state.delivered == batch || batch > state.stopBatch; });
+                const bool deliver = batch <= state.stopBatch;
+                lock.unlock();
+
+                Record* r = records.template Bottom<Record>();
+                for (Record* last = records.template End<Record>(); r != last; ++r) {
+                    if (!deliver)
+                        break;
+                    static_cast<ValueType&>(output).Swap(r->value);
+                    if (!callback(r->offset, output)) {
+                        error.Set(kParseErrorTermination, r->offset);
+                        state.Fail(batch, error);
+                        break;
+                    }
+                }
+                for (r = records.template Bottom<Record>(); r != records.template End<Record>(); ++r)
+                    r->~Record();
+                records.Clear();
+
+                lock.lock();
+                if (deliver)
+                    state.delivered = batch + 1;
+                state.turn.notify_all();
+                if (!deliver)
+                    break;
+            }
+
+            document.SetNull();
+            output.SetNull();
+            internal::NdjsonClearAllocator(allocator);
+            if (error.IsError())
+                break;
+        }
+    }
+
+    unsigned threadCount_;
+    size_t batchSize_;
+};
+
+//! NDJSON reader of UTF-8 documents with the default allocators.
+typedef GenericNdjsonReader<UTF8<> > NdjsonReader;
+
+RAPIDJSON_NAMESPACE_END
+
+#endif // RAPIDJSON_HAS_CXX11
+
+#endif // RAPIDJSON_NDJSON_H_
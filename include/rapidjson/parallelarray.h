@@ -0,0 +1,292 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_PARALLELARRAY_H_
+#define RAPIDJSON_PARALLELARRAY_H_
+
+/*! \file parallelarray.h */
+
+#include "document.h"
+#include "internal/structuralindex.h"
+
+#if RAPIDJSON_HAS_CXX11
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+namespace internal {
+
+//! Hands the values allocated by per-thread allocators over to the document allocator.
+/*! Only allocators whose memory can be owned by another instance are supported;
+    for the others, GenericParallelArrayParser parses serially.
+*/
+template <typename Allocator>
+struct ParallelArrayAllocator {
+    static const bool kSupported = false;
+    static void Merge(Allocator&, Allocator&) {}
+};
+
+template <>
+struct ParallelArrayAllocator<CrtAllocator> {
+    static const bool kSupported = true;
+    static void Merge(CrtAllocator&, CrtAllocator&) {}
+};
+
+template <>
+struct ParallelArrayAllocator<MemoryPoolAllocator<CrtAllocator> > {
+    static const bool kSupported = true;
+    static void Merge(MemoryPoolAllocator<CrtAllocator>& to, MemoryPoolAllocator<CrtAllocator>& from) { to.Adopt(from); }
+};
+
+} // namespace internal
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericParallelArrayParser
+
+//! Parallel parser of a JSON text whose root is a large array.
+/*!
+    A quick SIMD pre-scan, aware of strings, finds the commas separating
+    elements of the root array near evenly spaced offsets. The elements
+    between them are then parsed concurrently, one chunk per thread, the
+    calling thread included.
+
+    Parse() stitches the chunks, parsed with per-thread allocators, into the
+    root array of a document. ParseSax() instead sends the events of each
+    chunk to its own handler.
+
+    Texts smaller than two chunks, texts whose root is not a balanced array,
+    and parsing with \ref kParseCommentsFlag are handled by a single thread.
+
+    \tparam Encoding Encoding of the documents (the text is UTF-8).
+    \tparam Allocator Allocator of the documents. CrtAllocator and
+        MemoryPoolAllocator<CrtAllocator> are parsed in parallel; other
+        allocators are parsed serially.
+    \tparam StackAllocator Allocator of the parsing stacks.
+    \note Requires C++11.
+*/
+template <typename Encoding, typename Allocator = RAPIDJSON_DEFAULT_ALLOCATOR, typename StackAllocator = RAPIDJSON_DEFAULT_STACK_ALLOCATOR>
+class GenericParallelArrayParser {
+public:
+    typedef GenericDocument<Encoding, Allocator, StackAllocator> DocumentType;  //!< Document type.
+    typedef typename DocumentType::ValueType ValueType;                         //!< Value type of the elements.
+
+    static const size_t kDefaultMinChunkSize = 256 * 1024;
+
+    //! Constructor.
+    /*! \param threadCount Maximum number of threads, including the calling one. 0 for \c std::thread::hardware_concurrency().
+        \param minChunkSize Minimum size in bytes of the text parsed by each thread.
+    */
+    explicit GenericParallelArrayParser(unsigned threadCount = 0, size_t minChunkSize = kDefaultMinChunkSize) :
+        threadCount_(threadCount ? threadCount : (std::max)(1u, std::thread::hardware_concurrency())),
+        minChunkSize_(minChunkSize ? minChunkSize : 1) {}
+
+    //! Parse a JSON text into a document.
+    /*! The document is left as after GenericDocument::Parse(json, length):
+        when any chunk fails, the whole text is parsed again serially to
+        report the first error with its exact offset.
+
+        The elements of the chunks are moved into the root array by the
+        calling thread, once all chunks are parsed. This serial step copies
+        16 bytes per element (8 with \ref RAPIDJSON_48BITPOINTER_OPTIMIZATION),
+        but no string nor nested value, and is small next to parsing unless
+        the root array mostly holds short scalars.
+        \tparam parseFlags Combination of \ref ParseFlag. Insitu parsing is not supported.
+        \param document Document receiving the root value.
+        \param json Null-terminated UTF-8 JSON text.
+        \param length Length of \c json in bytes.
+        \return Result of parsing, as stored in the document.
+    */
+    template <unsigned parseFlags>
+    ParseResult Parse(DocumentType& document, const char* json, size_t length) {
+        RAPIDJSON_STATIC_ASSERT(!(parseFlags & kParseInsituFlag));
+        internal::Stack<StackAllocator> bounds(0, 64 * sizeof(size_t));
+        if (!internal::ParallelArrayAllocator<Allocator>::kSupported || !Split<parseFlags>(json, length, bounds))
+            return document.template Parse<parseFlags, UTF8<> >(json, length);
+
+        const size_t* b = bounds.template Bottom<size_t>();
+        const size_t chunkCount = bounds.GetSize() / sizeof(size_t) - 1;
+        std::vector<Allocator> allocators(chunkCount);
+        std::vector<DocumentType> chunks;
+        chunks.reserve(chunkCount);
+        for (size_t i = 0; i < chunkCount; i++)
+            chunks.emplace_back(&allocators[i]);
+
+        std::vector<ParseResult> results(chunkCount);
+        Run(chunkCount, [&](size_t i) {
+            auto generator = [&](DocumentType& handler) {
+                results[i] = ParseChunk<parseFlags>(json, b[i], b[i + 1], i == 0, i + 1 == chunkCount, handler);
+                return !results[i].IsError();
+            };
+            chunks[i].Populate(generator);
+        });
+
+        SizeType count = 0;
+        for (size_t i = 0; i < chunkCount; i++) {
+            if (results[i].IsError())
+                return document.template Parse<parseFlags, UTF8<> >(json, length);
+            count += chunks[i].Size();
+        }
+
+        // Reset the document to an empty array, with no parse error
+        document.template Parse<kParseDefaultFlags, UTF8<> >("[]", 2);
+        document.Reserve(count, document.GetAllocator());
+        for (size_t i = 0; i < chunkCount; i++) {
+            for (typename ValueType::ValueIterator v = chunks[i].Begin(); v != chunks[i].End(); ++v)
+                document.PushBack(*v, document.GetAllocator());
+            internal::ParallelArrayAllocator<Allocator>::Merge(document.GetAllocator(), allocators[i]);
+        }
+        return document;
+    }
+
+    //! Parse a JSON text into a document, with default parse flags.
+    ParseResult Parse(DocumentType& document, const char* json, size_t length) {
+        return Parse<kParseDefaultFlags>(document, json, length);
+    }
+
+    //! Parse a JSON text with one handler per chunk.
+    /*! Chunk \c i is sent to <tt>handlers[i]</tt> as an array of consecutive
+        elements of the root array, from \c StartArray() to \c EndArray():
+        concatenating the arrays of the handlers, in order, gives the root
+        array. Handlers are called concurrently. With
+        \ref kParseTrailingCommasFlag, the last handler may receive an empty
+        array, when the text is split at a trailing comma.
+
+        When the text is handled by a single thread, <tt>handlers[0]</tt>
+        receives the whole text, whatever its root.
+        \tparam parseFlags Combination of \ref ParseFlag. Insitu parsing is not supported.
+        \tparam Handler SAX handler type.
+        \param json Null-terminated UTF-8 JSON text.
+        \param length Length of \c json in bytes.
+        \param handlers GetThreadCount() handlers.
+        \param handlerCount Receives the number of handlers used, if not null.
+        \return Result of parsing, with the error of the earliest failing chunk.
+            Later chunks may have been parsed anyway.
+    */
+    template <unsigned parseFlags, typename Handler>
+    ParseResult ParseSax(const char* json, size_t length, Handler* handlers, size_t* handlerCount = 0) {
+        RAPIDJSON_STATIC_ASSERT(!(parseFlags & kParseInsituFlag));
+        internal::Stack<StackAllocator> bounds(0, 64 * sizeof(size_t));
+        if (!Split<parseFlags>(json, length, bounds)) {
+            if (handlerCount)
+                *handlerCount = 1;
+            GenericReader<UTF8<>, Encoding, StackAllocator> reader;
+            MemoryStream ms(json, length);
+            EncodedInputStream<UTF8<>, MemoryStream> is(ms);
+            return reader.template Parse<parseFlags>(is, handlers[0]);
+        }
+
+        const size_t* b = bounds.template Bottom<size_t>();
+        const size_t chunkCount = bounds.GetSize() / sizeof(size_t) - 1;
+        if (handlerCount)
+            *handlerCount = chunkCount;
+        std::vector<ParseResult> results(chunkCount);
+        Run(chunkCount, [&](size_t i) {
+            results[i] = ParseChunk<parseFlags>(json, b[i], b[i + 1], i == 0, i + 1 == chunkCount, handlers[i]);
+        });
+
+        for (size_t i = 0; i < chunkCount; i++)
+            if (results[i].IsError())
+                return results[i];
+        return ParseResult();
+    }
+
+    //! Maximum number of threads used, and of handlers needed by ParseSax().
+    unsigned GetThreadCount() const { return threadCount_; }
+
+private:
+    //! Find the chunks of the root array, fails when a single thread should parse the text.
+    template <unsigned parseFlags>
+    bool Split(const char* json, size_t length, internal::Stack<StackAllocator>& bounds) const {
+        const size_t chunkCount = (std::min)(static_cast<size_t>(threadCount_), length / minChunkSize_);
+        if ((parseFlags & kParseCommentsFlag) || chunkCount < 2)
+            return false;
+        std::vector<size_t> targets(chunkCount - 1);
+        for (size_t i = 1; i < chunkCount; i++)
+            targets[i - 1] = length / chunkCount * i;
+        return internal::StructuralIndexer::SplitArray(json, length, targets.data(), targets.size(), bounds);
+    }
+
+    //! Call \c f(i) for i in [0, count), on count - 1 threads and the calling one.
+    template <typename F>
+    static void Run(size_t count, F f) {
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < count; i++)
+            threads.emplace_back(f, i);
+        f(0);
+        for (std::thread& t : threads)
+            t.join();
+    }
+
+    //! Parse the elements between two offsets of the bounds as an array.
+    /*! \param begin Offset of the opening bracket or of the comma before the first element.
+        \param end Offset of the comma after the last element or of the closing bracket.
+        \param first Whether this is the first chunk, which may be empty.
+        \param last Whether this is the last chunk, which may end with a trailing comma,
+            or even be empty after one.
+    */
+    template <unsigned parseFlags, typename Handler>
+    static ParseResult ParseChunk(const char* json, size_t begin, size_t end, bool first, bool last, Handler& handler) {
+        static const unsigned kElementFlags = parseFlags | kParseStopWhenDoneFlag;
+        GenericReader<UTF8<>, Encoding, StackAllocator> reader;
+        StringStream is(json + begin + 1);
+        const size_t chunkLength = end - begin - 1;
+        ParseResult result;
+        SizeType count = 0;
+
+        if (!handler.StartArray())
+            return ParseResult(kParseErrorTermination, begin);
+        SkipWhitespace(is);
+        // Empty for an empty root array, or after a trailing comma the text was split at
+        const bool empty = (first || (parseFlags & kParseTrailingCommasFlag)) && last && is.Tell() == chunkLength;
+        if (!empty) {
+            for (;;) {
+                result = reader.template Parse<kElementFlags>(is, handler);
+                if (result.IsError())
+                    break;
+                count++;
+                SkipWhitespace(is);
+                if (is.Tell() >= chunkLength)
+                    break;
+                if (is.Peek() != ',') {
+                    result.Set(kParseErrorArrayMissCommaOrSquareBracket, is.Tell());
+                    break;
+                }
+                is.Take();
+                SkipWhitespace(is);
+                if ((parseFlags & kParseTrailingCommasFlag) && last && is.Tell() == chunkLength)
+                    break;
+            }
+        }
+        if (!result.IsError() && !handler.EndArray(count))
+            result.Set(kParseErrorTermination, is.Tell());
+        if (result.IsError())
+            result.Set(result.Code(), result.Offset() + begin + 1);
+        return result;
+    }
+
+    unsigned threadCount_;
+    size_t minChunkSize_;
+};
+
+//! Parallel array parser of UTF-8 documents with the default allocators.
+typedef GenericParallelArrayParser<UTF8<> > ParallelArrayParser;
+
+RAPIDJSON_NAMESPACE_END
+
+#endif // RAPIDJSON_HAS_CXX11
+
+#endif // RAPIDJSON_PARALLELARRAY_H_
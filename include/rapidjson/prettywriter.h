@@ -104,7 +104,7 @@ public:
         RAPIDJSON_ASSERT(str != 0);
         (void)copy;
         PrettyPrefix(kNumberType);
-        return Base::EndValue(Base::WriteString(str, length));
+        return Base::EndValue(Base::WriteRawValue(str, length));
     }
 
     bool String(const Ch* str, SizeType length, bool copy = false) {
@@ -167,12 +167,15 @@
 
 /*! \def RAPIDJSON_USE_MEMBERSMAP
     \ingroup RAPIDJSON_CONFIG
-    \brief Enable RapidJSON support for object members handling in a \c std::multimap
+    \brief Enable RapidJSON support for hash-indexed object members lookup
 
-    By defining this preprocessor symbol to \c 1, \ref rapidjson::GenericValue object
-    members are stored in a \c std::multimap for faster lookup and deletion times, a
-    trade off with a slightly slower insertion time and a small object allocat(or)ed
-    memory overhead.
+    By defining this preprocessor symbol to \c 1, \ref rapidjson::GenericValue objects
+    keep the hashes of their member names, stored in the same allocation after the
+    members array. Objects with a capacity of at least \ref RAPIDJSON_MEMBERSMAP_THRESHOLD
+    members keep them in an open-addressing hash index, for constant lookup and
+    deletion times. This is a trade off with a slightly slower insertion time and
+    4 bytes (small objects) or two to four 8-byte index slots of allocat(or)ed memory
+    per member of capacity.
 
     \hideinitializer
 */
@@ -180,6 +183,16 @@
 #define RAPIDJSON_USE_MEMBERSMAP 0 // not by default
 #endif
 
+/*! \def RAPIDJSON_MEMBERSMAP_THRESHOLD
+    \ingroup RAPIDJSON_CONFIG
+    \brief Minimum object capacity for which \ref RAPIDJSON_USE_MEMBERSMAP builds a hash index.
+
+    Smaller objects are searched linearly, which is faster than hashing for a few members.
+*/
+#ifndef RAPIDJSON_MEMBERSMAP_THRESHOLD
+#define RAPIDJSON_MEMBERSMAP_THRESHOLD 16
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // RAPIDJSON_NO_INT64DEFINE
 
@@ -351,23 +364,29 @@
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
-// RAPIDJSON_SSE2/RAPIDJSON_SSE42/RAPIDJSON_NEON/RAPIDJSON_SIMD
+// RAPIDJSON_SSE2/RAPIDJSON_SSE42/RAPIDJSON_AVX2/RAPIDJSON_AVX512/RAPIDJSON_NEON/RAPIDJSON_SIMD
 
 /*! \def RAPIDJSON_SIMD
     \ingroup RAPIDJSON_CONFIG
-    \brief Enable SSE2/SSE4.2/Neon optimization.
+    \brief Enable SSE2/SSE4.2/AVX2/AVX-512/Neon optimization.
 
     RapidJSON supports optimized implementations for some parsing operations
-    based on the SSE2, SSE4.2 or NEon SIMD extensions on modern Intel
-    or ARM compatible processors.
+    based on the SSE2, SSE4.2, AVX2, AVX-512BW or NEon SIMD extensions on
+    modern Intel or ARM compatible processors.
 
-    To enable these optimizations, three different symbols can be defined;
+    To enable these optimizations, these different symbols can be defined;
     \code
     // Enable SSE2 optimization.
     #define RAPIDJSON_SSE2
 
     // Enable SSE4.2 optimization.
     #define RAPIDJSON_SSE42
+
+    // Enable AVX2 optimization (32 bytes per step).
+    #define RAPIDJSON_AVX2
+
+    // Enable AVX-512BW optimization (64 bytes per step).
+    #define RAPIDJSON_AVX512
     \endcode
 
     // Enable ARM Neon optimization.
@@ -375,15 +394,46 @@
     \endcode
 
     \c RAPIDJSON_SSE42 takes precedence over SSE2, if both are defined.
+    \c RAPIDJSON_AVX512 takes precedence over \c RAPIDJSON_AVX2, which in turn
+    takes precedence over SSE4.2/SSE2 for string scanning and whitespace
+    skipping. Since every AVX2 capable processor also supports SSE4.2,
+    defining \c RAPIDJSON_AVX2 or \c RAPIDJSON_AVX512 alone implies
+    \c RAPIDJSON_SSE42 for the code paths without a wider implementation.
 
     If any of these symbols is defined, RapidJSON defines the macro
     \c RAPIDJSON_SIMD to indicate the availability of the optimized code.
 */
+#if defined(RAPIDJSON_AVX512) && !defined(RAPIDJSON_AVX2)
+#define RAPIDJSON_AVX2
+#endif
+#if defined(RAPIDJSON_AVX2) && !defined(RAPIDJSON_SSE2) && !defined(RAPIDJSON_SSE42)
+#define RAPIDJSON_SSE42
+#endif
 #if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42) \
     || defined(RAPIDJSON_NEON) || defined(RAPIDJSON_DOXYGEN_RUNNING)
 #define RAPIDJSON_SIMD
 #endif
 
+/*! \def RAPIDJSON_SIMD_DISPATCH
+    \ingroup RAPIDJSON_CONFIG
+    \brief Select SIMD string scanning kernels at runtime.
+
+    The SIMD symbols above select an instruction set at compile time, so the
+    resulting binary requires a processor supporting it. When this symbol is
+    defined and none of \c RAPIDJSON_SSE2, \c RAPIDJSON_SSE42 or
+    \c RAPIDJSON_NEON is, RapidJSON detects the processor capabilities once
+    (with \c cpuid on x86) and picks the AVX2, SSE4.2, SSE2 or scalar version
+    of whitespace skipping and (un)escaped string scanning for
+    \c StringStream / \c InsituStringStream parsing and writing into
+    buffered output streams (see BufferedOutputStream). This allows a portable build to benefit from the vector
+    instructions available on the machine it runs on.
+
+    Compile-time SIMD symbols take precedence over runtime dispatch.
+*/
+#if defined(RAPIDJSON_SIMD_DISPATCH) && defined(RAPIDJSON_SIMD)
+#undef RAPIDJSON_SIMD_DISPATCH
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // RAPIDJSON_NO_SIZETYPEDEFINE
 
@@ -621,6 +671,26 @@ RAPIDJSON_NAMESPACE_END
 #endif // RAPIDJSON_HAS_CXX11_NOEXCEPT
 #endif
 
+#ifndef RAPIDJSON_HAS_CXX11_CONSTEXPR
+#if RAPIDJSON_HAS_CXX11
+#define RAPIDJSON_HAS_CXX11_CONSTEXPR 1
+#elif defined(__clang__)
+#define RAPIDJSON_HAS_CXX11_CONSTEXPR __has_feature(cxx_constexpr)
+#elif (defined(RAPIDJSON_GNUC) && (RAPIDJSON_GNUC >= RAPIDJSON_VERSION_CODE(4,6,0)) && defined(__GXX_EXPERIMENTAL_CXX0X__)) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define RAPIDJSON_HAS_CXX11_CONSTEXPR 1
+#else
+#define RAPIDJSON_HAS_CXX11_CONSTEXPR 0
+#endif
+#endif
+#ifndef RAPIDJSON_CONSTEXPR
+#if RAPIDJSON_HAS_CXX11_CONSTEXPR
+#define RAPIDJSON_CONSTEXPR constexpr
+#else
+#define RAPIDJSON_CONSTEXPR
+#endif // RAPIDJSON_HAS_CXX11_CONSTEXPR
+#endif
+
 // no automatic detection, yet
 #ifndef RAPIDJSON_HAS_CXX11_TYPETRAITS
 #if (defined(_MSC_VER) && _MSC_VER >= 1700)
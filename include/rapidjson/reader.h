@@ -30,6 +30,9 @@
 #include <intrin.h>
 #pragma intrinsic(_BitScanForward)
 #endif
+#ifdef RAPIDJSON_AVX2
+#include <immintrin.h>
+#endif
 #ifdef RAPIDJSON_SSE42
 #include <nmmintrin.h>
 #elif defined(RAPIDJSON_SSE2)
@@ -37,6 +40,11 @@
 #elif defined(RAPIDJSON_NEON)
 #include <arm_neon.h>
 #endif
+#ifdef RAPIDJSON_SIMD_DISPATCH
+#include "internal/simddispatch.h"
+#endif
+#include <cstring>  // memcpy, memmove
+#include "internal/utf8validate.h"
 
 #ifdef __clang__
 RAPIDJSON_DIAG_PUSH
@@ -155,6 +163,8 @@ enum ParseFlag {
     kParseTrailingCommasFlag = 128, //!< Allow trailing commas at the end of objects and arrays.
     kParseNanAndInfFlag = 256,      //!< Allow parsing NaN, Inf, Infinity, -Inf and -Infinity as doubles.
     kParseEscapedApostropheFlag = 512,  //!< Allow escaped apostrophe in strings.
+    kParseLazyNumbersFlag = 1024,   //!< Keep numbers as their text in a GenericDocument, converted when read. Like kParseNumbersAsStringsFlag for GenericReader.
+    kParseLazyContainersFlag = 2048,    //!< Keep objects and arrays nested in the root as their text in a GenericDocument, parsed when accessed. Not with kParseIterativeFlag.
     kParseDefaultFlags = RAPIDJSON_PARSE_DEFAULT_FLAGS  //!< Default parse flags. Can be customized by defining RAPIDJSON_PARSE_DEFAULT_FLAGS
 };
 
@@ -179,6 +189,8 @@ concept Handler {
     /// enabled via kParseNumbersAsStringsFlag, string is not null-terminated (use length)
     bool RawNumber(const Ch* str, SizeType length, bool copy);
     bool String(const Ch* str, SizeType length, bool copy);
+    /// enabled via kParseLazyContainersFlag, text of an object or array nested in the root, not null-terminated (use length)
+    bool RawContainer(const Ch* str, SizeType length, bool copy);
     bool StartObject();
     bool Key(const Ch* str, SizeType length, bool copy);
     bool EndObject(SizeType memberCount);
@@ -211,6 +223,8 @@ struct BaseReaderHandler {
     /// enabled via kParseNumbersAsStringsFlag, string is not null-terminated (use length)
     bool RawNumber(const Ch* str, SizeType len, bool copy) { return static_cast<Override&>(*this).String(str, len, copy); }
     bool String(const Ch*, SizeType, bool) { return static_cast<Override&>(*this).Default(); }
+    /// enabled via kParseLazyContainersFlag, string is not null-terminated (use length)
+    bool RawContainer(const Ch*, SizeType, bool) { return static_cast<Override&>(*this).Default(); }
     bool StartObject() { return static_cast<Override&>(*this).Default(); }
     bool Key(const Ch* str, SizeType len, bool copy) { return static_cast<Override&>(*this).String(str, len, copy); }
     bool EndObject(SizeType) { return static_cast<Override&>(*this).Default(); }
@@ -258,12 +272,20 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 // SkipWhitespace
 
-//! Skip the JSON white spaces in a stream.
-/*! \param is A input stream for skipping white spaces.
-    \note This function has SSE2/SSE4.2 specialization.
-*/
+inline const char* SkipWhitespace(const char* p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+    return p;
+}
+
+#if defined(RAPIDJSON_SIMD) || defined(RAPIDJSON_SIMD_DISPATCH)
+inline const char *SkipWhitespace_SIMD(const char* p, const char* end);
+#endif
+
+namespace internal {
+
 template<typename InputStream>
-void SkipWhitespace(InputStream& is) {
+void SkipStreamWhitespace(InputStream& is, FalseType) {
     internal::StreamLocalCopy<InputStream> copy(is);
     InputStream& s(copy.s);
 
@@ -272,13 +294,154 @@ void SkipWhitespace(InputStream& is) {
         s.Take();
 }
 
-inline const char* SkipWhitespace(const char* p, const char* end) {
-    while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+// BufferedStream: skip whitespace in the buffered window, until a window has other characters.
+template<typename InputStream>
+void SkipStreamWhitespace(InputStream& is, TrueType) {
+    RAPIDJSON_STATIC_ASSERT(sizeof(typename InputStream::Ch) == 1);
+    for (;;) {
+        const char* p = is.Window();
+        const char* end = p + is.WindowSize();
+#if defined(RAPIDJSON_SIMD) || defined(RAPIDJSON_SIMD_DISPATCH)
+        const char* q = SkipWhitespace_SIMD(p, end);
+#else
+        const char* q = SkipWhitespace(p, end);
+#endif
+        is.Consume(static_cast<size_t>(q - p));
+        if (q != end || p == end)
+            return;
+    }
+}
+
+} // namespace internal
+
+//! Skip the JSON white spaces in a stream.
+/*! \param is A input stream for skipping white spaces.
+    \note This function has SSE2/SSE4.2 specialization, and scans the buffer of a \ref BufferedStream at once.
+*/
+template<typename InputStream>
+void SkipWhitespace(InputStream& is) {
+    internal::SkipStreamWhitespace(is, internal::BoolType<BufferedStreamTraits<InputStream>::buffered != 0>());
+}
+
+#if defined(RAPIDJSON_AVX512)
+//! Skip whitespace with AVX-512BW instructions, testing 64 8-byte characters at once.
+inline const char *SkipWhitespace_SIMD(const char* p) {
+    // Fast return for single non-whitespace
+    if (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
         ++p;
-    return p;
+    else
+        return p;
+
+    // 64-byte align to the next boundary
+    const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 63) & static_cast<size_t>(~63));
+    while (p != nextAligned)
+        if (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+            ++p;
+        else
+            return p;
+
+    // The rest of string using SIMD
+    const __m512i w0 = _mm512_set1_epi8(' ');
+    const __m512i w1 = _mm512_set1_epi8('\n');
+    const __m512i w2 = _mm512_set1_epi8('\r');
+    const __m512i w3 = _mm512_set1_epi8('\t');
+
+    for (;; p += 64) {
+        const __m512i s = _mm512_load_si512(reinterpret_cast<const void *>(p));
+        const uint64_t x = _mm512_cmpeq_epi8_mask(s, w0) | _mm512_cmpeq_epi8_mask(s, w1)
+                         | _mm512_cmpeq_epi8_mask(s, w2) | _mm512_cmpeq_epi8_mask(s, w3);
+        if (~x != 0)    // some of characters is non-whitespace
+            return p + internal::ctzll(~x);
+    }
 }
 
-#ifdef RAPIDJSON_SSE42
+inline const char *SkipWhitespace_SIMD(const char* p, const char* end) {
+    // Fast return for single non-whitespace
+    if (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+    else
+        return p;
+
+    // The middle of string using SIMD
+    const __m512i w0 = _mm512_set1_epi8(' ');
+    const __m512i w1 = _mm512_set1_epi8('\n');
+    const __m512i w2 = _mm512_set1_epi8('\r');
+    const __m512i w3 = _mm512_set1_epi8('\t');
+
+    for (; end - p >= 64; p += 64) {
+        const __m512i s = _mm512_loadu_si512(reinterpret_cast<const void *>(p));
+        const uint64_t x = _mm512_cmpeq_epi8_mask(s, w0) | _mm512_cmpeq_epi8_mask(s, w1)
+                         | _mm512_cmpeq_epi8_mask(s, w2) | _mm512_cmpeq_epi8_mask(s, w3);
+        if (~x != 0)    // some of characters is non-whitespace
+            return p + internal::ctzll(~x);
+    }
+
+    return SkipWhitespace(p, end);
+}
+
+#elif defined(RAPIDJSON_AVX2)
+//! Skip whitespace with AVX2 instructions, testing 32 8-byte characters at once.
+inline const char *SkipWhitespace_SIMD(const char* p) {
+    // Fast return for single non-whitespace
+    if (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+        ++p;
+    else
+        return p;
+
+    // 32-byte align to the next boundary
+    const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 31) & static_cast<size_t>(~31));
+    while (p != nextAligned)
+        if (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+            ++p;
+        else
+            return p;
+
+    // The rest of string using SIMD
+    const __m256i w0 = _mm256_set1_epi8(' ');
+    const __m256i w1 = _mm256_set1_epi8('\n');
+    const __m256i w2 = _mm256_set1_epi8('\r');
+    const __m256i w3 = _mm256_set1_epi8('\t');
+
+    for (;; p += 32) {
+        const __m256i s = _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i x = _mm256_cmpeq_epi8(s, w0);
+        x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, w1));
+        x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, w2));
+        x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, w3));
+        const uint32_t r = ~static_cast<uint32_t>(_mm256_movemask_epi8(x));
+        if (r != 0)     // some of characters is non-whitespace
+            return p + internal::ctzll(r);
+    }
+}
+
+inline const char *SkipWhitespace_SIMD(const char* p, const char* end) {
+    // Fast return for single non-whitespace
+    if (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+    else
+        return p;
+
+    // The middle of string using SIMD
+    const __m256i w0 = _mm256_set1_epi8(' ');
+    const __m256i w1 = _mm256_set1_epi8('\n');
+    const __m256i w2 = _mm256_set1_epi8('\r');
+    const __m256i w3 = _mm256_set1_epi8('\t');
+
+    for (; end - p >= 32; p += 32) {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i x = _mm256_cmpeq_epi8(s, w0);
+        x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, w1));
+        x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, w2));
+        x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, w3));
+        const uint32_t r = ~static_cast<uint32_t>(_mm256_movemask_epi8(x));
+        if (r != 0)     // some of characters is non-whitespace
+            return p + internal::ctzll(r);
+    }
+
+    return SkipWhitespace(p, end);
+}
+
+#elif defined(RAPIDJSON_SSE42)
 //! Skip whitespace with SSE 4.2 pcmpistrm instruction, testing 16 8-byte characters at once.
 inline const char *SkipWhitespace_SIMD(const char* p) {
     // Fast return for single non-whitespace
@@ -498,9 +661,32 @@ inline const char *SkipWhitespace_SIMD(const char* p, const char* end) {
     return SkipWhitespace(p, end);
 }
 
-#endif // RAPIDJSON_NEON
+#elif defined(RAPIDJSON_SIMD_DISPATCH)
+
+//! Skip whitespace with the SIMD kernel selected at runtime.
+inline const char *SkipWhitespace_SIMD(const char* p) {
+    // Fast return for single non-whitespace
+    if (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+        ++p;
+    else
+        return p;
+
+    return internal::GetSimdKernels().skipWhitespace(p);
+}
+
+inline const char *SkipWhitespace_SIMD(const char* p, const char* end) {
+    // Fast return for single non-whitespace
+    if (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+    else
+        return p;
 
-#ifdef RAPIDJSON_SIMD
+    return internal::GetSimdKernels().skipWhitespaceN(p, end);
+}
+
+#endif // RAPIDJSON_SIMD_DISPATCH
+
+#if defined(RAPIDJSON_SIMD) || defined(RAPIDJSON_SIMD_DISPATCH)
 //! Template function specialization for InsituStringStream
 template<> inline void SkipWhitespace(InsituStringStream& is) {
     is.src_ = const_cast<char*>(SkipWhitespace_SIMD(is.src_));
@@ -510,11 +696,145 @@ template<> inline void SkipWhitespace(InsituStringStream& is) {
 template<> inline void SkipWhitespace(StringStream& is) {
     is.src_ = SkipWhitespace_SIMD(is.src_);
 }
+#endif // RAPIDJSON_SIMD || RAPIDJSON_SIMD_DISPATCH
+
+namespace internal {
+
+//! Type of stream a stream is parsed as by GenericReader::Parse().
+/*! Specialize it for a stream deriving from an in-memory stream, like
+    StringStream or InsituStringStream, so that the parser uses the SIMD
+    specializations of that stream.
+*/
+template <typename InputStream>
+struct ReaderStream {
+    typedef InputStream Type;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Up to eight digits at once
+
+//! Powers of 10 for runs of 0 to 8 digits.
+static const uint32_t kPow10Digits[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+//! Number of decimal digits starting a word of 8 characters, first character in the low byte.
+inline unsigned CountDigits(uint64_t w) {
+    // Bytes other than 0x33 are not digits; a carry from the addition only follows a non-digit
+    const uint64_t t = ((w & RAPIDJSON_UINT64_C2(0xF0F0F0F0, 0xF0F0F0F0)) |
+                        (((w + RAPIDJSON_UINT64_C2(0x06060606, 0x06060606)) & RAPIDJSON_UINT64_C2(0xF0F0F0F0, 0xF0F0F0F0)) >> 4)) ^
+                       RAPIDJSON_UINT64_C2(0x33333333, 0x33333333);
+    return t == 0 ? 8u : ctzll(t) / 8;
+}
+
+//! Value of the first 1 <= n <= 8 decimal digits of a word, first digit in the low byte, with three multiplications.
+inline uint32_t ParseDigits(uint64_t w, unsigned n) {
+    RAPIDJSON_ASSERT(n >= 1 && n <= 8);
+    const uint64_t zeros = RAPIDJSON_UINT64_C2(0x30303030, 0x30303030);
+    const uint64_t mask = RAPIDJSON_UINT64_C2(0x000000FF, 0x000000FF);
+    const uint64_t mul1 = RAPIDJSON_UINT64_C2(0x000F4240, 0x00000064); // 100 + (1000000 << 32)
+    const uint64_t mul2 = RAPIDJSON_UINT64_C2(0x00002710, 0x00000001); // 1 + (10000 << 32)
+    if (n < 8) // leading '0's in place of the characters after the digits
+        w = (w << (64 - 8 * n)) | (zeros >> (8 * n));
+    w -= zeros;
+    w = (w * 10) + (w >> 8); // pairs of digits in every other byte
+    w = (((w & mask) * mul1) + (((w >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(w);
+}
+
+//! Take the run of up to 8 digits next in a stream, loaded in a word with the first character in the low byte.
+/*! \return Number of digits taken, always 0 for streams without contiguous characters.
+*/
+template<typename InputStream>
+inline unsigned TakeDigits(InputStream&, uint64_t&, FalseType) {
+    return 0;
+}
+
+#if RAPIDJSON_ENDIAN == RAPIDJSON_LITTLEENDIAN
+// BufferedStream: load up to 8 characters of the window.
+template<typename InputStream>
+inline unsigned TakeDigits(InputStream& is, uint64_t& w, TrueType) {
+    RAPIDJSON_STATIC_ASSERT(sizeof(typename InputStream::Ch) == 1);
+    const size_t size = is.WindowSize();
+    w = 0;
+    std::memcpy(&w, is.Window(), size < 8 ? size : 8);
+    const unsigned n = CountDigits(w);
+    is.Consume(n);
+    return n;
+}
+#else
+template<typename InputStream>
+inline unsigned TakeDigits(InputStream&, uint64_t&, TrueType) {
+    return 0;
+}
+#endif
+
+template<typename InputStream>
+inline unsigned TakeDigits(InputStream& is, uint64_t& w) {
+    return TakeDigits(is, w, BoolType<BufferedStreamTraits<InputStream>::buffered != 0>());
+}
+
+#if RAPIDJSON_ENDIAN == RAPIDJSON_LITTLEENDIAN
+#if defined(__SANITIZE_ADDRESS__)
+#define RAPIDJSON_READER_ASAN 1
+#elif defined(__clang__)
+#define RAPIDJSON_READER_ASAN __has_feature(address_sanitizer)
+#else
+#define RAPIDJSON_READER_ASAN 0
+#endif
+
+//! Load the 8 characters at p of a null-terminated string, and count the digits starting them.
+/*! As the SIMD whitespace skipping, only loads 8-byte aligned words. The
+    second word is loaded only when the characters of the first one are all
+    digits, so the string goes on into it, thus no load crosses a page
+    boundary after the terminator.
+
+    AddressSanitizer reports these loads, so its builds read the characters
+    one by one instead, stopping at the first one which is not a digit.
+*/
+inline unsigned LoadDigits(const char* p, uint64_t& w) {
+#if RAPIDJSON_READER_ASAN
+    unsigned n = 0;
+    w = 0;
+    while (n < 8 && static_cast<unsigned>(p[n] - '0') < 10) {
+        w |= static_cast<uint64_t>(static_cast<unsigned char>(p[n])) << (n * 8);
+        n++;
+    }
+    return n;
+#else
+    const size_t offset = reinterpret_cast<size_t>(p) & 7;
+    const char* aligned = p - offset;
+    std::memcpy(&w, aligned, 8);
+    if (offset == 0)
+        return CountDigits(w);
+
+    const unsigned shift = static_cast<unsigned>(offset * 8);
+    w >>= shift; // zero bytes, not digits, in place of the characters of the next word
+    const unsigned n = CountDigits(w);
+    if (n < 8 - offset)
+        return n;
+    uint64_t high;
+    std::memcpy(&high, aligned + 8, 8);
+    w |= high << (64 - shift);
+    return CountDigits(w);
+#endif
+}
+#undef RAPIDJSON_READER_ASAN
+
+//! Template function overload for StringStream
+inline unsigned TakeDigits(StringStream& is, uint64_t& w) {
+    const unsigned n = LoadDigits(is.src_, w);
+    is.src_ += n;
+    return n;
+}
 
-template<> inline void SkipWhitespace(EncodedInputStream<UTF8<>, MemoryStream>& is) {
-    is.is_.src_ = SkipWhitespace_SIMD(is.is_.src_, is.is_.end_);
+//! Template function overload for InsituStringStream
+inline unsigned TakeDigits(InsituStringStream& is, uint64_t& w) {
+    const unsigned n = LoadDigits(is.src_, w);
+    is.src_ += n;
+    return n;
 }
-#endif // RAPIDJSON_SIMD
+#endif // RAPIDJSON_ENDIAN == RAPIDJSON_LITTLEENDIAN
+
+} // namespace internal
 
 ///////////////////////////////////////////////////////////////////////////////
 // GenericReader
@@ -557,36 +877,7 @@ public:
     */
     template <unsigned parseFlags, typename InputStream, typename Handler>
     ParseResult Parse(InputStream& is, Handler& handler) {
-        if (parseFlags & kParseIterativeFlag)
-            return IterativeParse<parseFlags>(is, handler);
-
-        parseResult_.Clear();
-
-        ClearStackOnExit scope(*this);
-
-        SkipWhitespaceAndComments<parseFlags>(is);
-        RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
-
-        if (RAPIDJSON_UNLIKELY(is.Peek() == '\0')) {
-            RAPIDJSON_PARSE_ERROR_NORETURN(kParseErrorDocumentEmpty, is.Tell());
-            RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
-        }
-        else {
-            ParseValue<parseFlags>(is, handler);
-            RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
-
-            if (!(parseFlags & kParseStopWhenDoneFlag)) {
-                SkipWhitespaceAndComments<parseFlags>(is);
-                RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
-
-                if (RAPIDJSON_UNLIKELY(is.Peek() != '\0')) {
-                    RAPIDJSON_PARSE_ERROR_NORETURN(kParseErrorDocumentRootNotSingular, is.Tell());
-                    RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
-                }
-            }
-        }
-
-        return parseResult_;
+        return ParseRoot<parseFlags>(static_cast<typename internal::ReaderStream<InputStream>::Type&>(is), handler);
     }
 
     //! Parse JSON text (with \ref kParseDefaultFlags)
@@ -697,6 +988,40 @@ private:
 
     void ClearStack() { stack_.Clear(); }
 
+    template <unsigned parseFlags, typename InputStream, typename Handler>
+    ParseResult ParseRoot(InputStream& is, Handler& handler) {
+        if (parseFlags & kParseIterativeFlag)
+            return IterativeParse<parseFlags>(is, handler);
+
+        parseResult_.Clear();
+
+        ClearStackOnExit scope(*this);
+
+        SkipWhitespaceAndComments<parseFlags>(is);
+        RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
+
+        if (RAPIDJSON_UNLIKELY(is.Peek() == '\0')) {
+            RAPIDJSON_PARSE_ERROR_NORETURN(kParseErrorDocumentEmpty, is.Tell());
+            RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
+        }
+        else {
+            ParseValue<parseFlags>(is, handler);
+            RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
+
+            if (!(parseFlags & kParseStopWhenDoneFlag)) {
+                SkipWhitespaceAndComments<parseFlags>(is);
+                RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
+
+                if (RAPIDJSON_UNLIKELY(is.Peek() != '\0')) {
+                    RAPIDJSON_PARSE_ERROR_NORETURN(kParseErrorDocumentRootNotSingular, is.Tell());
+                    RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
+                }
+            }
+        }
+
+        return parseResult_;
+    }
+
     // clear stack on any exit from ParseStream, e.g. due to exception
     struct ClearStackOnExit {
         explicit ClearStackOnExit(GenericReader& r) : r_(r) {}
@@ -769,7 +1094,7 @@ private:
             SkipWhitespaceAndComments<parseFlags>(is);
             RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
 
-            ParseValue<parseFlags>(is, handler);
+            ParseNestedValue<parseFlags>(is, handler, internal::BoolType<(parseFlags & kParseLazyContainersFlag) != 0>());
             RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
 
             SkipWhitespaceAndComments<parseFlags>(is);
@@ -822,7 +1147,7 @@ private:
         }
 
         for (SizeType elementCount = 0;;) {
-            ParseValue<parseFlags>(is, handler);
+            ParseNestedValue<parseFlags>(is, handler, internal::BoolType<(parseFlags & kParseLazyContainersFlag) != 0>());
             RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
 
             ++elementCount;
@@ -852,6 +1177,21 @@ private:
         }
     }
 
+    // Parse a member value or an element
+    template<unsigned parseFlags, typename InputStream, typename Handler>
+    RAPIDJSON_FORCEINLINE void ParseNestedValue(InputStream& is, Handler& handler, internal::FalseType) {
+        ParseValue<parseFlags>(is, handler);
+    }
+
+    // Parse a member value or an element, keeping objects and arrays as their text
+    template<unsigned parseFlags, typename InputStream, typename Handler>
+    RAPIDJSON_FORCEINLINE void ParseNestedValue(InputStream& is, Handler& handler, internal::TrueType) {
+        if (is.Peek() == '{' || is.Peek() == '[')
+            ParseRawContainer<parseFlags>(is, handler);
+        else
+            ParseValue<parseFlags>(is, handler);
+    }
+
     template<unsigned parseFlags, typename InputStream, typename Handler>
     void ParseNull(InputStream& is, Handler& handler) {
         RAPIDJSON_ASSERT(is.Peek() == 'n');
@@ -985,6 +1325,92 @@ private:
             RAPIDJSON_PARSE_ERROR(kParseErrorTermination, s.Tell());
     }
 
+    // Parse object or array as its text and generate RawContainer event. Different code paths for kParseInsituFlag.
+    template<unsigned parseFlags, typename InputStream, typename Handler>
+    void ParseRawContainer(InputStream& is, Handler& handler) {
+        internal::StreamLocalCopy<InputStream> copy(is);
+        InputStream& s(copy.s);
+
+        bool success = false;
+        if (parseFlags & kParseInsituFlag) {
+            typename InputStream::Ch *head = s.PutBegin();
+            ScanRawContainer<parseFlags, SourceEncoding, SourceEncoding>(s, s);
+            RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+            size_t length = s.PutEnd(head);
+            RAPIDJSON_ASSERT(length <= 0xFFFFFFFF);
+            const typename TargetEncoding::Ch* const str = reinterpret_cast<typename TargetEncoding::Ch*>(head);
+            success = handler.RawContainer(str, SizeType(length), false);
+        }
+        else {
+            StackStream<typename TargetEncoding::Ch> stackStream(stack_);
+            ScanRawContainer<parseFlags, SourceEncoding, TargetEncoding>(s, stackStream);
+            RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+            SizeType length = static_cast<SizeType>(stackStream.Length());
+            const typename TargetEncoding::Ch* const str = stackStream.Pop();
+            success = handler.RawContainer(str, length, true);
+        }
+        if (RAPIDJSON_UNLIKELY(!success))
+            RAPIDJSON_PARSE_ERROR(kParseErrorTermination, s.Tell());
+    }
+
+    // Copy object or array to an output stream, up to its closing bracket.
+    // Only checks that the brackets are balanced outside strings and comments, the rest is parsed later from the copy.
+    template<unsigned parseFlags, typename SEncoding, typename TEncoding, typename InputStream, typename OutputStream>
+    void ScanRawContainer(InputStream& is, OutputStream& os) {
+        const bool isObject = is.Peek() == '{';
+        SizeType depth = 0;
+        for (;;) {
+            Ch c = is.Peek();
+            if (c == '{' || c == '[')
+                ++depth;
+            else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    os.Put(static_cast<typename TEncoding::Ch>(is.Take()));
+                    return;
+                }
+            }
+            else if (c == '"') {
+                os.Put(static_cast<typename TEncoding::Ch>(is.Take()));
+                while ((c = is.Peek()) != '"') {
+                    if (c == '\\') { // Copy the escaped character, which may be a quotation mark
+                        os.Put(static_cast<typename TEncoding::Ch>(is.Take()));
+                        c = is.Peek();
+                    }
+                    if (RAPIDJSON_UNLIKELY(c == '\0'))
+                        RAPIDJSON_PARSE_ERROR(kParseErrorStringMissQuotationMark, is.Tell());
+                    size_t offset = is.Tell();
+                    if (RAPIDJSON_UNLIKELY((parseFlags & kParseValidateEncodingFlag ?
+                        !Transcoder<SEncoding, TEncoding>::Validate(is, os) :
+                        !Transcoder<SEncoding, TEncoding>::Transcode(is, os))))
+                        RAPIDJSON_PARSE_ERROR(kParseErrorStringInvalidEncoding, offset);
+                }
+            }
+            else if ((parseFlags & kParseCommentsFlag) && c == '/') {
+                os.Put(static_cast<typename TEncoding::Ch>(is.Take()));
+                if (is.Peek() == '*') { // Copy up to */, not a quotation mark or bracket
+                    os.Put(static_cast<typename TEncoding::Ch>(is.Take()));
+                    for (;;) {
+                        if (RAPIDJSON_UNLIKELY((c = is.Peek()) == '\0'))
+                            RAPIDJSON_PARSE_ERROR(kParseErrorUnspecificSyntaxError, is.Tell());
+                        Transcoder<SEncoding, TEncoding>::Transcode(is, os);
+                        if (c == '*' && is.Peek() == '/') {
+                            os.Put(static_cast<typename TEncoding::Ch>(is.Take()));
+                            break;
+                        }
+                    }
+                }
+                else if (is.Peek() == '/') {
+                    while (is.Peek() != '\0' && is.Peek() != '\n')
+                        Transcoder<SEncoding, TEncoding>::Transcode(is, os);
+                }
+                continue;
+            }
+            else if (RAPIDJSON_UNLIKELY(c == '\0'))
+                RAPIDJSON_PARSE_ERROR(isObject ? kParseErrorObjectMissCommaOrCurlyBracket : kParseErrorArrayMissCommaOrSquareBracket, is.Tell());
+            Transcoder<SEncoding, TEncoding>::Transcode(is, os);
+        }
+    }
+
     // Parse string to an output is
     // This function handles the prefix/suffix double quotes, escaping, and optional encoding validation.
     template<unsigned parseFlags, typename SEncoding, typename TEncoding, typename InputStream, typename OutputStream>
@@ -1005,6 +1431,8 @@ private:
             // Scan and copy string before "\\\"" or < 0x20. This is an optional optimzation.
             if (!(parseFlags & kParseValidateEncodingFlag))
                 ScanCopyUnescapedString(is, os);
+            else if (internal::IsSame<SEncoding, UTF8<> >::Value && internal::IsSame<TEncoding, UTF8<> >::Value)
+                ScanCopyValidUnescapedString(is, os);
 
             Ch c = is.Peek();
             if (RAPIDJSON_UNLIKELY(c == '\\')) {    // Escape
@@ -1068,11 +1496,312 @@ private:
     }
 
     template<typename InputStream, typename OutputStream>
-    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(InputStream&, OutputStream&) {
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(InputStream& is, OutputStream& os) {
+        ScanCopyBufferedString(is, os, internal::BoolType<BufferedStreamTraits<InputStream>::buffered != 0>());
+    }
+
+    template<typename InputStream, typename OutputStream, typename Buffered>
+    static RAPIDJSON_FORCEINLINE void ScanCopyBufferedString(InputStream&, OutputStream&, Buffered) {
+            // Do nothing for generic version
+    }
+
+    // BufferedStream -> StackStream<char>: copy the unescaped characters of each window at once.
+    template<typename InputStream>
+    static RAPIDJSON_FORCEINLINE void ScanCopyBufferedString(InputStream& is, StackStream<char>& os, internal::TrueType) {
+        for (;;) {
+            const char* p = is.Window();
+            const size_t size = is.WindowSize();
+            size_t length = 0;
+            while (length != size && p[length] != '\"' && p[length] != '\\' && static_cast<unsigned char>(p[length]) >= 0x20)
+                ++length;
+            if (length != 0) {
+                std::memcpy(os.Push(static_cast<SizeType>(length)), p, length);
+                is.Consume(length);
+            }
+            if (length != size || size == 0)
+                return;
+        }
+    }
+
+    // Same as ScanCopyUnescapedString(), for UTF-8 to UTF-8 with kParseValidateEncodingFlag.
+    template<typename InputStream, typename OutputStream>
+    static RAPIDJSON_FORCEINLINE void ScanCopyValidUnescapedString(InputStream&, OutputStream&) {
             // Do nothing for generic version
     }
 
-#if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
+#if defined(RAPIDJSON_SSE42) || defined(RAPIDJSON_SIMD_DISPATCH)
+    static RAPIDJSON_FORCEINLINE const char* ScanValidUTF8Unescaped(const char* p) {
+#ifdef RAPIDJSON_SSE42
+        return internal::ScanValidUTF8Unescaped(p);
+#else
+        return internal::GetSimdKernels().scanValidUTF8Unescaped(p);
+#endif
+    }
+
+    // StringStream -> StackStream<char>
+    static RAPIDJSON_FORCEINLINE void ScanCopyValidUnescapedString(StringStream& is, StackStream<char>& os) {
+        const char* p = is.src_;
+        const char* end = ScanValidUTF8Unescaped(p);
+        if (end != p) {
+            const SizeType length = static_cast<SizeType>(end - p);
+            std::memcpy(os.Push(length), p, length);
+            is.src_ = end;
+        }
+    }
+
+    // InsituStringStream -> InsituStringStream
+    static RAPIDJSON_FORCEINLINE void ScanCopyValidUnescapedString(InsituStringStream& is, InsituStringStream& os) {
+        RAPIDJSON_ASSERT(&is == &os);
+        (void)os;
+
+        char* p = is.src_;
+        const size_t length = static_cast<size_t>(ScanValidUTF8Unescaped(p) - p);
+        if (is.src_ != is.dst_)
+            std::memmove(is.dst_, p, length);
+        is.src_ += length;
+        is.dst_ += length;
+    }
+#endif // RAPIDJSON_SSE42 || RAPIDJSON_SIMD_DISPATCH
+
+#if defined(RAPIDJSON_AVX512)
+    // StringStream -> StackStream<char>
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
+        const char* p = is.src_;
+
+        // Scan one by one until alignment (unaligned load may cross page boundary and cause crash)
+        const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 63) & static_cast<size_t>(~63));
+        while (p != nextAligned)
+            if (RAPIDJSON_UNLIKELY(*p == '\"') || RAPIDJSON_UNLIKELY(*p == '\\') || RAPIDJSON_UNLIKELY(static_cast<unsigned>(*p) < 0x20)) {
+                is.src_ = p;
+                return;
+            }
+            else
+                os.Put(*p++);
+
+        // The rest of string using SIMD
+        const __m512i dq = _mm512_set1_epi8('\"');
+        const __m512i bs = _mm512_set1_epi8('\\');
+        const __m512i sp = _mm512_set1_epi8(0x20);
+
+        for (;; p += 64) {
+            const __m512i s = _mm512_load_si512(reinterpret_cast<const void *>(p));
+            const uint64_t r = _mm512_cmpeq_epi8_mask(s, dq) | _mm512_cmpeq_epi8_mask(s, bs) | _mm512_cmplt_epu8_mask(s, sp);
+            if (RAPIDJSON_UNLIKELY(r != 0)) {   // some of characters is escaped
+                SizeType length = static_cast<SizeType>(internal::ctzll(r));
+                if (length != 0) {
+                    // Masked store writes only the unescaped prefix
+                    _mm512_mask_storeu_epi8(os.Push(length), (static_cast<uint64_t>(1) << length) - 1, s);
+                    p += length;
+                }
+                break;
+            }
+            _mm512_storeu_si512(os.Push(64), s);
+        }
+
+        is.src_ = p;
+    }
+
+    // InsituStringStream -> InsituStringStream
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(InsituStringStream& is, InsituStringStream& os) {
+        RAPIDJSON_ASSERT(&is == &os);
+        (void)os;
+
+        if (is.src_ == is.dst_) {
+            SkipUnescapedString(is);
+            return;
+        }
+
+        char* p = is.src_;
+        char *q = is.dst_;
+
+        // Scan one by one until alignment (unaligned load may cross page boundary and cause crash)
+        const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 63) & static_cast<size_t>(~63));
+        while (p != nextAligned)
+            if (RAPIDJSON_UNLIKELY(*p == '\"') || RAPIDJSON_UNLIKELY(*p == '\\') || RAPIDJSON_UNLIKELY(static_cast<unsigned>(*p) < 0x20)) {
+                is.src_ = p;
+                is.dst_ = q;
+                return;
+            }
+            else
+                *q++ = *p++;
+
+        // The rest of string using SIMD
+        const __m512i dq = _mm512_set1_epi8('\"');
+        const __m512i bs = _mm512_set1_epi8('\\');
+        const __m512i sp = _mm512_set1_epi8(0x20);
+
+        for (;; p += 64, q += 64) {
+            const __m512i s = _mm512_load_si512(reinterpret_cast<const void *>(p));
+            const uint64_t r = _mm512_cmpeq_epi8_mask(s, dq) | _mm512_cmpeq_epi8_mask(s, bs) | _mm512_cmplt_epu8_mask(s, sp);
+            if (RAPIDJSON_UNLIKELY(r != 0)) {   // some of characters is escaped
+                size_t length = internal::ctzll(r);
+                for (const char* pend = p + length; p != pend; )
+                    *q++ = *p++;
+                break;
+            }
+            _mm512_storeu_si512(reinterpret_cast<void *>(q), s);
+        }
+
+        is.src_ = p;
+        is.dst_ = q;
+    }
+
+    // When read/write pointers are the same for insitu stream, just skip unescaped characters
+    static RAPIDJSON_FORCEINLINE void SkipUnescapedString(InsituStringStream& is) {
+        RAPIDJSON_ASSERT(is.src_ == is.dst_);
+        char* p = is.src_;
+
+        // Scan one by one until alignment (unaligned load may cross page boundary and cause crash)
+        const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 63) & static_cast<size_t>(~63));
+        for (; p != nextAligned; p++)
+            if (RAPIDJSON_UNLIKELY(*p == '\"') || RAPIDJSON_UNLIKELY(*p == '\\') || RAPIDJSON_UNLIKELY(static_cast<unsigned>(*p) < 0x20)) {
+                is.src_ = is.dst_ = p;
+                return;
+            }
+
+        // The rest of string using SIMD
+        const __m512i dq = _mm512_set1_epi8('\"');
+        const __m512i bs = _mm512_set1_epi8('\\');
+        const __m512i sp = _mm512_set1_epi8(0x20);
+
+        for (;; p += 64) {
+            const __m512i s = _mm512_load_si512(reinterpret_cast<const void *>(p));
+            const uint64_t r = _mm512_cmpeq_epi8_mask(s, dq) | _mm512_cmpeq_epi8_mask(s, bs) | _mm512_cmplt_epu8_mask(s, sp);
+            if (RAPIDJSON_UNLIKELY(r != 0)) {   // some of characters is escaped
+                p += internal::ctzll(r);
+                break;
+            }
+        }
+
+        is.src_ = is.dst_ = p;
+    }
+#elif defined(RAPIDJSON_AVX2)
+    // StringStream -> StackStream<char>
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
+        const char* p = is.src_;
+
+        // Scan one by one until alignment (unaligned load may cross page boundary and cause crash)
+        const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 31) & static_cast<size_t>(~31));
+        while (p != nextAligned)
+            if (RAPIDJSON_UNLIKELY(*p == '\"') || RAPIDJSON_UNLIKELY(*p == '\\') || RAPIDJSON_UNLIKELY(static_cast<unsigned>(*p) < 0x20)) {
+                is.src_ = p;
+                return;
+            }
+            else
+                os.Put(*p++);
+
+        // The rest of string using SIMD
+        const __m256i dq = _mm256_set1_epi8('\"');
+        const __m256i bs = _mm256_set1_epi8('\\');
+        const __m256i sp = _mm256_set1_epi8(0x1F);
+
+        for (;; p += 32) {
+            const __m256i s = _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i t1 = _mm256_cmpeq_epi8(s, dq);
+            const __m256i t2 = _mm256_cmpeq_epi8(s, bs);
+            const __m256i t3 = _mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+            const __m256i x = _mm256_or_si256(_mm256_or_si256(t1, t2), t3);
+            const uint32_t r = static_cast<uint32_t>(_mm256_movemask_epi8(x));
+            if (RAPIDJSON_UNLIKELY(r != 0)) {   // some of characters is escaped
+                SizeType length = static_cast<SizeType>(internal::ctzll(r));
+                if (length != 0) {
+                    char* q = reinterpret_cast<char*>(os.Push(length));
+                    for (size_t i = 0; i < length; i++)
+                        q[i] = p[i];
+
+                    p += length;
+                }
+                break;
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(os.Push(32)), s);
+        }
+
+        is.src_ = p;
+    }
+
+    // InsituStringStream -> InsituStringStream
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(InsituStringStream& is, InsituStringStream& os) {
+        RAPIDJSON_ASSERT(&is == &os);
+        (void)os;
+
+        if (is.src_ == is.dst_) {
+            SkipUnescapedString(is);
+            return;
+        }
+
+        char* p = is.src_;
+        char *q = is.dst_;
+
+        // Scan one by one until alignment (unaligned load may cross page boundary and cause crash)
+        const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 31) & static_cast<size_t>(~31));
+        while (p != nextAligned)
+            if (RAPIDJSON_UNLIKELY(*p == '\"') || RAPIDJSON_UNLIKELY(*p == '\\') || RAPIDJSON_UNLIKELY(static_cast<unsigned>(*p) < 0x20)) {
+                is.src_ = p;
+                is.dst_ = q;
+                return;
+            }
+            else
+                *q++ = *p++;
+
+        // The rest of string using SIMD
+        const __m256i dq = _mm256_set1_epi8('\"');
+        const __m256i bs = _mm256_set1_epi8('\\');
+        const __m256i sp = _mm256_set1_epi8(0x1F);
+
+        for (;; p += 32, q += 32) {
+            const __m256i s = _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i t1 = _mm256_cmpeq_epi8(s, dq);
+            const __m256i t2 = _mm256_cmpeq_epi8(s, bs);
+            const __m256i t3 = _mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+            const __m256i x = _mm256_or_si256(_mm256_or_si256(t1, t2), t3);
+            const uint32_t r = static_cast<uint32_t>(_mm256_movemask_epi8(x));
+            if (RAPIDJSON_UNLIKELY(r != 0)) {   // some of characters is escaped
+                size_t length = internal::ctzll(r);
+                for (const char* pend = p + length; p != pend; )
+                    *q++ = *p++;
+                break;
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(q), s);
+        }
+
+        is.src_ = p;
+        is.dst_ = q;
+    }
+
+    // When read/write pointers are the same for insitu stream, just skip unescaped characters
+    static RAPIDJSON_FORCEINLINE void SkipUnescapedString(InsituStringStream& is) {
+        RAPIDJSON_ASSERT(is.src_ == is.dst_);
+        char* p = is.src_;
+
+        // Scan one by one until alignment (unaligned load may cross page boundary and cause crash)
+        const char* nextAligned = reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + 31) & static_cast<size_t>(~31));
+        for (; p != nextAligned; p++)
+            if (RAPIDJSON_UNLIKELY(*p == '\"') || RAPIDJSON_UNLIKELY(*p == '\\') || RAPIDJSON_UNLIKELY(static_cast<unsigned>(*p) < 0x20)) {
+                is.src_ = is.dst_ = p;
+                return;
+            }
+
+        // The rest of string using SIMD
+        const __m256i dq = _mm256_set1_epi8('\"');
+        const __m256i bs = _mm256_set1_epi8('\\');
+        const __m256i sp = _mm256_set1_epi8(0x1F);
+
+        for (;; p += 32) {
+            const __m256i s = _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i t1 = _mm256_cmpeq_epi8(s, dq);
+            const __m256i t2 = _mm256_cmpeq_epi8(s, bs);
+            const __m256i t3 = _mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+            const __m256i x = _mm256_or_si256(_mm256_or_si256(t1, t2), t3);
+            const uint32_t r = static_cast<uint32_t>(_mm256_movemask_epi8(x));
+            if (RAPIDJSON_UNLIKELY(r != 0)) {   // some of characters is escaped
+                p += internal::ctzll(r);
+                break;
+            }
+        }
+
+        is.src_ = is.dst_ = p;
+    }
+#elif defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
     // StringStream -> StackStream<char>
     static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
         const char* p = is.src_;
@@ -1402,7 +2131,31 @@ private:
 
         is.src_ = is.dst_ = p;
     }
-#endif // RAPIDJSON_NEON
+#elif defined(RAPIDJSON_SIMD_DISPATCH)
+    // StringStream -> StackStream<char>
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
+        const char* p = is.src_;
+        const char* q = internal::GetSimdKernels().scanUnescaped(p);
+        const SizeType length = static_cast<SizeType>(q - p);
+        if (length != 0)
+            std::memcpy(os.Push(length), p, length);
+        is.src_ = q;
+    }
+
+    // InsituStringStream -> InsituStringStream
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(InsituStringStream& is, InsituStringStream& os) {
+        RAPIDJSON_ASSERT(&is == &os);
+        (void)os;
+
+        char* p = is.src_;
+        char* q = const_cast<char*>(internal::GetSimdKernels().scanUnescaped(p));
+        const size_t length = static_cast<size_t>(q - p);
+        if (is.src_ != is.dst_) // destination trails source after escapes, ranges may overlap
+            std::memmove(is.dst_, p, length);
+        is.src_ = q;
+        is.dst_ += length;
+    }
+#endif // RAPIDJSON_SIMD_DISPATCH
 
     template<typename InputStream, typename StackCharacter, bool backup, bool pushOnTake>
     class NumberStream;
@@ -1418,6 +2171,7 @@ private:
         RAPIDJSON_FORCEINLINE Ch TakePush() { return is.Take(); }
         RAPIDJSON_FORCEINLINE Ch Take() { return is.Take(); }
         RAPIDJSON_FORCEINLINE void Push(char) {}
+        RAPIDJSON_FORCEINLINE unsigned TakePushDigits(uint64_t& w) { return internal::TakeDigits(is, w); }
 
         size_t Tell() { return is.Tell(); }
         size_t Length() { return 0; }
@@ -1444,6 +2198,13 @@ private:
             stackStream.Put(c);
         }
 
+        RAPIDJSON_FORCEINLINE unsigned TakePushDigits(uint64_t& w) {
+            const unsigned n = Base::TakePushDigits(w);
+            for (unsigned k = 0; k < n; k++)
+                stackStream.Put(static_cast<StackCharacter>((w >> (8 * k)) & 0xFF));
+            return n;
+        }
+
         size_t Length() { return stackStream.Length(); }
 
         const StackCharacter* Pop() {
@@ -1495,30 +2256,48 @@ private:
         else if (RAPIDJSON_LIKELY(s.Peek() >= '1' && s.Peek() <= '9')) {
             i = static_cast<unsigned>(s.TakePush() - '0');
 
-            if (minus)
-                while (RAPIDJSON_LIKELY(s.Peek() >= '0' && s.Peek() <= '9')) {
-                    if (RAPIDJSON_UNLIKELY(i >= 214748364)) { // 2^31 = 2147483648
-                        if (RAPIDJSON_LIKELY(i != 214748364 || s.Peek() > '8')) {
-                            i64 = i;
-                            use64bit = true;
-                            break;
+            // Take up to 8 digits at once from contiguous streams, up to 17 digits which cannot overflow 64 bits
+            uint64_t w;
+            unsigned n = s.TakePushDigits(w);
+            if (n != 0) {
+                i64 = static_cast<uint64_t>(i) * internal::kPow10Digits[n] + internal::ParseDigits(w, n);
+                significandDigit = static_cast<int>(n);
+                if (n == 8 && (n = s.TakePushDigits(w)) != 0) {
+                    i64 = i64 * internal::kPow10Digits[n] + internal::ParseDigits(w, n);
+                    significandDigit += static_cast<int>(n);
+                }
+                if (i64 > (minus ? 2147483648u : 4294967295u))
+                    use64bit = true;
+                else
+                    i = static_cast<unsigned>(i64);
+            }
+
+            if (!use64bit) {
+                if (minus)
+                    while (RAPIDJSON_LIKELY(s.Peek() >= '0' && s.Peek() <= '9')) {
+                        if (RAPIDJSON_UNLIKELY(i >= 214748364)) { // 2^31 = 2147483648
+                            if (RAPIDJSON_LIKELY(i != 214748364 || s.Peek() > '8')) {
+                                i64 = i;
+                                use64bit = true;
+                                break;
+                            }
                         }
+                        i = i * 10 + static_cast<unsigned>(s.TakePush() - '0');
+                        significandDigit++;
                     }
-                    i = i * 10 + static_cast<unsigned>(s.TakePush() - '0');
-                    significandDigit++;
-                }
-            else
-                while (RAPIDJSON_LIKELY(s.Peek() >= '0' && s.Peek() <= '9')) {
-                    if (RAPIDJSON_UNLIKELY(i >= 429496729)) { // 2^32 - 1 = 4294967295
-                        if (RAPIDJSON_LIKELY(i != 429496729 || s.Peek() > '5')) {
-                            i64 = i;
-                            use64bit = true;
-                            break;
+                else
+                    while (RAPIDJSON_LIKELY(s.Peek() >= '0' && s.Peek() <= '9')) {
+                        if (RAPIDJSON_UNLIKELY(i >= 429496729)) { // 2^32 - 1 = 4294967295
+                            if (RAPIDJSON_LIKELY(i != 429496729 || s.Peek() > '5')) {
+                                i64 = i;
+                                use64bit = true;
+                                break;
+                            }
                         }
+                        i = i * 10 + static_cast<unsigned>(s.TakePush() - '0');
+                        significandDigit++;
                     }
-                    i = i * 10 + static_cast<unsigned>(s.TakePush() - '0');
-                    significandDigit++;
-                }
+            }
         }
         // Parse NaN or Infinity here
         else if ((parseFlags & kParseNanAndInfFlag) && RAPIDJSON_LIKELY((s.Peek() == 'I' || s.Peek() == 'N'))) {
@@ -1596,6 +2375,22 @@ private:
                 if (!use64bit)
                     i64 = i;
 
+                // Take up to 8 digits at once while none of them can reach the limit below
+                uint64_t w;
+                unsigned n;
+                while (i64 <= 900719924u && (n = s.TakePushDigits(w)) != 0) { // (2^53 - 1 - 9999999) / 10^7
+                    const uint32_t digits = internal::ParseDigits(w, n);
+                    if (i64 != 0)
+                        significandDigit += static_cast<int>(n);
+                    else
+                        for (uint32_t v = digits; v != 0; v /= 10)
+                            significandDigit++;
+                    i64 = i64 * internal::kPow10Digits[n] + digits;
+                    expFrac -= static_cast<int>(n);
+                    if (n != 8)
+                        break;
+                }
+
                 while (RAPIDJSON_LIKELY(s.Peek() >= '0' && s.Peek() <= '9')) {
                     if (i64 > RAPIDJSON_UINT64_C2(0x1FFFFF, 0xFFFFFFFF)) // 2^53 - 1 for fast path
                         break;
@@ -79,6 +79,99 @@ struct StreamTraits {
     enum { copyOptimization = 0 };
 };
 
+///////////////////////////////////////////////////////////////////////////////
+//  BufferedStream
+
+/*! \class rapidjson::BufferedStream
+    \brief Concept for input byte streams reading through a buffer.
+
+    The parser scans the buffered characters of such a stream at once, e.g.
+    with SIMD instructions when skipping whitespace, or 8 digits of a number
+    at a time, instead of calling Peek() and Take() for each character.
+
+\code
+concept BufferedStream : Stream {
+    //! Current character, followed by the other buffered characters.
+    const Ch* Window() const;
+
+    //! Number of characters at Window(), 0 only at the end of the stream.
+    size_t WindowSize() const;
+
+    //! Move the read cursor by n <= WindowSize() characters, refilling the buffer when it is exhausted.
+    void Consume(size_t n);
+}
+\endcode
+
+    Streams implementing it specialize BufferedStreamTraits.
+*/
+
+//! Tells whether a stream implements the BufferedStream concept.
+template<typename Stream>
+struct BufferedStreamTraits {
+    //! Whether the parser may use Window(), WindowSize() and Consume() of a \c char stream.
+    enum { buffered = 0 };
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//  ScatterStream
+
+/*! \class rapidjson::ScatterStream
+    \brief Concept for output byte streams writing characters by reference.
+
+    Writer passes the runs of string characters that need no escaping, and
+    raw values, to such a stream without copying them, when no transcoding
+    or validation is needed. The stream may then write them directly from
+    the source memory, e.g. with writev().
+
+\code
+concept ScatterStream : Stream {
+    //! Write n characters, which may be referenced until the next Flush().
+    void PutRef(const Ch* s, size_t n);
+}
+\endcode
+
+    The characters passed to PutRef() must stay valid and unchanged until
+    Flush() is called, which Writer does at the end of each JSON text.
+    Streams implementing it specialize ScatterStreamTraits.
+*/
+
+//! Tells whether a stream implements the ScatterStream concept.
+template<typename Stream>
+struct ScatterStreamTraits {
+    //! Whether the writer may use PutRef() of the stream.
+    enum { scatter = 0 };
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//  BufferedOutputStream
+
+/*! \class rapidjson::BufferedOutputStream
+    \brief Concept for output byte streams writing through a buffer.
+
+    Writer scans the runs of string characters that need no escaping at
+    once, e.g. with SIMD instructions, and copies them into the free space of
+    the buffer of such a stream, instead of calling Put() for each character.
+
+\code
+concept BufferedOutputStream : Stream {
+    //! Free space of the buffer, of size >= 1, flushing or growing the buffer when it is full.
+    Ch* PutWindow(size_t& size);
+
+    //! Append the first n <= size characters written at PutWindow() to the stream.
+    void PutCommit(size_t n);
+}
+\endcode
+
+    Streams implementing it specialize BufferedOutputStreamTraits.
+*/
+
+//! Tells whether a stream implements the BufferedOutputStream concept.
+template<typename Stream>
+struct BufferedOutputStreamTraits {
+    //! Whether the writer may use PutWindow() and PutCommit() of a \c char stream.
+    enum { buffered = 0 };
+};
+
 //! Reserve n characters for writing to a stream.
 template<typename Stream>
 inline void PutReserve(Stream& stream, size_t count) {
@@ -35,7 +35,7 @@ RAPIDJSON_NAMESPACE_BEGIN
 /*!
     \tparam Encoding Encoding of the stream.
     \tparam Allocator type for allocating memory buffer.
-    \note implements Stream concept
+    \note implements Stream and BufferedOutputStream concepts
 */
 template <typename Encoding, typename Allocator = CrtAllocator>
 class GenericStringBuffer {
@@ -70,6 +70,15 @@ public:
     Ch* PushUnsafe(size_t count) { return stack_.template PushUnsafe<Ch>(count); }
     void Pop(size_t count) { stack_.template Pop<Ch>(count); }
 
+    // BufferedOutputStream concept
+    Ch* PutWindow(size_t& size) {
+        if (stack_.GetCapacity() - stack_.GetSize() < sizeof(Ch))
+            stack_.template Reserve<Ch>(1);
+        size = (stack_.GetCapacity() - stack_.GetSize()) / sizeof(Ch);
+        return stack_.template End<Ch>();
+    }
+    void PutCommit(size_t n) { stack_.template PushUnsafe<Ch>(n); }
+
     const Ch* GetString() const {
         // Push and pop a null terminator. This is safe.
         *stack_.template Push<Ch>() = '\0';
@@ -106,6 +115,11 @@ inline void PutUnsafe(GenericStringBuffer<Encoding, Allocator>& stream, typename
     stream.PutUnsafe(c);
 }
 
+template<typename Encoding, typename Allocator>
+struct BufferedOutputStreamTraits<GenericStringBuffer<Encoding, Allocator> > {
+    enum { buffered = 1 };
+};
+
 //! Implement specialized version of PutN() with memset() for better performance.
 template<>
 inline void PutN(GenericStringBuffer<UTF8<> >& stream, char c, size_t n) {
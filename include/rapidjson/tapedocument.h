@@ -0,0 +1,694 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_TAPEDOCUMENT_H_
+#define RAPIDJSON_TAPEDOCUMENT_H_
+
+/*! \file tapedocument.h */
+
+#include "reader.h"
+#include "memorystream.h"
+#include "encodedstream.h"
+#include "internal/stack.h"
+#include "internal/strfunc.h"
+#include <climits>
+#include <cstring>
+#include <iterator>
+#if RAPIDJSON_HAS_STDSTRING
+#include <string>
+#endif
+
+RAPIDJSON_DIAG_PUSH
+#ifdef __clang__
+RAPIDJSON_DIAG_OFF(padded)
+RAPIDJSON_DIAG_OFF(c++98-compat)
+#endif
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+namespace internal {
+
+///////////////////////////////////////////////////////////////////////////////
+// Tape words
+
+// A tape word holds a tag in its top byte and a 56-bit payload.
+//
+//  tag   payload                          words
+//  'n'   -                                1
+//  't'   -                                1
+//  'f'   -                                1
+//  'l'   -, next word is an int64_t       2
+//  'u'   -, next word is an uint64_t      2
+//  'd'   -, next word is a double         2
+//  '"'   arena offset, next word length   2
+//  '{'   distance to the matching '}'     1
+//  '}'   member count                     1
+//  '['   distance to the matching ']'     1
+//  ']'   element count                    1
+
+static const unsigned kTapeTagShift = 56;
+static const uint64_t kTapePayloadMask = (static_cast<uint64_t>(1) << kTapeTagShift) - 1;
+
+inline uint64_t TapeWord(char tag, uint64_t payload) {
+    RAPIDJSON_ASSERT(payload <= kTapePayloadMask);
+    return (static_cast<uint64_t>(static_cast<unsigned char>(tag)) << kTapeTagShift) | payload;
+}
+
+inline char TapeTag(uint64_t word) { return static_cast<char>(word >> kTapeTagShift); }
+inline uint64_t TapePayload(uint64_t word) { return word & kTapePayloadMask; }
+
+//! Word following the value starting at \c p.
+inline const uint64_t* TapeSkip(const uint64_t* p) {
+    switch (TapeTag(*p)) {
+    case '{':
+    case '[': return p + TapePayload(*p) + 1;
+    case 'l':
+    case 'u':
+    case 'd':
+    case '"': return p + 2;
+    default:  return p + 1;
+    }
+}
+
+} // namespace internal
+
+template <typename Encoding, typename Allocator, typename StackAllocator>
+class GenericTapeDocument;
+template <typename Encoding>
+class GenericTapeValue;
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericTapeMember, GenericTapeMemberIterator, GenericTapeValueIterator
+
+//! Name-value pair of an object in a GenericTapeDocument.
+template <typename Encoding>
+struct GenericTapeMember {
+    GenericTapeValue<Encoding> name;    //!< name of member (must be a string)
+    GenericTapeValue<Encoding> value;   //!< value of member.
+};
+
+//! Forward iterator over the members of an object in a GenericTapeDocument.
+template <typename Encoding>
+class GenericTapeMemberIterator {
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef GenericTapeMember<Encoding> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    GenericTapeMemberIterator() : m_() {}
+
+    reference operator*() const { return m_; }
+    pointer operator->() const { return &m_; }
+
+    GenericTapeMemberIterator& operator++() { Set(internal::TapeSkip(m_.value.word_), m_.name.strings_); return *this; }
+    GenericTapeMemberIterator operator++(int) { GenericTapeMemberIterator old(*this); ++*this; return old; }
+
+    bool operator==(const GenericTapeMemberIterator& that) const { return m_.name.word_ == that.m_.name.word_; }
+    bool operator!=(const GenericTapeMemberIterator& that) const { return m_.name.word_ != that.m_.name.word_; }
+
+private:
+    friend class GenericTapeValue<Encoding>;
+    GenericTapeMemberIterator(const uint64_t* word, const typename Encoding::Ch* strings) : m_() { Set(word, strings); }
+
+    void Set(const uint64_t* word, const typename Encoding::Ch* strings) {
+        m_.name = GenericTapeValue<Encoding>(word, strings);
+        m_.value = GenericTapeValue<Encoding>(word + 2, strings);  // names take two words
+    }
+
+    value_type m_;
+};
+
+//! Forward iterator over the elements of an array in a GenericTapeDocument.
+template <typename Encoding>
+class GenericTapeValueIterator {
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef GenericTapeValue<Encoding> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    GenericTapeValueIterator() : v_() {}
+
+    reference operator*() const { return v_; }
+    pointer operator->() const { return &v_; }
+
+    GenericTapeValueIterator& operator++() { v_.word_ = internal::TapeSkip(v_.word_); return *this; }
+    GenericTapeValueIterator operator++(int) { GenericTapeValueIterator old(*this); ++*this; return old; }
+
+    bool operator==(const GenericTapeValueIterator& that) const { return v_.word_ == that.v_.word_; }
+    bool operator!=(const GenericTapeValueIterator& that) const { return v_.word_ != that.v_.word_; }
+
+private:
+    friend class GenericTapeValue<Encoding>;
+    GenericTapeValueIterator(const uint64_t* word, const typename Encoding::Ch* strings) : v_(word, strings) {}
+
+    value_type v_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericTapeValue
+
+//! Read-only view of a value in a GenericTapeDocument.
+/*!
+    Mirrors the query API of GenericValue. A view is two pointers and is
+    passed by value; it stays valid until the document is parsed again or
+    destroyed.
+
+    Unlike GenericValue, positional access to array elements and member
+    lookup scan the container, so prefer iterators for traversal.
+
+    \tparam Encoding Encoding of the strings in the document.
+*/
+template <typename Encoding>
+class GenericTapeValue {
+public:
+    typedef typename Encoding::Ch Ch;   //!< Character type derived from Encoding.
+
+    typedef GenericTapeMember<Encoding> Member;                 //!< Name-value pair of an object.
+    typedef GenericTapeMemberIterator<Encoding> MemberIterator; //!< Member iterator for iterating in object.
+    typedef GenericTapeValueIterator<Encoding> ValueIterator;   //!< Value iterator for iterating in array.
+    typedef MemberIterator ConstMemberIterator;     //!< Constant member iterator, same as MemberIterator.
+    typedef ValueIterator ConstValueIterator;       //!< Constant element iterator, same as ValueIterator.
+
+    //! Default constructor creates a null value.
+    GenericTapeValue() : word_(&NullWord()), strings_(0) {}
+
+    //!@name Type
+    //@{
+
+    Type GetType() const {
+        switch (Tag()) {
+        case 't': return kTrueType;
+        case 'f': return kFalseType;
+        case '{': return kObjectType;
+        case '[': return kArrayType;
+        case '"': return kStringType;
+        case 'l':
+        case 'u':
+        case 'd': return kNumberType;
+        default:  return kNullType;
+        }
+    }
+
+    bool IsNull()   const { return Tag() == 'n'; }
+    bool IsFalse()  const { return Tag() == 'f'; }
+    bool IsTrue()   const { return Tag() == 't'; }
+    bool IsBool()   const { return Tag() == 't' || Tag() == 'f'; }
+    bool IsObject() const { return Tag() == '{'; }
+    bool IsArray()  const { return Tag() == '['; }
+    bool IsNumber() const { return Tag() == 'l' || Tag() == 'u' || Tag() == 'd'; }
+    bool IsString() const { return Tag() == '"'; }
+    bool IsDouble() const { return Tag() == 'd'; }
+
+    bool IsInt() const {
+        return (Tag() == 'l' && Int64Word() >= INT_MIN && Int64Word() <= INT_MAX) ||
+               (Tag() == 'u' && word_[1] <= static_cast<uint64_t>(INT_MAX));
+    }
+
+    bool IsUint() const {
+        return (Tag() == 'l' && Int64Word() >= 0 && Int64Word() <= static_cast<int64_t>(UINT_MAX)) ||
+               (Tag() == 'u' && word_[1] <= static_cast<uint64_t>(UINT_MAX));
+    }
+
+    bool IsInt64() const {
+        return Tag() == 'l' || (Tag() == 'u' && word_[1] <= RAPIDJSON_UINT64_C2(0x7FFFFFFF, 0xFFFFFFFF));
+    }
+
+    bool IsUint64() const { return Tag() == 'u' || (Tag() == 'l' && Int64Word() >= 0); }
+
+    //@}
+
+    //!@name Bool
+    //@{
+
+    bool GetBool() const { RAPIDJSON_ASSERT(IsBool()); return Tag() == 't'; }
+
+    //@}
+
+    //!@name Number
+    //@{
+
+    int GetInt() const { RAPIDJSON_ASSERT(IsInt()); return static_cast<int>(Int64Word()); }
+    unsigned GetUint() const { RAPIDJSON_ASSERT(IsUint()); return static_cast<unsigned>(word_[1]); }
+    int64_t GetInt64() const { RAPIDJSON_ASSERT(IsInt64()); return Int64Word(); }
+    uint64_t GetUint64() const { RAPIDJSON_ASSERT(IsUint64()); return word_[1]; }
+
+    //! Get the value as double type.
+    /*! \note If the value is 64-bit integer type, it may lose precision.
+    */
+    double GetDouble() const {
+        RAPIDJSON_ASSERT(IsNumber());
+        if (Tag() == 'd') {
+            double d;
+            std::memcpy(&d, word_ + 1, sizeof(d));
+            return d;
+        }
+        if (Tag() == 'l') return static_cast<double>(Int64Word());
+        return static_cast<double>(word_[1]);
+    }
+
+    float GetFloat() const { return static_cast<float>(GetDouble()); }
+
+    //@}
+
+    //!@name String
+    //@{
+
+    const Ch* GetString() const { RAPIDJSON_ASSERT(IsString()); return strings_ + internal::TapePayload(*word_); }
+    SizeType GetStringLength() const { RAPIDJSON_ASSERT(IsString()); return static_cast<SizeType>(word_[1]); }
+
+    //@}
+
+    //!@name Object
+    //@{
+
+    SizeType MemberCount() const { RAPIDJSON_ASSERT(IsObject()); return static_cast<SizeType>(internal::TapePayload(*Close())); }
+    bool ObjectEmpty() const { RAPIDJSON_ASSERT(IsObject()); return word_ + 1 == Close(); }
+
+    MemberIterator MemberBegin() const { RAPIDJSON_ASSERT(IsObject()); return MemberIterator(word_ + 1, strings_); }
+    MemberIterator MemberEnd() const { RAPIDJSON_ASSERT(IsObject()); return MemberIterator(Close(), strings_); }
+
+    bool HasMember(const Ch* name) const { return FindMember(name) != MemberEnd(); }
+
+    //! Find member by name.
+    /*! \note Linear time complexity, like GenericValue::FindMember().
+    */
+    MemberIterator FindMember(const Ch* name) const {
+        RAPIDJSON_ASSERT(name);
+        return FindMember(name, internal::StrLen(name));
+    }
+
+    //! Find member by name and length.
+    MemberIterator FindMember(const Ch* name, SizeType length) const {
+        RAPIDJSON_ASSERT(IsObject());
+        MemberIterator member = MemberBegin();
+        const MemberIterator end = MemberEnd();
+        for ( ; member != end; ++member)
+            if (member->name.GetStringLength() == length &&
+                (member->name.GetString() == name || std::memcmp(member->name.GetString(), name, sizeof(Ch) * length) == 0))
+                break;
+        return member;
+    }
+
+    //! Get the value of a member, or a null value if it does not exist.
+    GenericTapeValue operator[](const Ch* name) const {
+        MemberIterator member = FindMember(name);
+        if (member != MemberEnd())
+            return member->value;
+        RAPIDJSON_ASSERT(false);    // see GenericValue::operator[]
+        return GenericTapeValue();
+    }
+
+#if RAPIDJSON_HAS_STDSTRING
+    bool HasMember(const std::basic_string<Ch>& name) const { return FindMember(name) != MemberEnd(); }
+    MemberIterator FindMember(const std::basic_string<Ch>& name) const { return FindMember(name.data(), static_cast<SizeType>(name.size())); }
+    GenericTapeValue operator[](const std::basic_string<Ch>& name) const { return (*this)[name.c_str()]; }
+#endif
+
+    //@}
+
+    //!@name Array
+    //@{
+
+    SizeType Size() const { RAPIDJSON_ASSERT(IsArray()); return static_cast<SizeType>(internal::TapePayload(*Close())); }
+    bool Empty() const { RAPIDJSON_ASSERT(IsArray()); return word_ + 1 == Close(); }
+
+    ValueIterator Begin() const { RAPIDJSON_ASSERT(IsArray()); return ValueIterator(word_ + 1, strings_); }
+    ValueIterator End() const { RAPIDJSON_ASSERT(IsArray()); return ValueIterator(Close(), strings_); }
+
+    //! Get an element of the array.
+    /*! \note Linear time complexity, the preceding elements are skipped one by one.
+    */
+    GenericTapeValue operator[](SizeType index) const {
+        RAPIDJSON_ASSERT(index < Size());
+        ValueIterator v = Begin();
+        while (index-- > 0)
+            ++v;
+        return *v;
+    }
+
+    //@}
+
+    //! Generate events of this value to a Handler.
+    /*! \tparam Handler type of handler.
+        \param handler An object implementing concept Handler.
+    */
+    template <typename Handler>
+    bool Accept(Handler& handler) const {
+        switch (Tag()) {
+        case 'n': return handler.Null();
+        case 'f': return handler.Bool(false);
+        case 't': return handler.Bool(true);
+
+        case '{':
+            if (RAPIDJSON_UNLIKELY(!handler.StartObject()))
+                return false;
+            for (MemberIterator m = MemberBegin(); m != MemberEnd(); ++m) {
+                if (RAPIDJSON_UNLIKELY(!handler.Key(m->name.GetString(), m->name.GetStringLength(), false)))
+                    return false;
+                if (RAPIDJSON_UNLIKELY(!m->value.Accept(handler)))
+                    return false;
+            }
+            return handler.EndObject(MemberCount());
+
+        case '[':
+            if (RAPIDJSON_UNLIKELY(!handler.StartArray()))
+                return false;
+            for (ValueIterator v = Begin(); v != End(); ++v)
+                if (RAPIDJSON_UNLIKELY(!v->Accept(handler)))
+                    return false;
+            return handler.EndArray(Size());
+
+        case '"':
+            return handler.String(GetString(), GetStringLength(), false);
+
+        default:
+            RAPIDJSON_ASSERT(IsNumber());
+            if (IsDouble())         return handler.Double(GetDouble());
+            else if (IsInt())       return handler.Int(GetInt());
+            else if (IsUint())      return handler.Uint(GetUint());
+            else if (IsInt64())     return handler.Int64(GetInt64());
+            else                    return handler.Uint64(GetUint64());
+        }
+    }
+
+private:
+    template <typename, typename, typename> friend class GenericTapeDocument;
+    friend class GenericTapeMemberIterator<Encoding>;
+    friend class GenericTapeValueIterator<Encoding>;
+
+    GenericTapeValue(const uint64_t* word, const Ch* strings) : word_(word), strings_(strings) {}
+
+    static const uint64_t& NullWord() {
+        static const uint64_t word = static_cast<uint64_t>('n') << internal::kTapeTagShift;
+        return word;
+    }
+
+    char Tag() const { return internal::TapeTag(*word_); }
+    int64_t Int64Word() const { return static_cast<int64_t>(word_[1]); }
+    const uint64_t* Close() const { return word_ + internal::TapePayload(*word_); }
+
+    const uint64_t* word_;  //!< First tape word of the value.
+    const Ch* strings_;     //!< Beginning of the string arena.
+};
+
+//! GenericTapeValue with UTF8 encoding
+typedef GenericTapeValue<UTF8<> > TapeValue;
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericTapeDocument
+
+//! An immutable document storing parsed JSON as a tape of 64-bit words.
+/*!
+    The whole document lives in two contiguous buffers: the tape, which holds
+    one or two words per value in document order, and an arena with the
+    null-terminated strings. Compared to GenericDocument there are no per-node
+    allocations and traversal is a linear scan, but values cannot be modified
+    and member lookup always scans the object.
+
+    \code
+    TapeDocument d;
+    d.Parse(json);
+    if (!d.HasParseError() && d.GetRoot().IsObject())
+        handle(d.GetRoot()["route"].GetString());
+    \endcode
+
+    \note implements Handler concept
+    \tparam Encoding Encoding for both parsing and string storage.
+    \tparam Allocator Allocator for the tape and string arena.
+    \tparam StackAllocator Allocator for allocating memory for stack during parsing.
+*/
+template <typename Encoding, typename Allocator = CrtAllocator, typename StackAllocator = CrtAllocator>
+class GenericTapeDocument {
+public:
+    typedef typename Encoding::Ch Ch;                       //!< Character type derived from Encoding.
+    typedef GenericTapeValue<Encoding> ValueType;           //!< Value type of the document.
+    typedef Allocator AllocatorType;                        //!< Allocator type from template parameter.
+    typedef StackAllocator StackAllocatorType;              //!< StackAllocator type from template parameter.
+
+    //! Constructor
+    /*! Creates an empty document which root is null.
+        \param allocator        Optional allocator for the tape and string arena.
+        \param stackCapacity    Optional initial capacity of stack in bytes.
+        \param stackAllocator   Optional allocator for allocating memory for stack.
+    */
+    GenericTapeDocument(Allocator* allocator = 0, size_t stackCapacity = kDefaultStackCapacity, StackAllocator* stackAllocator = 0) :
+        tape_(allocator, kDefaultTapeCapacity), strings_(allocator, kDefaultStringCapacity), stack_(stackAllocator, stackCapacity), parseResult_() {}
+
+    //! Get the root value.
+    /*! A null value is returned before parsing and after a parse error.
+    */
+    ValueType GetRoot() const {
+        if (tape_.Empty())
+            return ValueType();
+        return ValueType(tape_.template Bottom<uint64_t>(), strings_.template Bottom<Ch>());
+    }
+
+    //! Generate events of the root value to a Handler.
+    template <typename Handler>
+    bool Accept(Handler& handler) const { return GetRoot().Accept(handler); }
+
+    //!@name Parse from stream
+    //!@{
+
+    //! Parse JSON text from an input stream (with Encoding conversion)
+    /*! \tparam parseFlags Combination of \ref ParseFlag.
+        \tparam SourceEncoding Encoding of input stream
+        \tparam InputStream Type of input stream, implementing Stream concept
+        \param is Input stream to be parsed.
+        \return The document itself for fluent API.
+    */
+    template <unsigned parseFlags, typename SourceEncoding, typename InputStream>
+    GenericTapeDocument& ParseStream(InputStream& is) {
+        GenericReader<SourceEncoding, Encoding, StackAllocator> reader(
+            stack_.HasAllocator() ? &stack_.GetAllocator() : 0);
+        ClearStackOnExit scope(*this);
+        tape_.Clear();
+        strings_.Clear();
+        parseResult_ = reader.template Parse<parseFlags>(is, *this);
+        if (!parseResult_) {
+            tape_.Clear();
+            strings_.Clear();
+        }
+        return *this;
+    }
+
+    //! Parse JSON text from an input stream
+    template <unsigned parseFlags, typename InputStream>
+    GenericTapeDocument& ParseStream(InputStream& is) {
+        return ParseStream<parseFlags, Encoding, InputStream>(is);
+    }
+
+    //! Parse JSON text from an input stream (with \ref kParseDefaultFlags)
+    template <typename InputStream>
+    GenericTapeDocument& ParseStream(InputStream& is) {
+        return ParseStream<kParseDefaultFlags, Encoding, InputStream>(is);
+    }
+    //!@}
+
+    //!@name Parse from read-only string
+    //!@{
+
+    //! Parse JSON text from a read-only string (with Encoding conversion)
+    /*! \tparam parseFlags Combination of \ref ParseFlag (must not contain \ref kParseInsituFlag).
+        \tparam SourceEncoding Transcoding from input Encoding
+        \param str Read-only zero-terminated string to be parsed.
+    */
+    template <unsigned parseFlags, typename SourceEncoding>
+    GenericTapeDocument& Parse(const typename SourceEncoding::Ch* str) {
+        RAPIDJSON_ASSERT(!(parseFlags & kParseInsituFlag));
+        GenericStringStream<SourceEncoding> s(str);
+        return ParseStream<parseFlags, SourceEncoding>(s);
+    }
+
+    //! Parse JSON text from a read-only string
+    template <unsigned parseFlags>
+    GenericTapeDocument& Parse(const Ch* str) {
+        return Parse<parseFlags, Encoding>(str);
+    }
+
+    //! Parse JSON text from a read-only string (with \ref kParseDefaultFlags)
+    GenericTapeDocument& Parse(const Ch* str) {
+        return Parse<kParseDefaultFlags>(str);
+    }
+
+    template <unsigned parseFlags, typename SourceEncoding>
+    GenericTapeDocument& Parse(const typename SourceEncoding::Ch* str, size_t length) {
+        RAPIDJSON_ASSERT(!(parseFlags & kParseInsituFlag));
+        MemoryStream ms(reinterpret_cast<const char*>(str), length * sizeof(typename SourceEncoding::Ch));
+        EncodedInputStream<SourceEncoding, MemoryStream> is(ms);
+        ParseStream<parseFlags, SourceEncoding>(is);
+        return *this;
+    }
+
+    template <unsigned parseFlags>
+    GenericTapeDocument& Parse(const Ch* str, size_t length) {
+        return Parse<parseFlags, Encoding>(str, length);
+    }
+
+    GenericTapeDocument& Parse(const Ch* str, size_t length) {
+        return Parse<kParseDefaultFlags>(str, length);
+    }
+
+#if RAPIDJSON_HAS_STDSTRING
+    template <unsigned parseFlags, typename SourceEncoding>
+    GenericTapeDocument& Parse(const std::basic_string<typename SourceEncoding::Ch>& str) {
+        // c_str() is constant complexity according to standard. Should be faster than Parse(const char*, size_t)
+        return Parse<parseFlags, SourceEncoding>(str.c_str());
+    }
+
+    template <unsigned parseFlags>
+    GenericTapeDocument& Parse(const std::basic_string<Ch>& str) {
+        return Parse<parseFlags, Encoding>(str.c_str());
+    }
+
+    GenericTapeDocument& Parse(const std::basic_string<Ch>& str) {
+        return Parse<kParseDefaultFlags>(str);
+    }
+#endif // RAPIDJSON_HAS_STDSTRING
+
+    //!@}
+
+    //!@name Handling parse errors
+    //!@{
+
+    //! Whether a parse error has occurred in the last parsing.
+    bool HasParseError() const { return parseResult_.IsError(); }
+
+    //! Get the \ref ParseErrorCode of last parsing.
+    ParseErrorCode GetParseError() const { return parseResult_.Code(); }
+
+    //! Get the position of last parsing error in input, 0 otherwise.
+    size_t GetErrorOffset() const { return parseResult_.Offset(); }
+
+    //! Implicit conversion to get the last parse result
+    operator ParseResult() const { return parseResult_; }
+    //!@}
+
+    //! Get the size of the tape in bytes.
+    size_t GetTapeSize() const { return tape_.GetSize(); }
+
+    //! Get the size of the string arena in bytes.
+    size_t GetStringsSize() const { return strings_.GetSize(); }
+
+    //! Get the capacity of stack in bytes.
+    size_t GetStackCapacity() const { return stack_.GetCapacity(); }
+
+private:
+    // clear stack on any exit from ParseStream, e.g. due to exception
+    struct ClearStackOnExit {
+        explicit ClearStackOnExit(GenericTapeDocument& d) : d_(d) {}
+        ~ClearStackOnExit() { d_.ClearStack(); }
+    private:
+        ClearStackOnExit(const ClearStackOnExit&);
+        ClearStackOnExit& operator=(const ClearStackOnExit&);
+        GenericTapeDocument& d_;
+    };
+
+public:
+    // Implementation of Handler
+    bool Null() { PushWord('n'); return true; }
+    bool Bool(bool b) { PushWord(b ? 't' : 'f'); return true; }
+    bool Int(int i) { PushNumber('l', static_cast<uint64_t>(static_cast<int64_t>(i))); return true; }
+    bool Uint(unsigned i) { PushNumber('u', i); return true; }
+    bool Int64(int64_t i) { PushNumber('l', static_cast<uint64_t>(i)); return true; }
+    bool Uint64(uint64_t i) { PushNumber('u', i); return true; }
+
+    bool Double(double d) {
+        uint64_t u;
+        std::memcpy(&u, &d, sizeof(u));
+        PushNumber('d', u);
+        return true;
+    }
+
+    bool RawNumber(const Ch* str, SizeType length, bool copy) { return String(str, length, copy); }
+
+    bool String(const Ch* str, SizeType length, bool) {
+        const size_t offset = strings_.GetSize() / sizeof(Ch);
+        Ch* s = strings_.template Push<Ch>(length + 1);
+        std::memcpy(s, str, length * sizeof(Ch));
+        s[length] = '\0';
+        PushNumber('"', length, offset);
+        return true;
+    }
+
+    bool StartObject() { return StartContainer('{'); }
+
+    bool Key(const Ch* str, SizeType length, bool copy) { return String(str, length, copy); }
+
+    bool EndObject(SizeType memberCount) { return EndContainer('{', '}', memberCount); }
+
+    bool StartArray() { return StartContainer('['); }
+
+    bool EndArray(SizeType elementCount) { return EndContainer('[', ']', elementCount); }
+
+private:
+    //! Prohibit copying
+    GenericTapeDocument(const GenericTapeDocument&);
+    //! Prohibit assignment
+    GenericTapeDocument& operator=(const GenericTapeDocument&);
+
+    void PushWord(char tag, uint64_t payload = 0) {
+        *tape_.template Push<uint64_t>() = internal::TapeWord(tag, payload);
+    }
+
+    void PushNumber(char tag, uint64_t value, uint64_t payload = 0) {
+        uint64_t* w = tape_.template Push<uint64_t>(2);
+        w[0] = internal::TapeWord(tag, payload);
+        w[1] = value;
+    }
+
+    bool StartContainer(char tag) {
+        *stack_.template Push<size_t>() = tape_.GetSize() / sizeof(uint64_t);
+        PushWord(tag);  // distance to the closing word is patched by EndContainer()
+        return true;
+    }
+
+    bool EndContainer(char openTag, char closeTag, SizeType count) {
+        const size_t open = *stack_.template Pop<size_t>(1);
+        const size_t close = tape_.GetSize() / sizeof(uint64_t);
+        tape_.template Bottom<uint64_t>()[open] = internal::TapeWord(openTag, close - open);
+        PushWord(closeTag, count);
+        return true;
+    }
+
+    void ClearStack() {
+        stack_.Clear();
+        stack_.ShrinkToFit();
+    }
+
+    static const size_t kDefaultStackCapacity = 1024;
+    static const size_t kDefaultTapeCapacity = 1024;
+    static const size_t kDefaultStringCapacity = 1024;
+    internal::Stack<Allocator> tape_;
+    internal::Stack<Allocator> strings_;
+    internal::Stack<StackAllocator> stack_;
+    ParseResult parseResult_;
+};
+
+//! GenericTapeDocument with UTF8 encoding
+typedef GenericTapeDocument<UTF8<> > TapeDocument;
+
+RAPIDJSON_NAMESPACE_END
+
+RAPIDJSON_DIAG_POP
+
+#endif // RAPIDJSON_TAPEDOCUMENT_H_
@@ -21,6 +21,7 @@
 #include "internal/stack.h"
 #include "internal/strfunc.h"
 #include "internal/dtoa.h"
+#include "internal/ryu.h"
 #include "internal/itoa.h"
 #include "stringbuffer.h"
 #include <new>      // placement new
@@ -29,6 +30,9 @@
 #include <intrin.h>
 #pragma intrinsic(_BitScanForward)
 #endif
+#ifdef RAPIDJSON_AVX2
+#include <immintrin.h>
+#endif
 #ifdef RAPIDJSON_SSE42
 #include <nmmintrin.h>
 #elif defined(RAPIDJSON_SSE2)
@@ -36,6 +40,10 @@
 #elif defined(RAPIDJSON_NEON)
 #include <arm_neon.h>
 #endif
+#ifdef RAPIDJSON_SIMD_DISPATCH
+#include "internal/simddispatch.h"
+#endif
+#include <cstring>  // memcpy
 
 #ifdef __clang__
 RAPIDJSON_DIAG_PUSH
@@ -62,6 +70,20 @@ RAPIDJSON_NAMESPACE_BEGIN
 #define RAPIDJSON_WRITE_DEFAULT_FLAGS kWriteNoFlags
 #endif
 
+/*! \def RAPIDJSON_DTOA_RYU
+    \ingroup RAPIDJSON_CONFIG
+    \brief Write doubles with the Ryu algorithm instead of Grisu2.
+
+    Define this as 1 to make Writer use internal::RyuDtoa(), which always
+    finds the shortest digits reading back to the same double, and the
+    closest to it among those. Grisu2 misses them for about 0.1% of random
+    doubles, although its output also reads back exactly. The formatting of
+    the digits is the same.
+*/
+#ifndef RAPIDJSON_DTOA_RYU
+#define RAPIDJSON_DTOA_RYU 0
+#endif
+
 //! Combination of writeFlags
 enum WriteFlag {
     kWriteNoFlags = 0,              //!< No flags are set.
@@ -71,6 +93,51 @@ enum WriteFlag {
     kWriteDefaultFlags = RAPIDJSON_WRITE_DEFAULT_FLAGS  //!< Default write flags. Can be customized by defining RAPIDJSON_WRITE_DEFAULT_FLAGS
 };
 
+namespace internal {
+
+//! Returns the first character to escape ('\"', '\\' or control character) in [p, end), or end.
+/*! Unaligned loads never go past \c end, so the string needs no terminator.
+*/
+inline const char* ScanUnescaped(const char* p, const char* end) {
+#if defined(RAPIDJSON_AVX2)
+    const __m256i dq = _mm256_set1_epi8('\"');
+    const __m256i bs = _mm256_set1_epi8('\\');
+    const __m256i sp = _mm256_set1_epi8(0x1F);
+    for (; end - p >= 32; p += 32) {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const __m256i t1 = _mm256_cmpeq_epi8(s, dq);
+        const __m256i t2 = _mm256_cmpeq_epi8(s, bs);
+        const __m256i t3 = _mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+        const uint32_t r = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(t1, t2), t3)));
+        if (RAPIDJSON_UNLIKELY(r != 0))
+            return p + ctzll(r);
+    }
+#endif
+#if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
+    // With AVX2, at most one 16-byte step for the tail
+    const __m128i dq16 = _mm_set1_epi8('\"');
+    const __m128i bs16 = _mm_set1_epi8('\\');
+    const __m128i sp16 = _mm_set1_epi8(0x1F);
+    for (; end - p >= 16; p += 16) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i t1 = _mm_cmpeq_epi8(s, dq16);
+        const __m128i t2 = _mm_cmpeq_epi8(s, bs16);
+        const __m128i t3 = _mm_cmpeq_epi8(_mm_max_epu8(s, sp16), sp16);
+        const uint32_t r = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(t1, t2), t3)));
+        if (RAPIDJSON_UNLIKELY(r != 0))
+            return p + ctzll(r);
+    }
+#elif defined(RAPIDJSON_SIMD_DISPATCH)
+    if (end - p >= 16)
+        return GetSimdKernels().scanUnescapedN(p, end);
+#endif
+    while (p != end && *p != '\"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20)
+        ++p;
+    return p;
+}
+
+} // namespace internal
+
 //! JSON writer
 /*! Writer implements the concept Handler.
     It generates JSON text by events to an output os.
@@ -194,11 +261,18 @@ public:
     */
     bool Double(double d)       { Prefix(kNumberType); return EndValue(WriteDouble(d)); }
 
+    //! Writes the text of a number as is
+    /*!
+        \param str Text of the number, as parsed with kParseNumbersAsStringsFlag or kParseLazyNumbersFlag.
+        \param length Length of the text.
+        \param copy Ignored.
+        \return Whether it is succeed.
+    */
     bool RawNumber(const Ch* str, SizeType length, bool copy = false) {
         RAPIDJSON_ASSERT(str != 0);
         (void)copy;
         Prefix(kNumberType);
-        return EndValue(WriteString(str, length));
+        return EndValue(WriteRawValue(str, length));
     }
 
     bool String(const Ch* str, SizeType length, bool copy = false) {
@@ -373,7 +447,11 @@ protected:
         }
 
         char buffer[25];
+#if RAPIDJSON_DTOA_RYU
+        char* end = internal::RyuDtoa(d, buffer, maxDecimalPlaces_);
+#else
         char* end = internal::dtoa(d, buffer, maxDecimalPlaces_);
+#endif
         PutReserve(*os_, static_cast<size_t>(end - buffer));
         for (char* p = buffer; p != end; ++p)
             PutUnsafe(*os_, static_cast<typename OutputStream::Ch>(*p));
@@ -455,15 +533,63 @@ protected:
     }
 
     bool ScanWriteUnescapedString(GenericStringStream<SourceEncoding>& is, size_t length) {
+        ScatterWriteUnescapedString(is, length, internal::BoolType<kScatter>());
+        BufferedWriteUnescapedString(is, length, internal::BoolType<kBuffered>());
         return RAPIDJSON_LIKELY(is.Tell() < length);
     }
 
+    //! Whether the characters which need no escaping are written unchanged.
+    static const bool kVerbatim = internal::IsSame<Ch, char>::Value && internal::IsSame<SourceEncoding, TargetEncoding>::Value &&
+        TargetEncoding::supportUnicode && !(writeFlags & kWriteValidateEncodingFlag);
+    //! Whether characters can be passed by reference to the output stream, see ScatterStream.
+    static const bool kScatter = kVerbatim && ScatterStreamTraits<OutputStream>::scatter != 0;
+    //! Whether characters can be copied into the buffer of the output stream, see BufferedOutputStream.
+    static const bool kBuffered = kVerbatim && !kScatter && BufferedOutputStreamTraits<OutputStream>::buffered != 0;
+
+    void ScatterWriteUnescapedString(GenericStringStream<SourceEncoding>&, size_t, internal::FalseType) {}
+
+    void ScatterWriteUnescapedString(GenericStringStream<SourceEncoding>& is, size_t length, internal::TrueType) {
+        const Ch* p = is.src_;
+        const Ch* q = internal::ScanUnescaped(p, is.head_ + length);
+        if (q != p) {
+            os_->PutRef(p, static_cast<size_t>(q - p));
+            is.src_ = q;
+        }
+    }
+
+    void BufferedWriteUnescapedString(GenericStringStream<SourceEncoding>&, size_t, internal::FalseType) {}
+
+    void BufferedWriteUnescapedString(GenericStringStream<SourceEncoding>& is, size_t length, internal::TrueType) {
+        const Ch* p = is.src_;
+        const Ch* q = internal::ScanUnescaped(p, is.head_ + length);
+        is.src_ = q;
+        while (p != q) {
+            size_t size;
+            Ch* window = os_->PutWindow(size);
+            if (size > static_cast<size_t>(q - p))
+                size = static_cast<size_t>(q - p);
+            std::memcpy(window, p, size);
+            os_->PutCommit(size);
+            p += size;
+        }
+    }
+
     bool WriteStartObject() { os_->Put('{'); return true; }
     bool WriteEndObject()   { os_->Put('}'); return true; }
     bool WriteStartArray()  { os_->Put('['); return true; }
     bool WriteEndArray()    { os_->Put(']'); return true; }
 
     bool WriteRawValue(const Ch* json, size_t length) {
+        return WriteRawValue(json, length, internal::BoolType<kScatter>());
+    }
+
+    bool WriteRawValue(const Ch* json, size_t length, internal::TrueType) {
+        if (length != 0)
+            os_->PutRef(json, length);
+        return true;
+    }
+
+    bool WriteRawValue(const Ch* json, size_t length, internal::FalseType) {
         PutReserve(*os_, length);
         GenericStringStream<SourceEncoding> is(json);
         while (RAPIDJSON_LIKELY(is.Tell() < length)) {
@@ -576,12 +702,17 @@ inline bool Writer<StringBuffer>::WriteDouble(double d) {
     }
     
     char *buffer = os_->Push(25);
+#if RAPIDJSON_DTOA_RYU
+    char* end = internal::RyuDtoa(d, buffer, maxDecimalPlaces_);
+#else
     char* end = internal::dtoa(d, buffer, maxDecimalPlaces_);
+#endif
     os_->Pop(static_cast<size_t>(25 - (end - buffer)));
     return true;
 }
 
-#if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
+// With AVX2, StringBuffer takes the generic BufferedOutputStream path of 32-byte steps.
+#if (defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)) && !defined(RAPIDJSON_AVX2)
 template<>
 inline bool Writer<StringBuffer>::ScanWriteUnescapedString(StringStream& is, size_t length) {
     if (length < 16)
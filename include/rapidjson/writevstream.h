@@ -0,0 +1,202 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_WRITEVSTREAM_H_
+#define RAPIDJSON_WRITEVSTREAM_H_
+
+/*! \file writevstream.h
+    \brief Output stream gathering buffered and referenced characters with writev(), for POSIX systems.
+*/
+
+#include "stream.h"
+
+/*! \def RAPIDJSON_HAS_WRITEV
+    \ingroup RAPIDJSON_CONFIG
+    \brief Whether WritevStream is available (POSIX systems).
+*/
+#ifndef RAPIDJSON_HAS_WRITEV
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#define RAPIDJSON_HAS_WRITEV 1
+#else
+#define RAPIDJSON_HAS_WRITEV 0
+#endif
+#endif
+
+#if RAPIDJSON_HAS_WRITEV
+
+#include <cerrno>
+#include <cstring>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+//! File descriptor output stream writing referenced characters without copying them.
+/*! Characters put one by one are buffered, as in FileWriteStream. Runs of at
+    least \c minRefLength characters passed to PutRef(), such as the unescaped
+    parts of long strings written by Writer, are not copied: Flush() writes
+    them from where they are, between the buffered parts, with a single
+    writev() call.
+
+    Strings and raw values given to Writer must therefore stay valid until
+    the writer reaches the end of the JSON text, or until Flush() is called.
+
+    \note implements Stream and ScatterStream concepts
+*/
+class WritevStream {
+public:
+    typedef char Ch;    //!< Character type. Only support char.
+
+    //! Default minimum length of the runs referenced instead of copied.
+    static const size_t kDefaultMinRefLength = 256;
+
+    //! Constructor.
+    /*!
+        \param fd File descriptor opened for write.
+        \param buffer user-supplied buffer of the copied characters.
+        \param bufferSize size of buffer in bytes.
+        \param minRefLength Shorter runs passed to PutRef() are copied into the buffer.
+    */
+    WritevStream(int fd, char* buffer, size_t bufferSize, size_t minRefLength = kDefaultMinRefLength) :
+        fd_(fd), buffer_(buffer), bufferEnd_(buffer + bufferSize), current_(buffer), segmentBegin_(buffer),
+        minRefLength_(minRefLength), segments_(), segmentCount_(0), error_(false)
+    {
+        RAPIDJSON_ASSERT(fd_ >= 0);
+        RAPIDJSON_ASSERT(bufferSize > 0);
+    }
+
+    ~WritevStream() { Flush(); }
+
+    void Put(char c) {
+        if (current_ >= bufferEnd_)
+            Flush();
+
+        *current_++ = c;
+    }
+
+    // ScatterStream concept
+    void PutRef(const char* s, size_t n) {
+        if (n < minRefLength_) {
+            size_t avail = static_cast<size_t>(bufferEnd_ - current_);
+            while (n > avail) {
+                std::memcpy(current_, s, avail);
+                current_ += avail;
+                s += avail;
+                n -= avail;
+                Flush();
+                avail = static_cast<size_t>(bufferEnd_ - current_);
+            }
+            std::memcpy(current_, s, n);
+            current_ += n;
+            return;
+        }
+
+        // Keep a segment free for the characters buffered until Flush()
+        if (segmentCount_ + 2 >= kMaxSegments)
+            Flush();
+        EndSegment();
+        AddSegment(s, n);
+    }
+
+    //! Write the buffered and referenced characters.
+    void Flush() {
+        EndSegment();
+        struct iovec* segment = segments_;
+        int count = static_cast<int>(segmentCount_);
+        while (count > 0) {
+            const ssize_t result = ::writev(fd_, segment, count);
+            if (result < 0) {
+                if (errno == EINTR)
+                    continue;
+                error_ = true;
+                break;
+            }
+            // Skip what was written, which may end in the middle of a segment
+            size_t written = static_cast<size_t>(result);
+            while (count > 0 && written >= segment->iov_len) {
+                written -= segment->iov_len;
+                ++segment;
+                --count;
+            }
+            if (count > 0) {
+                segment->iov_base = static_cast<char*>(segment->iov_base) + written;
+                segment->iov_len -= written;
+            }
+        }
+        current_ = segmentBegin_ = buffer_;
+        segmentCount_ = 0;
+    }
+
+    //! Whether a writev() call has failed.
+    bool HasError() const { return error_; }
+
+    // Not implemented
+    char Peek() const { RAPIDJSON_ASSERT(false); return 0; }
+    char Take() { RAPIDJSON_ASSERT(false); return 0; }
+    size_t Tell() const { RAPIDJSON_ASSERT(false); return 0; }
+    char* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+    size_t PutEnd(char*) { RAPIDJSON_ASSERT(false); return 0; }
+
+private:
+    // Prohibit copy constructor & assignment operator.
+    WritevStream(const WritevStream&);
+    WritevStream& operator=(const WritevStream&);
+
+    static const size_t kMaxSegments = 64;  //!< Segments per writev() call, far below IOV_MAX.
+
+    //! Record the characters buffered since the last segment as a segment.
+    void EndSegment() {
+        if (current_ != segmentBegin_) {
+            AddSegment(segmentBegin_, static_cast<size_t>(current_ - segmentBegin_));
+            segmentBegin_ = current_;
+        }
+    }
+
+    void AddSegment(const char* s, size_t n) {
+        RAPIDJSON_ASSERT(segmentCount_ < kMaxSegments);
+        segments_[segmentCount_].iov_base = const_cast<char*>(s);
+        segments_[segmentCount_].iov_len = n;
+        segmentCount_++;
+    }
+
+    int fd_;
+    char *buffer_;
+    char *bufferEnd_;
+    char *current_;
+    char *segmentBegin_;    //!< First buffered character not in a segment yet.
+    size_t minRefLength_;
+    struct iovec segments_[kMaxSegments];
+    size_t segmentCount_;
+    bool error_;
+};
+
+template<>
+struct ScatterStreamTraits<WritevStream> {
+    enum { scatter = 1 };
+};
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_HAS_WRITEV
+
+#endif // RAPIDJSON_WRITEVSTREAM_H_
@@ -22,10 +22,16 @@
 #define TEST_VERSION_CODE(x,y,z) \
   (((x)*100000) + ((y)*100) + (z))
 
-// __SSE2__ and __SSE4_2__ are recognized by gcc, clang, and the Intel compiler.
-// We use -march=native with gmake to enable -msse2 and -msse4.2, if supported.
+// __SSE2__, __SSE4_2__, __AVX2__ and __AVX512BW__ are recognized by gcc, clang, and the Intel compiler.
+// We use -march=native with gmake to enable -msse2, -msse4.2, -mavx2 and -mavx512bw, if supported.
 // Likewise, __ARM_NEON is used to detect Neon.
-#if defined(__SSE4_2__)
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+// Kernels are selected at runtime
+#elif defined(__AVX512BW__)
+#  define RAPIDJSON_AVX512
+#elif defined(__AVX2__)
+#  define RAPIDJSON_AVX2
+#elif defined(__SSE4_2__)
 #  define RAPIDJSON_SSE42
 #elif defined(__SSE2__)
 #  define RAPIDJSON_SSE2
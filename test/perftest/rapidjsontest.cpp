@@ -18,22 +18,38 @@
 
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/document.h"
+#include "rapidjson/tapedocument.h"
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/filereadstream.h"
+#include "rapidjson/filewritestream.h"
+#include "rapidjson/asyncfilereadstream.h"
 #include "rapidjson/istreamwrapper.h"
 #include "rapidjson/encodedstream.h"
 #include "rapidjson/memorystream.h"
+#include "rapidjson/mmapstream.h"
+#include "rapidjson/ndjson.h"
+#include "rapidjson/parallelarray.h"
+#include "rapidjson/writer.h"
+#include "rapidjson/writevstream.h"
 
+#include <algorithm>
 #include <fstream>
+#include <string>
 #include <vector>
 
-#ifdef RAPIDJSON_SSE2
+#ifdef RAPIDJSON_AVX512
+#define SIMD_SUFFIX(name) name##_AVX512
+#elif defined(RAPIDJSON_AVX2)
+#define SIMD_SUFFIX(name) name##_AVX2
+#elif defined(RAPIDJSON_SSE2)
 #define SIMD_SUFFIX(name) name##_SSE2
 #elif defined(RAPIDJSON_SSE42)
 #define SIMD_SUFFIX(name) name##_SSE42
 #elif defined(RAPIDJSON_NEON)
 #define SIMD_SUFFIX(name) name##_NEON
+#elif defined(RAPIDJSON_SIMD_DISPATCH)
+#define SIMD_SUFFIX(name) name##_DISPATCH
 #else
 #define SIMD_SUFFIX(name) name
 #endif
@@ -139,6 +155,56 @@ TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_FullPrecision)) {
     }
 }
 
+// Random doubles, mostly of 16 or 17 significant digits, which the fast path of strtod rarely handles
+static std::string MakeDoubleArray(size_t count) {
+    StringBuffer sb;
+    Writer<StringBuffer> writer(sb);
+    writer.StartArray();
+    uint64_t x = RAPIDJSON_UINT64_C2(0x0139408D, 0xCBBF7A44);
+    for (size_t i = 0; i < count; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17; // xorshift64
+        writer.Double(internal::Double(x & RAPIDJSON_UINT64_C2(0x7FEFFFFF, 0xFFFFFFFF)).Value());
+    }
+    writer.EndArray();
+    return std::string(sb.GetString(), sb.GetSize());
+}
+
+#define TEST_DOUBLES(Name, parseFlags)\
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_Doubles##Name)) {\
+    const std::string json = MakeDoubleArray(10000);\
+    for (size_t i = 0; i < kTrialCount; i++) {\
+        StringStream s(json.c_str());\
+        BaseReaderHandler<> h;\
+        Reader reader;\
+        EXPECT_TRUE(reader.Parse<parseFlags>(s, h));\
+    }\
+}
+
+TEST_DOUBLES(, kParseDefaultFlags)
+TEST_DOUBLES(_FullPrecision, kParseFullPrecisionFlag)
+
+#undef TEST_DOUBLES
+
+// Random 64-bit IDs, of 19 or 20 digits
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_Ids)) {
+    StringBuffer sb;
+    Writer<StringBuffer> writer(sb);
+    writer.StartArray();
+    uint64_t x = RAPIDJSON_UINT64_C2(0x0139408D, 0xCBBF7A44);
+    for (size_t i = 0; i < 10000; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17; // xorshift64
+        writer.Uint64(x | RAPIDJSON_UINT64_C2(0x80000000, 0x00000000));
+    }
+    writer.EndArray();
+
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringStream s(sb.GetString());
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse(s, h));
+    }
+}
+
 TEST_F(RapidJson, SIMD_SUFFIX(ReaderParseIterative_DummyHandler)) {
     for (size_t i = 0; i < kTrialCount; i++) {
         StringStream s(json_);
@@ -222,6 +288,39 @@ TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_MemoryPoolAllocator)) {
     }
 }
 
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_LazyContainers)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        Document doc;
+        doc.Parse<kParseLazyContainersFlag>(json_);
+        ASSERT_TRUE(doc.IsObject());
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParseInsitu_LazyContainers)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        memcpy(temp_, json_, length_ + 1);
+        Document doc;
+        doc.ParseInsitu<kParseLazyContainersFlag>(temp_);
+        ASSERT_TRUE(doc.IsObject());
+    }
+}
+
+#define TEST_DOCUMENT_DOUBLES(Name, parseFlags)\
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_Doubles##Name)) {\
+    const std::string json = MakeDoubleArray(10000);\
+    for (size_t i = 0; i < kTrialCount; i++) {\
+        Document doc;\
+        doc.Parse<parseFlags>(json.c_str());\
+        ASSERT_TRUE(doc.IsArray());\
+    }\
+}
+
+TEST_DOCUMENT_DOUBLES(, kParseDefaultFlags)
+TEST_DOCUMENT_DOUBLES(_FullPrecision, kParseFullPrecisionFlag)
+TEST_DOCUMENT_DOUBLES(_LazyNumbers, kParseLazyNumbersFlag)
+
+#undef TEST_DOCUMENT_DOUBLES
+
 TEST_F(RapidJson, SIMD_SUFFIX(DocumentParseLength_MemoryPoolAllocator)) {
     for (size_t i = 0; i < kTrialCount; i++) {
         Document doc;
@@ -258,6 +357,96 @@ TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_CrtAllocator)) {
     }
 }
 
+TEST_F(RapidJson, SIMD_SUFFIX(TapeDocumentParse)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        TapeDocument doc;
+        doc.Parse(json_);
+        ASSERT_TRUE(doc.GetRoot().IsObject());
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(TapeDocumentParse_Reuse)) {
+    TapeDocument doc;
+    for (size_t i = 0; i < kTrialCount; i++) {
+        doc.Parse(json_);
+        ASSERT_TRUE(doc.GetRoot().IsObject());
+    }
+}
+
+#if RAPIDJSON_HAS_CXX11
+// NDJSON of the type files, one compact document per line.
+static std::string MakeNdjson(const Document* docs, size_t count, size_t repeat) {
+    StringBuffer sb;
+    for (size_t r = 0; r < repeat; r++)
+        for (size_t i = 0; i < count; i++) {
+            Writer<StringBuffer> writer(sb);
+            docs[i].Accept(writer);
+            sb.Put('\n');
+        }
+    return std::string(sb.GetString(), sb.GetSize());
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_Ndjson_Serial)) {
+    const std::string json = MakeNdjson(typesDoc_, 8, 100);
+    for (size_t i = 0; i < 10; i++) {
+        size_t n = 0;
+        for (const char* p = json.data(), *end = p + json.size(); p < end; ) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            Document doc;
+            doc.Parse(p, static_cast<size_t>(eol - p));
+            n += doc.IsArray() || doc.IsObject();
+            p = eol + 1;
+        }
+        EXPECT_EQ(800u, n);
+    }
+}
+
+#define TEST_NDJSON(Name, threads, ordered) \
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_Ndjson_##Name)) {\
+    const std::string json = MakeNdjson(typesDoc_, 8, 100);\
+    NdjsonReader reader(threads);\
+    for (size_t i = 0; i < 10; i++) {\
+        std::atomic<size_t> n(0);\
+        EXPECT_TRUE(reader.Parse(json.data(), json.size(), [&](size_t, Document& doc) {\
+            n += doc.IsArray() || doc.IsObject();\
+            return true;\
+        }, ordered));\
+        EXPECT_EQ(800u, n.load());\
+    }\
+}
+TEST_NDJSON(Reader1Thread, 1, true)
+TEST_NDJSON(ReaderOrdered, 0, true)
+TEST_NDJSON(ReaderUnordered, 0, false)
+#undef TEST_NDJSON
+
+// One array of the type files, repeated.
+static std::string MakeHugeArray(const Document* docs, size_t count, size_t repeat) {
+    std::string json = MakeNdjson(docs, count, repeat);
+    std::replace(json.begin(), json.end(), '\n', ',');
+    json[json.size() - 1] = ']';
+    return "[" + json;
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_HugeArray_Serial)) {
+    const std::string json = MakeHugeArray(typesDoc_, 8, 100);
+    for (size_t i = 0; i < 10; i++) {
+        Document doc;
+        doc.Parse(json.c_str(), json.size());
+        EXPECT_EQ(800u, doc.Size());
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_HugeArray_Parallel)) {
+    const std::string json = MakeHugeArray(typesDoc_, 8, 100);
+    ParallelArrayParser parser;
+    for (size_t i = 0; i < 10; i++) {
+        Document doc;
+        parser.Parse(doc, json.c_str(), json.size());
+        EXPECT_EQ(800u, doc.Size());
+    }
+}
+#endif // RAPIDJSON_HAS_CXX11
+
 TEST_F(RapidJson, SIMD_SUFFIX(DocumentParseEncodedInputStream_MemoryStream)) {
     for (size_t i = 0; i < kTrialCount; i++) {
         MemoryStream ms(json_, length_);
@@ -310,6 +499,15 @@ TEST_F(RapidJson, DocumentTraverse) {
     }
 }
 
+TEST_F(RapidJson, TapeDocumentTraverse) {
+    TapeDocument doc;
+    doc.Parse(json_);
+    for (size_t i = 0; i < kTrialCount; i++) {
+        size_t count = Traverse(doc.GetRoot());
+        EXPECT_EQ(4339u, count);
+    }
+}
+
 #ifdef __GNUC__
 RAPIDJSON_DIAG_PUSH
 RAPIDJSON_DIAG_OFF(effc++)
@@ -353,6 +551,23 @@ TEST_F(RapidJson, DocumentFind) {
     }
 }
 
+TEST_F(RapidJson, DocumentFindHashed) {
+    typedef Document::ValueType ValueType;
+    typedef ValueType::ConstMemberIterator ConstMemberIterator;
+    const Document &doc = typesDoc_[7]; // alotofkeys.json
+    if (doc.IsObject()) {
+        std::vector<ValueType::HashedStringRefType> keys;
+        for (ConstMemberIterator it = doc.MemberBegin(); it != doc.MemberEnd(); ++it) {
+            keys.push_back(HashedStringRef(it->name.GetString(), it->name.GetStringLength()));
+        }
+        for (size_t i = 0; i < kTrialCount; i++) {
+            for (size_t j = 0; j < keys.size(); j++) {
+                EXPECT_TRUE(doc.FindMember(keys[j]) != doc.MemberEnd());
+            }
+        }
+    }
+}
+
 struct NullStream {
     typedef char Ch;
 
@@ -405,6 +620,48 @@ TEST_TYPED(6, Paragraphs)
 
 #undef TEST_TYPED
 
+// Double to string conversion of bin/types/floats.json, Grisu2 vs Ryu
+#define TEST_DTOA(Name, Function)\
+TEST_F(RapidJson, SIMD_SUFFIX(Dtoa_##Name##_Floats)) {\
+    const Value& floats = typesDoc_[1];\
+    char buffer[25];\
+    size_t length = 0;\
+    for (size_t i = 0; i < kTrialCount * 10; i++)\
+        for (Value::ConstValueIterator itr = floats.Begin(); itr != floats.End(); ++itr)\
+            length += static_cast<size_t>(Function(itr->GetDouble(), buffer) - buffer);\
+    EXPECT_GT(length, 0u);\
+}
+
+TEST_DTOA(Grisu2, internal::dtoa)
+TEST_DTOA(Ryu, internal::RyuDtoa)
+
+#undef TEST_DTOA
+
+#if RAPIDJSON_HAS_WRITEV
+// Long strings written to a file, copied into the buffer or referenced
+TEST_F(RapidJson, SIMD_SUFFIX(Writer_FileWriteStream_Paragraphs)) {
+    FILE *fp = fopen("/dev/null", "wb");
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        char buffer[65536];
+        FileWriteStream s(fp, buffer, sizeof(buffer));
+        Writer<FileWriteStream> writer(s);
+        typesDoc_[6].Accept(writer);
+    }
+    fclose(fp);
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(Writer_WritevStream_Paragraphs)) {
+    FILE *fp = fopen("/dev/null", "wb");
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        char buffer[65536];
+        WritevStream s(fileno(fp), buffer, sizeof(buffer));
+        Writer<WritevStream> writer(s);
+        typesDoc_[6].Accept(writer);
+    }
+    fclose(fp);
+}
+#endif // RAPIDJSON_HAS_WRITEV
+
 TEST_F(RapidJson, SIMD_SUFFIX(PrettyWriter_StringBuffer)) {
     for (size_t i = 0; i < kTrialCount; i++) {
         StringBuffer s(0, 2048 * 1024);
@@ -484,6 +741,63 @@ TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_FileReadStream)) {
     }
 }
 
+#if RAPIDJSON_HAS_CXX11
+TEST_F(RapidJson, AsyncFileReadStream) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        FILE *fp = fopen(filename_, "rb");
+        char buffer[65536 * 2];
+        {
+            AsyncFileReadStream s(fp, buffer, sizeof(buffer));
+            while (s.Take() != '\0')
+                ;
+        }
+        fclose(fp);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_AsyncFileReadStream)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        FILE *fp = fopen(filename_, "rb");
+        char buffer[65536 * 2];
+        {
+            AsyncFileReadStream s(fp, buffer, sizeof(buffer));
+            BaseReaderHandler<> h;
+            Reader reader;
+            reader.Parse(s, h);
+        }
+        fclose(fp);
+    }
+}
+#endif // RAPIDJSON_HAS_CXX11
+
+#if RAPIDJSON_HAS_MMAP
+TEST_F(RapidJson, MmapReadStream) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        MmapReadStream s(filename_);
+        while (s.Take() != '\0')
+            ;
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_MmapReadStream)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        MmapReadStream s(filename_);
+        BaseReaderHandler<> h;
+        Reader reader;
+        reader.Parse(s, h);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_MmapInsituStream)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        MmapInsituStream s(filename_);
+        BaseReaderHandler<> h;
+        Reader reader;
+        reader.Parse<kParseInsituFlag>(s, h);
+    }
+}
+#endif // RAPIDJSON_HAS_MMAP
+
 TEST_F(RapidJson, IStreamWrapper) {
     for (size_t i = 0; i < kTrialCount; i++) {
         std::ifstream is(filename_, std::ios::in | std::ios::binary);
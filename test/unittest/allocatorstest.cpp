@@ -254,6 +254,39 @@ TEST(Allocator, MemoryPoolAllocator) {
     }
 }
 
+TEST(Allocator, MemoryPoolAllocatorAdopt) {
+    MemoryPoolAllocator<> a(64), b(64);
+    char* p = static_cast<char*>(a.Malloc(16));
+    std::memset(p, 'a', 16);
+
+    a.Adopt(b); // Nothing to adopt yet
+    EXPECT_EQ(a.Size(), 16u);
+    EXPECT_EQ(a.Capacity(), 64u);
+
+    char* q[10];
+    for (int i = 0; i < 10; i++) {
+        q[i] = static_cast<char*>(b.Malloc(48));
+        std::memset(q[i], '0' + i, 48);
+    }
+    const size_t capacity = a.Capacity() + b.Capacity();
+    const size_t size = a.Size() + b.Size();
+    a.Adopt(b);
+    EXPECT_EQ(b.Capacity(), 0u);
+    EXPECT_EQ(b.Size(), 0u);
+    EXPECT_EQ(a.Capacity(), capacity);
+    EXPECT_EQ(a.Size(), size);
+
+    // a keeps allocating from its own chunk, b starts over
+    EXPECT_EQ(p + 16, a.Malloc(16));
+    b.Free(b.Malloc(8));
+    EXPECT_EQ(b.Size(), 8u);
+    for (int i = 0; i < 10; i++)
+        EXPECT_EQ(std::string(48, static_cast<char>('0' + i)), std::string(q[i], 48));
+
+    a.Clear();
+    EXPECT_EQ(a.Capacity(), 0u);
+}
+
 TEST(Allocator, Alignment) {
     if (sizeof(size_t) >= 8) {
         EXPECT_EQ(RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_ALIGN(0));
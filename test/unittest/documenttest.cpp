@@ -369,6 +369,167 @@ TEST(Document, AcceptWriter) {
     EXPECT_EQ("{\"hello\":\"world\",\"t\":true,\"f\":false,\"n\":null,\"i\":123,\"pi\":3.1416,\"a\":[1,2,3,4]}", os.str());
 }
 
+template <typename ValueType>
+static void TestLazyNumbers(const ValueType& lazy, const Value& eager) {
+    ASSERT_TRUE(lazy.IsArray());
+    ASSERT_EQ(eager.Size(), lazy.Size());
+    for (SizeType i = 0; i < lazy.Size(); i++) {
+        const typename ValueType::ValueType& l = lazy[i];
+        const Value& e = eager[i];
+        EXPECT_TRUE(l.IsRawNumber());
+        EXPECT_FALSE(e.IsRawNumber());
+        EXPECT_EQ(kNumberType, l.GetType());
+        EXPECT_TRUE(l.IsNumber());
+        EXPECT_EQ(e.IsInt(), l.IsInt());
+        EXPECT_EQ(e.IsUint(), l.IsUint());
+        EXPECT_EQ(e.IsInt64(), l.IsInt64());
+        EXPECT_EQ(e.IsUint64(), l.IsUint64());
+        EXPECT_EQ(e.IsDouble(), l.IsDouble());
+        EXPECT_EQ(e.IsLosslessDouble(), l.IsLosslessDouble());
+        if (e.IsInt()) {
+            EXPECT_EQ(e.GetInt(), l.GetInt());
+        }
+        if (e.IsUint()) {
+            EXPECT_EQ(e.GetUint(), l.GetUint());
+        }
+        if (e.IsInt64()) {
+            EXPECT_EQ(e.GetInt64(), l.GetInt64());
+        }
+        if (e.IsUint64()) {
+            EXPECT_EQ(e.GetUint64(), l.GetUint64());
+        }
+        if (!internal::Double(e.GetDouble()).IsNan()) {
+            EXPECT_EQ(e.GetDouble(), l.GetDouble());
+            EXPECT_TRUE(l == e);
+            EXPECT_TRUE(e == l);
+        }
+    }
+}
+
+TEST(Document, ParseLazyNumbers) {
+    const char json[] = "[0, -0, 123, -123, 2147483648, -2147483649, 4294967296, 18446744073709551615, 18446744073709551616, "
+        "1.5, 1.50E+2, -0.0, 1e-400, 0.1, 3.14159265358979323846264338327950288419716939937510582097494459, NaN, -Infinity]";
+
+    Document eager;
+    eager.Parse<kParseFullPrecisionFlag | kParseNanAndInfFlag>(json);
+    ASSERT_FALSE(eager.HasParseError());
+
+    // Copied raw numbers, inline or allocated
+    GenericDocument<UTF8<>, CrtAllocator> lazy;
+    lazy.Parse<kParseLazyNumbersFlag | kParseNanAndInfFlag>(json);
+    ASSERT_FALSE(lazy.HasParseError());
+    TestLazyNumbers(lazy, eager);
+    EXPECT_STREQ("1.50E+2", lazy[10].GetRawNumber());
+    EXPECT_EQ(7u, lazy[10].GetRawNumberLength());
+
+    // Written as is
+    StringBuffer sb;
+    Writer<StringBuffer> writer(sb);
+    lazy.Accept(writer);
+    Document reparsed;
+    reparsed.Parse<kParseLazyNumbersFlag | kParseNanAndInfFlag>(sb.GetString());
+    EXPECT_STREQ("1.50E+2", reparsed[10].GetRawNumber());
+    EXPECT_NE(std::string::npos, std::string(sb.GetString()).find("3.14159265358979323846264338327950288419716939937510582097494459"));
+
+    // Raw numbers in situ, copied with the const strings
+    std::vector<char> buffer(json, json + sizeof(json));
+    Document insitu;
+    insitu.ParseInsitu<kParseLazyNumbersFlag | kParseNanAndInfFlag>(&buffer[0]);
+    ASSERT_FALSE(insitu.HasParseError());
+    TestLazyNumbers(insitu, eager);
+    EXPECT_EQ(&buffer[1], insitu[0].GetRawNumber());
+    Document copy;
+    copy.CopyFrom(insitu, copy.GetAllocator(), true);
+    TestLazyNumbers(copy, eager);
+    EXPECT_NE(&buffer[1], copy[0].GetRawNumber());
+    GenericValue<UTF8<>, CrtAllocator> crtCopy(lazy, lazy.GetAllocator());
+    TestLazyNumbers(crtCopy, eager);
+
+    // Set as other values
+    lazy[2].SetInt(5);
+    EXPECT_FALSE(lazy[2].IsRawNumber());
+    EXPECT_EQ(5, lazy[2].GetInt());
+    lazy[14].SetNull();
+    EXPECT_TRUE(lazy[14].IsNull());
+
+    // Still strings without kParseLazyNumbersFlag
+    Document strings;
+    strings.Parse<kParseNumbersAsStringsFlag>("[1.5]");
+    EXPECT_TRUE(strings[0].IsString());
+}
+
+TEST(Document, ParseLazyContainers) {
+    const char json[] = "{ \"a\" : { \"b\" : [1, 2, { \"c\" : \"}]\\\"[{\" }], \"d\" : {} }, \"e\" : [ [], [\"\\\\\"] ], \"f\" : 1.5, \"g\" : \"h\" }";
+
+    Document eager;
+    eager.Parse(json);
+    ASSERT_FALSE(eager.HasParseError());
+
+    Document lazy;
+    lazy.Parse<kParseLazyContainersFlag>(json);
+    ASSERT_FALSE(lazy.HasParseError());
+    EXPECT_FALSE(lazy.IsLazy());
+    EXPECT_TRUE(lazy["a"].IsLazy());
+    EXPECT_TRUE(lazy["a"].IsObject());
+    EXPECT_TRUE(lazy["e"].IsLazy());
+    EXPECT_TRUE(lazy["e"].IsArray());
+    EXPECT_EQ(1.5, lazy["f"].GetDouble());
+
+    // Parsed one level at a time, when accessed
+    const Value& b = lazy["a"]["b"];
+    EXPECT_FALSE(lazy["a"].IsLazy());
+    EXPECT_TRUE(b.IsLazy());
+    EXPECT_EQ(3u, b.Size());
+    EXPECT_FALSE(b.IsLazy());
+    EXPECT_STREQ("}]\"[{", b[2]["c"].GetString());
+    EXPECT_TRUE(lazy["e"] == eager["e"]);
+    EXPECT_TRUE(lazy == eager);
+
+    // Written as parsed
+    StringBuffer sb1, sb2;
+    Writer<StringBuffer> w1(sb1), w2(sb2);
+    Document written;
+    written.Parse<kParseLazyContainersFlag>(json);
+    written.Accept(w1);
+    eager.Accept(w2);
+    EXPECT_STREQ(sb2.GetString(), sb1.GetString());
+
+    // In situ, copied by CopyFrom() and to an allocator which frees
+    std::vector<char> buffer(json, json + sizeof(json));
+    Document insitu;
+    insitu.ParseInsitu<kParseLazyContainersFlag>(&buffer[0]);
+    ASSERT_FALSE(insitu.HasParseError());
+    Document copy;
+    copy.CopyFrom(insitu, copy.GetAllocator());
+    EXPECT_TRUE(copy == eager);
+    EXPECT_TRUE(insitu == eager);
+    GenericDocument<UTF8<>, CrtAllocator> crt;
+    crt.Parse<kParseLazyContainersFlag | kParseLazyNumbersFlag>(json);
+    ASSERT_FALSE(crt.HasParseError());
+    crt["e"].PushBack(1, crt.GetAllocator());
+    EXPECT_EQ(3u, crt["e"].Size());
+    EXPECT_TRUE(crt["e"][0].Empty());
+    crt["a"].SetNull();
+
+    // Comments may contain brackets and quotation marks
+    Document comments;
+    comments.Parse<kParseLazyContainersFlag | kParseCommentsFlag>("[ { \"a\" : /* }\" */ 1 }, [ // ]\n 2 ] ]");
+    ASSERT_FALSE(comments.HasParseError());
+    EXPECT_EQ(1, comments[0]["a"].GetInt());
+    EXPECT_EQ(2, comments[1][0].GetInt());
+
+    // Only unbalanced brackets are found when parsing
+    Document error;
+    error.Parse<kParseLazyContainersFlag>("[ [1, 2 ]");
+    EXPECT_EQ(kParseErrorArrayMissCommaOrSquareBracket, error.GetParseError());
+    error.Parse<kParseLazyContainersFlag>("[ { \"a\" : \"] }");
+    EXPECT_EQ(kParseErrorStringMissQuotationMark, error.GetParseError());
+    error.Parse<kParseLazyContainersFlag>("[ [1, , 2], { \"a\" ] ]");
+    ASSERT_FALSE(error.HasParseError());
+    EXPECT_TRUE(error[0].Empty());
+    EXPECT_TRUE(error[1].ObjectEmpty());
+}
+
 TEST(Document, UserBuffer) {
     typedef GenericDocument<UTF8<>, MemoryPoolAllocator<>, MemoryPoolAllocator<> > DocumentType;
     char valueBuffer[4096];
@@ -14,6 +14,8 @@
 
 #include "unittest.h"
 #include "rapidjson/internal/dtoa.h"
+#include "rapidjson/internal/ryu.h"
+#include <cstdlib>
 
 #ifdef __GNUC__
 RAPIDJSON_DIAG_PUSH
@@ -94,6 +96,69 @@ TEST(dtoa, maxDecimalPlaces) {
 }
 
 
+TEST(dtoa, ryu) {
+    char buffer[30];
+
+#define TEST_DTOA(d, a)\
+    *RyuDtoa(d, buffer) = '\0';\
+    EXPECT_STREQ(a, buffer)
+
+    TEST_DTOA(0.0, "0.0");
+    TEST_DTOA(-0.0, "-0.0");
+    TEST_DTOA(1.0, "1.0");
+    TEST_DTOA(-1.0, "-1.0");
+    TEST_DTOA(1.2345, "1.2345");
+    TEST_DTOA(1.2345678, "1.2345678");
+    TEST_DTOA(0.123456789012, "0.123456789012");
+    TEST_DTOA(1234567.8, "1234567.8");
+    TEST_DTOA(-79.39773355813419, "-79.39773355813419");
+    TEST_DTOA(-36.973846435546875, "-36.973846435546875");
+    TEST_DTOA(0.000001, "0.000001");
+    TEST_DTOA(0.0000001, "1e-7");
+    TEST_DTOA(1e30, "1e30");
+    TEST_DTOA(1.234567890123456e30, "1.234567890123456e30");
+    TEST_DTOA(5e-324, "5e-324"); // Min subnormal positive double
+    TEST_DTOA(2.225073858507201e-308, "2.225073858507201e-308"); // Max subnormal positive double
+    TEST_DTOA(2.2250738585072014e-308, "2.2250738585072014e-308"); // Min normal positive double
+    TEST_DTOA(1.7976931348623157e308, "1.7976931348623157e308"); // Max double
+    TEST_DTOA(9007199254740992.0, "9007199254740992.0"); // 2^53
+
+    // Grisu2 does not find the shortest digits of these
+    TEST_DTOA(1e23, "1e23");
+    TEST_DTOA(59477.146976, "59477.146976");
+    TEST_DTOA(-36952.943937, "-36952.943937");
+
+#undef TEST_DTOA
+
+#define TEST_DTOA(m, d, a)\
+    *RyuDtoa(d, buffer, m) = '\0';\
+    EXPECT_STREQ(a, buffer)
+
+    TEST_DTOA(3, 0.123456789012, "0.123");
+    TEST_DTOA(1, 0.0001, "0.0");
+    TEST_DTOA(3, 5e-324, "0.0");
+    TEST_DTOA(3, -0.14000000000000001, "-0.14");
+
+#undef TEST_DTOA
+}
+
+TEST(dtoa, ryuRoundTrip) {
+    // Compare with Grisu2 on random bit patterns of finite doubles
+    uint64_t x = RAPIDJSON_UINT64_C2(0x0139408D, 0xCBBF7A44);
+    for (int i = 0; i < 100000; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17; // xorshift64
+        const uint64_t bits = x & RAPIDJSON_UINT64_C2(0x7FEFFFFF, 0xFFFFFFFF);
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+
+        char ryu[30], grisu[30];
+        *RyuDtoa(d, ryu) = '\0';
+        *dtoa(d, grisu) = '\0';
+        EXPECT_EQ(d, std::strtod(ryu, 0)) << ryu;
+        EXPECT_LE(std::strlen(ryu), std::strlen(grisu)) << ryu << " " << grisu;
+    }
+}
+
 #ifdef __GNUC__
 RAPIDJSON_DIAG_POP
 #endif
@@ -14,8 +14,13 @@
 
 #include "unittest.h"
 #include "rapidjson/filereadstream.h"
+#include "rapidjson/asyncfilereadstream.h"
 #include "rapidjson/filewritestream.h"
 #include "rapidjson/encodedstream.h"
+#include "rapidjson/mmapstream.h"
+#include "rapidjson/writevstream.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/document.h"
 
 using namespace rapidjson;
 
@@ -129,6 +134,139 @@ TEST_F(FileStreamTest, FileReadStream_Peek4) {
     fclose(fp);
 }
 
+#if RAPIDJSON_HAS_CXX11
+TEST_F(FileStreamTest, AsyncFileReadStream) {
+    const size_t bufferSizes[] = { 8, 13, 4096, 65536 };
+    for (size_t i = 0; i < sizeof(bufferSizes) / sizeof(bufferSizes[0]); i++) {
+        FILE *fp = fopen(filename_, "rb");
+        ASSERT_TRUE(fp != 0);
+        char buffer[65536];
+        {
+            AsyncFileReadStream s(fp, buffer, bufferSizes[i]);
+            for (size_t j = 0; j < length_; j++) {
+                EXPECT_EQ(json_[j], s.Peek());
+                EXPECT_EQ(json_[j], s.Take());
+            }
+            EXPECT_EQ(length_, s.Tell());
+            EXPECT_EQ('\0', s.Peek());
+        }
+        fclose(fp);
+    }
+
+    // Destroyed before the end of the file, with the reading thread waiting for a free block
+    FILE *fp = fopen(filename_, "rb");
+    ASSERT_TRUE(fp != 0);
+    char buffer[64];
+    {
+        AsyncFileReadStream s(fp, buffer, sizeof(buffer), 4);
+        EXPECT_EQ(json_[0], s.Take());
+    }
+    fclose(fp);
+}
+
+TEST_F(FileStreamTest, AsyncFileReadStream_Peek4) {
+    FILE *fp = fopen(abcde_, "rb");
+    ASSERT_TRUE(fp != 0);
+    char buffer[8];
+    {
+        AsyncFileReadStream s(fp, buffer, sizeof(buffer));
+
+        const char* c = s.Peek4();
+        for (int i = 0; i < 4; i++)
+            EXPECT_EQ('a' + i, c[i]);
+        EXPECT_EQ(0u, s.Tell());
+
+        for (int i = 0; i < 5; i++) {
+            EXPECT_EQ(static_cast<size_t>(i), s.Tell());
+            EXPECT_EQ('a' + i, s.Peek());
+            EXPECT_EQ('a' + i, s.Take());
+        }
+        EXPECT_EQ(5u, s.Tell());
+        EXPECT_EQ(0, s.Peek());
+        EXPECT_EQ(0, s.Take());
+    }
+    fclose(fp);
+}
+#endif // RAPIDJSON_HAS_CXX11
+
+// Texts whose whitespace runs and strings straddle buffer refills, and end at EOF.
+static const char* const kWindowTexts[] = {
+    "  \n\t [ \"abcdefghijklmnopqrstuvwxyz\\n0123456789\\u00e9\" ,   \t\r\n  {\"key\\\"\"  :   \"\\\\\"   } , 1 ,\"\"  ]   \n  ",
+    "[1,2]",
+    "      \"abcdefghij\"",
+    "   123",
+    "[\"abcdefghijkl\x01mnop\"]",
+    "[\"abcdefghijklm",
+    "\t\t\t\t\t\t\t\t",
+    "[1]        x",
+    ""
+};
+
+static void TestFileReadStreamWindow(const char* json, size_t length) {
+    char filename[L_tmpnam];
+    FILE* fp = TempFile(filename);
+    fwrite(json, 1, length, fp);
+    fclose(fp);
+
+    // Full precision: the default number parsing of string streams may round differently
+    Document expected;
+    expected.Parse<kParseFullPrecisionFlag>(json);
+    const size_t bufferSizes[] = { 4, 5, 7, 65536 };
+    for (size_t i = 0; i < sizeof(bufferSizes) / sizeof(bufferSizes[0]); i++) {
+        fp = fopen(filename, "rb");
+        ASSERT_TRUE(fp != 0);
+        char buffer[65536 * 3];
+        FileReadStream s(fp, buffer, bufferSizes[i]);
+        Document d;
+        d.ParseStream<kParseFullPrecisionFlag>(s);
+        EXPECT_EQ(expected.GetParseError(), d.GetParseError()) << json << " " << bufferSizes[i];
+        EXPECT_EQ(expected.GetErrorOffset(), d.GetErrorOffset()) << json << " " << bufferSizes[i];
+        EXPECT_TRUE(expected == d) << json << " " << bufferSizes[i];
+        fclose(fp);
+
+#if RAPIDJSON_HAS_CXX11
+        // Same block size, with 2 and 3 blocks read ahead
+        for (size_t blockCount = 2; blockCount <= 3; blockCount++) {
+            fp = fopen(filename, "rb");
+            ASSERT_TRUE(fp != 0);
+            Document a;
+            {
+                AsyncFileReadStream as(fp, buffer, bufferSizes[i] * blockCount, blockCount);
+                a.ParseStream<kParseFullPrecisionFlag>(as);
+            }
+            EXPECT_EQ(expected.GetParseError(), a.GetParseError()) << json << " " << bufferSizes[i];
+            EXPECT_EQ(expected.GetErrorOffset(), a.GetErrorOffset()) << json << " " << bufferSizes[i];
+            EXPECT_TRUE(expected == a) << json << " " << bufferSizes[i];
+            fclose(fp);
+        }
+#endif
+    }
+    remove(filename);
+}
+
+TEST_F(FileStreamTest, FileReadStream_Window) {
+    FILE *fp = fopen(abcde_, "rb");
+    ASSERT_TRUE(fp != 0);
+    char buffer[4];
+    FileReadStream s(fp, buffer, sizeof(buffer));
+
+    // Consuming a whole window refills the buffer
+    size_t tell = 0;
+    while (size_t size = s.WindowSize()) {
+        EXPECT_EQ('a' + static_cast<int>(tell), *s.Window());
+        s.Consume(size);
+        tell += size;
+        EXPECT_EQ(tell, s.Tell());
+    }
+    EXPECT_EQ(5u, tell);
+    EXPECT_EQ('\0', s.Peek());
+    fclose(fp);
+
+    for (size_t i = 0; i < sizeof(kWindowTexts) / sizeof(kWindowTexts[0]); i++)
+        TestFileReadStreamWindow(kWindowTexts[i], std::strlen(kWindowTexts[i]));
+    TestFileReadStreamWindow(json_, length_);
+}
+
 TEST_F(FileStreamTest, FileWriteStream) {
     char filename[L_tmpnam];
     FILE* fp = TempFile(filename);
@@ -153,3 +291,152 @@ TEST_F(FileStreamTest, FileWriteStream) {
     //std::cout << filename << std::endl;
     remove(filename);
 }
+
+#if RAPIDJSON_HAS_WRITEV
+static std::string ReadFile(const char* filename) {
+    std::string s;
+    FILE* fp = fopen(filename, "rb");
+    char buffer[4096];
+    while (size_t n = fread(buffer, 1, sizeof(buffer), fp))
+        s.append(buffer, n);
+    fclose(fp);
+    return s;
+}
+
+// Writes d with a WritevStream, and checks the result against a StringBuffer.
+template <typename WriterType, typename ExpectedWriterType>
+static void TestWritevStream(const Document& d, size_t bufferSize, size_t minRefLength) {
+    StringBuffer expected;
+    ExpectedWriterType ew(expected);
+    d.Accept(ew);
+
+    char filename[L_tmpnam];
+    FILE* fp = TempFile(filename);
+    std::vector<char> buffer(bufferSize);
+    {
+        WritevStream os(fileno(fp), &buffer[0], bufferSize, minRefLength);
+        WriterType writer(os);
+        EXPECT_TRUE(d.Accept(writer));
+        EXPECT_FALSE(os.HasError());
+    }
+    fclose(fp);
+    EXPECT_EQ(std::string(expected.GetString(), expected.GetSize()), ReadFile(filename)) << bufferSize << " " << minRefLength;
+    remove(filename);
+}
+
+TEST_F(FileStreamTest, WritevStream) {
+    // More long strings than segments of a writev() call, with escapes and short runs
+    Document d;
+    d.SetArray();
+    for (unsigned i = 0; i < 100; i++) {
+        std::string s(i * 7, static_cast<char>('a' + i % 26));
+        s += "\"\n\x01\xC3\xA9";
+        s += std::string(i * 3, 'x');
+        if (i % 10 == 0)
+            d.PushBack(Value(kObjectType).AddMember(Value(s.c_str(), d.GetAllocator()), Value(i), d.GetAllocator()), d.GetAllocator());
+        else
+            d.PushBack(Value(s.c_str(), d.GetAllocator()), d.GetAllocator());
+    }
+    Document sample;
+    sample.Parse(json_, length_);
+    d.PushBack(sample, d.GetAllocator());
+
+    const size_t bufferSizes[] = { 1, 16, 65536 };
+    const size_t minRefLengths[] = { 1, 8, WritevStream::kDefaultMinRefLength };
+    for (size_t i = 0; i < sizeof(bufferSizes) / sizeof(bufferSizes[0]); i++)
+        for (size_t j = 0; j < sizeof(minRefLengths) / sizeof(minRefLengths[0]); j++) {
+            TestWritevStream<Writer<WritevStream>, Writer<StringBuffer> >(d, bufferSizes[i], minRefLengths[j]);
+            TestWritevStream<PrettyWriter<WritevStream>, PrettyWriter<StringBuffer> >(d, bufferSizes[i], minRefLengths[j]);
+        }
+}
+
+TEST_F(FileStreamTest, WritevStream_RawValue) {
+    const std::string raw = "{\"a\":[" + std::string(1000, '1') + "]}";
+    char filename[L_tmpnam];
+    FILE* fp = TempFile(filename);
+    char buffer[16];
+    {
+        WritevStream os(fileno(fp), buffer, sizeof(buffer), 8);
+        Writer<WritevStream> writer(os);
+        writer.StartArray();
+        writer.RawValue(raw.c_str(), raw.size(), kObjectType);
+        writer.String("b");
+        writer.RawValue("", 0, kNullType);
+        writer.EndArray();
+    }
+    fclose(fp);
+    EXPECT_EQ("[" + raw + ",\"b\",]", ReadFile(filename));
+    remove(filename);
+}
+#endif // RAPIDJSON_HAS_WRITEV
+
+#if RAPIDJSON_HAS_MMAP
+TEST_F(FileStreamTest, MmapReadStream) {
+    MmapReadStream s(filename_);
+    ASSERT_TRUE(s.IsMapped());
+    EXPECT_EQ(length_, s.GetSize());
+
+    for (size_t i = 0; i < length_; i++) {
+        EXPECT_EQ(json_[i], s.Peek());
+        EXPECT_EQ(json_[i], s.Take());
+    }
+
+    EXPECT_EQ(length_, s.Tell());
+    EXPECT_EQ('\0', s.Peek());
+
+    Document expected, d;
+    expected.Parse(json_, length_);
+    MmapReadStream s2(filename_, false);
+    d.ParseStream(s2);
+    EXPECT_FALSE(d.HasParseError());
+    EXPECT_TRUE(expected == d);
+}
+
+TEST_F(FileStreamTest, MmapInsituStream) {
+    Document expected;
+    expected.Parse(json_, length_);
+    {
+        MmapInsituStream s(filename_);
+        ASSERT_TRUE(s.IsMapped());
+        Document d;
+        d.ParseStream<kParseInsituFlag>(s);
+        EXPECT_FALSE(d.HasParseError());
+        EXPECT_TRUE(expected == d);
+    }
+
+    // The file is left untouched
+    MmapReadStream s(filename_);
+    ASSERT_EQ(length_, s.GetSize());
+    EXPECT_EQ(0, memcmp(json_, s.GetData(), length_));
+}
+
+TEST_F(FileStreamTest, MmapReadStream_Empty) {
+    MmapReadStream missing("nonexistent.json");
+    EXPECT_FALSE(missing.IsMapped());
+    EXPECT_EQ(0u, missing.GetSize());
+    Document d;
+    d.ParseStream(missing);
+    EXPECT_EQ(kParseErrorDocumentEmpty, d.GetParseError());
+
+    // An empty file, and a file filling whole pages, are null-terminated too
+    const size_t sizes[] = { 0, 4096, 65536 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        char filename[L_tmpnam];
+        FILE* fp = TempFile(filename);
+        std::string json;
+        if (sizes[i]) {
+            json = "[" + std::string(sizes[i] - 3, ' ') + "1]";
+            fwrite(json.data(), 1, json.size(), fp);
+        }
+        fclose(fp);
+
+        MmapReadStream s(filename);
+        EXPECT_TRUE(s.IsMapped());
+        EXPECT_EQ(sizes[i], s.GetSize());
+        EXPECT_EQ('\0', s.GetData()[sizes[i]]);
+        d.ParseStream(s);
+        EXPECT_EQ(sizes[i] ? kParseErrorNone : kParseErrorDocumentEmpty, d.GetParseError());
+        remove(filename);
+    }
+}
+#endif // RAPIDJSON_HAS_MMAP
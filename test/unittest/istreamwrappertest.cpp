@@ -102,6 +102,36 @@ TEST(IStreamWrapper, wstringstream) {
     TestStringStream<wstringstream>();
 }
 
+TEST(IStreamWrapper, Window) {
+    // Whitespace runs and strings straddle buffer refills, tokens end at EOF
+    const char* texts[] = {
+        "  \n\t [ \"abcdefghijklmnopqrstuvwxyz\\n0123456789\\u00e9\" ,   \t\r\n  {\"key\\\"\"  :   \"\\\\\"   } , 1 ,\"\"  ]   \n  ",
+        "      \"abcdefghij\"",
+        "   123",
+        "[\"abcdefghijkl\x01mnop\"]",
+        "[\"abcdefghijklm",
+        "\t\t\t\t\t\t\t\t",
+        "[1]        x"
+    };
+    EXPECT_EQ(1, static_cast<int>(BufferedStreamTraits<IStreamWrapper>::buffered));
+    EXPECT_EQ(0, static_cast<int>(BufferedStreamTraits<WIStreamWrapper>::buffered));
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+        Document expected;
+        expected.Parse(texts[i]);
+        for (size_t bufferSize = 4; bufferSize <= 8; bufferSize++) {
+            istringstream iss(texts[i]);
+            char buffer[8];
+            IStreamWrapper isw(iss, buffer, bufferSize);
+            Document d;
+            d.ParseStream(isw);
+            EXPECT_EQ(expected.GetParseError(), d.GetParseError()) << texts[i] << " " << bufferSize;
+            EXPECT_EQ(expected.GetErrorOffset(), d.GetErrorOffset()) << texts[i] << " " << bufferSize;
+            EXPECT_TRUE(expected == d) << texts[i] << " " << bufferSize;
+        }
+    }
+}
+
 template <typename FileStreamType>
 static bool Open(FileStreamType& fs, const char* filename) {
     const char *paths[] = {
@@ -0,0 +1,138 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+#include "rapidjson/ndjson.h"
+
+#if RAPIDJSON_HAS_CXX11
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace rapidjson;
+
+static const int kRecordCount = 2000;
+
+// Records {"i":n,"s":"..."} with blank lines and CRLF line endings mixed in.
+static std::string MakeNdjson(std::vector<size_t>* offsets) {
+    std::string json;
+    for (int i = 0; i < kRecordCount; i++) {
+        if (i % 7 == 0)
+            json += i % 2 ? "\n" : " \r\n";
+        offsets->push_back(json.size());
+        json += "{\"i\":" + std::to_string(i) + ",\"s\":\"" + std::string(static_cast<size_t>(i % 50), 'x') + "\"}";
+        json += i % 3 ? "\n" : "\r\n";
+    }
+    while (json[json.size() - 1] != '}')
+        json.resize(json.size() - 1); // No line feed after the last record
+    return json;
+}
+
+TEST(NdjsonReader, Ordered) {
+    std::vector<size_t> offsets;
+    const std::string json = MakeNdjson(&offsets);
+
+    for (unsigned threads = 1; threads <= 4; threads++) {
+        NdjsonReader reader(threads, 1000);
+        EXPECT_EQ(threads, reader.GetThreadCount());
+        int n = 0;
+        ParseResult r = reader.Parse(json.data(), json.size(), [&](size_t offset, Document& d) {
+            EXPECT_EQ(offsets[static_cast<size_t>(n)], offset);
+            EXPECT_EQ(n, d["i"].GetInt());
+            EXPECT_EQ(static_cast<SizeType>(n % 50), d["s"].GetStringLength());
+            n++;
+            return true;
+        });
+        EXPECT_TRUE(r);
+        EXPECT_EQ(kRecordCount, n);
+    }
+}
+
+TEST(NdjsonReader, Unordered) {
+    std::vector<size_t> offsets;
+    const std::string json = MakeNdjson(&offsets);
+
+    NdjsonReader reader(4, 100);
+    std::mutex mutex;
+    std::vector<int> values;
+    ParseResult r = reader.Parse<kParseFullPrecisionFlag>(json.data(), json.size(), [&](size_t, Document& d) {
+        std::lock_guard<std::mutex> lock(mutex);
+        values.push_back(d["i"].GetInt());
+        return true;
+    }, false);
+    EXPECT_TRUE(r);
+    ASSERT_EQ(static_cast<size_t>(kRecordCount), values.size());
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < kRecordCount; i++)
+        EXPECT_EQ(i, values[static_cast<size_t>(i)]);
+}
+
+TEST(NdjsonReader, Error) {
+    std::vector<size_t> offsets;
+    std::string json = MakeNdjson(&offsets);
+    json[offsets[1500] + 1] = '?';  // {?i":1500,...
+
+    for (unsigned threads = 1; threads <= 4; threads++) {
+        NdjsonReader reader(threads, 1000);
+        int n = 0;
+        ParseResult r = reader.Parse(json.data(), json.size(), [&](size_t, Document& d) {
+            EXPECT_FALSE(d.HasParseError());
+            EXPECT_EQ(n++, d["i"].GetInt());
+            return true;
+        });
+        EXPECT_EQ(kParseErrorObjectMissName, r.Code());
+        EXPECT_EQ(offsets[1500] + 1, r.Offset());
+        EXPECT_EQ(1500, n);
+    }
+
+    // A record must fit on one line
+    const char split[] = "[1,\n2]\n";
+    EXPECT_EQ(kParseErrorValueInvalid, NdjsonReader(1).Parse(split, sizeof(split) - 1, [](size_t, Document&) { return true; }).Code());
+}
+
+TEST(NdjsonReader, Termination) {
+    std::vector<size_t> offsets;
+    const std::string json = MakeNdjson(&offsets);
+
+    NdjsonReader reader(4, 1000);
+    int n = 0;
+    ParseResult r = reader.Parse(json.data(), json.size(), [&](size_t, Document&) { return ++n < 100; });
+    EXPECT_EQ(kParseErrorTermination, r.Code());
+    EXPECT_EQ(offsets[99], r.Offset());
+    EXPECT_EQ(100, n);
+}
+
+TEST(NdjsonReader, Empty) {
+    NdjsonReader reader(2);
+    int n = 0;
+    EXPECT_TRUE(reader.Parse("", 0, [&](size_t, Document&) { return ++n > 0; }));
+    EXPECT_TRUE(reader.Parse("\n \r\n\n", 5, [&](size_t, Document&) { return ++n > 0; }));
+    EXPECT_EQ(0, n);
+}
+
+TEST(NdjsonReader, CrtAllocator) {
+    std::vector<size_t> offsets;
+    const std::string json = MakeNdjson(&offsets);
+
+    GenericNdjsonReader<UTF8<>, CrtAllocator> reader(3, 500);
+    int n = 0;
+    EXPECT_TRUE(reader.Parse(json.data(), json.size(), [&](size_t, GenericDocument<UTF8<>, CrtAllocator>& d) {
+        return d["i"].GetInt() == n++;
+    }));
+    EXPECT_EQ(kRecordCount, n);
+}
+
+#endif // RAPIDJSON_HAS_CXX11
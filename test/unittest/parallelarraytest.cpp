@@ -0,0 +1,225 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+#include "rapidjson/parallelarray.h"
+
+#if RAPIDJSON_HAS_CXX11
+
+#include <string>
+#include <vector>
+
+using namespace rapidjson;
+
+static const int kElementCount = 3000;
+
+// Objects whose strings hold commas, brackets and escaped quotes, mixed with scalars.
+static std::string MakeArray(std::vector<size_t>* offsets = 0) {
+    std::string json = " [\n";
+    for (int i = 0; i < kElementCount; i++) {
+        if (i)
+            json += i % 5 ? "," : " ,\n ";
+        if (offsets)
+            offsets->push_back(json.size());
+        if (i % 4 == 3)
+            json += std::to_string(i);
+        else
+            json += "{\"i\":" + std::to_string(i) + ",\"s\":\"],[\\\"{\\\\\",\"a\":[" + std::string(static_cast<size_t>(i % 3), '[') + "1" + std::string(static_cast<size_t>(i % 3), ']') + "]}";
+    }
+    json += "\n] ";
+    return json;
+}
+
+TEST(ParallelArray, SplitArray) {
+    const std::string json = MakeArray();
+    const size_t targets[] = { 100, 101, 5000, 20000 };
+    internal::Stack<CrtAllocator> bounds(0, 64);
+    ASSERT_TRUE(internal::StructuralIndexer::SplitArray(json.c_str(), json.size(), targets, 4, bounds));
+    ASSERT_EQ(5u, bounds.GetSize() / sizeof(size_t));
+    const size_t* b = bounds.Bottom<size_t>();
+    EXPECT_EQ(1u, b[0]);
+    EXPECT_EQ(json.size() - 2, b[4]);
+    for (size_t i = 1; i < 4; i++) {
+        EXPECT_EQ(',', json[b[i]]);
+        EXPECT_GE(b[i], targets[i]);
+        EXPECT_LT(b[i], targets[i] + 100);
+        // The next element starts a record of MakeArray()
+        Document d;
+        d.Parse<kParseStopWhenDoneFlag>(json.c_str() + b[i] + 1);
+        EXPECT_FALSE(d.HasParseError());
+    }
+
+    const char* invalid[] = { "", "  ", "{}", "[1]2", "[1] ]", "[[1]", "[1]]", "[\"]\"", "1, [2]" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(*invalid); i++) {
+        bounds.Clear();
+        EXPECT_FALSE(internal::StructuralIndexer::SplitArray(invalid[i], std::strlen(invalid[i]), targets, 4, bounds)) << invalid[i];
+    }
+
+    bounds.Clear();
+    EXPECT_TRUE(internal::StructuralIndexer::SplitArray("[]", 2, targets, 4, bounds));
+    EXPECT_EQ(2u, bounds.GetSize() / sizeof(size_t));
+}
+
+template <typename Allocator>
+static void TestParse(unsigned threadCount) {
+    typedef GenericDocument<UTF8<>, Allocator> DocumentType;
+    const std::string json = MakeArray();
+    DocumentType expected;
+    expected.Parse(json.c_str());
+    ASSERT_FALSE(expected.HasParseError());
+
+    GenericParallelArrayParser<UTF8<>, Allocator> parser(threadCount, 1000);
+    DocumentType d;
+    d.Parse("{");   // The parse error is reset
+    ParseResult r = parser.Parse(d, json.c_str(), json.size());
+    EXPECT_FALSE(r.IsError());
+    EXPECT_FALSE(d.HasParseError());
+    ASSERT_TRUE(d.IsArray());
+    EXPECT_EQ(static_cast<SizeType>(kElementCount), d.Size());
+    EXPECT_TRUE(d == expected);
+
+    // Values are owned by the document allocator once the parser is gone
+    typename DocumentType::ValueType v(d[1], d.GetAllocator());
+    d.Erase(d.Begin());
+    d.PushBack(v, d.GetAllocator());
+    EXPECT_EQ(1, d[0]["i"].GetInt());
+    EXPECT_TRUE(d[0] == d[kElementCount - 1]);
+}
+
+TEST(ParallelArray, Parse) {
+    for (unsigned threadCount = 1; threadCount <= 4; threadCount++) {
+        TestParse<MemoryPoolAllocator<> >(threadCount);
+        TestParse<CrtAllocator>(threadCount);
+    }
+}
+
+TEST(ParallelArray, ParseError) {
+    std::vector<size_t> offsets;
+    std::string json = MakeArray(&offsets);
+    ParallelArrayParser parser(4, 1000);
+
+    // Errors, and text whose root is not an array, are reported as by a serial parse
+    const std::string errors[] = {
+        json.substr(0, offsets[2000]) + "," + json.substr(offsets[2000]),
+        json.substr(0, offsets[2000]) + "{\"a\" 1}" + json.substr(offsets[2000]),
+        json.substr(0, json.size() - 3) + ",\n] ",
+        json.substr(0, json.size() - 3) + "\n]]",
+        "{\"a\":" + json + "}",
+        json + json,
+        "[" + std::string(3000, ' ') + "]"
+    };
+    for (size_t i = 0; i < sizeof(errors) / sizeof(*errors); i++) {
+        Document expected;
+        expected.Parse(errors[i].c_str());
+        Document d;
+        ParseResult r = parser.Parse(d, errors[i].c_str(), errors[i].size());
+        EXPECT_EQ(expected.GetParseError(), r.Code()) << i;
+        EXPECT_EQ(expected.GetErrorOffset(), r.Offset()) << i;
+        EXPECT_EQ(expected.GetParseError(), d.GetParseError()) << i;
+        EXPECT_TRUE(expected == d) << i;
+    }
+
+    // Trailing comma
+    const std::string trailing = json.substr(0, json.size() - 3) + ",\n] ";
+    Document d;
+    parser.Parse<kParseTrailingCommasFlag>(d, trailing.c_str(), trailing.size());
+    EXPECT_FALSE(d.HasParseError());
+    EXPECT_EQ(static_cast<SizeType>(kElementCount), d.Size());
+}
+
+// Records the uints of an array of uints.
+struct UintHandler : BaseReaderHandler<UTF8<>, UintHandler> {
+    UintHandler() : values(), depth(), arrays(), stop(~0u) {}
+    bool Default() { return false; }
+    bool Uint(unsigned u) { values.push_back(u); return u != stop; }
+    bool StartArray() { depth++; arrays++; return true; }
+    bool EndArray(SizeType count) { depth--; return count <= values.size(); }
+    std::vector<unsigned> values;
+    int depth;
+    int arrays;
+    unsigned stop;  // Value terminating the parse
+};
+
+TEST(ParallelArray, ParseSax) {
+    std::string json = "[";
+    for (unsigned i = 0; i < 100000; i++)
+        json += (i ? "," : "") + std::to_string(i);
+    json += "]";
+
+    for (unsigned threadCount = 1; threadCount <= 4; threadCount++) {
+        ParallelArrayParser parser(threadCount, 1000);
+        std::vector<UintHandler> handlers(threadCount);
+        size_t handlerCount = 0;
+        ParseResult r = parser.ParseSax<kParseDefaultFlags>(json.c_str(), json.size(), handlers.data(), &handlerCount);
+        EXPECT_FALSE(r.IsError());
+        EXPECT_EQ(threadCount, handlerCount);
+        unsigned next = 0;
+        for (size_t i = 0; i < handlerCount; i++) {
+            EXPECT_EQ(0, handlers[i].depth);
+            EXPECT_EQ(1, handlers[i].arrays);
+            for (size_t j = 0; j < handlers[i].values.size(); j++)
+                EXPECT_EQ(next++, handlers[i].values[j]);
+        }
+        EXPECT_EQ(100000u, next);
+    }
+
+    // The error of the earliest failing chunk is reported, at its offset in the text
+    ParallelArrayParser parser(4, 1000);
+    std::vector<UintHandler> handlers(4);
+    const std::string wrong = json.substr(0, json.size() - 100) + "x" + json.substr(json.size() - 99);
+    ParseResult r = parser.ParseSax<kParseDefaultFlags>(wrong.c_str(), wrong.size(), handlers.data());
+    Document expected;
+    expected.Parse(wrong.c_str());
+    EXPECT_EQ(expected.GetParseError(), r.Code());
+    EXPECT_EQ(expected.GetErrorOffset(), r.Offset());
+
+    handlers.assign(4, UintHandler());
+    for (size_t i = 0; i < handlers.size(); i++)
+        handlers[i].stop = 12345;
+    r = parser.ParseSax<kParseDefaultFlags>(json.c_str(), json.size(), handlers.data());
+    EXPECT_EQ(kParseErrorTermination, r.Code());
+    EXPECT_EQ(json.find(",12345,") + 1, r.Offset());
+}
+
+TEST(ParallelArray, ParseSaxTrailingComma) {
+    // Only whitespace after the middle of the text: it is split at the trailing comma
+    std::string json = "[";
+    for (unsigned i = 0; i < 1000; i++)
+        json += (i ? "," : "") + std::to_string(i);
+    json += std::string(json.size() * 2, ' ') + ",]";
+
+    ParallelArrayParser parser(2, 1000);
+    std::vector<UintHandler> handlers(2);
+    size_t handlerCount = 0;
+    ParseResult r = parser.ParseSax<kParseTrailingCommasFlag>(json.c_str(), json.size(), handlers.data(), &handlerCount);
+    EXPECT_FALSE(r.IsError());
+    ASSERT_EQ(2u, handlerCount);
+    EXPECT_EQ(1000u, handlers[0].values.size());
+    EXPECT_TRUE(handlers[1].values.empty());
+    EXPECT_EQ(1, handlers[1].arrays);
+    EXPECT_EQ(0, handlers[1].depth);
+
+    Document d;
+    r = parser.Parse<kParseTrailingCommasFlag>(d, json.c_str(), json.size());
+    EXPECT_FALSE(r.IsError());
+    EXPECT_EQ(1000u, d.Size());
+
+    // Still an error without the flag
+    handlers.assign(2, UintHandler());
+    r = parser.ParseSax<kParseDefaultFlags>(json.c_str(), json.size(), handlers.data());
+    EXPECT_EQ(kParseErrorValueInvalid, r.Code());
+    EXPECT_EQ(json.size() - 1, r.Offset());
+}
+
+#endif // RAPIDJSON_HAS_CXX11
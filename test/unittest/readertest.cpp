@@ -20,6 +20,8 @@
 #include "rapidjson/memorystream.h"
 
 #include <limits>
+#include <string>
+#include <vector>
 
 using namespace rapidjson;
 
@@ -1379,6 +1381,106 @@ TEST(Reader, CustomStringStream) {
     EXPECT_EQ(20u, h.step_);
 }
 
+struct NumberEventHandler : BaseReaderHandler<UTF8<>, NumberEventHandler> {
+    NumberEventHandler() : events_() {}
+    bool Int(int i) { return Event('i', static_cast<uint64_t>(static_cast<int64_t>(i))); }
+    bool Uint(unsigned u) { return Event('u', u); }
+    bool Int64(int64_t i) { return Event('I', static_cast<uint64_t>(i)); }
+    bool Uint64(uint64_t u) { return Event('U', u); }
+    bool Double(double d) { return Event('d', internal::Double(d).Uint64Value()); }
+    bool RawNumber(const char* str, SizeType length, bool) {
+        events_ += 's';
+        events_.append(str, length);
+        events_ += ' ';
+        return true;
+    }
+
+    bool Event(char type, uint64_t value) {
+        char buffer[32];
+        *internal::u64toa(value, buffer) = '\0';
+        events_ += type;
+        events_ += buffer;
+        events_ += ' ';
+        return true;
+    }
+
+    std::string events_;
+};
+
+template <unsigned parseFlags>
+static void TestParseDigitRuns(const std::string& json) {
+    // CustomStringStream takes characters one by one
+    CustomStringStream<UTF8<> > cs(json.c_str());
+    NumberEventHandler expected;
+    Reader reader;
+    ASSERT_EQ(kParseErrorNone, reader.Parse<parseFlags>(cs, expected).Code());
+
+    // Digits at every offset to an aligned word
+    for (size_t offset = 0; offset < 8; offset++) {
+        std::string padded = std::string(offset, ' ') + json;
+
+        StringStream s(padded.c_str());
+        NumberEventHandler h;
+        ASSERT_EQ(kParseErrorNone, reader.Parse<parseFlags>(s, h).Code());
+        EXPECT_EQ(expected.events_, h.events_);
+
+        MemoryStream ms(padded.c_str(), padded.size());
+        NumberEventHandler mh;
+        ASSERT_EQ(kParseErrorNone, reader.Parse<parseFlags>(ms, mh).Code());
+        EXPECT_EQ(expected.events_, mh.events_);
+
+        if (!(parseFlags & kParseNumbersAsStringsFlag)) { // RawNumber() strings would not be null-terminated
+            std::vector<char> buffer(padded.begin(), padded.end());
+            buffer.push_back('\0');
+            InsituStringStream is(&buffer[0]);
+            NumberEventHandler ih;
+            ASSERT_EQ(kParseErrorNone, reader.Parse<parseFlags | kParseInsituFlag>(is, ih).Code());
+            EXPECT_EQ(expected.events_, ih.events_);
+        }
+    }
+}
+
+TEST(Reader, ParseNumber_DigitRuns) {
+    // Runs of digits around multiples of 8 and the overflow limits, with fractions and exponents
+    std::string json = "[0, -0, 12345678, -12345678, 123456789, 1234567890123456, 12345678901234567, 123456789012345678, "
+        "2147483647, 2147483648, 2147483649, -2147483647, -2147483648, -2147483649, "
+        "4294967295, 4294967296, 99999999999999999, 100000000000000000, "
+        "9223372036854775807, -9223372036854775808, -9223372036854775809, "
+        "18446744073709551615, 18446744073709551616, 123456789012345678901234567890, "
+        "0.12345678, 0.00000000, 0.000000001234567890123, 1.2345678901234567890, 12345678.12345678e-3, "
+        "9007199254740991.12345678, 900719924.123456789, 900719925.123456789, 1.00000000000000000000000001e10, "
+        "12345678e8, 1234567890123456789e-19]";
+    TestParseDigitRuns<kParseDefaultFlags>(json);
+    TestParseDigitRuns<kParseFullPrecisionFlag>(json);
+    TestParseDigitRuns<kParseNumbersAsStringsFlag>(json);
+
+    // Random runs of digits
+    Random r;
+    for (unsigned i = 0; i < 1000; i++) {
+        json = "[";
+        for (unsigned j = 0; j < 10; j++) {
+            if (j != 0)
+                json += ',';
+            if (r() % 2)
+                json += '-';
+            unsigned n = r() % 24;
+            json += static_cast<char>('1' + r() % 9);
+            while (n--)
+                json += static_cast<char>('0' + r() % 10);
+            if (r() % 2) {
+                json += '.';
+                n = r() % 24;
+                do
+                    json += static_cast<char>('0' + r() % 10);
+                while (n--);
+            }
+        }
+        json += "]";
+        TestParseDigitRuns<kParseDefaultFlags>(json);
+        TestParseDigitRuns<kParseFullPrecisionFlag>(json);
+    }
+}
+
 #include <sstream>
 
 class IStreamWrapper {
@@ -0,0 +1,178 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+// 
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed 
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR 
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the 
+// specific language governing permissions and limitations under the License.
+
+// Runtime dispatch is used regardless of the -march flags of the build, so no
+// compile-time SIMD symbol may be defined here.
+#ifndef RAPIDJSON_SIMD_DISPATCH
+#define RAPIDJSON_SIMD_DISPATCH
+#endif
+
+#define RAPIDJSON_NAMESPACE rapidjson_simd_dispatch
+
+#include "unittest.h"
+
+#include "rapidjson/reader.h"
+#include "rapidjson/writer.h"
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+using namespace rapidjson_simd_dispatch;
+using namespace rapidjson_simd_dispatch::internal;
+
+TEST(SIMDDispatch, DetectSimdLevel) {
+    const SimdLevel level = DetectSimdLevel();
+    EXPECT_EQ(level, DetectSimdLevel());
+#if defined(__x86_64__) || defined(_M_X64)
+    EXPECT_GE(level, kSimdSSE2); // SSE2 is part of x86-64
+#endif
+}
+
+TEST(SIMDDispatch, Kernels) {
+    const SimdLevel detected = DetectSimdLevel();
+    const char* escapes = "\"\\\n\x01";
+
+    for (int l = kSimdScalar; l <= detected; l++) {
+        const SimdKernels k = GetSimdKernels(static_cast<SimdLevel>(l));
+        for (size_t offset = 0; offset < 32; offset++) {
+            for (size_t step = 0; step < 160; step++) {
+                char buffer[256 + 64];
+                char* s = buffer + offset;
+
+                // Whitespace run followed by 'X'
+                for (size_t i = 0; i < step; i++)
+                    s[i] = " \t\r\n"[i % 4];
+                s[step] = 'X';
+                s[step + 1] = '\0';
+                EXPECT_EQ(s + step, k.skipWhitespace(s));
+                EXPECT_EQ(s + step, k.skipWhitespaceN(s, s + step + 1));
+                EXPECT_EQ(s + step, k.skipWhitespaceN(s, s + step));
+
+                // Unescaped run followed by a character to be escaped
+                for (size_t i = 0; i < step; i++)
+                    s[i] = "AB\xC3\xA9"[i % 4];
+                s[step] = escapes[step % 4];
+                s[step + 1] = '\0';
+                EXPECT_EQ(s + step, k.scanUnescaped(s));
+                EXPECT_EQ(s + step, k.scanUnescapedN(s, s + step + 1));
+                EXPECT_EQ(s + step, k.scanUnescapedN(s, s + step));
+            }
+        }
+    }
+}
+
+// Fills s[0, length) with 1 to 4-byte code points, completed with ASCII.
+static void FillUTF8(char* s, size_t length) {
+    static const char kCodePoints[] = "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+    const size_t n = sizeof(kCodePoints) - 1;
+    size_t i = 0;
+    for (; i + n <= length; i += n)
+        std::memcpy(s + i, kCodePoints, n);
+    for (; i < length; i++)
+        s[i] = 'a';
+}
+
+TEST(SIMDDispatch, ValidUTF8Kernels) {
+    const SimdLevel detected = DetectSimdLevel();
+    char storage[256 + 128];
+    char* buffer = reinterpret_cast<char*>((reinterpret_cast<size_t>(storage) + 63) & ~static_cast<size_t>(63));
+    for (int l = kSimdScalar; l <= detected; l++) {
+        const SimdKernels k = GetSimdKernels(static_cast<SimdLevel>(l));
+        const bool simd = l >= kSimdSSE42;
+        for (size_t offset = 0; offset < 64; offset++) {
+            for (size_t step = 0; step < 200; step++) {
+                char* s = buffer + offset;
+                FillUTF8(s, step);
+                s[step] = '\"';
+                s[step + 1] = '\0';
+                // SIMD kernels stop right at the quote, from any alignment
+                EXPECT_EQ(simd ? s + step : s, k.scanValidUTF8Unescaped(s)) << l << " " << offset << " " << step;
+
+                // An invalid byte stops the scan before it, at a code point
+                if (step > 0) {
+                    s[step - 1] = '\xFF';
+                    const char* r = k.scanValidUTF8Unescaped(s);
+                    EXPECT_TRUE(r >= s && r <= s + step - 1);
+                    EXPECT_NE(0x80, static_cast<unsigned char>(*r) & 0xC0);
+                }
+            }
+        }
+    }
+}
+
+struct DispatchStringHandler : BaseReaderHandler<UTF8<>, DispatchStringHandler> {
+    DispatchStringHandler() : str() {}
+    bool String(const char* s, SizeType length, bool) {
+        str.assign(s, length);
+        return true;
+    }
+    std::string str;
+};
+
+TEST(SIMDDispatch, ReaderWriter) {
+    for (size_t step = 0; step < 200; step++) {
+        std::string expected(step, 'a');
+        expected += "\\\"\n";
+        expected += std::string(step, 'b');
+
+        StringBuffer sb;
+        Writer<StringBuffer> writer(sb);
+        writer.String(expected.c_str(), static_cast<SizeType>(expected.size()));
+        const std::string json = std::string("  \n\t") + std::string(step, ' ') + sb.GetString();
+        EXPECT_EQ("\"" + std::string(step, 'a') + "\\\\\\\"\\n" + std::string(step, 'b') + "\"", sb.GetString());
+
+        {
+            StringStream s(json.c_str());
+            Reader reader;
+            DispatchStringHandler h;
+            EXPECT_TRUE(reader.Parse(s, h));
+            EXPECT_EQ(expected, h.str);
+        }
+        {
+            std::vector<char> insitu(json.begin(), json.end());
+            insitu.push_back('\0');
+            InsituStringStream s(&insitu[0]);
+            Reader reader;
+            DispatchStringHandler h;
+            EXPECT_TRUE(reader.Parse<kParseInsituFlag>(s, h));
+            EXPECT_EQ(expected, h.str);
+        }
+    }
+}
+
+TEST(SIMDDispatch, ValidateEncoding) {
+    for (size_t step = 0; step < 200; step++) {
+        std::string expected(step, ' ');
+        FillUTF8(&expected[0], step);
+        const std::string json = "\"" + expected + "\"";
+        const std::string invalid = "\"" + expected + "\xE2\x28\xA1\"";   // Invalid 3-byte sequence
+
+        StringStream s(json.c_str());
+        Reader reader;
+        DispatchStringHandler h;
+        EXPECT_TRUE(reader.Parse<kParseValidateEncodingFlag>(s, h));
+        EXPECT_EQ(expected, h.str);
+
+        StringStream t(invalid.c_str());
+        ParseResult r = reader.Parse<kParseValidateEncodingFlag>(t, h);
+        EXPECT_EQ(kParseErrorStringInvalidEncoding, r.Code());
+        EXPECT_EQ(step + 1, r.Offset());
+    }
+}
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
@@ -15,9 +15,13 @@
 // Since Travis CI installs old Valgrind 3.7.0, which fails with some SSE4.2
 // The unit tests prefix with SIMD should be skipped by Valgrind test
 
-// __SSE2__ and __SSE4_2__ are recognized by gcc, clang, and the Intel compiler.
-// We use -march=native with gmake to enable -msse2 and -msse4.2, if supported.
-#if defined(__SSE4_2__)
+// __SSE2__, __SSE4_2__, __AVX2__ and __AVX512BW__ are recognized by gcc, clang, and the Intel compiler.
+// We use -march=native with gmake to enable -msse2, -msse4.2, -mavx2 and -mavx512bw, if supported.
+#if defined(__AVX512BW__)
+#  define RAPIDJSON_AVX512
+#elif defined(__AVX2__)
+#  define RAPIDJSON_AVX2
+#elif defined(__SSE4_2__)
 #  define RAPIDJSON_SSE42
 #elif defined(__SSE2__)
 #  define RAPIDJSON_SSE2
@@ -31,6 +35,8 @@
 
 #include "rapidjson/reader.h"
 #include "rapidjson/writer.h"
+#include "rapidjson/memorystream.h"
+#include <string>
 
 #ifdef __GNUC__
 RAPIDJSON_DIAG_PUSH
@@ -39,7 +45,11 @@ RAPIDJSON_DIAG_OFF(effc++)
 
 using namespace rapidjson_simd;
 
-#ifdef RAPIDJSON_SSE2
+#ifdef RAPIDJSON_AVX512
+#define SIMD_SUFFIX(name) name##_AVX512
+#elif defined(RAPIDJSON_AVX2)
+#define SIMD_SUFFIX(name) name##_AVX2
+#elif defined(RAPIDJSON_SSE2)
 #define SIMD_SUFFIX(name) name##_SSE2
 #elif defined(RAPIDJSON_SSE42)
 #define SIMD_SUFFIX(name) name##_SSE42
@@ -49,7 +59,7 @@ using namespace rapidjson_simd;
 #define SIMD_SUFFIX(name) name
 #endif
 
-#define SIMD_SIZE_ALIGN(n) ((size_t(n) + 15) & ~size_t(15))
+#define SIMD_SIZE_ALIGN(n) ((size_t(n) + 63) & ~size_t(63))
 
 template <typename StreamType>
 void TestSkipWhitespace() {
@@ -166,6 +176,67 @@ TEST(SIMD, SIMD_SUFFIX(ScanCopyUnescapedString)) {
     TestScanCopyUnescapedString<kParseInsituFlag, InsituStringStream>();
 }
 
+struct ValidateStringHandler : BaseReaderHandler<UTF8<>, ValidateStringHandler> {
+    ValidateStringHandler() : str_() {}
+    bool String(const char* str, SizeType length, bool) { str_.assign(str, length); return true; }
+    std::string str_;
+};
+
+// Compare kParseValidateEncodingFlag on string streams with the scalar path,
+// which EncodedInputStream<UTF8<>, MemoryStream> always takes.
+TEST(SIMD, SIMD_SUFFIX(ScanCopyValidUnescapedString)) {
+    static const char* const valid[] = { "a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xED\x9F\xBF", "\xF4\x8F\xBF\xBF", "\xEF\xBF\xBD" };
+    static const char* const invalid[] = { "", "\x80", "\xC3", "\xC1\xBF", "\xE2\x82", "\xE0\x9F\xBF", "\xED\xA0\x80", "\xF0\x8F\xBF\xBF",
+        "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", "\xF0\x9F\x98", "\xC3\xA9\xA9", "\\n", "\x01" };
+    const size_t validCount = sizeof(valid) / sizeof(valid[0]);
+    const size_t invalidCount = sizeof(invalid) / sizeof(invalid[0]);
+
+    unsigned seed = 1;
+    char buffer[SIMD_SIZE_ALIGN(512)];
+    for (size_t i = 0; i < invalidCount; i++) {
+        for (size_t prefix = 0; prefix < 64; prefix++) {
+            std::string json = "\"";
+            for (size_t k = 0; k < prefix; k++) {
+                seed = seed * 1103515245u + 12345u;
+                json += valid[(seed >> 16) % validCount];
+            }
+            json += invalid[i];
+            for (size_t k = 0; k < 32; k++) {
+                seed = seed * 1103515245u + 12345u;
+                json += valid[(seed >> 16) % validCount];
+            }
+            json += "\"";
+
+            char* str = buffer + (seed >> 8) % 16;
+            ASSERT_LT(json.size() + 16, sizeof(buffer));
+            memcpy(str, json.c_str(), json.size() + 1);
+
+            MemoryStream ms(json.data(), json.size());
+            EncodedInputStream<UTF8<>, MemoryStream> expectedStream(ms);
+            ValidateStringHandler expected;
+            Reader expectedReader;
+            expectedReader.Parse<kParseValidateEncodingFlag>(expectedStream, expected);
+
+            StringStream s(str);
+            ValidateStringHandler h;
+            Reader reader;
+            reader.Parse<kParseValidateEncodingFlag>(s, h);
+            EXPECT_EQ(expectedReader.GetParseErrorCode(), reader.GetParseErrorCode());
+            EXPECT_EQ(expectedReader.GetErrorOffset(), reader.GetErrorOffset());
+            EXPECT_EQ(expectedStream.Tell(), s.Tell());
+            EXPECT_EQ(expected.str_, h.str_);
+
+            InsituStringStream is(str);
+            ValidateStringHandler hi;
+            Reader insituReader;
+            insituReader.Parse<kParseInsituFlag | kParseValidateEncodingFlag>(is, hi);
+            EXPECT_EQ(expectedReader.GetParseErrorCode(), insituReader.GetParseErrorCode());
+            EXPECT_EQ(expectedReader.GetErrorOffset(), insituReader.GetErrorOffset());
+            EXPECT_EQ(expected.str_, hi.str_);
+        }
+    }
+}
+
 TEST(SIMD, SIMD_SUFFIX(ScanWriteUnescapedString)) {
     char buffer[SIMD_SIZE_ALIGN(2048 + 1 + 32)];
     for (size_t offset = 0; offset < 32; offset++) {
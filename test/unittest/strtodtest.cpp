@@ -15,6 +15,7 @@
 #include "unittest.h"
 
 #include "rapidjson/internal/strtod.h"
+#include "rapidjson/internal/ryu.h"
 
 #ifdef __clang__
 RAPIDJSON_DIAG_PUSH
@@ -127,6 +128,60 @@ TEST(Strtod, CheckApproximationCase) {
     EXPECT_EQ(-1, delta.Compare(hS));
 }
 
+static uint64_t DoubleBits(double d) {
+    return Double(d).Uint64Value();
+}
+
+static uint64_t DecimalUint64(const char* s) {
+    uint64_t w = 0;
+    for (; *s; s++)
+        w = w * 10u + static_cast<unsigned>(*s - '0');
+    return w;
+}
+
+TEST(Strtod, EiselLemire) {
+#define TEST_EISELLEMIRE(w, q, d)\
+    EXPECT_EQ(DoubleBits(d), DoubleBits(EiselLemire(DecimalUint64(w), q)))
+
+    TEST_EISELLEMIRE("1", 0, 1.0);
+    TEST_EISELLEMIRE("3", -1, 0.3);
+    TEST_EISELLEMIRE("1", 23, 1e23);
+    TEST_EISELLEMIRE("17976931348623157", 292, 1.7976931348623157e308); // Max double
+    TEST_EISELLEMIRE("17976931348623159", 292, std::numeric_limits<double>::infinity());
+    TEST_EISELLEMIRE("22250738585072014", -324, 2.2250738585072014e-308); // Min normal positive double
+    TEST_EISELLEMIRE("2225073858507201", -323, 2.225073858507201e-308); // Max subnormal positive double
+    TEST_EISELLEMIRE("5", -324, 5e-324); // Min subnormal positive double
+    TEST_EISELLEMIRE("24703282292062327", -340, 0.0); // Below half of the min subnormal
+    TEST_EISELLEMIRE("24703282292062328", -340, 5e-324);
+    TEST_EISELLEMIRE("1", -342, 0.0);
+    TEST_EISELLEMIRE("9007199254740993", 0, 9007199254740992.0); // 2^53 + 1, tie rounded to even
+    TEST_EISELLEMIRE("9007199254740995", 0, 9007199254740996.0); // 2^53 + 3, tie rounded to even
+
+#undef TEST_EISELLEMIRE
+
+    // Read back the shortest digits of random doubles
+    uint64_t x = RAPIDJSON_UINT64_C2(0x0139408D, 0xCBBF7A44);
+    for (int i = 0; i < 100000; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17; // xorshift64
+        const double d = Double(x & RAPIDJSON_UINT64_C2(0x7FEFFFFF, 0xFFFFFFFF)).Value();
+        if (!(d > 0.0))
+            continue;
+        int K;
+        const uint64_t digits = Ryu(d, &K);
+        EXPECT_EQ(DoubleBits(d), DoubleBits(EiselLemire(digits, K)));
+    }
+}
+
+TEST(Strtod, StrtodFullPrecisionEiselLemire) {
+    // More than 19 digits: the first 19 only decide when adding one to them gives the same double
+    const char halfway[] = "9007199254740993000000001"; // Above the tie of 2^53 + 1 by 10^-16
+    EXPECT_EQ(9007199254740994.0, StrtodFullPrecision(0.0, 100, halfway, sizeof(halfway) - 1, 16, 0));
+    const char tie[] = "9007199254740993000000000";
+    EXPECT_EQ(9007199254740992.0, StrtodFullPrecision(0.0, 100, tie, sizeof(tie) - 1, 16, 0));
+    const char many[] = "12345678901234567890123";
+    EXPECT_EQ(1.2345678901234568e22, StrtodFullPrecision(0.0, 100, many, sizeof(many) - 1, sizeof(many) - 1, 0));
+}
+
 #ifdef __clang__
 RAPIDJSON_DIAG_POP
 #endif
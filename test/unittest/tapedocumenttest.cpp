@@ -0,0 +1,165 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+#include "rapidjson/tapedocument.h"
+#include "rapidjson/document.h"
+#include "rapidjson/writer.h"
+#include "rapidjson/stringbuffer.h"
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(c++98-compat)
+#endif
+
+using namespace rapidjson;
+
+static const char kTapeJson[] =
+    "{ \"hello\" : \"world\", \"t\" : true , \"f\" : false, \"n\": null, \"i\":123, \"pi\": 3.1416,"
+    " \"a\":[1, 2, 3, 4], \"o\": {\"x\": -1, \"y\": {}, \"z\": []}, \"e\": \"a\\u0000b\","
+    " \"big\": 18446744073709551615, \"neg\": -9223372036854775808, \"u\": 4294967295 }";
+
+TEST(TapeDocument, Parse) {
+    TapeDocument doc;
+    EXPECT_TRUE(doc.GetRoot().IsNull());
+
+    doc.Parse(kTapeJson);
+    EXPECT_FALSE(doc.HasParseError());
+    EXPECT_TRUE(static_cast<ParseResult>(doc));
+
+    TapeValue root = doc.GetRoot();
+    EXPECT_EQ(kObjectType, root.GetType());
+    EXPECT_EQ(12u, root.MemberCount());
+    EXPECT_FALSE(root.ObjectEmpty());
+
+    EXPECT_TRUE(root.HasMember("hello"));
+    EXPECT_STREQ("world", root["hello"].GetString());
+    EXPECT_EQ(5u, root["hello"].GetStringLength());
+
+    EXPECT_TRUE(root["t"].IsTrue());
+    EXPECT_TRUE(root["t"].GetBool());
+    EXPECT_TRUE(root["f"].IsFalse());
+    EXPECT_FALSE(root["f"].GetBool());
+    EXPECT_TRUE(root["n"].IsNull());
+
+    EXPECT_TRUE(root["i"].IsInt());
+    EXPECT_TRUE(root["i"].IsUint());
+    EXPECT_TRUE(root["i"].IsInt64());
+    EXPECT_TRUE(root["i"].IsUint64());
+    EXPECT_FALSE(root["i"].IsDouble());
+    EXPECT_EQ(123, root["i"].GetInt());
+    EXPECT_DOUBLE_EQ(123.0, root["i"].GetDouble());
+
+    EXPECT_TRUE(root["pi"].IsDouble());
+    EXPECT_EQ(kNumberType, root["pi"].GetType());
+    EXPECT_DOUBLE_EQ(3.1416, root["pi"].GetDouble());
+
+    EXPECT_FALSE(root["big"].IsInt64());
+    EXPECT_EQ(RAPIDJSON_UINT64_C2(0xFFFFFFFF, 0xFFFFFFFF), root["big"].GetUint64());
+    EXPECT_FALSE(root["neg"].IsInt());
+    EXPECT_FALSE(root["neg"].IsUint64());
+    EXPECT_EQ(static_cast<int64_t>(RAPIDJSON_UINT64_C2(0x80000000, 0x00000000)), root["neg"].GetInt64());
+    EXPECT_FALSE(root["u"].IsInt());
+    EXPECT_TRUE(root["u"].IsUint());
+    EXPECT_EQ(4294967295u, root["u"].GetUint());
+
+    EXPECT_EQ(3u, root["e"].GetStringLength());
+    EXPECT_EQ('\0', root["e"].GetString()[1]);
+    EXPECT_EQ('b', root["e"].GetString()[2]);
+
+    TapeValue a = root["a"];
+    EXPECT_TRUE(a.IsArray());
+    EXPECT_EQ(4u, a.Size());
+    EXPECT_FALSE(a.Empty());
+    for (SizeType i = 0; i < a.Size(); i++)
+        EXPECT_EQ(static_cast<int>(i) + 1, a[i].GetInt());
+    int sum = 0;
+    for (TapeValue::ConstValueIterator v = a.Begin(); v != a.End(); ++v)
+        sum += v->GetInt();
+    EXPECT_EQ(10, sum);
+
+    TapeValue o = root["o"];
+    EXPECT_EQ(-1, o["x"].GetInt());
+    EXPECT_TRUE(o["y"].IsObject());
+    EXPECT_TRUE(o["y"].ObjectEmpty());
+    EXPECT_TRUE(o["y"].MemberBegin() == o["y"].MemberEnd());
+    EXPECT_TRUE(o["z"].IsArray());
+    EXPECT_TRUE(o["z"].Empty());
+    EXPECT_EQ(0u, o["z"].Size());
+
+    EXPECT_TRUE(root.FindMember("nothing") == root.MemberEnd());
+    EXPECT_FALSE(root.HasMember("nothing"));
+    EXPECT_FALSE(o.HasMember("hello"));     // not in a nested object
+#if RAPIDJSON_HAS_STDSTRING
+    EXPECT_TRUE(root.HasMember(std::string("pi")));
+    EXPECT_EQ(-1, o[std::string("x")].GetInt());
+#endif
+
+    const char* names[] = { "hello", "t", "f", "n", "i", "pi", "a", "o", "e", "big", "neg", "u" };
+    SizeType n = 0;
+    for (TapeValue::ConstMemberIterator m = root.MemberBegin(); m != root.MemberEnd(); ++m, ++n)
+        EXPECT_STREQ(names[n], m->name.GetString());
+    EXPECT_EQ(root.MemberCount(), n);
+}
+
+TEST(TapeDocument, Accept) {
+    Document d;
+    d.Parse(kTapeJson);
+    StringBuffer expected;
+    Writer<StringBuffer> w1(expected);
+    d.Accept(w1);
+
+    TapeDocument doc;
+    doc.Parse(kTapeJson, sizeof(kTapeJson) - 1);
+    StringBuffer actual;
+    Writer<StringBuffer> w2(actual);
+    EXPECT_TRUE(doc.Accept(w2));
+    EXPECT_STREQ(expected.GetString(), actual.GetString());
+
+    // Scalar root
+    doc.Parse("\"abc\"");
+    EXPECT_STREQ("abc", doc.GetRoot().GetString());
+    doc.Parse(" 1.5 ");
+    EXPECT_DOUBLE_EQ(1.5, doc.GetRoot().GetDouble());
+}
+
+TEST(TapeDocument, ParseError) {
+    TapeDocument doc;
+    doc.Parse("{\"a\": [1, 2}");
+    EXPECT_TRUE(doc.HasParseError());
+    EXPECT_EQ(kParseErrorArrayMissCommaOrSquareBracket, doc.GetParseError());
+    EXPECT_EQ(11u, doc.GetErrorOffset());
+    EXPECT_TRUE(doc.GetRoot().IsNull());
+    EXPECT_EQ(0u, doc.GetTapeSize());
+
+    // Reuse after error
+    doc.Parse("[null]");
+    EXPECT_FALSE(doc.HasParseError());
+    EXPECT_TRUE(doc.GetRoot()[0u].IsNull());
+    EXPECT_EQ(3u * sizeof(uint64_t), doc.GetTapeSize());
+}
+
+TEST(TapeDocument, UTF16) {
+    typedef GenericTapeDocument<UTF16<> > TapeDocument16;
+    TapeDocument16 doc;
+    doc.Parse<kParseDefaultFlags, UTF8<> >("{\"k\":\"\\u4e2d\"}");
+    EXPECT_FALSE(doc.HasParseError());
+    const UTF16<>::Ch key[] = { 'k', '\0' };
+    EXPECT_EQ(1u, doc.GetRoot()[key].GetStringLength());
+    EXPECT_EQ(0x4e2d, doc.GetRoot()[key].GetString()[0]);
+}
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
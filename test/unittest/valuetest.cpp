@@ -1624,6 +1624,107 @@ TEST(Value, EraseMember_String) {
     EXPECT_TRUE(x.MemberBegin() == x.MemberEnd());
 }
 
+template <typename Allocator>
+static void TestLargeObject() {
+    typedef GenericValue<UTF8<>, Allocator> V;
+    Allocator allocator;
+    V x(kObjectType);
+    static const int n = 500;
+    char name[16];
+
+    for (int i = 0; i < n; i++) {
+        sprintf(name, "key%d", i);
+        x.AddMember(V(name, allocator), V(i), allocator);
+    }
+    for (int i = 0; i < n; i++) {
+        sprintf(name, "key%d", i);
+        ASSERT_TRUE(x.HasMember(name));
+        EXPECT_EQ(i, x[name].GetInt());
+    }
+    EXPECT_FALSE(x.HasMember("key500"));
+
+    // Copy
+    V y(x, allocator);
+    for (int i = 0; i < n; i++) {
+        sprintf(name, "key%d", i);
+        EXPECT_EQ(i, y[name].GetInt());
+    }
+
+    // RemoveMember() moves the last member into the removed one's place
+    for (int i = 0; i < n; i += 2) {
+        sprintf(name, "key%d", i);
+        EXPECT_TRUE(x.RemoveMember(name));
+        EXPECT_FALSE(x.HasMember(name));
+    }
+    EXPECT_EQ(static_cast<SizeType>(n / 2), x.MemberCount());
+    for (int i = 1; i < n; i += 2) {
+        sprintf(name, "key%d", i);
+        EXPECT_EQ(i, x[name].GetInt());
+    }
+
+    // EraseMember() shifts the following members
+    x.EraseMember(x.MemberBegin() + 10, x.MemberBegin() + 20);
+    EXPECT_EQ(static_cast<SizeType>(n / 2 - 10), x.MemberCount());
+    for (typename V::ConstMemberIterator m = x.MemberBegin(); m != x.MemberEnd(); ++m)
+        EXPECT_TRUE(x.FindMember(m->name) == m);
+
+    // Duplicated names
+    x.AddMember("key1", 1000, allocator);
+    EXPECT_EQ(1, x["key1"].GetInt());
+    EXPECT_TRUE(x.RemoveMember("key1"));
+    EXPECT_EQ(1000, x["key1"].GetInt());
+
+    x.RemoveAllMembers();
+    EXPECT_FALSE(x.HasMember("key1"));
+    x.AddMember("key1", 1, allocator);
+    EXPECT_EQ(1, x["key1"].GetInt());
+}
+
+TEST(Value, LargeObject) {
+    TestLargeObject<MemoryPoolAllocator<> >();
+    TestLargeObject<CrtAllocator>();
+}
+
+TEST(Value, HashedStringRef) {
+    Value::AllocatorType allocator;
+    static const Value::HashedStringRefType kTimestamp("timestamp");
+    const Value::HashedStringRefType missing = HashedStringRef("missing");
+    EXPECT_EQ(9u, kTimestamp.length);
+    EXPECT_EQ(internal::StrHash("timestamp", 9), kTimestamp.hash);
+    EXPECT_EQ(kTimestamp.hash, HashedStringRef("timestamp\0x", 9).hash);
+#if RAPIDJSON_HAS_CXX11_CONSTEXPR
+    // The hash of a literal is a constant expression
+    static constexpr Value::HashedStringRefType kName = "name";
+    static_assert(kName.hash == 2369371622u, "FNV-1a hash of \"name\"");
+    EXPECT_EQ(internal::StrHash("name", 4), kName.hash);
+#endif
+
+    Value x(kObjectType);
+    char name[16];
+    for (int n = 0; n < 40; n++) {  // Below and above RAPIDJSON_MEMBERSMAP_THRESHOLD
+        if (n == 3)
+            x.AddMember(kTimestamp, n, allocator);
+        else {
+            sprintf(name, "k%d", n);
+            x.AddMember(Value(name, allocator), Value(n), allocator);
+        }
+
+        const Value& y = x;
+        EXPECT_EQ(n >= 3, x.HasMember(kTimestamp));
+        EXPECT_EQ(n >= 3, y.FindMember(kTimestamp) != y.MemberEnd());
+        EXPECT_FALSE(y.HasMember(missing));
+        EXPECT_TRUE(x.FindMember(missing) == x.MemberEnd());
+        if (n >= 3) {
+            EXPECT_EQ(3, x[kTimestamp].GetInt());
+            EXPECT_EQ(3, y[kTimestamp].GetInt());
+            EXPECT_TRUE(x.FindMember(kTimestamp) == x.FindMember("timestamp"));
+        }
+    }
+
+    EXPECT_TRUE(x.RemoveMember("timestamp"));
+    EXPECT_FALSE(x.HasMember(kTimestamp));
+}
+
 TEST(Value, BigNestedArray) {
     MemoryPoolAllocator<> allocator;
     Value x(kArrayType);
@@ -19,6 +19,7 @@
 #include "rapidjson/writer.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/memorybuffer.h"
+#include "rapidjson/filewritestream.h"
 
 #ifdef __clang__
 RAPIDJSON_DIAG_PUSH
@@ -126,6 +127,76 @@ TEST(Writer, ScanWriteUnescapedString) {
     }
 }
 
+// Escapes the string the way Writer does, one character at a time.
+static std::string EscapeString(const std::string& s) {
+    static const char hexDigits[] = "0123456789ABCDEF";
+    std::string result("\"");
+    for (size_t i = 0; i < s.size(); i++) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == '\"' || c == '\\') {
+            result += '\\';
+            result += static_cast<char>(c);
+        }
+        else if (c == '\n')
+            result += "\\n";
+        else if (c < 0x20) {
+            result += "\\u00";
+            result += hexDigits[c >> 4];
+            result += hexDigits[c & 15];
+        }
+        else
+            result += static_cast<char>(c);
+    }
+    return result + '"';
+}
+
+template <typename OutputStream>
+static void TestBufferedOutputStreamString(OutputStream& os, const std::string& s) {
+    Writer<OutputStream> writer(os);
+    EXPECT_TRUE(writer.String(s.data(), static_cast<SizeType>(s.size())));
+    os.Flush();
+}
+
+TEST(Writer, ScanWriteUnescapedString_BufferedOutputStream) {
+    // Runs long enough for the 16 and 32-byte steps, with a character to escape at each position
+    const char special[] = { '"', '\\', '\n', '\x1F', '\0' };
+    std::string base;
+    for (size_t i = 0; i < 100; i++)
+        base += static_cast<char>(i % 3 == 0 ? '\xC3' : i % 3 == 1 ? '\xA9' : 'a' + static_cast<char>(i % 26)); // Not only ASCII
+
+    for (size_t length = 0; length <= base.size(); length += 7) {
+        for (size_t pos = 0; pos <= length; pos++) {
+            for (size_t k = 0; k < sizeof(special); k++) {
+                std::string s = base.substr(0, length);
+                if (pos < length)
+                    s[pos] = special[k];
+                else if (k > 0)
+                    break;
+                const std::string expected = EscapeString(s);
+
+                StringBuffer sb;
+                TestBufferedOutputStreamString(sb, s);
+                EXPECT_EQ(expected, std::string(sb.GetString(), sb.GetSize()));
+
+                MemoryBuffer mb(0, 1); // Grown while writing
+                TestBufferedOutputStreamString(mb, s);
+                EXPECT_EQ(expected, std::string(mb.GetBuffer(), mb.GetSize()));
+
+                FILE* fp = tmpfile();
+                ASSERT_TRUE(fp != 0);
+                char buffer[7]; // Flushed while writing
+                FileWriteStream fs(fp, buffer, sizeof(buffer));
+                TestBufferedOutputStreamString(fs, s);
+                std::string actual(static_cast<size_t>(ftell(fp)), '\0');
+                rewind(fp);
+                EXPECT_EQ(actual.size(), fread(&actual[0], 1, actual.size() + 1, fp));
+                fclose(fp);
+                EXPECT_EQ(expected, actual);
+            }
+        }
+    }
+}
+
 TEST(Writer, Double) {
     TEST_ROUNDTRIP("[1.2345,1.2345678,0.123456789012,1234567.8]");
     TEST_ROUNDTRIP("0.0");